@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Портрет CSR и раскраска для сетки range(1) x range(1) на пуле из range(0) потоков
+    void BM_StiffnessPattern(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+        auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, side);
+
+        for (auto _ : state) {
+            assembly::StiffnessAssembler<Parallel, 4> assembler{pthreads_pool, quads, mesh.extent(0)};
+            benchmark::DoNotOptimize(&assembler);
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.counters["dofs"] = static_cast<double>(2 * mesh.extent(0));
+        state.SetItemsProcessed(state.iterations() * quads.extent(0));
+    }
+
+    ///Заполнение значений по цветам на готовом портрете
+    template <execution_policy Policy>
+    void BM_StiffnessAssemble(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+        auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, side);
+        assembly::StiffnessAssembler<Policy, 4> assembler{pthreads_pool, quads, mesh.extent(0)};
+        auto matrix = assembler.pattern();
+
+        for (auto _ : state) {
+            if (assembler.assemble(pthreads_pool, mesh, steel, matrix) != SPARSE_STATUS_SUCCESS) {
+                state.SkipWithError("mkl_sparse_d_create_csr failed");
+                break;
+            }
+            benchmark::DoNotOptimize(matrix.values_.data());
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.counters["dofs"] = static_cast<double>(matrix.count_rows_);
+        state.counters["colors"] = static_cast<double>(assembler.coloring().count_colors());
+        state.SetItemsProcessed(state.iterations() * quads.extent(0));
+        state.SetBytesProcessed(state.iterations() * matrix.count_nonzeros() * (sizeof(double) + sizeof(MKL_INT)));
+    }
+}
+
+BENCHMARK(BM_StiffnessPattern)
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 2048, 4)})
+    ->UseRealTime();
+BENCHMARK(BM_StiffnessAssemble<Parallel>)
+    ->Name("BM_StiffnessAssemble/Parallel")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 2048, 4)})
+    ->UseRealTime();
+BENCHMARK(BM_StiffnessAssemble<WorkStealing>)
+    ->Name("BM_StiffnessAssemble/WorkStealing")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 2048, 4)})
+    ->UseRealTime();
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "include.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+
+    ///Сетка Кирша range(0) x range(0): pthreads пул
+    void BM_KirschPthreads(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        mesh::GenFrameKirsch<ViewType, Parallel> gen_mesh;
+        for (auto _ : state) {
+            auto mesh = gen_mesh(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.SetItemsProcessed(state.iterations() * side * side);
+    }
+
+    ///Сетка Кирша range(0) x range(0): Kokkos TeamPolicy на пространстве исполнения хоста по умолчанию
+    void BM_KirschKokkos(benchmark::State& state) {
+        const std::size_t side = state.range(0);
+        Kokkos::DefaultHostExecutionSpace space{};
+        custom_kokkos::mesh::GenFrameKirsch<ViewType> gen_mesh;
+        for (auto _ : state) {
+            auto mesh = gen_mesh(space, radius_hole, side_size, multiplier_q, side, side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.counters["threads"] = static_cast<double>(space.concurrency());
+        state.SetItemsProcessed(state.iterations() * side * side);
+    }
+
+    ///Сетка Кирша range(0) x range(0): oneTBB task_group по секторам в арене на все ядра
+    void BM_KirschTbb(benchmark::State& state) {
+        const std::size_t side = state.range(0);
+        tbb::task_arena arena{};
+        custom_tbb::mesh::GenFrameKirsch<ViewType> gen_mesh;
+        for (auto _ : state) {
+            auto mesh = gen_mesh(arena, radius_hole, side_size, multiplier_q, side, side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.counters["threads"] = static_cast<double>(arena.max_concurrency());
+        state.SetItemsProcessed(state.iterations() * side * side);
+    }
+
+    ///Один луч из range(0) точек
+    void BM_RayPthreads(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        auto ray = ViewType("v", state.range(0));
+        grid::GenNonUniformOnRay<ViewType, Parallel> gen_ray;
+        for (auto _ : state) {
+            gen_ray(pthreads_pool, {0.6, 0.8}, {0.06, 0.08}, {6.0, 8.0}, 1.0001, ray);
+            benchmark::DoNotOptimize(ray.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_RayKokkos(benchmark::State& state) {
+        auto ray = ViewType("v", state.range(0));
+        custom_kokkos::grid::GenNonUniformOnRay<ViewType> gen_ray;
+        for (auto _ : state) {
+            gen_ray({0.6, 0.8}, {0.06, 0.08}, {6.0, 8.0}, 1.0001, ray);
+            benchmark::DoNotOptimize(ray.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_RayTbb(benchmark::State& state) {
+        auto ray = ViewType("v", state.range(0));
+        tbb::task_arena arena{};
+        custom_tbb::grid::GenNonUniformOnRay<ViewType> gen_ray;
+        for (auto _ : state) {
+            gen_ray(arena, {0.6, 0.8}, {0.06, 0.08}, {6.0, 8.0}, 1.0001, ray);
+            benchmark::DoNotOptimize(ray.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(BM_KirschPthreads)->RangeMultiplier(4)->Range(64, 2048)->UseRealTime();
+BENCHMARK(BM_KirschKokkos)->RangeMultiplier(4)->Range(64, 2048)->UseRealTime();
+BENCHMARK(BM_KirschTbb)->RangeMultiplier(4)->Range(64, 2048)->UseRealTime();
+BENCHMARK(BM_RayPthreads)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK(BM_RayKokkos)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK(BM_RayTbb)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->UseRealTime();
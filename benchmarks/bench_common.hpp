@@ -0,0 +1,40 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+#ifndef FEM_BENCHMARK_OUTPUT_DIR
+#define FEM_BENCHMARK_OUTPUT_DIR "."
+#endif
+
+namespace bench {
+
+    ///Путь файла бенчмарка в каталоге сборки (FEM_BENCHMARK_OUTPUT_DIR)
+    inline std::string output_path(const std::string& name) {
+        return std::string(FEM_BENCHMARK_OUTPUT_DIR) + "/" + name;
+    }
+
+    ///ISA, под которую собраны ядра (FEM_SIMD_ISA)
+    inline const char* simd_label() {
+#if defined(__AVX512F__)
+        return "avx512";
+#elif defined(__AVX2__)
+        return "avx2";
+#else
+        return "default";
+#endif
+    }
+
+    ///Числа потоков для развертки: степени двойки меньше числа ядер и само число ядер
+    inline std::vector<std::int64_t> thread_counts() {
+        const std::size_t count_cpu = pthreads_manage::get_count_cpu();
+        std::vector<std::int64_t> counts;
+        for (std::size_t count_threads = 1; count_threads < count_cpu; count_threads *= 2)
+            counts.push_back(static_cast<std::int64_t>(count_threads));
+        counts.push_back(static_cast<std::int64_t>(count_cpu));
+        return counts;
+    }
+
+}
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "include.hpp"
+
+namespace {
+    constexpr std::size_t batch_size = 1024;
+
+    ///fast_pow для пачки оснований при показателе range(0); число умножений растет как log2(range(0))
+    template <typename ScalarT>
+    void BM_FastPow(benchmark::State& state) {
+        const std::size_t exp = state.range(0);
+        std::vector<ScalarT> bases(batch_size);
+        for (std::size_t i = 0; i < batch_size; i++)
+            bases[i] = ScalarT(1) + ScalarT(i) / ScalarT(batch_size * exp);
+
+        for (auto _ : state) {
+            ScalarT sum = ScalarT(0);
+            for (std::size_t i = 0; i < batch_size; i++)
+                sum += math_helper::fast_pow(bases[i], exp);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * batch_size);
+    }
+
+    ///То же через std::pow - для сравнения
+    template <typename ScalarT>
+    void BM_StdPow(benchmark::State& state) {
+        const std::size_t exp = state.range(0);
+        std::vector<ScalarT> bases(batch_size);
+        for (std::size_t i = 0; i < batch_size; i++)
+            bases[i] = ScalarT(1) + ScalarT(i) / ScalarT(batch_size * exp);
+
+        for (auto _ : state) {
+            ScalarT sum = ScalarT(0);
+            for (std::size_t i = 0; i < batch_size; i++)
+                sum += std::pow(bases[i], static_cast<ScalarT>(exp));
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * batch_size);
+    }
+
+    ///Пересечение пачки лучей из (0,0) с правой стороной пластины - как при построении каждого луча сетки Кирша
+    template <typename ScalarT>
+    void BM_InterceptionLines(benchmark::State& state) {
+        using p_type = geometry::Point2D<ScalarT>;
+        std::vector<p_type> hole_points(batch_size);
+        for (std::size_t i = 0; i < batch_size; i++) {
+            const ScalarT angle = ScalarT(std::numbers::pi / 4) * ScalarT(i) / ScalarT(batch_size);
+            hole_points[i] = p_type{ScalarT(0.5) * std::cos(angle), ScalarT(0.5) * std::sin(angle)};
+        }
+        const p_type zero_point{ScalarT(0), ScalarT(0)};
+        const p_type first_point_edge{ScalarT(4), ScalarT(0)};
+        const p_type second_point_edge{ScalarT(4), ScalarT(4)};
+
+        for (auto _ : state) {
+            ScalarT sum = ScalarT(0);
+            for (std::size_t i = 0; i < batch_size; i++)
+                sum += geometry::interception_lines(zero_point, hole_points[i], first_point_edge, second_point_edge).y;
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * batch_size);
+    }
+}
+
+BENCHMARK(BM_FastPow<double>)->Name("BM_FastPow/double")->RangeMultiplier(16)->Range(1, 1 << 20);
+BENCHMARK(BM_FastPow<float>)->Name("BM_FastPow/float")->RangeMultiplier(16)->Range(1, 1 << 20);
+BENCHMARK(BM_StdPow<double>)->Name("BM_StdPow/double")->RangeMultiplier(16)->Range(1, 1 << 20);
+BENCHMARK(BM_InterceptionLines<double>)->Name("BM_InterceptionLines/double");
+BENCHMARK(BM_InterceptionLines<float>)->Name("BM_InterceptionLines/float");
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    ///Луч из range(1) точек на пуле из range(0) потоков
+    template <execution_policy Policy>
+    void BM_GenNonUniformOnRay(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t N = state.range(1);
+        auto ray = ViewType("v", N);
+        grid::GenNonUniformOnRay<ViewType, Policy> gen_ray;
+
+        for (auto _ : state) {
+            gen_ray(pthreads_pool, {0.6, 0.8}, {0.06, 0.08}, {6.0, 8.0}, 1.0001, ray);
+            benchmark::DoNotOptimize(ray.data());
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.SetItemsProcessed(state.iterations() * N);
+        state.SetBytesProcessed(state.iterations() * N * 2 * sizeof(double));
+    }
+}
+
+//Sequential исполняется на вызывающем потоке, размер пула на него не влияет
+BENCHMARK(BM_GenNonUniformOnRay<Sequential>)
+    ->Name("BM_GenNonUniformOnRay/Sequential")
+    ->ArgNames({"threads", "points"})
+    ->ArgsProduct({{1}, benchmark::CreateRange(1 << 10, 1 << 22, 16)})
+    ->UseRealTime();
+BENCHMARK(BM_GenNonUniformOnRay<Parallel>)
+    ->Name("BM_GenNonUniformOnRay/Parallel")
+    ->ArgNames({"threads", "points"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(1 << 10, 1 << 22, 16)})
+    ->UseRealTime();
+BENCHMARK(BM_GenNonUniformOnRay<WorkStealing>)
+    ->Name("BM_GenNonUniformOnRay/WorkStealing")
+    ->ArgNames({"threads", "points"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(1 << 10, 1 << 22, 16)})
+    ->UseRealTime();
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+
+    ///Сетка side x side, четырехугольники и поле перемещений в узлах
+    struct OutputProblem {
+        ViewType mesh;
+        topology::QuadView quads;
+        std::vector<double> displacement;
+
+        OutputProblem(pthreads_manage::Pool& pthreads_pool, std::size_t side)
+            : mesh(mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side)),
+              quads(mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, side)),
+              displacement(2 * mesh.extent(0), 1e-3) {}
+
+        [[nodiscard]] std::size_t bytes() const noexcept {
+            return mesh.extent(0) * (2 * sizeof(double) + displacement.size() / mesh.extent(0) * sizeof(double)) + quads.extent(0) * 4 * sizeof(std::size_t);
+        }
+    };
+
+    ///Запись writers:: (range(0) потоков, сетка range(1) x range(1)); bytes - исходные данные сетки и полей
+    template <typename WriterT>
+    void run_writer(benchmark::State& state, const char* file_name) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        OutputProblem problem(pthreads_pool, state.range(1));
+        const std::string path = bench::output_path(file_name);
+
+        for (auto _ : state) {
+            const int error = WriterT{}(pthreads_pool, path, problem.mesh, problem.quads, {{"displacement", problem.displacement.data(), 2}});
+            if (error != 0) {
+                state.SkipWithError("write failed");
+                break;
+            }
+        }
+        std::remove(path.c_str());
+        state.SetBytesProcessed(state.iterations() * problem.bytes());
+    }
+
+    void BM_WriteVtu(benchmark::State& state) {
+        run_writer<writers::VtuWriter<Parallel>>(state, "bench.vtu");
+    }
+
+    void BM_WriteBinary(benchmark::State& state) {
+        run_writer<writers::BinaryWriter<Parallel>>(state, "bench.bin");
+    }
+
+    ///Базовая линия: текстовый вывод через std::ofstream, как делалось до writers::
+    void BM_WriteAscii(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        OutputProblem problem(pthreads_pool, state.range(0));
+        const std::string path = bench::output_path("bench_ascii.txt");
+
+        for (auto _ : state) {
+            std::ofstream file(path);
+            for (std::size_t i = 0; i < problem.mesh.extent(0); i++)
+                file << problem.mesh(i, 0) << ' ' << problem.mesh(i, 1) << ' ' << problem.displacement[2 * i] << ' ' << problem.displacement[2 * i + 1] << '\n';
+            for (std::size_t e = 0; e < problem.quads.extent(0); e++)
+                file << problem.quads(e, 0) << ' ' << problem.quads(e, 1) << ' ' << problem.quads(e, 2) << ' ' << problem.quads(e, 3) << '\n';
+        }
+        std::remove(path.c_str());
+        state.SetBytesProcessed(state.iterations() * problem.bytes());
+    }
+
+    /**
+     * Генерация сетки range(0) x range(0) по секторам (материализация неявной сетки) и запись узлов сектора в файл
+     * @tparam Pipelined true - Executor с двумя полосами: запись сектора k зависит только от его генерации и идет вместе
+     * с генерацией k + 1; false - этапы по очереди на одном пуле
+     */
+    template <bool Pipelined>
+    void BM_PipelinedSectors(benchmark::State& state) {
+        const std::size_t side = static_cast<std::size_t>(state.range(0));
+        constexpr std::size_t count_sectors = 16;
+        const auto implicit_mesh = mesh::GenImplicitKirsch<double>{}(radius_hole, side_size, multiplier_q, side, side);
+        const std::size_t count_nodes = implicit_mesh.extent(0);
+        const std::string path = bench::output_path("bench_pipeline.bin");
+        auto file = io::create_file(path);
+        std::vector<ViewType> sectors(count_sectors);
+        std::atomic<int> error{0};
+
+        auto generate = [&](pthreads_manage::Pool& pthreads_pool, std::size_t k) noexcept {
+            sectors[k] = mesh::materialize<ViewType, Parallel>(pthreads_pool, implicit_mesh,
+                                                               k * count_nodes / count_sectors, (k + 1) * count_nodes / count_sectors);
+        };
+        auto write = [&](std::size_t k) noexcept {
+            const std::size_t begin = k * count_nodes / count_sectors;
+            if (const int status = io::pwrite_all(file.get(), sectors[k].data(), sectors[k].extent(0) * 2 * sizeof(double), begin * 2 * sizeof(double));
+                status != 0)
+                error.store(status);
+            sectors[k] = ViewType{};
+        };
+
+        if constexpr (Pipelined) {
+            pthreads_manage::Executor executor{pthreads_manage::ExecutorSettings{2}};
+            for (auto _ : state) {
+                for (std::size_t k = 0; k < count_sectors; ++k) {
+                    auto generated = executor.submit([&generate, k](pthreads_manage::Pool& pthreads_pool) noexcept { generate(pthreads_pool, k); });
+                    executor.submit([&write, k](pthreads_manage::Pool&) noexcept { write(k); }, {generated});
+                }
+                executor.waitAll();
+            }
+        } else {
+            pthreads_manage::Pool pthreads_pool{};
+            for (auto _ : state) {
+                for (std::size_t k = 0; k < count_sectors; ++k) {
+                    generate(pthreads_pool, k);
+                    write(k);
+                }
+            }
+        }
+        if (error.load() != 0)
+            state.SkipWithError("write failed");
+        file.reset();
+        std::remove(path.c_str());
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(count_nodes * 2 * sizeof(double)));
+    }
+}
+
+BENCHMARK(BM_WriteVtu)
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), {256, 1024}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_WriteBinary)
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), {256, 1024}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_WriteAscii)->ArgNames({"side"})->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PipelinedSectors<false>)->Name("BM_PipelinedSectors/Serial")->ArgNames({"side"})->Arg(1024)->Arg(2048)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PipelinedSectors<true>)->Name("BM_PipelinedSectors/Pipelined")->ArgNames({"side"})->Arg(1024)->Arg(2048)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <numbers>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    template <bool Vectorized>
+    void BM_FillRaySegment(benchmark::State& state) {
+        const std::size_t N = state.range(0);
+        auto ray = ViewType("v", N);
+        geometry::Point2D<double> direction{0.6, 0.8};
+        geometry::Point2D<double> start{0.06, 0.08};
+        geometry::Point2D<double> end{6.0, 8.0};
+        const double multiplier_q = 1.001;
+        const double denominator = 1.0 - math_helper::fast_pow(multiplier_q, N - 1);
+
+        for (auto _ : state) {
+            if constexpr (Vectorized)
+                kernels::fill_ray_segment_nonuniform(direction, start, end, multiplier_q, denominator, 0, ray);
+            else
+                kernels::fill_ray_segment_nonuniform_scalar(direction, start, end, multiplier_q, denominator, 0, ray);
+            benchmark::DoNotOptimize(ray.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * N);
+        state.SetBytesProcessed(state.iterations() * N * 2 * sizeof(double));
+        state.SetLabel(bench::simd_label());
+    }
+
+    template <bool Vectorized>
+    void BM_FillCircleArc(benchmark::State& state) {
+        const std::size_t N = state.range(0);
+        auto arc = ViewType("v", N);
+
+        for (auto _ : state) {
+            if constexpr (Vectorized)
+                kernels::fill_circle_arc_uniform(0.0, std::numbers::pi / 2, 0.5, arc);
+            else
+                kernels::fill_circle_arc_uniform_scalar(0.0, std::numbers::pi / 2, 0.5, arc);
+            benchmark::DoNotOptimize(arc.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * N);
+        state.SetBytesProcessed(state.iterations() * N * 2 * sizeof(double));
+        state.SetLabel(bench::simd_label());
+    }
+}
+
+BENCHMARK(BM_FillRaySegment<false>)->Name("BM_FillRaySegment/scalar")->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BM_FillRaySegment<true>)->Name("BM_FillRaySegment/simd")->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BM_FillCircleArc<false>)->Name("BM_FillCircleArc/scalar")->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BM_FillCircleArc<true>)->Name("BM_FillCircleArc/simd")->RangeMultiplier(8)->Range(64, 1 << 18);
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include "include.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.05;
+
+    ///Генерация сетки Кирша: count_points_on_hole = count_points_on_ray = range(0)
+    template <typename StorageT>
+    void BM_GenFrameKirschLayout(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        mesh::GenFrameKirsch<StorageT, Parallel> gen_mesh;
+
+        for (auto _ : state) {
+            auto mesh = gen_mesh(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.SetItemsProcessed(state.iterations() * side * side);
+        state.SetBytesProcessed(state.iterations() * side * side * 2 * sizeof(double));
+    }
+
+    ///Обход по ячейкам сетки (четырехугольник между соседними лучами): сумма площадей по формуле шнурков
+    template <typename StorageT>
+    void BM_TraverseCellsLayout(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        auto mesh = mesh::GenFrameKirsch<StorageT, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+
+        for (auto _ : state) {
+            double area = 0.0;
+            for (std::size_t ray = 0; ray + 1 < side; ray++) {
+                const std::size_t first = ray * side, second = first + side;
+                for (std::size_t j = 0; j + 1 < side; j++) {
+                    //Обход a -> b -> c -> d: a, b на луче ray, d, c на луче ray + 1
+                    const double ax = mesh(first + j, 0), ay = mesh(first + j, 1);
+                    const double bx = mesh(first + j + 1, 0), by = mesh(first + j + 1, 1);
+                    const double cx = mesh(second + j + 1, 0), cy = mesh(second + j + 1, 1);
+                    const double dx = mesh(second + j, 0), dy = mesh(second + j, 1);
+                    area += 0.5 * ((ax * by - bx * ay) + (bx * cy - cx * by) + (cx * dy - dx * cy) + (dx * ay - ax * dy));
+                }
+            }
+            benchmark::DoNotOptimize(area);
+        }
+        state.SetItemsProcessed(state.iterations() * (side - 1) * (side - 1));
+        state.SetBytesProcessed(state.iterations() * side * side * 2 * sizeof(double));
+    }
+}
+
+BENCHMARK(BM_GenFrameKirschLayout<storage::AoSView<double>>)->Name("BM_GenFrameKirschLayout/AoS")->RangeMultiplier(4)->Range(64, 1024)->UseRealTime();
+BENCHMARK(BM_GenFrameKirschLayout<storage::SoAView<double>>)->Name("BM_GenFrameKirschLayout/SoA")->RangeMultiplier(4)->Range(64, 1024)->UseRealTime();
+BENCHMARK(BM_GenFrameKirschLayout<storage::AoSoAView<double, 8>>)->Name("BM_GenFrameKirschLayout/AoSoA8")->RangeMultiplier(4)->Range(64, 1024)->UseRealTime();
+
+BENCHMARK(BM_TraverseCellsLayout<storage::AoSView<double>>)->Name("BM_TraverseCellsLayout/AoS")->RangeMultiplier(4)->Range(64, 1024);
+BENCHMARK(BM_TraverseCellsLayout<storage::SoAView<double>>)->Name("BM_TraverseCellsLayout/SoA")->RangeMultiplier(4)->Range(64, 1024);
+BENCHMARK(BM_TraverseCellsLayout<storage::AoSoAView<double, 8>>)->Name("BM_TraverseCellsLayout/AoSoA8")->RangeMultiplier(4)->Range(64, 1024);
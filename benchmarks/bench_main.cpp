@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <Kokkos_Core.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "bench_common.hpp"
+#include "core/trace/trace.hpp"
+
+#ifndef FEM_GIT_REVISION
+#define FEM_GIT_REVISION "unknown"
+#endif
+
+int main(int argc, char** argv) {
+    Kokkos::initialize(argc, argv);
+
+    //Контекст попадает в JSON (--benchmark_out_format=json), чтобы при сравнении выпусков было видно, что именно сравнивается
+    ::benchmark::AddCustomContext("fem_git_revision", FEM_GIT_REVISION);
+    ::benchmark::AddCustomContext("fem_simd_isa", bench::simd_label());
+    ::benchmark::AddCustomContext("fem_count_cpu", std::to_string(pthreads_manage::get_count_cpu()));
+    ::benchmark::AddCustomContext("fem_trace", trace::enabled ? "on" : "off");
+    trace::attach_kokkos_tools();
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+
+    //В сборке с ENABLE_TRACE - последние события каждого потока (chrome://tracing, ui.perfetto.dev)
+    if constexpr (trace::enabled) {
+        const std::string trace_path = bench::output_path("fem_trace.json");
+        if (const int error = trace::write_chrome_trace(trace_path); error != 0)
+            std::fprintf(stderr, "trace: cannot write %s: %s\n", trace_path.c_str(), std::strerror(error));
+    }
+
+    Kokkos::finalize();
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Сетка Кирша side x side с закреплениями симметрии
+    struct KirschProblem {
+        ViewType mesh;
+        topology::RayLayout layout;
+        std::vector<MKL_INT> fixed_dofs;
+
+        KirschProblem(pthreads_manage::Pool& pthreads_pool, std::size_t side)
+            : mesh(mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side)),
+              layout{side, side},
+              fixed_dofs(fem::kirsch_symmetry_dofs(layout)) {}
+    };
+
+    /**
+     * y = K * x без хранения матрицы (range(0) потоков, сетка range(1) x range(1)).
+     * bytes - только координаты, x и y: матрица не читается
+     */
+    template <execution_policy Policy>
+    void BM_MatrixFreeApply(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        KirschProblem problem(pthreads_pool, side);
+        matrix_free::ElasticityOperator<Policy, ViewType> op{pthreads_pool, problem.mesh, side, steel, problem.fixed_dofs};
+        std::vector<double> x(op.size(), 1.0), y(op.size());
+
+        for (auto _ : state) {
+            op.apply(x.data(), y.data());
+            benchmark::DoNotOptimize(y.data());
+        }
+        state.counters["dofs"] = static_cast<double>(op.size());
+        state.SetItemsProcessed(state.iterations() * (side - 1) * (side - 1));
+        state.SetBytesProcessed(state.iterations() * side * side * (2 * sizeof(double) + 2 * 2 * sizeof(double)));
+    }
+
+    ///Та же операция через собранную CSR матрицу и mkl_sparse_d_mv (сетка range(0) x range(0))
+    void BM_CsrApply(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        KirschProblem problem(pthreads_pool, side);
+        auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, problem.mesh, side);
+        sparse_status_t status = SPARSE_STATUS_NOT_INITIALIZED;
+        auto matrix = assembly::StiffnessAssembler<Parallel, 4>{pthreads_pool, quads, problem.mesh.extent(0)}(pthreads_pool, problem.mesh, steel, status);
+        fem::apply_dirichlet(matrix, problem.fixed_dofs);
+        if (status != SPARSE_STATUS_SUCCESS || matrix.make_handle(10000) != SPARSE_STATUS_SUCCESS) {
+            state.SkipWithError("assembly failed");
+            return;
+        }
+        solvers::SparseOperator op{matrix};
+        std::vector<double> x(op.size(), 1.0), y(op.size());
+
+        for (auto _ : state) {
+            op.apply(x.data(), y.data());
+            benchmark::DoNotOptimize(y.data());
+        }
+        state.counters["dofs"] = static_cast<double>(op.size());
+        state.counters["matrix_bytes"] = static_cast<double>(matrix.count_nonzeros() * (sizeof(double) + sizeof(MKL_INT)));
+        state.SetItemsProcessed(state.iterations() * (side - 1) * (side - 1));
+        state.SetBytesProcessed(state.iterations() * matrix.count_nonzeros() * (sizeof(double) + sizeof(MKL_INT)));
+    }
+
+    ///CG с предобуславливателем Якоби на матрица-фри операторе
+    void BM_MatrixFreeCg(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        KirschProblem problem(pthreads_pool, side);
+        matrix_free::ElasticityOperator<Parallel, ViewType> A{pthreads_pool, problem.mesh, side, steel, problem.fixed_dofs};
+        solvers::JacobiPreconditioner M{A.inverse_diagonal()};
+        std::vector<double> rhs(A.size(), 0.0), solution(A.size());
+        fem::add_far_field_load(problem.mesh, problem.layout, fem::FarFieldStress{1.0e6, 0.0}, steel.thickness_, rhs.data());
+        for (MKL_INT dof : problem.fixed_dofs)
+            rhs[dof] = 0.0;
+
+        solvers::CgReport report{};
+        for (auto _ : state) {
+            std::fill(solution.begin(), solution.end(), 0.0);
+            report = solvers::conjugate_gradient(A, M, rhs.data(), solution.data(), solvers::CgSettings{1e-8, 100000});
+            benchmark::DoNotOptimize(solution.data());
+        }
+        state.counters["iterations"] = static_cast<double>(report.iterations_);
+        state.counters["dofs"] = static_cast<double>(A.size());
+    }
+
+}
+
+BENCHMARK(BM_MatrixFreeApply<Sequential>)->Name("BM_MatrixFreeApply/Sequential")->ArgNames({"threads", "side"})->ArgsProduct({{1}, {256, 1024, 2048}})->UseRealTime();
+BENCHMARK(BM_MatrixFreeApply<Parallel>)->Name("BM_MatrixFreeApply/Parallel")->ArgNames({"threads", "side"})->ArgsProduct({bench::thread_counts(), {256, 1024, 2048}})->UseRealTime();
+BENCHMARK(BM_MatrixFreeApply<WorkStealing>)->Name("BM_MatrixFreeApply/WorkStealing")->ArgNames({"threads", "side"})->ArgsProduct({bench::thread_counts(), {256, 1024, 2048}})->UseRealTime();
+BENCHMARK(BM_CsrApply)->ArgNames({"side"})->Arg(256)->Arg(1024)->Arg(2048)->UseRealTime();
+BENCHMARK(BM_MatrixFreeCg)->ArgNames({"side"})->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond)->UseRealTime();
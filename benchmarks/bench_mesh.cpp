@@ -0,0 +1,363 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+
+    ///Сетка Кирша range(1) x range(1) на пуле из range(0) потоков
+    template <execution_policy Policy>
+    void BM_GenFrameKirsch(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        mesh::GenFrameKirsch<ViewType, Policy> gen_mesh;
+
+        for (auto _ : state) {
+            auto mesh = gen_mesh(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.SetItemsProcessed(state.iterations() * side * side);
+        state.SetBytesProcessed(state.iterations() * side * side * 2 * sizeof(double));
+    }
+}
+
+BENCHMARK(BM_GenFrameKirsch<Parallel>)
+    ->Name("BM_GenFrameKirsch/Parallel")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 4096, 4)})
+    ->UseRealTime();
+BENCHMARK(BM_GenFrameKirsch<WorkStealing>)
+    ->Name("BM_GenFrameKirsch/WorkStealing")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 4096, 4)})
+    ->UseRealTime();
+
+namespace {
+    /**
+     * Сетка Side x Side с размерами - параметрами шаблона (GenFrameKirschFixed) против того же размера во время выполнения,
+     * в одно и то же хранилище. Fixed = false - GenFrameKirsch::fill
+     */
+    template <execution_policy Policy, std::size_t Side, bool Fixed>
+    void BM_KirschFixedSize(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        auto mesh = storage::allocate<ViewType>("v", Side * Side);
+        for (auto _ : state) {
+            if constexpr (Fixed)
+                mesh::GenFrameKirschFixed<ViewType, Policy, Side, Side>{}.fill(pthreads_pool, mesh, radius_hole, side_size, multiplier_q);
+            else
+                mesh::GenFrameKirsch<ViewType, Policy>{}.fill(pthreads_pool, mesh, radius_hole, side_size, multiplier_q, Side, Side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.SetItemsProcessed(state.iterations() * Side * Side);
+    }
+}
+
+BENCHMARK(BM_KirschFixedSize<Sequential, 33, false>)->Name("BM_KirschFixedSize/Sequential/Runtime/side:33");
+BENCHMARK(BM_KirschFixedSize<Sequential, 33, true>)->Name("BM_KirschFixedSize/Sequential/Fixed/side:33");
+BENCHMARK(BM_KirschFixedSize<Sequential, 129, false>)->Name("BM_KirschFixedSize/Sequential/Runtime/side:129");
+BENCHMARK(BM_KirschFixedSize<Sequential, 129, true>)->Name("BM_KirschFixedSize/Sequential/Fixed/side:129");
+BENCHMARK(BM_KirschFixedSize<Sequential, 513, false>)->Name("BM_KirschFixedSize/Sequential/Runtime/side:513");
+BENCHMARK(BM_KirschFixedSize<Sequential, 513, true>)->Name("BM_KirschFixedSize/Sequential/Fixed/side:513");
+BENCHMARK(BM_KirschFixedSize<Parallel, 129, false>)->Name("BM_KirschFixedSize/Parallel/Runtime/side:129")->UseRealTime();
+BENCHMARK(BM_KirschFixedSize<Parallel, 129, true>)->Name("BM_KirschFixedSize/Parallel/Fixed/side:129")->UseRealTime();
+BENCHMARK(BM_KirschFixedSize<Parallel, 513, false>)->Name("BM_KirschFixedSize/Parallel/Runtime/side:513")->UseRealTime();
+BENCHMARK(BM_KirschFixedSize<Parallel, 513, true>)->Name("BM_KirschFixedSize/Parallel/Fixed/side:513")->UseRealTime();
+
+namespace {
+    /**
+     * Сетка range(0) x range(0) из дискового кэша: каждая итерация - новый кэш (как при запуске процесса),
+     * отображение файла и чтение всех координат (подкачка страниц). Сравнивать с BM_GenFrameKirsch
+     */
+    void BM_KirschMeshCacheHit(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        const std::string directory = bench::output_path("kirsch_cache");
+        {
+            mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+            (void)cache(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+        }
+
+        for (auto _ : state) {
+            mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+            const auto cached = cache(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+            const auto& mesh = cached.mesh();
+            double sum = 0.0;
+            for (std::size_t i = 0; i < mesh.extent(0); i++)
+                sum += mesh(i, 0) + mesh(i, 1);
+            benchmark::DoNotOptimize(sum);
+            if (cache.stats().hits_ != 1) {
+                state.SkipWithError("cache miss");
+                break;
+            }
+        }
+        std::filesystem::remove_all(directory);
+        state.SetItemsProcessed(state.iterations() * side * side);
+        state.SetBytesProcessed(state.iterations() * side * side * 2 * sizeof(double));
+    }
+}
+
+BENCHMARK(BM_KirschMeshCacheHit)->ArgNames({"side"})->RangeMultiplier(4)->Range(64, 4096)->UseRealTime();
+
+namespace {
+    /**
+     * Проход по всем узлам сетки side x side через operator(): хранимая сетка читает 16 байт на узел,
+     * неявная считает координаты из таблиц размера O(side). Counter memory_bytes - память координат
+     */
+    template <bool Implicit>
+    void BM_KirschSweep(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        auto source = [&] {
+            if constexpr (Implicit)
+                return mesh::GenImplicitKirsch<double>{}(radius_hole, side_size, multiplier_q, side, side);
+            else
+                return mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+        }();
+
+        for (auto _ : state) {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < source.extent(0); i++)
+                sum += source(i, 0) + source(i, 1);
+            benchmark::DoNotOptimize(sum);
+        }
+        if constexpr (Implicit)
+            state.counters["memory_bytes"] = static_cast<double>(source.memory_bytes());
+        else
+            state.counters["memory_bytes"] = static_cast<double>(source.extent(0) * 2 * sizeof(double));
+        state.SetItemsProcessed(state.iterations() * side * side);
+    }
+
+    ///Построение неявной сетки и ее материализация в ViewType на пуле из range(0) потоков. Сравнивать с BM_GenFrameKirsch
+    void BM_ImplicitKirschMaterialize(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+
+        for (auto _ : state) {
+            auto implicit_mesh = mesh::GenImplicitKirsch<double>{}(radius_hole, side_size, multiplier_q, side, side);
+            auto mesh = mesh::materialize<ViewType, Parallel>(pthreads_pool, implicit_mesh, 0, implicit_mesh.extent(0));
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.SetItemsProcessed(state.iterations() * side * side);
+        state.SetBytesProcessed(state.iterations() * side * side * 2 * sizeof(double));
+    }
+}
+
+namespace {
+    /**
+     * Перебор параметров: 16 сеток side x side с разными q за итерацию. С ареной сетка и временные точки на отверстии
+     * берутся из storage::Workspace (reset между сетками), без нее - Kokkos выделяет и освобождает память каждой сетки
+     */
+    template <bool UseWorkspace>
+    void BM_KirschParameterSweep(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        mesh::GenFrameKirsch<ViewType, Parallel> gen_mesh;
+        storage::Workspace workspace;
+        constexpr std::size_t count_meshes = 16;
+
+        for (auto _ : state) {
+            for (std::size_t k = 0; k < count_meshes; k++) {
+                const double q = 1.01 + 0.01 * static_cast<double>(k);
+                if constexpr (UseWorkspace) {
+                    if (workspace.reset() != 0) {
+                        state.SkipWithError("workspace");
+                        return;
+                    }
+                    auto mesh = gen_mesh(pthreads_pool, workspace, radius_hole, side_size, q, side, side);
+                    benchmark::DoNotOptimize(mesh.data());
+                } else {
+                    auto mesh = gen_mesh(pthreads_pool, radius_hole, side_size, q, side, side);
+                    benchmark::DoNotOptimize(mesh.data());
+                }
+            }
+        }
+        if constexpr (UseWorkspace)
+            state.counters["overflows"] = static_cast<double>(workspace.countOverflows());
+        state.SetItemsProcessed(state.iterations() * count_meshes * side * side);
+    }
+}
+
+BENCHMARK(BM_KirschParameterSweep<false>)->Name("BM_KirschParameterSweep/Allocate")->ArgNames({"side"})->RangeMultiplier(4)->Range(16, 1024)->UseRealTime();
+BENCHMARK(BM_KirschParameterSweep<true>)->Name("BM_KirschParameterSweep/Workspace")->ArgNames({"side"})->RangeMultiplier(4)->Range(16, 1024)->UseRealTime();
+BENCHMARK(BM_KirschSweep<false>)->Name("BM_KirschSweep/Stored")->ArgNames({"side"})->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_KirschSweep<true>)->Name("BM_KirschSweep/Implicit")->ArgNames({"side"})->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_ImplicitKirschMaterialize)
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 4096, 4)})
+    ->UseRealTime();
+
+namespace {
+    ///Размещение страниц сетки в BM_KirschPlacement
+    enum class Placement {
+        Default,           // Выделение Kokkos, страницы касаются потоки генерации в порядке работы
+        FirstTouch,        // Сектор заранее касается поток, который его генерирует
+        FirstTouchThp,     // То же + madvise(MADV_HUGEPAGE)
+        FirstTouchHugeTlb  // То же на storage::PageBuffer с MAP_HUGETLB (нужен пул vm.nr_hugepages)
+    };
+
+    /**
+     * Сетка side x side с размещением P: генерация вместе с выделением (страницы размещаются при первом касании),
+     * затем повторные параллельные проходы по готовой сетке. Counter traverse_bytes_per_second - полоса повторного прохода
+     */
+    template <Placement P>
+    void BM_KirschPlacement(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        const std::size_t mesh_size = side * side;
+        mesh::GenFrameKirsch<ViewType, Parallel> gen_mesh{mesh::MeshPlacement{P != Placement::Default, P == Placement::FirstTouchThp}};
+
+        storage::PageBuffer buffer;
+        auto generate = [&]() -> ViewType {
+            if constexpr (P == Placement::FirstTouchHugeTlb) {
+                if (buffer.allocate(storage::required_bytes<ViewType>(mesh_size), storage::PageMode::ExplicitHuge) != 0)
+                    return ViewType{};
+                auto mesh = storage::wrap<ViewType>(buffer, mesh_size);
+                gen_mesh.fill(pthreads_pool, mesh, radius_hole, side_size, multiplier_q, side, side);
+                return mesh;
+            } else {
+                return gen_mesh(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+            }
+        };
+
+        ViewType mesh;
+        for (auto _ : state) {
+            mesh = ViewType{};
+            buffer.reset();
+            mesh = generate();
+            if (mesh.extent(0) != mesh_size) {
+                state.SkipWithError("MAP_HUGETLB failed: vm.nr_hugepages is empty");
+                return;
+            }
+            benchmark::DoNotOptimize(mesh.data());
+        }
+        state.SetItemsProcessed(state.iterations() * mesh_size);
+        state.SetBytesProcessed(state.iterations() * mesh_size * 2 * sizeof(double));
+
+        //Повторный проход: каждый поток читает свой сегмент и считает сумму (страницы остаются там, где их разместила генерация)
+        constexpr std::size_t count_traversals = 8;
+        std::vector<double> partial_sums(pthreads_pool.totalThreads() * pthreads_manage::chunks_per_thread_stealing, 0.0);
+        pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange range, std::size_t chunk_id, const std::pair<ViewType, double*>& args) noexcept {
+                                    double sum = 0.0;
+                                    for (std::size_t i = range.begin_; i < range.end_; i++)
+                                        sum += args.first(i, 0) + args.first(i, 1);
+                                    args.second[chunk_id] += sum;
+                                },
+                                std::pair<ViewType, double*>{mesh, partial_sums.data()},
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{mesh_size, pthreads_pool.rangeChunkSize<Parallel>(mesh_size), 0}
+                                };
+        const auto begin = std::chrono::steady_clock::now();
+        for (std::size_t traversal = 0; traversal < count_traversals; traversal++)
+            pthreads_pool.dispatchRange<Parallel>(mesh_size, env);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        benchmark::DoNotOptimize(partial_sums.data());
+        state.counters["traverse_bytes_per_second"] = static_cast<double>(count_traversals * mesh_size * 2 * sizeof(double)) / elapsed.count();
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+    }
+}
+
+BENCHMARK(BM_KirschPlacement<Placement::Default>)
+    ->Name("BM_KirschPlacement/Default")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), {1024, 4096}})
+    ->UseRealTime();
+BENCHMARK(BM_KirschPlacement<Placement::FirstTouch>)
+    ->Name("BM_KirschPlacement/FirstTouch")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), {1024, 4096}})
+    ->UseRealTime();
+BENCHMARK(BM_KirschPlacement<Placement::FirstTouchThp>)
+    ->Name("BM_KirschPlacement/FirstTouchThp")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), {1024, 4096}})
+    ->UseRealTime();
+BENCHMARK(BM_KirschPlacement<Placement::FirstTouchHugeTlb>)
+    ->Name("BM_KirschPlacement/FirstTouchHugeTlb")
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), {1024, 4096}})
+    ->UseRealTime();
+
+namespace {
+    ///Связность четырехугольников для сетки range(1) x range(1) на пуле из range(0) потоков
+    void BM_GenConnectivityKirsch(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+        mesh::GenConnectivityKirsch<Parallel> gen_connectivity;
+
+        for (auto _ : state) {
+            auto quads = gen_connectivity.quads(pthreads_pool, mesh, side);
+            benchmark::DoNotOptimize(quads.data());
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.SetItemsProcessed(state.iterations() * (side - 1) * (side - 1));
+        state.SetBytesProcessed(state.iterations() * (side - 1) * (side - 1) * 4 * sizeof(std::size_t));
+    }
+
+    ///Перенумерация узлов сетки range(0) лучей x range(1) точек; ширина ленты и профиль до и после - в счетчиках
+    template <topology::NodeOrdering Ordering>
+    void BM_Renumber(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t count_rays = state.range(0);
+        const std::size_t count_points_on_ray = state.range(1);
+        auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, count_rays, count_points_on_ray);
+        auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, count_points_on_ray);
+
+        topology::OrderingReport report{};
+        for (auto _ : state) {
+            auto renumbered = topology::renumber(Ordering, mesh, quads);
+            benchmark::DoNotOptimize(renumbered.coordinates_.data());
+            report = renumbered.report_;
+        }
+        state.counters["bandwidth_before"] = static_cast<double>(report.before_.bandwidth_);
+        state.counters["bandwidth_after"] = static_cast<double>(report.after_.bandwidth_);
+        state.counters["profile_before"] = static_cast<double>(report.before_.profile_);
+        state.counters["profile_after"] = static_cast<double>(report.after_.profile_);
+        state.SetItemsProcessed(state.iterations() * count_rays * count_points_on_ray);
+    }
+}
+
+BENCHMARK(BM_GenConnectivityKirsch)
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(64, 4096, 4)})
+    ->UseRealTime();
+BENCHMARK(BM_Renumber<topology::NodeOrdering::ReverseCuthillMcKee>)
+    ->Name("BM_Renumber/RCM")
+    ->ArgNames({"rays", "points"})
+    ->Args({64, 1024})->Args({1024, 64})->Args({512, 512});
+BENCHMARK(BM_Renumber<topology::NodeOrdering::Hilbert>)
+    ->Name("BM_Renumber/Hilbert")
+    ->ArgNames({"rays", "points"})
+    ->Args({64, 1024})->Args({1024, 64})->Args({512, 512});
+
+namespace {
+    ///Проверка качества сетки range(1) x range(1) (прямоугольник узлов и показатели ячеек) на пуле из range(0) потоков
+    void BM_MeshQuality(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(0))};
+        const std::size_t side = state.range(1);
+        const topology::RayLayout layout{side, side};
+        auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+
+        for (auto _ : state) {
+            auto quality = mesh::mesh_quality<Parallel>(pthreads_pool, mesh, layout);
+            benchmark::DoNotOptimize(quality);
+        }
+        state.counters["threads"] = static_cast<double>(pthreads_pool.totalThreads());
+        state.SetItemsProcessed(state.iterations() * layout.count_cells());
+    }
+}
+
+BENCHMARK(BM_MeshQuality)
+    ->ArgNames({"threads", "side"})
+    ->ArgsProduct({bench::thread_counts(), benchmark::CreateRange(256, 4096, 4)})
+    ->UseRealTime();
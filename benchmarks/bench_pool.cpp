@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include <thread>
+#include <vector>
+#include "include.hpp"
+#include "bench_common.hpp"
+
+namespace {
+    void emptyKernel(ViewType, std::size_t, void*) {}
+
+    pthreads_manage::PartitionerSettings onePerThread(void* args) {
+        auto* count_threads = static_cast<std::size_t*>(args);
+        return pthreads_manage::PartitionerSettings{*count_threads, 1, 0};
+    }
+
+    ///Время полного цикла dispatchJob с пустым ядром: публикация задачи, пробуждение потоков, ожидание всех. range(1) - число потоков
+    void BM_DispatchEmptyKernel(benchmark::State& state) {
+        auto wait_policy = static_cast<pthreads_manage::WaitPolicy>(state.range(0));
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(1)), wait_policy};
+        std::size_t count_threads = pthreads_pool.totalThreads();
+        auto view = ViewType("v", count_threads);
+        pthreads_manage::JobContext context{view, &emptyKernel, nullptr, &onePerThread, &count_threads};
+
+        for (auto _ : state)
+            pthreads_pool.dispatchJob(context);
+
+        state.counters["threads"] = static_cast<double>(count_threads);
+        state.SetLabel(wait_policy == pthreads_manage::WaitPolicy::Park ? "Park" : "SpinThenPark");
+    }
+
+    ///То же через типизированный dispatchJob<Policy>: ядро - лямбда, сегмент на поток
+    template <execution_policy Policy>
+    void BM_DispatchTypedEmptyKernel(benchmark::State& state) {
+        auto wait_policy = static_cast<pthreads_manage::WaitPolicy>(state.range(0));
+        pthreads_manage::Pool pthreads_pool{static_cast<std::size_t>(state.range(1)), wait_policy};
+        const std::size_t count_threads = pthreads_pool.totalThreads();
+        auto view = ViewType("v", count_threads);
+        pthreads_manage::Environment env{
+                                [](auto chunk, std::size_t, std::size_t) noexcept { benchmark::DoNotOptimize(chunk.data()); },
+                                std::size_t{0},
+                                [](std::size_t count_chunks) noexcept { return pthreads_manage::PartitionerSettings{count_chunks, 1, 0}; },
+                                count_threads
+                            };
+
+        for (auto _ : state)
+            pthreads_pool.dispatchJob<Policy>(view, env);
+
+        state.counters["threads"] = static_cast<double>(count_threads);
+        state.SetLabel(wait_policy == pthreads_manage::WaitPolicy::Park ? "Park" : "SpinThenPark");
+    }
+
+    ///Короткий луч: накладные расходы диспетчеризации сравнимы с ядром
+    template <execution_policy Policy>
+    void BM_ShortRay(benchmark::State& state) {
+        auto wait_policy = static_cast<pthreads_manage::WaitPolicy>(state.range(0));
+        pthreads_manage::Pool pthreads_pool{wait_policy};
+        auto ray = ViewType("v", state.range(1));
+        grid::GenNonUniformOnRay<ViewType, Policy> gen_ray;
+        geometry::Point2D<double> direction{0.6, 0.8};
+
+        for (auto _ : state) {
+            gen_ray(pthreads_pool, direction, geometry::Point2D<double>{0.06, 0.08}, geometry::Point2D<double>{6.0, 8.0}, 1.01, ray);
+            benchmark::DoNotOptimize(ray.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(1));
+        state.SetLabel(wait_policy == pthreads_manage::WaitPolicy::Park ? "Park" : "SpinThenPark");
+    }
+
+    const char* affinity_label(pthreads_manage::Affinity affinity) {
+        switch (affinity) {
+            case pthreads_manage::Affinity::None: return "None";
+            case pthreads_manage::Affinity::Compact: return "Compact";
+            case pthreads_manage::Affinity::Scatter: return "Scatter";
+            case pthreads_manage::Affinity::SmtAware: return "SmtAware";
+        }
+        return "";
+    }
+
+    ///Сумма по массиву 64 МиБ, сегмент на поток: пропускная способность памяти при разном закреплении. range(1) - число потоков
+    void BM_AffinityStream(benchmark::State& state) {
+        const auto affinity = static_cast<pthreads_manage::Affinity>(state.range(0));
+        pthreads_manage::Pool pthreads_pool{pthreads_manage::PoolSettings{static_cast<std::size_t>(state.range(1)), affinity}};
+        const std::size_t count_threads = pthreads_pool.totalThreads();
+        const std::size_t N = std::size_t{4} << 20;
+        auto view = ViewType("v", N);
+        std::vector<double> sums(count_threads, 0.0);
+        pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange range, std::size_t chunk_id, const std::pair<ViewType, double*>& args) noexcept {
+                                    double sum = 0.0;
+                                    for (std::size_t i = range.begin_; i < range.end_; ++i)
+                                        sum += args.first(i, 0) + args.first(i, 1);
+                                    args.second[chunk_id] = sum;
+                                },
+                                std::pair<ViewType, double*>{view, sums.data()},
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{N, (N + count_threads - 1) / count_threads, 0}
+                                };
+
+        for (auto _ : state) {
+            pthreads_pool.dispatchRange<Parallel>(N, env);
+            benchmark::DoNotOptimize(sums.data());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(N * 2 * sizeof(double)));
+        state.counters["threads"] = static_cast<double>(count_threads);
+        state.SetLabel(affinity_label(affinity));
+    }
+
+    /**
+     * Два пула в одном процессе, каждый из своего потока, диспетчеризуют короткие задачи
+     * @tparam Partitioned true - пулы на непересекающихся половинах CpuTopology::partition(2), false - оба на всех процессорах
+     */
+    template <bool Partitioned>
+    void BM_TwoPools(benchmark::State& state) {
+        const auto topology = pthreads_manage::CpuTopology::discover();
+        const auto halves = topology.partition(2);
+        const std::size_t count_threads = std::max<std::size_t>(topology.size() / 2, 1);
+        constexpr std::size_t dispatches_per_iteration = 256;
+
+        for (auto _ : state) {
+            std::vector<std::thread> owners;
+            for (std::size_t part = 0; part < 2; ++part) {
+                owners.emplace_back([&, part] {
+                    pthreads_manage::PoolSettings settings{count_threads, pthreads_manage::Affinity::Compact,
+                                                           pthreads_manage::WaitPolicy::Park, Partitioned ? halves[part] : topology, Partitioned};
+                    pthreads_manage::Pool pthreads_pool{settings};
+                    pthreads_manage::Environment env{
+                                            [](pthreads_manage::IndexRange range, std::size_t, int) noexcept { benchmark::DoNotOptimize(range.end_); },
+                                            0,
+                                            [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                            pthreads_manage::PartitionerSettings{count_threads, 1, 0}
+                                            };
+                    for (std::size_t dispatch = 0; dispatch < dispatches_per_iteration; ++dispatch)
+                        pthreads_pool.dispatchRange<Parallel>(count_threads, env);
+                });
+            }
+            for (auto& owner : owners)
+                owner.join();
+        }
+        state.SetItemsProcessed(state.iterations() * 2 * dispatches_per_iteration);
+        state.counters["threads"] = static_cast<double>(count_threads);
+    }
+}
+
+BENCHMARK(BM_DispatchEmptyKernel)
+    ->ArgNames({"wait", "threads"})
+    ->ArgsProduct({{static_cast<int>(pthreads_manage::WaitPolicy::Park), static_cast<int>(pthreads_manage::WaitPolicy::SpinThenPark)}, bench::thread_counts()})
+    ->UseRealTime();
+BENCHMARK(BM_DispatchTypedEmptyKernel<Parallel>)
+    ->Name("BM_DispatchTypedEmptyKernel/Parallel")
+    ->ArgNames({"wait", "threads"})
+    ->ArgsProduct({{static_cast<int>(pthreads_manage::WaitPolicy::Park), static_cast<int>(pthreads_manage::WaitPolicy::SpinThenPark)}, bench::thread_counts()})
+    ->UseRealTime();
+BENCHMARK(BM_DispatchTypedEmptyKernel<WorkStealing>)
+    ->Name("BM_DispatchTypedEmptyKernel/WorkStealing")
+    ->ArgNames({"wait", "threads"})
+    ->ArgsProduct({{static_cast<int>(pthreads_manage::WaitPolicy::Park)}, bench::thread_counts()})
+    ->UseRealTime();
+
+BENCHMARK(BM_ShortRay<Sequential>)
+    ->ArgsProduct({{static_cast<int>(pthreads_manage::WaitPolicy::Park)}, {256, 1024}})
+    ->UseRealTime();
+BENCHMARK(BM_ShortRay<Parallel>)
+    ->ArgsProduct({{static_cast<int>(pthreads_manage::WaitPolicy::Park), static_cast<int>(pthreads_manage::WaitPolicy::SpinThenPark)}, {256, 1024}})
+    ->UseRealTime();
+
+BENCHMARK(BM_AffinityStream)
+    ->ArgNames({"affinity", "threads"})
+    ->ArgsProduct({{static_cast<int>(pthreads_manage::Affinity::None), static_cast<int>(pthreads_manage::Affinity::Compact),
+                    static_cast<int>(pthreads_manage::Affinity::Scatter), static_cast<int>(pthreads_manage::Affinity::SmtAware)},
+                   bench::thread_counts()})
+    ->UseRealTime();
+BENCHMARK(BM_TwoPools<false>)->Name("BM_TwoPools/Shared")->UseRealTime();
+BENCHMARK(BM_TwoPools<true>)->Name("BM_TwoPools/Partitioned")->UseRealTime();
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include "include.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+
+    /**
+     * Генерация сетки Кирша в заданной точности (count_points_on_hole = count_points_on_ray = range(0)).
+     * Кроме времени выводится потеря точности относительно сетки double:
+     * max_abs_error - максимальное отклонение координаты, max_rel_error - оно же, деленное на сторону пластины,
+     * rms_error - среднеквадратичное отклонение по всем координатам
+     * @tparam StorageT Хранилище (тип хранения)
+     * @tparam ComputeT Тип вычислений
+     */
+    template <typename StorageT, typename ComputeT>
+    void BM_GenFrameKirschPrecision(benchmark::State& state) {
+        pthreads_manage::Pool pthreads_pool{};
+        const std::size_t side = state.range(0);
+        mesh::GenFrameKirsch<StorageT, Parallel, ComputeT> gen_mesh;
+
+        StorageT mesh;
+        for (auto _ : state) {
+            mesh = gen_mesh(pthreads_pool, ComputeT(radius_hole), ComputeT(side_size), ComputeT(multiplier_q), side, side);
+            benchmark::DoNotOptimize(mesh.data());
+        }
+
+        auto reference = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+        double max_abs_error = 0.0, sum_squares = 0.0;
+        for (std::size_t i = 0; i < reference.extent(0); i++) {
+            for (std::size_t c = 0; c < 2; c++) {
+                const double error = std::abs(static_cast<double>(mesh(i, c)) - reference(i, c));
+                max_abs_error = std::max(max_abs_error, error);
+                sum_squares += error * error;
+            }
+        }
+        state.counters["max_abs_error"] = max_abs_error;
+        state.counters["max_rel_error"] = max_abs_error / side_size;
+        state.counters["rms_error"] = std::sqrt(sum_squares / (2.0 * reference.extent(0)));
+        state.SetItemsProcessed(state.iterations() * side * side);
+        state.SetBytesProcessed(state.iterations() * side * side * 2 * sizeof(storage::scalar_t<StorageT>));
+    }
+}
+
+BENCHMARK(BM_GenFrameKirschPrecision<storage::AoSView<double>, double>)->Name("BM_GenFrameKirschPrecision/double")->RangeMultiplier(4)->Range(64, 1024)->UseRealTime();
+BENCHMARK(BM_GenFrameKirschPrecision<storage::AoSView<float>, float>)->Name("BM_GenFrameKirschPrecision/float")->RangeMultiplier(4)->Range(64, 1024)->UseRealTime();
+BENCHMARK(BM_GenFrameKirschPrecision<storage::AoSView<float>, double>)->Name("BM_GenFrameKirschPrecision/mixed")->RangeMultiplier(4)->Range(64, 1024)->UseRealTime();
@@ -0,0 +1,177 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include "include.hpp"
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.01;
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Собранная система задачи Кирша side x side с range(1) случаями нагружения
+    struct KirschSystem {
+        pthreads_manage::Pool pthreads_pool{};
+        sparse::CsrMatrix matrix;
+        std::vector<double> rhs;
+        sparse_status_t status = SPARSE_STATUS_NOT_INITIALIZED; // Статус сборки
+
+        KirschSystem(std::size_t side, std::size_t count_cases) {
+            auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, side, side);
+            auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, side);
+            matrix = assembly::StiffnessAssembler<Parallel, 4>{pthreads_pool, quads, mesh.extent(0)}(pthreads_pool, mesh, steel, status);
+
+            const topology::RayLayout layout{side, side};
+            const std::size_t n = matrix.count_rows_;
+            rhs.assign(n * count_cases, 0.0);
+            for (std::size_t c = 0; c < count_cases; c++) {
+                //Случаи нагружения: поворот главных напряжений far field
+                const double t = count_cases > 1 ? double(c) / double(count_cases - 1) : 0.0;
+                fem::add_far_field_load(mesh, layout, fem::FarFieldStress{1.0e6 * (1.0 - t), 1.0e6 * t}, steel.thickness_, rhs.data() + c * n);
+            }
+            fem::apply_dirichlet(matrix, fem::kirsch_symmetry_dofs(layout), rhs.data(), count_cases);
+        }
+    };
+
+    ///Полный цикл PARDISO: reorder + factor + solve для range(1) правых частей. Время этапов - в счетчиках
+    void BM_PardisoPhases(benchmark::State& state) {
+        const std::size_t count_cases = state.range(1);
+        KirschSystem system(state.range(0), count_cases);
+        if (system.status != SPARSE_STATUS_SUCCESS) {
+            state.SkipWithError("assembly failed");
+            return;
+        }
+        std::vector<double> solution(system.rhs.size());
+
+        solvers::PhaseTimings timings{};
+        for (auto _ : state) {
+            solvers::PardisoSolver solver;
+            solver.analyze(system.matrix);
+            solver.factorize(system.matrix);
+            solver.solve(system.rhs.data(), solution.data(), static_cast<MKL_INT>(count_cases));
+            benchmark::DoNotOptimize(solution.data());
+            timings = solver.timings();
+        }
+        state.counters["reorder_s"] = timings.reorder_seconds_;
+        state.counters["factor_s"] = timings.factor_seconds_;
+        state.counters["solve_s"] = timings.solve_seconds_;
+        state.counters["dofs"] = static_cast<double>(system.matrix.count_rows_);
+        state.SetItemsProcessed(state.iterations() * count_cases);
+    }
+
+    ///Только solve по готовой факторизации: стоимость еще одного случая нагружения
+    void BM_PardisoSolveReuse(benchmark::State& state) {
+        const std::size_t count_cases = state.range(1);
+        KirschSystem system(state.range(0), count_cases);
+        if (system.status != SPARSE_STATUS_SUCCESS) {
+            state.SkipWithError("assembly failed");
+            return;
+        }
+        std::vector<double> solution(system.rhs.size());
+        solvers::PardisoSolver solver;
+        solver.analyze(system.matrix);
+        solver.factorize(system.matrix);
+
+        for (auto _ : state) {
+            solver.solve(system.rhs.data(), solution.data(), static_cast<MKL_INT>(count_cases));
+            benchmark::DoNotOptimize(solution.data());
+        }
+        state.counters["dofs"] = static_cast<double>(system.matrix.count_rows_);
+        state.SetItemsProcessed(state.iterations() * count_cases);
+    }
+
+    ///CG с предобуславливателем Якоби на mkl_sparse_d_mv
+    void BM_JacobiCg(benchmark::State& state) {
+        KirschSystem system(state.range(0), 1);
+        if (system.status != SPARSE_STATUS_SUCCESS || system.matrix.make_handle(10000) != SPARSE_STATUS_SUCCESS) {
+            state.SkipWithError("assembly failed");
+            return;
+        }
+        solvers::SparseOperator A{system.matrix};
+        solvers::JacobiPreconditioner M{system.matrix};
+        std::vector<double> solution(system.rhs.size());
+
+        solvers::CgReport report{};
+        for (auto _ : state) {
+            std::fill(solution.begin(), solution.end(), 0.0);
+            report = solvers::conjugate_gradient(A, M, system.rhs.data(), solution.data(), solvers::CgSettings{1e-8, 100000});
+            benchmark::DoNotOptimize(solution.data());
+        }
+        state.counters["iterations"] = static_cast<double>(report.iterations_);
+        state.counters["dofs"] = static_cast<double>(system.matrix.count_rows_);
+        state.SetBytesProcessed(state.iterations() * report.iterations_ * system.matrix.count_nonzeros() * (sizeof(double) + sizeof(MKL_INT)));
+    }
+
+    ///Решение задачи Кирша (одноосное растяжение) и ошибки напряжений в ячейках относительно аналитического решения (пусто, если сборка не удалась)
+    template <coordinate_source_like ContainerT>
+    std::vector<double> kirsch_cell_errors(pthreads_manage::Pool& pthreads_pool, const ContainerT& mesh, const topology::RayLayout& layout, double plate_radius_hole) {
+        const fem::FarFieldStress tension{1.0e6, 0.0};
+        auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, layout.count_points_on_ray_);
+        sparse_status_t status = SPARSE_STATUS_NOT_INITIALIZED;
+        auto matrix = assembly::StiffnessAssembler<Parallel, 4>{pthreads_pool, quads, mesh.extent(0)}(pthreads_pool, mesh, steel, status);
+        std::vector<double> rhs(matrix.count_rows_, 0.0), solution(rhs.size(), 0.0);
+        fem::add_far_field_load(mesh, layout, tension, steel.thickness_, rhs.data());
+        fem::apply_dirichlet(matrix, fem::kirsch_symmetry_dofs(layout), rhs.data(), 1);
+        if (status != SPARSE_STATUS_SUCCESS || matrix.make_handle(1000) != SPARSE_STATUS_SUCCESS)
+            return {};
+        solvers::conjugate_gradient(solvers::SparseOperator{matrix}, solvers::JacobiPreconditioner{matrix}, rhs.data(), solution.data(), solvers::CgSettings{1e-10, 100000});
+        const auto stresses = fem::cell_stresses(mesh, layout, solution.data(), steel);
+        return fem::analytic_cell_errors(mesh, layout, stresses, tension, plate_radius_hole);
+    }
+
+    /**
+     * Путь до точности напряжений range(0) / 1000 на пластине 10 x 10: адаптивная сетка (веер из 5 лучей, refine до допуска)
+     * против равномерных сеток n x n с растущим n. Счетчики: степени свободы последней сетки и число решенных задач
+     */
+    template <bool Adaptive>
+    void BM_KirschToTolerance(benchmark::State& state) {
+        const double target = static_cast<double>(state.range(0)) / 1000.0;
+        constexpr double plate_side = 10.0;
+        pthreads_manage::Pool pthreads_pool{};
+        std::size_t dofs = 0, count_solves = 0;
+        double error = 0.0;
+        for (auto _ : state) {
+            count_solves = 0;
+            if constexpr (Adaptive) {
+                mesh::AdaptiveKirsch<ViewType, Parallel> adaptive(pthreads_pool, radius_hole, plate_side, mesh::RayFan::uniform(5, 1.1), 25);
+                mesh::RefineSettings settings;
+                settings.tolerance_ = target;
+                while (true) {
+                    const auto errors = kirsch_cell_errors(pthreads_pool, adaptive.mesh(), adaptive.layout(), radius_hole);
+                    if (errors.empty()) {
+                        state.SkipWithError("assembly failed");
+                        return;
+                    }
+                    ++count_solves;
+                    error = *std::max_element(errors.begin(), errors.end());
+                    if (error < target || adaptive.refine(pthreads_pool, fem::ray_interval_errors(adaptive.layout(), errors), settings) == 0)
+                        break;
+                }
+                dofs = 2 * adaptive.mesh().extent(0);
+            } else {
+                for (std::size_t n = 9; n <= 129; n += 8) {
+                    const auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, plate_side, 1.15, n, n);
+                    const auto errors = kirsch_cell_errors(pthreads_pool, mesh, topology::RayLayout{n, n}, radius_hole);
+                    if (errors.empty()) {
+                        state.SkipWithError("assembly failed");
+                        return;
+                    }
+                    ++count_solves;
+                    error = *std::max_element(errors.begin(), errors.end());
+                    dofs = 2 * n * n;
+                    if (error < target)
+                        break;
+                }
+            }
+        }
+        state.counters["dofs"] = static_cast<double>(dofs);
+        state.counters["error"] = error;
+        state.counters["solves"] = static_cast<double>(count_solves);
+    }
+}
+
+BENCHMARK(BM_PardisoPhases)->ArgNames({"side", "cases"})->ArgsProduct({{64, 256, 1024}, {1, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PardisoSolveReuse)->ArgNames({"side", "cases"})->ArgsProduct({{64, 256, 1024}, {1, 4, 16}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_JacobiCg)->ArgNames({"side"})->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_KirschToTolerance<false>)->Name("BM_KirschToTolerance/Uniform")->ArgNames({"target_permille"})->Arg(30)->Arg(20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_KirschToTolerance<true>)->Name("BM_KirschToTolerance/Adaptive")->ArgNames({"target_permille"})->Arg(30)->Arg(20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -1,12 +1,15 @@
 #pragma once
 #include <type_traits>
 #include <concepts>
+#include <cstddef>
+#include <utility>
 #include <Kokkos_Core.hpp>
 
 using ViewType = Kokkos::View<double*[2], Kokkos::LayoutRight, Kokkos::HostSpace>;
 
 struct Sequential {};
 struct Parallel {};
+struct WorkStealing {};
 
 template<class T>
 concept scalar = std::floating_point<T>;
@@ -26,6 +29,59 @@ concept kokkos_view_rank2_like = kokkos_view_like<View> && std::remove_cvref_t<V
 template<class View>
 concept kokkos_view_2d_like = kokkos_view_rank2_like<View> && std::remove_cvref_t<View>::traits::dimension::N1 == 2;
 
+///Блочное хранение AoSoA: блоки по block_size точек, внутри блока сначала все x, затем все y
+template<class S>
+concept aosoa_storage_like = requires (const S s, std::size_t i){
+    typename S::value_type;
+    { S::block_size } -> std::convertible_to<std::size_t>;
+    { s.extent(0) } -> std::convertible_to<std::size_t>;
+    { s(i, 0) } -> std::same_as<typename S::value_type&>;
+    { s.subrange(i, i) } -> std::same_as<S>;
+};
+
+///Хранилище координат точек: s(i, 0) = x, s(i, 1) = y. AoS (LayoutRight), SoA (LayoutLeft) или AoSoA
+template<class S>
+concept coordinate_storage_like = kokkos_view_2d_like<S> || aosoa_storage_like<std::remove_cvref_t<S>>;
+
+///Неявная сетка: координаты вычисляются при доступе, s(i, c) возвращает значение, а не ссылку
+template<class S>
+concept implicit_coordinates_like = requires (const S s, std::size_t i){
+    typename S::value_type;
+    { s.extent(0) } -> std::convertible_to<std::size_t>;
+    { s(i, 0) } -> std::same_as<typename S::value_type>;
+    { s.subrange(i, i) } -> std::same_as<S>;
+};
+
+///Источник координат только для чтения: хранилище или неявная сетка. Принимается всеми, кто координаты не пишет
+template<class S>
+concept coordinate_source_like = coordinate_storage_like<S> || implicit_coordinates_like<std::remove_cvref_t<S>>;
+
+///Тип сегмента [begin, end) хранилища координат
+template<class S>
+struct storage_subrange;
+
+template<kokkos_view_2d_like S>
+struct storage_subrange<S> {
+    using type = decltype(Kokkos::subview(std::declval<S>(), Kokkos::pair<std::size_t, std::size_t>(0, 0), Kokkos::ALL));
+};
+
+template<aosoa_storage_like S>
+struct storage_subrange<S> {
+    using type = S;
+};
+
+template<implicit_coordinates_like S>
+struct storage_subrange<S> {
+    using type = S;
+};
+
+template<class S>
+using storage_subrange_t = typename storage_subrange<std::remove_cvref_t<S>>::type;
+
+///Пространство исполнения Kokkos с доступом к памяти хоста (Serial, OpenMP, Threads)
+template<class S>
+concept kokkos_host_execution_space = Kokkos::is_execution_space_v<S> && Kokkos::SpaceAccessibility<S, Kokkos::HostSpace>::accessible;
+
 template<class P>
 concept is_parallel = std::same_as<std::remove_cvref_t<P>, Parallel>;
 
@@ -33,7 +89,10 @@ template<class P>
 concept is_sequential = std::same_as<std::remove_cvref_t<P>, Sequential>;
 
 template<class P>
-concept execution_policy = is_sequential<P> || is_parallel<P>;
+concept is_work_stealing = std::same_as<std::remove_cvref_t<P>, WorkStealing>;
+
+template<class P>
+concept execution_policy = is_sequential<P> || is_parallel<P> || is_work_stealing<P>;
 
 template<class E>
 concept environment = requires (E e){
@@ -44,4 +103,17 @@ concept environment = requires (E e){
     e.partitioner_args;
 };
 
+///Окружение, применимое к хранилищу View: разделитель возвращает параметры нарезки, ядро принимает сегмент хранилища
+template<class E, class View>
+concept environment_for = environment<E> && coordinate_source_like<View> && requires (const E e, storage_subrange_t<View> chunk, std::size_t chunk_id){
+    { e.partitioner(e.partitioner_args).chunk_size_ } -> std::convertible_to<std::size_t>;
+    { e.partitioner(e.partitioner_args).overlap_size_ } -> std::convertible_to<std::size_t>;
+    e.run_kernel(chunk, chunk_id, e.kernel_args);
+};
 
+///Линейный оператор на векторах длины size(): op.apply(x, y) записывает y = A * x (матрица, matrix-free оператор, предобуславливатель)
+template<class Op>
+concept linear_operator = requires (const Op op, const double* x, double* y){
+    { op.size() } -> std::convertible_to<std::size_t>;
+    op.apply(x, y);
+};
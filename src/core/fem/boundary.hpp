@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "core/sparse/csr_matrix.hpp"
+
+namespace fem {
+
+    /**
+     * Однородные условия Дирихле u_i = 0 с сохранением симметрии: строка и столбец i обнуляются, на диагональ ставится 1,
+     * правые части в строке i обнуляются. Значения меняются на месте, поэтому handle MKL пересоздается
+     * @param matrix Собранная матрица (портрет симметричный)
+     * @param dofs Закрепленные степени свободы
+     * @param rhs Правые части по столбцам (count_rhs столбцов длины count_rows_), может быть nullptr
+     * @param count_rhs
+     * @return Статус создания handle
+     */
+    inline sparse_status_t apply_dirichlet(sparse::CsrMatrix& matrix, const std::vector<MKL_INT>& dofs, double* rhs = nullptr, std::size_t count_rhs = 0) {
+        matrix.handle_.reset();
+        for (MKL_INT dof : dofs) {
+            for (MKL_INT p = matrix.row_offsets_[dof]; p < matrix.row_offsets_[dof + 1]; p++) {
+                const MKL_INT column = matrix.col_indices_[p];
+                matrix.values_[p] = (column == dof) ? 1.0 : 0.0;
+                if (column != dof)
+                    matrix.values_[matrix.find(column, dof)] = 0.0;
+            }
+            for (std::size_t c = 0; c < count_rhs; c++)
+                rhs[c * matrix.count_rows_ + dof] = 0.0;
+        }
+        return matrix.make_handle();
+    }
+
+}
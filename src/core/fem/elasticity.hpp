@@ -0,0 +1,238 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include "core/custom_concepts.hpp"
+
+namespace fem {
+
+    ///Степеней свободы в узле: перемещения u_x, u_y. Степень свободы c узла n имеет номер dofs_per_node * n + c
+    inline constexpr std::size_t dofs_per_node = 2;
+
+    ///Изотропный материал пластины в плоском напряженном состоянии
+    struct Material {
+        double young_modulus_;
+        double poisson_ratio_;
+        double thickness_ = 1.0;
+    };
+
+    using ElasticityMatrix = std::array<std::array<double, 3>, 3>;
+
+    ///Матрица упругости D плоского напряженного состояния: sigma = D * (eps_xx, eps_yy, gamma_xy)
+    [[nodiscard]] constexpr ElasticityMatrix plane_stress(const Material& material) noexcept {
+        const double E = material.young_modulus_;
+        const double nu = material.poisson_ratio_;
+        const double factor = E / (1.0 - nu * nu);
+        return {{
+            {factor, factor * nu, 0.0},
+            {factor * nu, factor, 0.0},
+            {0.0, 0.0, factor * (1.0 - nu) / 2.0}
+        }};
+    }
+
+    /**
+     * Матрица жесткости элемента в степенях свободы (u_x0, u_y0, u_x1, u_y1, ...)
+     * @tparam NodesPerElement 4 - билинейный четырехугольник, 3 - треугольник с постоянной деформацией
+     */
+    template <std::size_t NodesPerElement>
+    using ElementMatrix = std::array<std::array<double, dofs_per_node * NodesPerElement>, dofs_per_node * NodesPerElement>;
+
+    ///Добавить к верхнему блочному треугольнику K_e (блоки b <= a) вклад w * B^T D B (B - 3 x 2N матрица деформаций)
+    template <std::size_t NodesPerElement>
+    constexpr void add_btdb(
+                    ElementMatrix<NodesPerElement>& stiffness,
+                    const std::array<double, NodesPerElement>& dN_dx,
+                    const std::array<double, NodesPerElement>& dN_dy,
+                    const ElasticityMatrix& D,
+                    double weight
+                    ) noexcept {
+        for (std::size_t a = 0; a < NodesPerElement; a++) {
+            //D * B_a, B_a = [[dN_a/dx, 0], [0, dN_a/dy], [dN_a/dy, dN_a/dx]]
+            const double db_xx = D[0][0] * dN_dx[a], db_xy = D[0][1] * dN_dy[a];
+            const double db_yx = D[1][0] * dN_dx[a], db_yy = D[1][1] * dN_dy[a];
+            const double db_sx = D[2][2] * dN_dy[a], db_sy = D[2][2] * dN_dx[a];
+            for (std::size_t b = 0; b <= a; b++) {
+                stiffness[2 * b][2 * a]         += weight * (dN_dx[b] * db_xx + dN_dy[b] * db_sx);
+                stiffness[2 * b][2 * a + 1]     += weight * (dN_dx[b] * db_xy + dN_dy[b] * db_sy);
+                stiffness[2 * b + 1][2 * a]     += weight * (dN_dy[b] * db_yx + dN_dx[b] * db_sx);
+                stiffness[2 * b + 1][2 * a + 1] += weight * (dN_dy[b] * db_yy + dN_dx[b] * db_sy);
+            }
+        }
+    }
+
+    /**
+     * Матрица жесткости элемента по координатам его узлов (узлы против часовой стрелки).
+     * Четырехугольник - изопараметрический билинейный, интегрирование Гаусса 2 x 2; треугольник - CST, точная формула
+     * @param x Абсциссы узлов
+     * @param y Ординаты узлов
+     * @param D Матрица упругости
+     * @param thickness Толщина пластины
+     */
+    template <std::size_t NodesPerElement>
+    [[nodiscard]] constexpr ElementMatrix<NodesPerElement> element_stiffness(
+                                                    const std::array<double, NodesPerElement>& x,
+                                                    const std::array<double, NodesPerElement>& y,
+                                                    const ElasticityMatrix& D,
+                                                    double thickness
+                                                    ) noexcept {
+        static_assert(NodesPerElement == 3 || NodesPerElement == 4, "поддерживаются треугольники и четырехугольники");
+        ElementMatrix<NodesPerElement> stiffness{};
+        if constexpr (NodesPerElement == 3) {
+            const double double_area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            const std::array<double, 3> dN_dx{(y[1] - y[2]) / double_area, (y[2] - y[0]) / double_area, (y[0] - y[1]) / double_area};
+            const std::array<double, 3> dN_dy{(x[2] - x[1]) / double_area, (x[0] - x[2]) / double_area, (x[1] - x[0]) / double_area};
+            add_btdb<3>(stiffness, dN_dx, dN_dy, D, thickness * double_area / 2.0);
+        } else {
+            constexpr double g = 0.57735026918962576451; // 1 / sqrt(3)
+            constexpr std::array<double, 4> xi_nodes{-1.0, 1.0, 1.0, -1.0};
+            constexpr std::array<double, 4> eta_nodes{-1.0, -1.0, 1.0, 1.0};
+            for (std::size_t q = 0; q < 4; q++) {
+                const double xi = g * xi_nodes[q], eta = g * eta_nodes[q];
+                std::array<double, 4> dN_dxi{}, dN_deta{};
+                for (std::size_t a = 0; a < 4; a++) {
+                    dN_dxi[a] = 0.25 * xi_nodes[a] * (1.0 + eta_nodes[a] * eta);
+                    dN_deta[a] = 0.25 * eta_nodes[a] * (1.0 + xi_nodes[a] * xi);
+                }
+                double j11 = 0.0, j12 = 0.0, j21 = 0.0, j22 = 0.0;
+                for (std::size_t a = 0; a < 4; a++) {
+                    j11 += dN_dxi[a] * x[a];  j12 += dN_dxi[a] * y[a];
+                    j21 += dN_deta[a] * x[a]; j22 += dN_deta[a] * y[a];
+                }
+                const double det_j = j11 * j22 - j12 * j21;
+                std::array<double, 4> dN_dx{}, dN_dy{};
+                for (std::size_t a = 0; a < 4; a++) {
+                    dN_dx[a] = ( j22 * dN_dxi[a] - j12 * dN_deta[a]) / det_j;
+                    dN_dy[a] = (-j21 * dN_dxi[a] + j11 * dN_deta[a]) / det_j;
+                }
+                add_btdb<4>(stiffness, dN_dx, dN_dy, D, thickness * det_j);
+            }
+        }
+        //Нижний блочный треугольник - по симметрии
+        for (std::size_t a = 0; a < NodesPerElement; a++)
+            for (std::size_t b = a + 1; b < NodesPerElement; b++)
+                for (std::size_t c = 0; c < dofs_per_node; c++)
+                    for (std::size_t d = 0; d < dofs_per_node; d++)
+                        stiffness[dofs_per_node * b + c][dofs_per_node * a + d] = stiffness[dofs_per_node * a + d][dofs_per_node * b + c];
+        return stiffness;
+    }
+
+    ///Напряжения плоского напряженного состояния
+    struct Stress {
+        double sigma_xx_ = 0.0;
+        double sigma_yy_ = 0.0;
+        double sigma_xy_ = 0.0;
+    };
+
+    ///Евклидова норма разности тензоров напряжений (касательная компонента входит дважды, как в тензоре)
+    [[nodiscard]] inline double stress_distance(const Stress& a, const Stress& b) noexcept {
+        const double dxx = a.sigma_xx_ - b.sigma_xx_, dyy = a.sigma_yy_ - b.sigma_yy_, dxy = a.sigma_xy_ - b.sigma_xy_;
+        return std::sqrt(dxx * dxx + dyy * dyy + 2.0 * dxy * dxy);
+    }
+
+    /**
+     * Напряжения в центре билинейного четырехугольника (xi = eta = 0) - точке сверхсходимости напряжений
+     * @param x Абсциссы узлов (против часовой стрелки)
+     * @param y Ординаты узлов
+     * @param ux Перемещения u_x узлов
+     * @param uy Перемещения u_y узлов
+     * @param D Матрица упругости
+     */
+    [[nodiscard]] constexpr Stress quad_center_stress(
+                                    const std::array<double, 4>& x,
+                                    const std::array<double, 4>& y,
+                                    const std::array<double, 4>& ux,
+                                    const std::array<double, 4>& uy,
+                                    const ElasticityMatrix& D
+                                    ) noexcept {
+        constexpr std::array<double, 4> xi_nodes{-1.0, 1.0, 1.0, -1.0};
+        constexpr std::array<double, 4> eta_nodes{-1.0, -1.0, 1.0, 1.0};
+        double j11 = 0.0, j12 = 0.0, j21 = 0.0, j22 = 0.0;
+        for (std::size_t a = 0; a < 4; a++) {
+            j11 += 0.25 * xi_nodes[a] * x[a];  j12 += 0.25 * xi_nodes[a] * y[a];
+            j21 += 0.25 * eta_nodes[a] * x[a]; j22 += 0.25 * eta_nodes[a] * y[a];
+        }
+        const double det_j = j11 * j22 - j12 * j21;
+        double eps_xx = 0.0, eps_yy = 0.0, gamma_xy = 0.0;
+        for (std::size_t a = 0; a < 4; a++) {
+            const double dN_dx = ( j22 * 0.25 * xi_nodes[a] - j12 * 0.25 * eta_nodes[a]) / det_j;
+            const double dN_dy = (-j21 * 0.25 * xi_nodes[a] + j11 * 0.25 * eta_nodes[a]) / det_j;
+            eps_xx += dN_dx * ux[a];
+            eps_yy += dN_dy * uy[a];
+            gamma_xy += dN_dy * ux[a] + dN_dx * uy[a];
+        }
+        return Stress{D[0][0] * eps_xx + D[0][1] * eps_yy, D[1][0] * eps_xx + D[1][1] * eps_yy, D[2][2] * gamma_xy};
+    }
+
+    /**
+     * Вклад блока из BlockSize четырехугольников в K * u без сборки матриц элементов: в каждой точке Гаусса
+     * eps = B u_e, sigma = D eps, f_e += t * det J * B^T sigma. Элементы блока - независимые дорожки SIMD:
+     * циклы по дорожкам имеют длину BlockSize и векторизуются (как ядра kernels::)
+     * @tparam BlockSize Количество элементов в блоке
+     * @param x Абсциссы узлов: x[a][l] - узел a элемента l (узлы против часовой стрелки)
+     * @param y Ординаты узлов
+     * @param ux Перемещения u_x узлов
+     * @param uy Перемещения u_y узлов
+     * @param fx Узловые силы по x (к ним добавляется вклад)
+     * @param fy Узловые силы по y
+     * @param D Матрица упругости
+     * @param thickness
+     */
+    template <std::size_t BlockSize>
+    void quad_apply_block(
+                    const double (&x)[4][BlockSize],
+                    const double (&y)[4][BlockSize],
+                    const double (&ux)[4][BlockSize],
+                    const double (&uy)[4][BlockSize],
+                    double (&fx)[4][BlockSize],
+                    double (&fy)[4][BlockSize],
+                    const ElasticityMatrix& D,
+                    double thickness
+                    ) noexcept {
+        constexpr double g = 0.57735026918962576451; // 1 / sqrt(3)
+        constexpr double xi_nodes[4] = {-1.0, 1.0, 1.0, -1.0};
+        constexpr double eta_nodes[4] = {-1.0, -1.0, 1.0, 1.0};
+        const double d00 = D[0][0], d01 = D[0][1], d11 = D[1][1], d22 = D[2][2];
+
+        for (std::size_t q = 0; q < 4; q++) {
+            const double xi = g * xi_nodes[q], eta = g * eta_nodes[q];
+            double dN_dxi[4], dN_deta[4];
+            for (std::size_t a = 0; a < 4; a++) {
+                dN_dxi[a] = 0.25 * xi_nodes[a] * (1.0 + eta_nodes[a] * eta);
+                dN_deta[a] = 0.25 * eta_nodes[a] * (1.0 + xi_nodes[a] * xi);
+            }
+            //Каждый шаг - отдельный цикл по дорожкам блока над массивами [BlockSize]
+            double j11[BlockSize], j12[BlockSize], j21[BlockSize], j22[BlockSize];
+            for (std::size_t l = 0; l < BlockSize; l++) {
+                j11[l] = dN_dxi[0] * x[0][l] + dN_dxi[1] * x[1][l] + dN_dxi[2] * x[2][l] + dN_dxi[3] * x[3][l];
+                j12[l] = dN_dxi[0] * y[0][l] + dN_dxi[1] * y[1][l] + dN_dxi[2] * y[2][l] + dN_dxi[3] * y[3][l];
+                j21[l] = dN_deta[0] * x[0][l] + dN_deta[1] * x[1][l] + dN_deta[2] * x[2][l] + dN_deta[3] * x[3][l];
+                j22[l] = dN_deta[0] * y[0][l] + dN_deta[1] * y[1][l] + dN_deta[2] * y[2][l] + dN_deta[3] * y[3][l];
+            }
+            //Производные без деления на det J (G = det J * B): t * det J * B^T D B u = t / det J * G^T D G u
+            double sigma_xx[BlockSize], sigma_yy[BlockSize], sigma_xy[BlockSize];
+            for (std::size_t l = 0; l < BlockSize; l++) {
+                double eps_xx = 0.0, eps_yy = 0.0, gamma_xy = 0.0;
+                for (std::size_t a = 0; a < 4; a++) {
+                    const double dN_dx =  j22[l] * dN_dxi[a] - j12[l] * dN_deta[a];
+                    const double dN_dy = -j21[l] * dN_dxi[a] + j11[l] * dN_deta[a];
+                    eps_xx += dN_dx * ux[a][l];
+                    eps_yy += dN_dy * uy[a][l];
+                    gamma_xy += dN_dy * ux[a][l] + dN_dx * uy[a][l];
+                }
+                const double weight = thickness / (j11[l] * j22[l] - j12[l] * j21[l]);
+                sigma_xx[l] = weight * (d00 * eps_xx + d01 * eps_yy);
+                sigma_yy[l] = weight * (d01 * eps_xx + d11 * eps_yy);
+                sigma_xy[l] = weight * d22 * gamma_xy;
+            }
+            for (std::size_t a = 0; a < 4; a++) {
+                for (std::size_t l = 0; l < BlockSize; l++) {
+                    const double dN_dx =  j22[l] * dN_dxi[a] - j12[l] * dN_deta[a];
+                    const double dN_dy = -j21[l] * dN_dxi[a] + j11[l] * dN_deta[a];
+                    fx[a][l] += dN_dx * sigma_xx[l] + dN_dy * sigma_xy[l];
+                    fy[a][l] += dN_dy * sigma_yy[l] + dN_dx * sigma_xy[l];
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "core/custom_concepts.hpp"
+#include "core/fem/elasticity.hpp"
+#include "core/fem/kirsch.hpp"
+#include "core/topology/topology.hpp"
+
+namespace fem {
+
+    /**
+     * Напряжения в центрах ячеек сетки лучей. Ячейка (k, j) имеет номер k * (count_points_on_ray - 1) + j
+     * @param mesh Узлы сетки
+     * @param layout Раскладка узлов
+     * @param displacement Перемещения (dofs_per_node на узел)
+     * @param material
+     */
+    template <coordinate_source_like ContainerT>
+    [[nodiscard]] std::vector<Stress> cell_stresses(const ContainerT& mesh, const topology::RayLayout& layout, const double* displacement, const Material& material) {
+        const ElasticityMatrix D = plane_stress(material);
+        const std::size_t cells_on_ray = layout.count_points_on_ray_ - 1;
+        std::vector<Stress> stresses(layout.count_cells());
+        for (std::size_t k = 0; k + 1 < layout.count_rays_; k++) {
+            for (std::size_t j = 0; j < cells_on_ray; j++) {
+                const auto nodes = layout.cell(k, j);
+                std::array<double, 4> x{}, y{}, ux{}, uy{};
+                for (std::size_t a = 0; a < 4; a++) {
+                    x[a] = static_cast<double>(mesh(nodes[a], 0));
+                    y[a] = static_cast<double>(mesh(nodes[a], 1));
+                    ux[a] = displacement[dofs_per_node * nodes[a]];
+                    uy[a] = displacement[dofs_per_node * nodes[a] + 1];
+                }
+                stresses[k * cells_on_ray + j] = quad_center_stress(x, y, ux, uy, D);
+            }
+        }
+        return stresses;
+    }
+
+    ///Масштаб для относительных ошибок: наибольшая по модулю компонента поля на бесконечности
+    [[nodiscard]] inline double stress_scale(const FarFieldStress& far_field) noexcept {
+        return std::max(std::abs(far_field.sigma_xx_), std::abs(far_field.sigma_yy_));
+    }
+
+    /**
+     * Ошибка каждой ячейки относительно аналитического решения Кирша в ее центре, в долях stress_scale(far_field)
+     * @param stresses Результат cell_stresses
+     */
+    template <coordinate_source_like ContainerT>
+    [[nodiscard]] std::vector<double> analytic_cell_errors(
+                                        const ContainerT& mesh,
+                                        const topology::RayLayout& layout,
+                                        const std::vector<Stress>& stresses,
+                                        const FarFieldStress& far_field,
+                                        double radius_hole
+                                        ) {
+        const std::size_t cells_on_ray = layout.count_points_on_ray_ - 1;
+        const double scale = stress_scale(far_field);
+        std::vector<double> errors(stresses.size());
+        for (std::size_t k = 0; k + 1 < layout.count_rays_; k++) {
+            for (std::size_t j = 0; j < cells_on_ray; j++) {
+                const auto nodes = layout.cell(k, j);
+                double center_x = 0.0, center_y = 0.0;
+                for (const std::size_t node : nodes) {
+                    center_x += 0.25 * static_cast<double>(mesh(node, 0));
+                    center_y += 0.25 * static_cast<double>(mesh(node, 1));
+                }
+                const std::size_t cell = k * cells_on_ray + j;
+                errors[cell] = stress_distance(stresses[cell], kirsch_stress(far_field, radius_hole, center_x, center_y)) / scale;
+            }
+        }
+        return errors;
+    }
+
+    /**
+     * Оценка восстановлением (Зенкевич - Чжу): напряжения в узле - среднее по соседним ячейкам,
+     * ошибка ячейки - среднеквадратичное отличие восстановленных напряжений ее узлов от напряжений в центре, в долях scale.
+     * Не требует точного решения
+     */
+    [[nodiscard]] inline std::vector<double> recovery_cell_errors(const topology::RayLayout& layout, const std::vector<Stress>& stresses, double scale) {
+        const std::size_t cells_on_ray = layout.count_points_on_ray_ - 1;
+        std::vector<Stress> nodal(layout.count_nodes());
+        std::vector<double> count_cells(layout.count_nodes(), 0.0);
+        for (std::size_t k = 0; k + 1 < layout.count_rays_; k++) {
+            for (std::size_t j = 0; j < cells_on_ray; j++) {
+                const Stress& cell = stresses[k * cells_on_ray + j];
+                for (const std::size_t node : layout.cell(k, j)) {
+                    nodal[node].sigma_xx_ += cell.sigma_xx_;
+                    nodal[node].sigma_yy_ += cell.sigma_yy_;
+                    nodal[node].sigma_xy_ += cell.sigma_xy_;
+                    count_cells[node] += 1.0;
+                }
+            }
+        }
+        for (std::size_t node = 0; node < nodal.size(); node++) {
+            nodal[node].sigma_xx_ /= count_cells[node];
+            nodal[node].sigma_yy_ /= count_cells[node];
+            nodal[node].sigma_xy_ /= count_cells[node];
+        }
+
+        std::vector<double> errors(stresses.size());
+        for (std::size_t k = 0; k + 1 < layout.count_rays_; k++) {
+            for (std::size_t j = 0; j < cells_on_ray; j++) {
+                const std::size_t cell = k * cells_on_ray + j;
+                double sum = 0.0;
+                for (const std::size_t node : layout.cell(k, j)) {
+                    const double distance = stress_distance(nodal[node], stresses[cell]);
+                    sum += distance * distance;
+                }
+                errors[cell] = std::sqrt(0.25 * sum) / scale;
+            }
+        }
+        return errors;
+    }
+
+    ///Ошибка полосы ячеек между соседними лучами
+    struct RayIntervalError {
+        double error_ = 0.0;         // Наибольшая ошибка ячейки полосы
+        std::size_t worst_point_ = 0; // Номер точки на луче (от отверстия) у ячейки с наибольшей ошибкой
+    };
+
+    ///Свертка ошибок ячеек по полосам между лучами k и k + 1 (count_rays - 1 полос)
+    [[nodiscard]] inline std::vector<RayIntervalError> ray_interval_errors(const topology::RayLayout& layout, const std::vector<double>& cell_errors) {
+        const std::size_t cells_on_ray = layout.count_points_on_ray_ - 1;
+        std::vector<RayIntervalError> intervals(layout.count_rays_ - 1);
+        for (std::size_t k = 0; k < intervals.size(); k++) {
+            for (std::size_t j = 0; j < cells_on_ray; j++) {
+                const double error = cell_errors[k * cells_on_ray + j];
+                if (error > intervals[k].error_)
+                    intervals[k] = RayIntervalError{error, j};
+            }
+        }
+        return intervals;
+    }
+
+}
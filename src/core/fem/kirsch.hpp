@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <mkl_types.h>
+#include "core/custom_concepts.hpp"
+#include "core/fem/elasticity.hpp"
+#include "core/topology/topology.hpp"
+
+namespace fem {
+
+    ///Однородное поле напряжений на бесконечности (случай нагружения задачи Кирша)
+    struct FarFieldStress {
+        double sigma_xx_;
+        double sigma_yy_;
+    };
+
+    /**
+     * Аналитическое решение Кирша: напряжения в точке (x, y) бесконечной пластины с отверстием радиуса radius_hole
+     * под полем far_field (сумма одноосных решений). На краю отверстия при одноосном растяжении sigma - 3 * sigma на оси,
+     * перпендикулярной нагрузке. Для конечной пластины со стороной L поправка порядка (radius_hole / L)^2
+     */
+    [[nodiscard]] inline Stress kirsch_stress(const FarFieldStress& far_field, double radius_hole, double x, double y) noexcept {
+        const double r2 = x * x + y * y;
+        const double a2 = radius_hole * radius_hole / r2; // (a / r)^2
+        const double a4 = a2 * a2;
+        const double mean = 0.5 * (far_field.sigma_xx_ + far_field.sigma_yy_);
+        const double deviator = 0.5 * (far_field.sigma_xx_ - far_field.sigma_yy_);
+        //cos 2t, sin 2t без тригонометрии
+        const double cos_2t = (x * x - y * y) / r2;
+        const double sin_2t = 2.0 * x * y / r2;
+        const double sigma_rr = mean * (1.0 - a2) + deviator * (1.0 - 4.0 * a2 + 3.0 * a4) * cos_2t;
+        const double sigma_tt = mean * (1.0 + a2) - deviator * (1.0 + 3.0 * a4) * cos_2t;
+        const double sigma_rt = -deviator * (1.0 + 2.0 * a2 - 3.0 * a4) * sin_2t;
+        //Поворот из полярных осей: cos^2 t = (1 + cos 2t) / 2, sin^2 t = (1 - cos 2t) / 2, sin t cos t = sin 2t / 2
+        const double half_sum = 0.5 * (sigma_rr + sigma_tt), half_difference = 0.5 * (sigma_rr - sigma_tt);
+        return Stress{
+            half_sum + half_difference * cos_2t - sigma_rt * sin_2t,
+            half_sum - half_difference * cos_2t + sigma_rt * sin_2t,
+            half_difference * sin_2t + sigma_rt * cos_2t
+        };
+    }
+
+    /**
+     * Условия симметрии четверти пластины: луч 0 лежит на оси x (u_y = 0), последний луч - на оси y (u_x = 0)
+     * @param layout Раскладка узлов сетки GenFrameKirsch
+     */
+    [[nodiscard]] inline std::vector<MKL_INT> kirsch_symmetry_dofs(const topology::RayLayout& layout) {
+        std::vector<MKL_INT> dofs;
+        dofs.reserve(2 * layout.count_points_on_ray_);
+        for (std::size_t j = 0; j < layout.count_points_on_ray_; j++)
+            dofs.push_back(static_cast<MKL_INT>(dofs_per_node * layout.node(0, j) + 1));
+        for (std::size_t j = 0; j < layout.count_points_on_ray_; j++)
+            dofs.push_back(static_cast<MKL_INT>(dofs_per_node * layout.node(layout.count_rays_ - 1, j)));
+        return dofs;
+    }
+
+    /**
+     * Узловые силы от поля far_field на внешней границе (последние точки лучей). Граница обходится против часовой стрелки,
+     * на отрезке длины L с внешней нормалью n действует сила sigma * n * L * thickness, которая делится поровну между концами
+     * @param mesh Узлы сетки
+     * @param layout Раскладка узлов
+     * @param far_field
+     * @param thickness
+     * @param rhs Вектор длины dofs_per_node * count_nodes, силы добавляются к нему
+     */
+    template <coordinate_source_like ContainerT>
+    void add_far_field_load(const ContainerT& mesh, const topology::RayLayout& layout, const FarFieldStress& far_field, double thickness, double* rhs) noexcept {
+        const std::size_t last_point = layout.count_points_on_ray_ - 1;
+        for (std::size_t k = 0; k + 1 < layout.count_rays_; k++) {
+            const std::size_t begin = layout.node(k, last_point);
+            const std::size_t end = layout.node(k + 1, last_point);
+            const double dx = static_cast<double>(mesh(end, 0)) - static_cast<double>(mesh(begin, 0));
+            const double dy = static_cast<double>(mesh(end, 1)) - static_cast<double>(mesh(begin, 1));
+            //n * L = (dy, -dx) при обходе против часовой стрелки
+            const double half_force_x = 0.5 * thickness * far_field.sigma_xx_ * dy;
+            const double half_force_y = -0.5 * thickness * far_field.sigma_yy_ * dx;
+            rhs[dofs_per_node * begin]     += half_force_x;
+            rhs[dofs_per_node * begin + 1] += half_force_y;
+            rhs[dofs_per_node * end]       += half_force_x;
+            rhs[dofs_per_node * end + 1]   += half_force_y;
+        }
+    }
+
+}
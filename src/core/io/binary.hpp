@@ -0,0 +1,237 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/io/fields.hpp"
+#include "core/io/file.hpp"
+
+namespace io {
+
+    inline constexpr char binary_magic[8] = {'F', 'E', 'M', 'M', 'E', 'S', 'H', '\0'};
+    ///Версия формата: меняется при любом изменении раскладки, файлы другой версии не читаются
+    inline constexpr std::uint32_t binary_version = 2;
+    ///Разделы файла выровнены по странице: отображенный файл можно использовать как хранилище без копирования
+    inline constexpr std::size_t binary_alignment = 4096;
+    inline constexpr std::size_t binary_field_name_size = 48;
+
+    /**
+     * Заголовок двоичного файла сетки (little endian, в начале файла). За ним - таблица полей, затем разделы:
+     * узлы (count_nodes_ x 2 значений scalar_size_ байт, x и y подряд), ячейки (count_cells_ x nodes_per_cell_ uint64),
+     * поля (double), метаданные записавшего (metadata_size_ байт). Каждый раздел начинается с кратного binary_alignment смещения
+     */
+    struct BinaryHeader {
+        char magic_[8];
+        std::uint32_t version_;
+        std::uint32_t scalar_size_;
+        std::uint64_t count_nodes_;
+        std::uint64_t nodes_offset_;
+        std::uint64_t count_cells_;
+        std::uint64_t nodes_per_cell_;
+        std::uint64_t cells_offset_;
+        std::uint64_t count_point_fields_;
+        std::uint64_t count_cell_fields_;
+        std::uint64_t metadata_offset_;
+        std::uint64_t metadata_size_;
+        std::uint64_t tag_;         // Произвольная метка записавшего (например, хэш параметров генерации)
+        std::uint64_t file_size_;
+    };
+
+    ///Запись таблицы полей: сначала поля в узлах, затем в ячейках
+    struct BinaryFieldRecord {
+        char name_[binary_field_name_size];
+        std::uint64_t count_components_;
+        std::uint64_t offset_;
+    };
+
+    static_assert(sizeof(BinaryHeader) == 104 && sizeof(BinaryFieldRecord) == 64, "раскладка заголовка - часть формата");
+
+    ///Заголовок и таблица полей файла; смещения разделов уже вычислены
+    struct BinaryLayout {
+        BinaryHeader header_{};
+        std::vector<BinaryFieldRecord> fields_;
+    };
+
+    /**
+     * Раскладка двоичного файла сетки
+     * @param scalar_size Размер координаты в байтах (4 или 8)
+     * @param count_nodes
+     * @param nodes_per_cell 0, если ячеек нет
+     * @param count_cells
+     * @param point_fields
+     * @param cell_fields
+     * @param tag Метка, сохраняемая в заголовке
+     * @param metadata_size Размер раздела метаданных в байтах
+     */
+    [[nodiscard]] inline BinaryLayout binary_layout(
+                        std::size_t scalar_size,
+                        std::size_t count_nodes,
+                        std::size_t nodes_per_cell,
+                        std::size_t count_cells,
+                        const std::vector<FieldView>& point_fields,
+                        const std::vector<FieldView>& cell_fields,
+                        std::uint64_t tag = 0,
+                        std::size_t metadata_size = 0
+                        ) {
+        BinaryLayout layout;
+        BinaryHeader& header = layout.header_;
+        std::memcpy(header.magic_, binary_magic, sizeof(binary_magic));
+        header.version_ = binary_version;
+        header.scalar_size_ = static_cast<std::uint32_t>(scalar_size);
+        header.count_nodes_ = count_nodes;
+        header.count_cells_ = count_cells;
+        header.nodes_per_cell_ = nodes_per_cell;
+        header.count_point_fields_ = point_fields.size();
+        header.count_cell_fields_ = cell_fields.size();
+        header.tag_ = tag;
+
+        std::size_t offset = sizeof(BinaryHeader) + (point_fields.size() + cell_fields.size()) * sizeof(BinaryFieldRecord);
+        auto add_section = [&offset](std::size_t bytes) {
+            const std::size_t begin = align_up(offset, binary_alignment);
+            offset = begin + bytes;
+            return begin;
+        };
+        header.nodes_offset_ = add_section(count_nodes * 2 * scalar_size);
+        header.cells_offset_ = add_section(count_cells * nodes_per_cell * sizeof(std::uint64_t));
+        auto add_fields = [&](const std::vector<FieldView>& fields, std::size_t count_values) {
+            for (const auto& field : fields) {
+                BinaryFieldRecord record{};
+                field.name_.copy(record.name_, binary_field_name_size - 1);
+                record.count_components_ = field.count_components_;
+                record.offset_ = add_section(count_values * field.count_components_ * sizeof(double));
+                layout.fields_.push_back(record);
+            }
+        };
+        add_fields(point_fields, count_nodes);
+        add_fields(cell_fields, count_cells);
+        header.metadata_size_ = metadata_size;
+        header.metadata_offset_ = add_section(metadata_size);
+        header.file_size_ = offset;
+        return layout;
+    }
+
+    /**
+     * Раздел offset + count * width * element_bytes байт помещается в limit. Все произведения и суммы проверяются
+     * на переполнение: у испорченного файла они могут обернуться в малое число и пройти сравнение с длиной
+     */
+    [[nodiscard]] inline bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t width, std::uint64_t element_bytes,
+                                           std::uint64_t limit) noexcept {
+        std::uint64_t count_values, bytes, end;
+        return !__builtin_mul_overflow(count, width, &count_values)
+            && !__builtin_mul_overflow(count_values, element_bytes, &bytes)
+            && !__builtin_add_overflow(offset, bytes, &end)
+            && end <= limit;
+    }
+
+    /**
+     * Раздел начинается с кратного binary_alignment смещения (так пишет writers::BinaryWriter). Иначе указатели
+     * на double и uint64_t в отображении были бы невыровненными
+     */
+    [[nodiscard]] constexpr bool section_aligned(std::uint64_t offset) noexcept {
+        return offset % binary_alignment == 0;
+    }
+
+    ///Проверка заголовка: сигнатура, версия, выравнивание разделов и согласованность размеров с длиной файла
+    [[nodiscard]] inline bool valid_header(const BinaryHeader& header, std::size_t file_size) noexcept {
+        if (std::memcmp(header.magic_, binary_magic, sizeof(binary_magic)) != 0 || header.version_ != binary_version)
+            return false;
+        if (header.scalar_size_ != sizeof(float) && header.scalar_size_ != sizeof(double))
+            return false;
+        if (header.file_size_ != file_size)
+            return false;
+        if (!section_aligned(header.nodes_offset_) || !section_aligned(header.cells_offset_) || !section_aligned(header.metadata_offset_))
+            return false;
+        std::uint64_t count_fields;
+        return section_fits(header.nodes_offset_, header.count_nodes_, 2, header.scalar_size_, file_size)
+            && section_fits(header.cells_offset_, header.count_cells_, header.nodes_per_cell_, sizeof(std::uint64_t), file_size)
+            && section_fits(header.metadata_offset_, header.metadata_size_, 1, 1, file_size)
+            && !__builtin_add_overflow(header.count_point_fields_, header.count_cell_fields_, &count_fields)
+            && section_fits(sizeof(BinaryHeader), count_fields, 1, sizeof(BinaryFieldRecord), file_size);
+    }
+
+    /**
+     * Двоичный файл сетки, отображенный в память только на чтение. Разделы используются на месте, без копирования
+     */
+    class MappedBinaryMesh {
+    public:
+        /**
+         * Открытие и проверка файла
+         * @param path
+         * @param mode ReadOnly или CopyOnWrite (разделы можно менять, файл остается прежним)
+         * @return 0, errno или EINVAL для файла чужого формата, другой версии, обрезанного или с невыровненными разделами
+         */
+        [[nodiscard]] int open(const std::string& path, MapMode mode = MapMode::ReadOnly) {
+            file_.reset();
+            FileDescriptor fd = open_file(path);
+            if (!fd)
+                return errno;
+            std::size_t size = 0;
+            if (int error = file_size(fd.get(), size); error != 0)
+                return error;
+            if (size < sizeof(BinaryHeader))
+                return EINVAL;
+            MappedFile file;
+            if (int error = file.map(fd.get(), size, mode); error != 0)
+                return error;
+            const auto& header = *reinterpret_cast<const BinaryHeader*>(file.data());
+            if (!valid_header(header, size)) // Проверяет и то, что таблица полей помещается в файл
+                return EINVAL;
+            const std::size_t count_fields = header.count_point_fields_ + header.count_cell_fields_;
+            file_ = std::move(file);
+            for (std::size_t f = 0; f < count_fields; f++) {
+                const auto& record = fields()[f];
+                const std::size_t count_values = f < header.count_point_fields_ ? header.count_nodes_ : header.count_cells_;
+                if (!section_aligned(record.offset_) || !section_fits(record.offset_, count_values, record.count_components_, sizeof(double), size)) {
+                    file_.reset();
+                    return EINVAL;
+                }
+            }
+            return 0;
+        }
+
+        [[nodiscard]] const BinaryHeader& header() const noexcept { return *reinterpret_cast<const BinaryHeader*>(file_.data()); }
+
+        ///Координаты узлов: x и y подряд, тип - float или double по header().scalar_size_
+        [[nodiscard]] const void* nodes() const noexcept { return file_.data() + header().nodes_offset_; }
+
+        ///То же для записи: только при открытии с MapMode::CopyOnWrite
+        [[nodiscard]] void* writable_nodes() const noexcept { return file_.data() + header().nodes_offset_; }
+
+        [[nodiscard]] const std::uint64_t* cells() const noexcept {
+            return reinterpret_cast<const std::uint64_t*>(file_.data() + header().cells_offset_);
+        }
+
+        [[nodiscard]] const BinaryFieldRecord* fields() const noexcept {
+            return reinterpret_cast<const BinaryFieldRecord*>(file_.data() + sizeof(BinaryHeader));
+        }
+
+        ///Поле по имени (сначала ищется среди полей в узлах) или nullptr
+        [[nodiscard]] const BinaryFieldRecord* field(std::string_view name) const noexcept {
+            const std::size_t count_fields = header().count_point_fields_ + header().count_cell_fields_;
+            const auto* end = fields() + count_fields;
+            const auto* found = std::find_if(fields(), end, [name](const BinaryFieldRecord& record) {
+                return name == std::string_view(record.name_, strnlen(record.name_, binary_field_name_size));
+            });
+            return found == end ? nullptr : found;
+        }
+
+        [[nodiscard]] const double* field_data(const BinaryFieldRecord& record) const noexcept {
+            return reinterpret_cast<const double*>(file_.data() + record.offset_);
+        }
+
+        ///Метаданные записавшего (пусто, если их нет)
+        [[nodiscard]] std::string_view metadata() const noexcept {
+            return {file_.data() + header().metadata_offset_, header().metadata_size_};
+        }
+
+        [[nodiscard]] explicit operator bool() const noexcept { return static_cast<bool>(file_); }
+
+    private:
+        MappedFile file_;
+    };
+
+}
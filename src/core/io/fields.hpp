@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace io {
+
+    ///Поле в узлах или ячейках без копирования: count_components_ значений на узел (ячейку) подряд
+    struct FieldView {
+        std::string name_;
+        const double* data_;
+        std::size_t count_components_ = 1;
+    };
+
+}
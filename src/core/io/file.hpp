@@ -0,0 +1,176 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace io {
+
+    ///Выравнивание value вверх до кратного alignment
+    [[nodiscard]] constexpr std::size_t align_up(std::size_t value, std::size_t alignment) noexcept {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    ///Владеющая обертка над файловым дескриптором: close в деструкторе, только перемещение
+    class FileDescriptor {
+    public:
+        FileDescriptor() = default;
+        explicit FileDescriptor(int fd) noexcept : fd_(fd) {}
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+        FileDescriptor(FileDescriptor&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+        FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+            if (this != &other) {
+                reset();
+                fd_ = std::exchange(other.fd_, -1);
+            }
+            return *this;
+        }
+        ~FileDescriptor() { reset(); }
+
+        void reset() noexcept {
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+        }
+        [[nodiscard]] int get() const noexcept { return fd_; }
+        [[nodiscard]] explicit operator bool() const noexcept { return fd_ >= 0; }
+
+    private:
+        int fd_ = -1;
+    };
+
+    ///Создание (с усечением) файла на запись и чтение; при ошибке - пустой дескриптор, причина в errno
+    [[nodiscard]] inline FileDescriptor create_file(const std::string& path) noexcept {
+        return FileDescriptor(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    }
+
+    ///Открытие существующего файла на чтение; при ошибке - пустой дескриптор, причина в errno
+    [[nodiscard]] inline FileDescriptor open_file(const std::string& path) noexcept {
+        return FileDescriptor(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    }
+
+    /**
+     * Запись size байт по смещению offset без сдвига позиции файла (безопасно из нескольких потоков).
+     * Короткие записи и EINTR повторяются
+     * @return 0 или errno
+     */
+    [[nodiscard]] inline int pwrite_all(int fd, const void* data, std::size_t size, std::size_t offset) noexcept {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                return errno;
+            }
+            bytes += written;
+            offset += static_cast<std::size_t>(written);
+            size -= static_cast<std::size_t>(written);
+        }
+        return 0;
+    }
+
+    enum class MapMode {
+        ReadOnly,
+        Shared,         // Запись через отображение попадает в файл
+        CopyOnWrite     // Запись видна только процессу, файл не меняется (файл открыт на чтение)
+    };
+
+    ///Владеющее отображение файла в память: munmap в деструкторе, только перемещение
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept
+                : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                reset();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+        ~MappedFile() { reset(); }
+
+        /**
+         * Отображение первых size байт файла
+         * @return 0 или errno
+         */
+        [[nodiscard]] int map(int fd, std::size_t size, MapMode mode) noexcept {
+            reset();
+            if (size == 0)
+                return 0;
+            const int protection = mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+            const int flags = mode == MapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+            void* address = ::mmap(nullptr, size, protection, flags, fd, 0);
+            if (address == MAP_FAILED)
+                return errno;
+            data_ = static_cast<char*>(address);
+            size_ = size;
+            return 0;
+        }
+
+        void reset() noexcept {
+            if (data_ != nullptr)
+                ::munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+        [[nodiscard]] char* data() const noexcept { return data_; }
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+        [[nodiscard]] explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    private:
+        char* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    ///Размер файла по дескриптору: 0 или errno
+    [[nodiscard]] inline int file_size(int fd, std::size_t& size) noexcept {
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+            return errno;
+        size = static_cast<std::size_t>(info.st_size);
+        return 0;
+    }
+
+    ///Установка размера файла (дыры читаются нулями)
+    [[nodiscard]] inline int resize_file(int fd, std::size_t size) noexcept {
+        return ::ftruncate(fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+    }
+
+    /**
+     * Выделение блоков под первые size байт файла (файл растет до size). В отличие от resize_file дыр не остается:
+     * нехватка места обнаруживается здесь, а не сигналом SIGBUS при записи через отображение
+     * @return 0 или код ошибки (ENOSPC, EDQUOT, ...)
+     */
+    [[nodiscard]] inline int allocate_file(int fd, std::size_t size) noexcept {
+        if (size == 0)
+            return 0;
+        int error;
+        while ((error = ::posix_fallocate(fd, 0, static_cast<off_t>(size))) == EINTR) {}
+        return error;
+    }
+
+    /**
+     * Сброс файла или каталога на диск (fsync). Для каталога фиксирует сделанные в нем rename и создание файлов
+     * @return 0 или errno
+     */
+    [[nodiscard]] inline int sync_path(const std::string& path) noexcept {
+        const FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (!fd)
+            return errno;
+        while (::fsync(fd.get()) != 0)
+            if (errno != EINTR)
+                return errno;
+        return 0;
+    }
+
+}
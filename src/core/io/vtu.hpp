@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "core/custom_concepts.hpp"
+#include "core/io/fields.hpp"
+
+namespace io {
+
+    ///Тип ячейки VTK: VTK_QUAD = 9, VTK_TRIANGLE = 5
+    template <std::size_t NodesPerElement>
+    inline constexpr std::uint8_t vtk_cell_type = NodesPerElement == 4 ? 9 : 5;
+
+    template <scalar ScalarT>
+    inline constexpr const char* vtk_type_name = std::is_same_v<ScalarT, float> ? "Float32" : "Float64";
+
+    ///Размер заголовка блока в appended данных (header_type="UInt64")
+    inline constexpr std::size_t vtu_block_header_size = sizeof(std::uint64_t);
+
+    ///Экранирование текста для значения XML атрибута в двойных кавычках
+    [[nodiscard]] inline std::string xml_escape(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const char symbol : text) {
+            switch (symbol) {
+                case '&': escaped += "&amp;"; break;
+                case '<': escaped += "&lt;"; break;
+                case '>': escaped += "&gt;"; break;
+                case '"': escaped += "&quot;"; break;
+                case '\'': escaped += "&apos;"; break;
+                default: escaped += symbol;
+            }
+        }
+        return escaped;
+    }
+
+    ///Блок appended данных: смещение от начала файла до полезных данных (после заголовка блока) и их размер
+    struct VtuBlock {
+        std::size_t offset_;
+        std::size_t bytes_;
+    };
+
+    /**
+     * Раскладка .vtu файла: XML заголовок, блоки appended данных (UInt64 размер + данные), XML хвост.
+     * Точки в VTK трехмерные, поэтому блок точек содержит (x, y, 0); связность - Int64, как topology::ConnectivityView
+     */
+    struct VtuLayout {
+        std::string header_;
+        std::string footer_;
+        VtuBlock points_{};
+        VtuBlock connectivity_{};
+        VtuBlock offsets_{};
+        VtuBlock types_{};
+        std::vector<VtuBlock> point_fields_;
+        std::vector<VtuBlock> cell_fields_;
+        std::size_t file_size_ = 0;
+    };
+
+    /**
+     * Раскладка .vtu файла с appended raw данными
+     * @tparam ScalarT Тип координат
+     * @tparam NodesPerElement 3 или 4
+     * @param count_nodes
+     * @param count_cells
+     * @param point_fields Поля в узлах (count_nodes * count_components_ значений)
+     * @param cell_fields Поля в ячейках (count_cells * count_components_ значений)
+     */
+    template <scalar ScalarT, std::size_t NodesPerElement>
+    [[nodiscard]] VtuLayout vtu_layout(
+                        std::size_t count_nodes,
+                        std::size_t count_cells,
+                        const std::vector<FieldView>& point_fields,
+                        const std::vector<FieldView>& cell_fields
+                        ) {
+        VtuLayout layout;
+        std::size_t appended_offset = 0; // offset в атрибуте DataArray - от символа '_'
+        std::vector<std::size_t> xml_offsets;
+        auto add_block = [&](std::size_t bytes) {
+            xml_offsets.push_back(appended_offset);
+            const VtuBlock block{appended_offset + vtu_block_header_size, bytes};
+            appended_offset += vtu_block_header_size + bytes;
+            return block;
+        };
+        layout.points_ = add_block(count_nodes * 3 * sizeof(ScalarT));
+        layout.connectivity_ = add_block(count_cells * NodesPerElement * sizeof(std::int64_t));
+        layout.offsets_ = add_block(count_cells * sizeof(std::int64_t));
+        layout.types_ = add_block(count_cells * sizeof(std::uint8_t));
+        for (const auto& field : point_fields)
+            layout.point_fields_.push_back(add_block(count_nodes * field.count_components_ * sizeof(double)));
+        for (const auto& field : cell_fields)
+            layout.cell_fields_.push_back(add_block(count_cells * field.count_components_ * sizeof(double)));
+
+        auto data_array = [&](const std::string& type, const std::string& name, std::size_t components, std::size_t block_idx) {
+            std::string xml = "        <DataArray type=\"" + type + "\"";
+            if (!name.empty())
+                xml += " Name=\"" + xml_escape(name) + "\"";
+            if (components != 1)
+                xml += " NumberOfComponents=\"" + std::to_string(components) + "\"";
+            return xml + " format=\"appended\" offset=\"" + std::to_string(xml_offsets[block_idx]) + "\"/>\n";
+        };
+        std::string& xml = layout.header_;
+        xml = "<?xml version=\"1.0\"?>\n"
+              "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n"
+              "  <UnstructuredGrid>\n"
+              "    <Piece NumberOfPoints=\"" + std::to_string(count_nodes) + "\" NumberOfCells=\"" + std::to_string(count_cells) + "\">\n";
+        xml += "      <PointData>\n";
+        for (std::size_t f = 0; f < point_fields.size(); f++)
+            xml += data_array("Float64", point_fields[f].name_, point_fields[f].count_components_, 4 + f);
+        xml += "      </PointData>\n      <CellData>\n";
+        for (std::size_t f = 0; f < cell_fields.size(); f++)
+            xml += data_array("Float64", cell_fields[f].name_, cell_fields[f].count_components_, 4 + point_fields.size() + f);
+        xml += "      </CellData>\n      <Points>\n";
+        xml += data_array(vtk_type_name<ScalarT>, "", 3, 0);
+        xml += "      </Points>\n      <Cells>\n";
+        xml += data_array("Int64", "connectivity", 1, 1);
+        xml += data_array("Int64", "offsets", 1, 2);
+        xml += data_array("UInt8", "types", 1, 3);
+        xml += "      </Cells>\n"
+               "    </Piece>\n"
+               "  </UnstructuredGrid>\n"
+               "  <AppendedData encoding=\"raw\">\n"
+               "   _";
+        layout.footer_ = "\n  </AppendedData>\n</VTKFile>\n";
+
+        //Смещения блоков - от начала файла
+        const std::size_t data_start = layout.header_.size();
+        for (VtuBlock* block : {&layout.points_, &layout.connectivity_, &layout.offsets_, &layout.types_})
+            block->offset_ += data_start;
+        for (auto& block : layout.point_fields_)
+            block.offset_ += data_start;
+        for (auto& block : layout.cell_fields_)
+            block.offset_ += data_start;
+        layout.file_size_ = data_start + appended_offset + layout.footer_.size();
+        return layout;
+    }
+
+}
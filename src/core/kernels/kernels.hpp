@@ -1,13 +1,25 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
 #include "../math/math_helper.hpp"
 #include "../custom_concepts.hpp"
 #include "core/geometry/geometry.hpp"
+#include "core/storage/storage.hpp"
 
 namespace kernels {
 
+    ///Ширина блока векторных ядер: точки блока независимы, цикл по блоку компилятор разворачивает в SIMD (AVX2 - 2 вектора, AVX-512 - 1 вектор double)
+    inline constexpr std::size_t simd_block_size = 8;
+    ///Через сколько блоков степень q пересчитывается через fast_pow заново, чтобы ошибка рекуррентного умножения не накапливалась
+    inline constexpr std::size_t pow_reanchor_blocks = 16;
+
     /**
      * Функция для заполнения переданного интервала сетки равномерной сеткой на окружности
+     * Синусы и косинусы считаются блоками: для начала блока точно (std::cos, std::sin), внутри блока - поворотом
+     * на заранее посчитанные углы j * step. Ошибка не накапливается от блока к блоку
      * @tparam ContainerT
      * @tparam ScalarT
      * @param start_arc_angle_rad Угол в радианах начала дуги
@@ -15,24 +27,49 @@ namespace kernels {
      * @param radius
      * @param circle_storage
      */
-    template <kokkos_view_2d_like ContainerT, typename ScalarT>
+    template <coordinate_storage_like ContainerT, typename ScalarT>
     void fill_circle_arc_uniform(
                             ScalarT start_arc_angle_rad,
                             ScalarT end_arc_angle_rad,
                             ScalarT radius,
                             ContainerT circle_storage
                         ) noexcept {
+        using StorageScalarT = storage::scalar_t<ContainerT>;
+        constexpr std::size_t block_size = simd_block_size;
         const std::size_t grid_size = circle_storage.extent(0);
         const ScalarT step_on_circle = (end_arc_angle_rad - start_arc_angle_rad) / (grid_size - 1);
-        for (std::size_t i = 0; i < grid_size; i++) {
-            circle_storage(i, 0) = radius * std::cos(start_arc_angle_rad + i * step_on_circle);
-            circle_storage(i, 1) = radius * std::sin(start_arc_angle_rad + i * step_on_circle);
+
+        ScalarT cos_in_block[block_size], sin_in_block[block_size];
+        for (std::size_t j = 0; j < block_size; j++) {
+            cos_in_block[j] = std::cos(j * step_on_circle);
+            sin_in_block[j] = std::sin(j * step_on_circle);
+        }
+
+        ScalarT x_block[block_size], y_block[block_size];
+        for (std::size_t block_start = 0; block_start < grid_size; block_start += block_size) {
+            const ScalarT anchor_angle = start_arc_angle_rad + block_start * step_on_circle;
+            const ScalarT radius_cos = radius * std::cos(anchor_angle);
+            const ScalarT radius_sin = radius * std::sin(anchor_angle);
+            //cos(a + b) = cos a cos b - sin a sin b, sin(a + b) = sin a cos b + cos a sin b
+            //Блок считается целиком (длина известна компилятору - векторизуется без хвоста), записывается только попавшее в сетку
+            for (std::size_t j = 0; j < block_size; j++) {
+                x_block[j] = radius_cos * cos_in_block[j] - radius_sin * sin_in_block[j];
+                y_block[j] = radius_sin * cos_in_block[j] + radius_cos * sin_in_block[j];
+            }
+            const std::size_t count = std::min(block_size, grid_size - block_start);
+            for (std::size_t j = 0; j < count; j++) {
+                circle_storage(block_start + j, 0) = static_cast<StorageScalarT>(x_block[j]);
+                circle_storage(block_start + j, 1) = static_cast<StorageScalarT>(y_block[j]);
+            }
         }
     }
 
     /**
      * Функция для заполнения переданного интервала сетки неравномерной сеткой на основе геометрической прогрессии
      * (x, y) = (x_0, y_0) + (V_x, V_y) * (b-a) * t уравнение прямой, где t = (1 - q^i) / 1 - q^N
+     * Степени q считаются блоками: q^i = q^(начало блока) * q^j, где q^j - таблица на блок, а степень начала блока
+     * получается умножением на q^(размер блока) и каждые pow_reanchor_blocks блоков пересчитывается через fast_pow.
+     * Блоки выровнены по глобальному индексу точки, поэтому результат не зависит от разбиения луча на сегменты
      * @tparam ContainerT
      * @tparam ScalarT
      * @param normalized_direction_ray Вектор направления луча
@@ -43,7 +80,7 @@ namespace kernels {
      * @param idx_from_start Индекс от начала (tid * standard_segment_size), требуется в показателе степени (1 - q^i)
      * @param ray_segment_storage
      */
-    template <kokkos_view_2d_like ContainerT, typename ScalarT>
+    template <coordinate_storage_like ContainerT, typename ScalarT>
     void fill_ray_segment_nonuniform(
                 const geometry::Point2D<ScalarT> &normalized_direction_ray,
                 const geometry::Point2D<ScalarT> &start_point_grid,
@@ -53,6 +90,197 @@ namespace kernels {
                 std::size_t idx_from_start,
                 ContainerT ray_segment_storage
                 ) noexcept {
+        using StorageScalarT = storage::scalar_t<ContainerT>;
+        constexpr std::size_t block_size = simd_block_size;
+        auto interval = end_point_grid - start_point_grid;
+        const ScalarT scale = interval.GetL2Norm() / denominator;
+        const ScalarT step_x = normalized_direction_ray.x * scale;
+        const ScalarT step_y = normalized_direction_ray.y * scale;
+        const std::size_t subgrid_size = ray_segment_storage.extent(0);
+
+        ScalarT pow_in_block[block_size];
+        for (std::size_t j = 0; j < block_size; j++)
+            pow_in_block[j] = math_helper::fast_pow(multiplier_q, j);
+        const ScalarT pow_block = math_helper::fast_pow(multiplier_q, block_size);
+
+        ScalarT x_block[block_size], y_block[block_size];
+        std::size_t i = 0;
+        while (i < subgrid_size) {
+            std::size_t block = (idx_from_start + i) / block_size;
+            const std::size_t anchor_block = block - block % pow_reanchor_blocks;
+            ScalarT pow_block_start = math_helper::fast_pow(multiplier_q, anchor_block * block_size);
+            for (std::size_t b = anchor_block; b < block; b++)
+                pow_block_start *= pow_block;
+
+            for (; block < anchor_block + pow_reanchor_blocks && i < subgrid_size; block++, pow_block_start *= pow_block) {
+                //Блок считается целиком (длина известна компилятору - векторизуется без хвоста), записывается только попавшее в сегмент
+                for (std::size_t j = 0; j < block_size; j++) {
+                    //(x, y) = (x_0, y_0) + (V_x, V_y) * (b-a) * t уравнение прямой
+                    //t = (1 - q^i) / 1 - q^N
+                    const ScalarT t_numerator = ScalarT(1) - pow_block_start * pow_in_block[j];
+                    x_block[j] = start_point_grid.x + step_x * t_numerator;
+                    y_block[j] = start_point_grid.y + step_y * t_numerator;
+                }
+                const std::size_t first_in_block = idx_from_start + i - block * block_size; // Не ноль только у первого блока сегмента
+                const std::size_t end_in_block = std::min(block_size, first_in_block + (subgrid_size - i));
+                for (std::size_t j = first_in_block; j < end_in_block; j++, i++) {
+                    ray_segment_storage(i, 0) = static_cast<StorageScalarT>(x_block[j]);
+                    ray_segment_storage(i, 1) = static_cast<StorageScalarT>(y_block[j]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Числители параметра точек луча 1 - q^i, i = [0, count), по той же схеме блоков и пересчета степени,
+     * что и fill_ray_segment_nonuniform: x_0 + step_x * numerators[i] - та же точка, что пишет ядро.
+     * Таблица общая для всех лучей сетки
+     * @tparam ScalarT
+     * @param multiplier_q
+     * @param count Количество точек на луче
+     * @param numerators
+     */
+    template <typename ScalarT>
+    constexpr void fill_ray_parameter_numerators(ScalarT multiplier_q, std::size_t count, ScalarT* numerators) noexcept {
+        constexpr std::size_t block_size = simd_block_size;
+        ScalarT pow_in_block[block_size];
+        for (std::size_t j = 0; j < block_size; j++)
+            pow_in_block[j] = math_helper::fast_pow(multiplier_q, j);
+        const ScalarT pow_block = math_helper::fast_pow(multiplier_q, block_size);
+
+        ScalarT pow_block_start = ScalarT(1);
+        for (std::size_t block = 0; block * block_size < count; block++) {
+            if (block % pow_reanchor_blocks == 0)
+                pow_block_start = math_helper::fast_pow(multiplier_q, block * block_size);
+            ScalarT numerators_block[block_size];
+            for (std::size_t j = 0; j < block_size; j++)
+                numerators_block[j] = ScalarT(1) - pow_block_start * pow_in_block[j];
+            const std::size_t end_in_block = std::min(block_size, count - block * block_size);
+            for (std::size_t j = 0; j < end_in_block; j++)
+                numerators[block * block_size + j] = numerators_block[j];
+            pow_block_start *= pow_block;
+        }
+    }
+
+    ///Предел размера таблиц генераторов фиксированного размера: таблицы лежат на стеке вызывающего
+    inline constexpr std::size_t max_fixed_table_bytes = 64 * 1024;
+
+    ///Знаменатель 1 - q^(N-1) луча из count_points_on_ray точек - один для всех генераторов, использующих RayFrame
+    template <typename ScalarT>
+    [[nodiscard]] constexpr ScalarT ray_denominator(ScalarT multiplier_q, std::size_t count_points_on_ray) noexcept {
+        return ScalarT(1) - math_helper::fast_pow(multiplier_q, count_points_on_ray - 1);
+    }
+
+    /**
+     * Таблица числителей 1 - q^i на Count точек луча (fill_ray_parameter_numerators). При q - константе времени компиляции
+     * вычисляется компилятором: constexpr auto table = ray_parameter_numerators<Count>(1.1)
+     */
+    template <std::size_t Count, typename ScalarT>
+    [[nodiscard]] constexpr std::array<ScalarT, Count> ray_parameter_numerators(ScalarT multiplier_q) noexcept {
+        static_assert(Count * sizeof(ScalarT) <= max_fixed_table_bytes, "таблица числителей не помещается в предел стека");
+        std::array<ScalarT, Count> numerators{};
+        fill_ray_parameter_numerators(multiplier_q, Count, numerators.data());
+        return numerators;
+    }
+
+    ///Параметры луча сетки: направление, начало (точка на отверстии), конец (пересечение с границей) и знаменатель (1 - q^(N-1))
+    template <typename ScalarT>
+    struct RayFrame {
+        geometry::Point2D<ScalarT> normalized_direction_;
+        geometry::Point2D<ScalarT> start_point_, end_point_;
+        ScalarT denominator_;
+    };
+
+    /**
+     * Параметры луча, выпущенного из zero_point через hole_point до прямой (first_point_edge, second_point_edge).
+     * Общая часть всех реализаций генерации сетки, чтобы они давали побитово одинаковый результат
+     * @tparam ScalarT
+     * @param zero_point Начало координат (0, 0): точка на отверстии совпадает с вектором направления
+     * @param hole_point
+     * @param first_point_edge Граница задается двумя точками (first_point_edge, second_point_edge)
+     * @param second_point_edge
+     * @param multiplier_q
+     * @param count_points_on_ray
+     * @return RayFrame
+     */
+    template <typename ScalarT>
+    [[nodiscard]] RayFrame<ScalarT> make_ray_frame(
+                const geometry::Point2D<ScalarT> &zero_point,
+                const geometry::Point2D<ScalarT> &hole_point,
+                const geometry::Point2D<ScalarT> &first_point_edge,
+                const geometry::Point2D<ScalarT> &second_point_edge,
+                ScalarT multiplier_q,
+                std::size_t count_points_on_ray
+                ) noexcept {
+        using p_type = geometry::Point2D<ScalarT>;
+        p_type interception_point = geometry::interception_lines(
+                                                zero_point,
+                                                hole_point,
+                                                first_point_edge,
+                                                second_point_edge
+                                                        );
+        // Так как первая точка нулевая, то точка на окружности = вектор направления луча
+        p_type direction = hole_point;
+        direction.Normalize();
+
+        return RayFrame<ScalarT>{direction, hole_point, interception_point, ray_denominator(multiplier_q, count_points_on_ray)};
+    }
+
+    /**
+     * Луч из Count точек по готовой таблице числителей: x_i = x_0 + step_x * numerators[i], те же точки, что у
+     * fill_ray_segment_nonuniform. Длина цикла известна компилятору - без хвоста, с разворачиванием
+     * @tparam Count Точек на луче (= ray_storage.extent(0))
+     * @param frame Параметры луча (make_ray_frame)
+     * @param numerators Таблица ray_parameter_numerators<Count>(q)
+     * @param ray_storage
+     */
+    template <std::size_t Count, coordinate_storage_like ContainerT, typename ScalarT>
+    void fill_ray_fixed(const RayFrame<ScalarT> &frame, const std::array<ScalarT, Count> &numerators, ContainerT ray_storage) noexcept {
+        assert(ray_storage.extent(0) == Count);
+        using StorageScalarT = storage::scalar_t<ContainerT>;
+        auto interval = frame.end_point_ - frame.start_point_;
+        const ScalarT scale = interval.GetL2Norm() / frame.denominator_;
+        const ScalarT step_x = frame.normalized_direction_.x * scale;
+        const ScalarT step_y = frame.normalized_direction_.y * scale;
+        for (std::size_t i = 0; i < Count; i++) {
+            ray_storage(i, 0) = static_cast<StorageScalarT>(frame.start_point_.x + step_x * numerators[i]);
+            ray_storage(i, 1) = static_cast<StorageScalarT>(frame.start_point_.y + step_y * numerators[i]);
+        }
+    }
+
+    /**
+     * Скалярная версия fill_circle_arc_uniform: std::cos и std::sin на каждую точку.
+     * Эталон для тестов и бенчмарков векторной версии
+     */
+    template <coordinate_storage_like ContainerT, typename ScalarT>
+    void fill_circle_arc_uniform_scalar(
+                            ScalarT start_arc_angle_rad,
+                            ScalarT end_arc_angle_rad,
+                            ScalarT radius,
+                            ContainerT circle_storage
+                        ) noexcept {
+        const std::size_t grid_size = circle_storage.extent(0);
+        const ScalarT step_on_circle = (end_arc_angle_rad - start_arc_angle_rad) / (grid_size - 1);
+        for (std::size_t i = 0; i < grid_size; i++) {
+            circle_storage(i, 0) = radius * std::cos(start_arc_angle_rad + i * step_on_circle);
+            circle_storage(i, 1) = radius * std::sin(start_arc_angle_rad + i * step_on_circle);
+        }
+    }
+
+    /**
+     * Скалярная версия fill_ray_segment_nonuniform: fast_pow на каждую точку.
+     * Эталон для тестов и бенчмарков векторной версии
+     */
+    template <coordinate_storage_like ContainerT, typename ScalarT>
+    void fill_ray_segment_nonuniform_scalar(
+                const geometry::Point2D<ScalarT> &normalized_direction_ray,
+                const geometry::Point2D<ScalarT> &start_point_grid,
+                const geometry::Point2D<ScalarT> &end_point_grid,
+                ScalarT multiplier_q,
+                ScalarT denominator,
+                std::size_t idx_from_start,
+                ContainerT ray_segment_storage
+                ) noexcept {
         auto interval = end_point_grid - start_point_grid;
         ScalarT length_interval = interval.GetL2Norm();
         const std::size_t subgrid_size = ray_segment_storage.extent(0);
@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <mkl_cblas.h>
+#include <mkl_spblas.h>
+#include "core/custom_concepts.hpp"
+#include "core/solvers/pardiso.hpp"
+#include "core/sparse/csr_matrix.hpp"
+
+namespace solvers {
+
+    struct CgSettings {
+        double relative_tolerance_ = 1e-8; // Остановка при ||r|| <= relative_tolerance_ * ||b||
+        std::size_t max_iterations_ = 20000;
+    };
+
+    struct CgReport {
+        std::size_t iterations_ = 0;
+        double relative_residual_ = 0.0;
+        bool converged_ = false;
+        double seconds_ = 0.0;
+    };
+
+    ///y = K * x через mkl_sparse_d_mv. Матрица должна иметь handle (CsrMatrix::make_handle)
+    class SparseOperator {
+    public:
+        explicit SparseOperator(const sparse::CsrMatrix& matrix) noexcept : matrix_(&matrix) {}
+
+        [[nodiscard]] std::size_t size() const noexcept { return static_cast<std::size_t>(matrix_->count_rows_); }
+        void apply(const double* x, double* y) const noexcept {
+            mkl_sparse_d_mv(SPARSE_OPERATION_NON_TRANSPOSE, 1.0, matrix_->handle_.get(), sparse::general_descr(), x, 0.0, y);
+        }
+
+    private:
+        const sparse::CsrMatrix* matrix_;
+    };
+
+    ///Предобуславливатель Якоби: z = r / diag(K)
+    class JacobiPreconditioner {
+    public:
+        JacobiPreconditioner() = default;
+        explicit JacobiPreconditioner(const sparse::CsrMatrix& matrix) : inverse_diagonal_(matrix.count_rows_) {
+            for (MKL_INT row = 0; row < matrix.count_rows_; row++)
+                inverse_diagonal_[row] = 1.0 / matrix.values_[matrix.find(row, row)];
+        }
+        explicit JacobiPreconditioner(std::vector<double> inverse_diagonal) noexcept : inverse_diagonal_(std::move(inverse_diagonal)) {}
+
+        [[nodiscard]] std::size_t size() const noexcept { return inverse_diagonal_.size(); }
+        void apply(const double* r, double* z) const noexcept {
+            for (std::size_t i = 0; i < inverse_diagonal_.size(); i++)
+                z[i] = inverse_diagonal_[i] * r[i];
+        }
+
+    private:
+        std::vector<double> inverse_diagonal_;
+    };
+
+    /**
+     * Метод сопряженных градиентов с предобуславливателем для симметричной положительно определенной системы A x = b.
+     * Оператор не обязан хранить матрицу (см. matrix-free операторы), векторные операции - MKL BLAS
+     * @param A Оператор системы
+     * @param M Предобуславливатель (приближение A^-1)
+     * @param b Правая часть
+     * @param x Начальное приближение на входе, решение на выходе
+     * @param settings
+     */
+    template <linear_operator OperatorT, linear_operator PreconditionerT>
+    CgReport conjugate_gradient(const OperatorT& A, const PreconditionerT& M, const double* b, double* x, const CgSettings& settings = {}) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto n = static_cast<MKL_INT>(A.size());
+        std::vector<double> r(n), z(n), p(n), q(n);
+
+        CgReport report;
+        const double norm_b = cblas_dnrm2(n, b, 1);
+        if (norm_b == 0.0) {
+            std::fill(x, x + n, 0.0);
+            report.converged_ = true;
+            report.seconds_ = seconds_since(start);
+            return report;
+        }
+
+        A.apply(x, r.data());
+        for (MKL_INT i = 0; i < n; i++)
+            r[i] = b[i] - r[i];
+        M.apply(r.data(), z.data());
+        cblas_dcopy(n, z.data(), 1, p.data(), 1);
+        double rz = cblas_ddot(n, r.data(), 1, z.data(), 1);
+        report.relative_residual_ = cblas_dnrm2(n, r.data(), 1) / norm_b;
+
+        while (report.relative_residual_ > settings.relative_tolerance_ && report.iterations_ < settings.max_iterations_) {
+            A.apply(p.data(), q.data());
+            const double alpha = rz / cblas_ddot(n, p.data(), 1, q.data(), 1);
+            cblas_daxpy(n, alpha, p.data(), 1, x, 1);
+            cblas_daxpy(n, -alpha, q.data(), 1, r.data(), 1);
+            report.iterations_++;
+            report.relative_residual_ = cblas_dnrm2(n, r.data(), 1) / norm_b;
+
+            M.apply(r.data(), z.data());
+            const double rz_next = cblas_ddot(n, r.data(), 1, z.data(), 1);
+            const double beta = rz_next / rz;
+            rz = rz_next;
+            //p = z + beta * p
+            cblas_dscal(n, beta, p.data(), 1);
+            cblas_daxpy(n, 1.0, z.data(), 1, p.data(), 1);
+        }
+        report.converged_ = report.relative_residual_ <= settings.relative_tolerance_;
+        report.seconds_ = seconds_since(start);
+        return report;
+    }
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include <mkl_pardiso.h>
+#include "core/sparse/csr_matrix.hpp"
+
+namespace solvers {
+
+    ///Время этапов решателя с момента создания (секунды) и число их вызовов
+    struct PhaseTimings {
+        double reorder_seconds_ = 0.0; // Переупорядочивание и символьная факторизация
+        double factor_seconds_ = 0.0;  // Численная факторизация
+        double solve_seconds_ = 0.0;   // Прямой и обратный ход
+        std::size_t count_factorizations_ = 0;
+        std::size_t count_solves_ = 0;
+    };
+
+    [[nodiscard]] inline double seconds_since(std::chrono::steady_clock::time_point start) noexcept {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * Прямой решатель MKL PARDISO для симметричных положительно определенных матриц (mtype = 2).
+     * Этапы разделены, чтобы переиспользовать результаты: analyze - один раз на портрет, factorize - при смене значений,
+     * solve - сколько угодно раз, в том числе сразу для нескольких правых частей.
+     * PARDISO требует верхний треугольник, поэтому решатель держит его копию; позиции копии в полной матрице запоминаются в analyze
+     * Методы возвращают код ошибки PARDISO (0 - успех); вызов не по порядку (factorize до успешного analyze,
+     * solve до успешной факторизации) возвращает not_ready, не обращаясь к PARDISO
+     */
+    class PardisoSolver {
+    public:
+        static constexpr MKL_INT not_ready = -1; // Код PARDISO "входные данные несогласованы"
+
+        PardisoSolver() noexcept {
+            pardisoinit(pt_, &mtype_, iparm_);
+            iparm_[0] = 1;  // Параметры заданы явно
+            iparm_[1] = 2;  // Переупорядочивание nested dissection (METIS)
+            iparm_[23] = 1; // Двухуровневая параллельная факторизация
+            iparm_[34] = 1; // Нумерация с нуля
+        }
+        PardisoSolver(const PardisoSolver&) = delete;
+        PardisoSolver& operator=(const PardisoSolver&) = delete;
+        ~PardisoSolver() { release(); }
+
+        /**
+         * Переупорядочивание и символьная факторизация (phase 11) по портрету matrix
+         * @param matrix Симметричная матрица, хранятся оба треугольника
+         */
+        MKL_INT analyze(const sparse::CsrMatrix& matrix) {
+            release();
+            count_rows_ = matrix.count_rows_;
+            upper_offsets_.assign(count_rows_ + 1, 0);
+            upper_columns_.clear();
+            upper_positions_.clear();
+            for (MKL_INT row = 0; row < count_rows_; row++) {
+                for (MKL_INT p = matrix.row_offsets_[row]; p < matrix.row_offsets_[row + 1]; p++) {
+                    if (matrix.col_indices_[p] >= row) {
+                        upper_columns_.push_back(matrix.col_indices_[p]);
+                        upper_positions_.push_back(p);
+                    }
+                }
+                upper_offsets_[row + 1] = static_cast<MKL_INT>(upper_columns_.size());
+            }
+            upper_values_.assign(upper_columns_.size(), 0.0);
+            copyUpperValues(matrix);
+
+            const auto start = std::chrono::steady_clock::now();
+            const MKL_INT error = call(11, nullptr, nullptr, 1);
+            timings_.reorder_seconds_ += seconds_since(start);
+            analyzed_ = (error == 0);
+            if (!analyzed_)
+                call(-1, nullptr, nullptr, 1); // Часть памяти PARDISO могла быть выделена до ошибки
+            return error;
+        }
+
+        ///Численная факторизация (phase 22) текущих значений matrix. Портрет должен совпадать с тем, что был в analyze
+        MKL_INT factorize(const sparse::CsrMatrix& matrix) {
+            factorized_ = false;
+            if (!analyzed_)
+                return not_ready;
+            copyUpperValues(matrix);
+            const auto start = std::chrono::steady_clock::now();
+            const MKL_INT error = call(22, nullptr, nullptr, 1);
+            timings_.factor_seconds_ += seconds_since(start);
+            factorized_ = (error == 0);
+            if (factorized_)
+                timings_.count_factorizations_++;
+            return error;
+        }
+
+        /**
+         * Прямой и обратный ход (phase 33) по последней факторизации
+         * @param rhs Правые части по столбцам: столбец c - rhs[c * count_rows, (c + 1) * count_rows)
+         * @param solution Решения в той же раскладке
+         * @param count_rhs Количество правых частей (случаев нагружения)
+         */
+        MKL_INT solve(const double* rhs, double* solution, MKL_INT count_rhs = 1) {
+            if (!factorized_)
+                return not_ready;
+            const auto start = std::chrono::steady_clock::now();
+            const MKL_INT error = call(33, const_cast<double*>(rhs), solution, count_rhs);
+            timings_.solve_seconds_ += seconds_since(start);
+            timings_.count_solves_ += static_cast<std::size_t>(count_rhs);
+            return error;
+        }
+
+        [[nodiscard]] const PhaseTimings& timings() const noexcept { return timings_; }
+        ///Число ненулевых элементов множителя (iparm[17] после analyze)
+        [[nodiscard]] MKL_INT factorNonzeros() const noexcept { return iparm_[17]; }
+
+    private:
+        MKL_INT call(MKL_INT phase, double* rhs, double* solution, MKL_INT count_rhs) noexcept {
+            MKL_INT error = 0;
+            pardiso(pt_, &max_factors_, &matrix_number_, &mtype_, &phase, &count_rows_,
+                    upper_values_.data(), upper_offsets_.data(), upper_columns_.data(),
+                    nullptr, &count_rhs, iparm_, &message_level_, rhs, solution, &error);
+            return error;
+        }
+
+        void copyUpperValues(const sparse::CsrMatrix& matrix) noexcept {
+            for (std::size_t i = 0; i < upper_positions_.size(); i++)
+                upper_values_[i] = matrix.values_[upper_positions_[i]];
+        }
+
+        ///Освобождение памяти PARDISO (phase -1)
+        void release() noexcept {
+            if (analyzed_)
+                call(-1, nullptr, nullptr, 1);
+            analyzed_ = factorized_ = false;
+        }
+
+        void* pt_[64]{};
+        MKL_INT iparm_[64]{};
+        MKL_INT mtype_ = 2; // Вещественная симметричная положительно определенная
+        MKL_INT max_factors_ = 1;
+        MKL_INT matrix_number_ = 1;
+        MKL_INT message_level_ = 0;
+        MKL_INT count_rows_ = 0;
+        bool analyzed_ = false;
+        bool factorized_ = false;
+
+        std::vector<MKL_INT> upper_offsets_;
+        std::vector<MKL_INT> upper_columns_;
+        std::vector<MKL_INT> upper_positions_; // Позиция элемента верхнего треугольника в values_ полной матрицы
+        std::vector<double> upper_values_;
+        PhaseTimings timings_;
+    };
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <mkl_spblas.h>
+
+namespace sparse {
+
+    ///Владеющая обертка над sparse_matrix_t: mkl_sparse_destroy в деструкторе, только перемещение
+    class SparseHandle {
+    public:
+        SparseHandle() = default;
+        explicit SparseHandle(sparse_matrix_t handle) noexcept : handle_(handle) {}
+        SparseHandle(const SparseHandle&) = delete;
+        SparseHandle& operator=(const SparseHandle&) = delete;
+        SparseHandle(SparseHandle&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        SparseHandle& operator=(SparseHandle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+        ~SparseHandle() { reset(); }
+
+        void reset() noexcept {
+            if (handle_ != nullptr)
+                mkl_sparse_destroy(handle_);
+            handle_ = nullptr;
+        }
+        [[nodiscard]] sparse_matrix_t get() const noexcept { return handle_; }
+        [[nodiscard]] explicit operator bool() const noexcept { return handle_ != nullptr; }
+
+    private:
+        sparse_matrix_t handle_ = nullptr;
+    };
+
+    ///Описатель матрицы общего вида (хранятся оба треугольника)
+    [[nodiscard]] inline matrix_descr general_descr() noexcept {
+        matrix_descr descr{};
+        descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+        descr.mode = SPARSE_FILL_MODE_FULL;
+        descr.diag = SPARSE_DIAG_NON_UNIT;
+        return descr;
+    }
+
+    /**
+     * Квадратная матрица в формате CSR с нумерацией с нуля: столбцы строки i - col_indices_[row_offsets_[i], row_offsets_[i + 1]),
+     * отсортированы по возрастанию. Массивы принадлежат матрице, handle MKL ссылается на них без копирования
+     * (при перемещении матрицы буферы std::vector не меняются, поэтому handle остается действительным)
+     */
+    struct CsrMatrix {
+        MKL_INT count_rows_ = 0;
+        std::vector<MKL_INT> row_offsets_;
+        std::vector<MKL_INT> col_indices_;
+        std::vector<double> values_;
+        SparseHandle handle_;
+
+        [[nodiscard]] std::size_t count_nonzeros() const noexcept { return col_indices_.size(); }
+
+        ///Позиция a_ij в values_ (бинарный поиск по строке), count_nonzeros(), если элемента нет в портрете
+        [[nodiscard]] std::size_t find(MKL_INT row, MKL_INT column) const noexcept {
+            MKL_INT begin = row_offsets_[row], end = row_offsets_[row + 1];
+            while (begin < end) {
+                const MKL_INT middle = begin + (end - begin) / 2;
+                if (col_indices_[middle] < column)
+                    begin = middle + 1;
+                else
+                    end = middle;
+            }
+            return (begin < row_offsets_[row + 1] && col_indices_[begin] == column) ? static_cast<std::size_t>(begin) : count_nonzeros();
+        }
+
+        /**
+         * Создать handle MKL над массивами матрицы (если его еще нет) и подготовить его к expected_mv_calls умножениям на вектор
+         * @return Статус MKL
+         */
+        sparse_status_t make_handle(MKL_INT expected_mv_calls = 0) {
+            if (!handle_) {
+                sparse_matrix_t raw = nullptr;
+                const sparse_status_t status = mkl_sparse_d_create_csr(
+                                                            &raw,
+                                                            SPARSE_INDEX_BASE_ZERO,
+                                                            count_rows_,
+                                                            count_rows_,
+                                                            row_offsets_.data(),
+                                                            row_offsets_.data() + 1,
+                                                            col_indices_.data(),
+                                                            values_.data()
+                                                            );
+                if (status != SPARSE_STATUS_SUCCESS)
+                    return status;
+                handle_ = SparseHandle{raw};
+            }
+            if (expected_mv_calls > 0) {
+                mkl_sparse_set_mv_hint(handle_.get(), SPARSE_OPERATION_NON_TRANSPOSE, general_descr(), expected_mv_calls);
+                return mkl_sparse_optimize(handle_.get());
+            }
+            return SPARSE_STATUS_SUCCESS;
+        }
+    };
+
+}
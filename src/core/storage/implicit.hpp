@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/storage/storage.hpp"
+
+namespace storage {
+
+    /**
+     * Неявная сетка GenFrameKirsch: хранятся только общая для всех лучей таблица числителей 1 - q^i
+     * и для каждого луча начало и шаг (направление * длина / (1 - q^(N-1))). Точка i луча k вычисляется при доступе:
+     * (x, y) = start_k + step_k * numerators_i - та же формула и те же операнды, что у ядра генерации,
+     * поэтому координаты совпадают с хранимой сеткой с точностью до сжатия в FMA. Память O(лучи + точки на луче) вместо O(лучи * точки).
+     * Узлы нумеруются как в GenFrameKirsch: node = ray_idx * count_points_on_ray + point_idx.
+     * Удовлетворяет coordinate_source_like: годится всем, кто координаты только читает
+     * @tparam ScalarT
+     */
+    template <scalar ScalarT = double>
+    class ImplicitKirschMesh {
+    public:
+        using value_type = ScalarT;
+        using rays_type = AoSView<ScalarT>;
+        using numerators_type = Kokkos::View<ScalarT*, Kokkos::HostSpace>;
+
+        ImplicitKirschMesh() = default;
+        /**
+         * @param ray_starts Точки лучей на отверстии
+         * @param ray_steps Шаг луча: координата точки i = start + step * numerators(i)
+         * @param numerators Числители 1 - q^i (kernels::fill_ray_parameter_numerators)
+         */
+        ImplicitKirschMesh(rays_type ray_starts, rays_type ray_steps, numerators_type numerators) noexcept
+                : ray_starts_(ray_starts), ray_steps_(ray_steps), numerators_(numerators),
+                  size_(ray_starts.extent(0) * numerators.extent(0)) {}
+
+        [[nodiscard]] std::size_t extent(std::size_t dim) const noexcept { return dim == 0 ? size_ : 2; }
+        [[nodiscard]] std::size_t count_rays() const noexcept { return ray_starts_.extent(0); }
+        [[nodiscard]] std::size_t count_points_on_ray() const noexcept { return numerators_.extent(0); }
+
+        [[nodiscard]] ScalarT operator()(std::size_t i, std::size_t component) const noexcept {
+            const std::size_t node = offset_ + i;
+            const std::size_t count_points = numerators_.extent(0);
+            const std::size_t ray_idx = node / count_points;
+            return point(ray_idx, node - ray_idx * count_points, component);
+        }
+
+        ///Координата точки point_idx луча ray_idx (без деления на count_points_on_ray)
+        [[nodiscard]] ScalarT point(std::size_t ray_idx, std::size_t point_idx, std::size_t component) const noexcept {
+            return ray_starts_(ray_idx, component) + ray_steps_(ray_idx, component) * numerators_(point_idx);
+        }
+
+        ///Сегмент узлов [begin, end): разделяет таблицы с исходной сеткой
+        [[nodiscard]] ImplicitKirschMesh subrange(std::size_t begin, std::size_t end) const noexcept {
+            ImplicitKirschMesh result = *this;
+            result.offset_ = offset_ + begin;
+            result.size_ = end - begin;
+            return result;
+        }
+
+        /**
+         * Запись узлов [begin, begin + out.extent(0)) сегмента в хранилище out. Обход по лучам: внутри луча цикл по точкам
+         * без деления и векторизуется
+         */
+        template <coordinate_storage_like ContainerT>
+        void materialize(std::size_t begin, ContainerT out) const noexcept {
+            using StorageScalarT = scalar_t<ContainerT>;
+            const std::size_t count_points = numerators_.extent(0);
+            std::size_t node = offset_ + begin;
+            const std::size_t end = node + out.extent(0);
+            std::size_t out_idx = 0;
+            while (node < end) {
+                const std::size_t ray_idx = node / count_points;
+                const std::size_t first_point = node - ray_idx * count_points;
+                const std::size_t end_point = std::min(count_points, first_point + (end - node));
+                const ScalarT start_x = ray_starts_(ray_idx, 0), start_y = ray_starts_(ray_idx, 1);
+                const ScalarT step_x = ray_steps_(ray_idx, 0), step_y = ray_steps_(ray_idx, 1);
+                for (std::size_t j = first_point; j < end_point; j++, out_idx++) {
+                    out(out_idx, 0) = static_cast<StorageScalarT>(start_x + step_x * numerators_(j));
+                    out(out_idx, 1) = static_cast<StorageScalarT>(start_y + step_y * numerators_(j));
+                }
+                node += end_point - first_point;
+            }
+        }
+
+        ///Память таблиц в байтах
+        [[nodiscard]] std::size_t memory_bytes() const noexcept {
+            return (4 * ray_starts_.extent(0) + numerators_.extent(0)) * sizeof(ScalarT);
+        }
+
+    private:
+        rays_type ray_starts_;
+        rays_type ray_steps_;
+        numerators_type numerators_;
+        std::size_t offset_ = 0;
+        std::size_t size_ = 0;
+    };
+
+}
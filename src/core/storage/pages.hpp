@@ -0,0 +1,166 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <sys/mman.h>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/storage/storage.hpp"
+
+namespace storage {
+
+    ///Страницы памяти под хранилище
+    enum class PageMode {
+        Default,         // Обычные страницы 4K
+        TransparentHuge, // madvise(MADV_HUGEPAGE): ядро собирает область из страниц 2M, если они есть (THP в режиме madvise или always)
+        ExplicitHuge     // MAP_HUGETLB: страницы из пула vm.nr_hugepages, при пустом пуле выделение не удается (ENOMEM)
+    };
+
+    inline constexpr std::size_t small_page_size = 4096;
+    inline constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+    ///Начало и длина в байтах памяти хранилища (у сегмента - от первой до последней точки)
+    template <coordinate_storage_like StorageT>
+    [[nodiscard]] std::pair<void*, std::size_t> memory_span(const StorageT& coordinates) noexcept {
+        using ScalarT = scalar_t<StorageT>;
+        if constexpr (kokkos_view_2d_like<StorageT>)
+            return {coordinates.data(), coordinates.span() * sizeof(ScalarT)};
+        else
+            return {coordinates.blocks().data(), coordinates.blocks().span() * sizeof(ScalarT)};
+    }
+
+    /**
+     * Просьба к ядру собрать [data, data + bytes) из огромных страниц (вызывать до первого касания памяти).
+     * Края, не покрывающие целую страницу 2M, остаются на страницах 4K. Области меньше huge_page_size не трогаются
+     * @return 0 или errno
+     */
+    [[nodiscard]] inline int advise_huge_pages(void* data, std::size_t bytes) noexcept {
+        if (bytes < huge_page_size)
+            return 0;
+        const auto address = reinterpret_cast<std::uintptr_t>(data);
+        const std::uintptr_t begin = (address + small_page_size - 1) / small_page_size * small_page_size;
+        const std::uintptr_t end = (address + bytes) / small_page_size * small_page_size;
+        if (end <= begin)
+            return 0;
+        return ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) == 0 ? 0 : errno;
+    }
+
+    /**
+     * Анонимная память под хранилище, выделенная напрямую через mmap: munmap в деструкторе, только перемещение.
+     * Страницы не касаются при выделении - их размещает по узлам NUMA первый записавший поток
+     */
+    class PageBuffer {
+    public:
+        PageBuffer() = default;
+        PageBuffer(const PageBuffer&) = delete;
+        PageBuffer& operator=(const PageBuffer&) = delete;
+        PageBuffer(PageBuffer&& other) noexcept
+                : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+                  mapping_(std::exchange(other.mapping_, nullptr)), mapping_size_(std::exchange(other.mapping_size_, 0)) {}
+        PageBuffer& operator=(PageBuffer&& other) noexcept {
+            if (this != &other) {
+                reset();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                mapping_ = std::exchange(other.mapping_, nullptr);
+                mapping_size_ = std::exchange(other.mapping_size_, 0);
+            }
+            return *this;
+        }
+        ~PageBuffer() { reset(); }
+
+        /**
+         * Выделение bytes байт. TransparentHuge и ExplicitHuge выравнивают начало по huge_page_size
+         * @return 0 или errno (ExplicitHuge без зарезервированных страниц - ENOMEM)
+         */
+        [[nodiscard]] int allocate(std::size_t bytes, PageMode mode) noexcept {
+            reset();
+            if (bytes == 0)
+                return 0;
+            constexpr int protection = PROT_READ | PROT_WRITE;
+            constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+            if (mode == PageMode::ExplicitHuge) {
+                const std::size_t size = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+                void* address = ::mmap(nullptr, size, protection, flags | MAP_HUGETLB, -1, 0);
+                if (address == MAP_FAILED)
+                    return errno;
+                mapping_ = data_ = static_cast<std::byte*>(address);
+                mapping_size_ = size;
+                size_ = bytes;
+                return 0;
+            }
+
+            //Запас в одну огромную страницу, чтобы выровнять начало: иначе первая страница 2M области не целая
+            const std::size_t padding = mode == PageMode::TransparentHuge ? huge_page_size : 0;
+            void* address = ::mmap(nullptr, bytes + padding, protection, flags, -1, 0);
+            if (address == MAP_FAILED)
+                return errno;
+            mapping_ = static_cast<std::byte*>(address);
+            mapping_size_ = bytes + padding;
+            data_ = mapping_;
+            if (padding != 0)
+                data_ += (huge_page_size - reinterpret_cast<std::uintptr_t>(address) % huge_page_size) % huge_page_size;
+            size_ = bytes;
+            if (mode == PageMode::TransparentHuge) {
+                if (const int error = advise_huge_pages(data_, size_); error != 0) {
+                    reset();
+                    return error;
+                }
+            }
+            return 0;
+        }
+
+        void reset() noexcept {
+            if (mapping_ != nullptr)
+                ::munmap(mapping_, mapping_size_);
+            data_ = mapping_ = nullptr;
+            size_ = mapping_size_ = 0;
+        }
+        [[nodiscard]] std::byte* data() const noexcept { return data_; }
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+        [[nodiscard]] explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    private:
+        std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+        std::byte* mapping_ = nullptr;
+        std::size_t mapping_size_ = 0;
+    };
+
+    ///Байт памяти под size точек хранилища StorageT (для PageBuffer::allocate)
+    template <coordinate_storage_like StorageT>
+    [[nodiscard]] constexpr std::size_t required_bytes(std::size_t size) noexcept {
+        return size * 2 * sizeof(scalar_t<StorageT>);
+    }
+
+    /**
+     * Неуправляемое хранилище Kokkos на памяти buffer: buffer должен жить дольше хранилища и его копий
+     * @tparam StorageT AoSView или SoAView
+     */
+    template <coordinate_storage_like StorageT>
+    requires kokkos_view_2d_like<StorageT>
+    [[nodiscard]] StorageT wrap(const PageBuffer& buffer, std::size_t size) noexcept {
+        return StorageT(reinterpret_cast<typename StorageT::pointer_type>(buffer.data()), size);
+    }
+
+    /**
+     * Первое касание страниц сегмента вызывающим потоком: запись нуля в точки с шагом не больше страницы 4K
+     * в каждой из раскладок (AoS, SoA, AoSoA) и в последнюю точку. Страница размещается на узле NUMA потока
+     */
+    template <coordinate_storage_like ChunkT>
+    void touch_pages(ChunkT chunk) noexcept {
+        using ScalarT = scalar_t<ChunkT>;
+        constexpr std::size_t points_per_touch = small_page_size / (2 * sizeof(ScalarT));
+        const std::size_t size = chunk.extent(0);
+        for (std::size_t i = 0; i < size; i += points_per_touch) {
+            chunk(i, 0) = ScalarT(0);
+            chunk(i, 1) = ScalarT(0);
+        }
+        if (size > 0) {
+            chunk(size - 1, 0) = ScalarT(0);
+            chunk(size - 1, 1) = ScalarT(0);
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <Kokkos_Core.hpp>
+#include "../custom_concepts.hpp"
+
+namespace storage {
+
+    ///AoS: x и y точки лежат рядом (x0 y0 x1 y1 ...). Совпадает с ViewType
+    template <scalar ScalarT = double>
+    using AoSView = Kokkos::View<ScalarT*[2], Kokkos::LayoutRight, Kokkos::HostSpace>;
+
+    ///SoA: сначала все x, затем все y (x0 x1 ... y0 y1 ...)
+    template <scalar ScalarT = double>
+    using SoAView = Kokkos::View<ScalarT*[2], Kokkos::LayoutLeft, Kokkos::HostSpace>;
+
+    /**
+     * AoSoA: точки разбиты на блоки по BlockSize, внутри блока сначала BlockSize значений x, затем BlockSize значений y.
+     * Блок целиком помещается в SIMD регистры, при этом x и y одной точки лежат в одной-двух кэш-линиях.
+     * Сегмент (subrange) разделяет память с исходным хранилищем и может начинаться с середины блока
+     * @tparam ScalarT
+     * @tparam BlockSize Количество точек в блоке (ширина SIMD регистра в элементах ScalarT или кратная ей)
+     */
+    template <scalar ScalarT = double, std::size_t BlockSize = 8>
+    class AoSoAView {
+    public:
+        using value_type = ScalarT;
+        using blocks_type = Kokkos::View<ScalarT*[2][BlockSize], Kokkos::LayoutRight, Kokkos::HostSpace>;
+        static constexpr std::size_t block_size = BlockSize;
+
+        AoSoAView() = default;
+        AoSoAView(const std::string& label, std::size_t size)
+                : blocks_(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), (size + BlockSize - 1) / BlockSize), size_(size) {}
+        ///Неуправляемое хранилище на чужой памяти из целых блоков (например, из storage::Workspace)
+        AoSoAView(ScalarT* data, std::size_t size) : blocks_(data, (size + BlockSize - 1) / BlockSize), size_(size) {}
+
+        [[nodiscard]] std::size_t extent(std::size_t dim) const noexcept { return dim == 0 ? size_ : 2; }
+
+        [[nodiscard]] ScalarT& operator()(std::size_t i, std::size_t component) const noexcept {
+            const std::size_t idx = offset_ + i;
+            return blocks_(idx / BlockSize, component, idx % BlockSize);
+        }
+
+        ///Сегмент точек [begin, end)
+        [[nodiscard]] AoSoAView subrange(std::size_t begin, std::size_t end) const noexcept {
+            AoSoAView result = *this;
+            result.offset_ = offset_ + begin;
+            result.size_ = end - begin;
+            return result;
+        }
+
+        ///Номер первой точки сегмента в блоках (для обхода по целым блокам)
+        [[nodiscard]] std::size_t offset() const noexcept { return offset_; }
+        [[nodiscard]] const blocks_type& blocks() const noexcept { return blocks_; }
+        [[nodiscard]] ScalarT* data() const noexcept { return blocks_.data(); }
+
+    private:
+        blocks_type blocks_;
+        std::size_t offset_ = 0;
+        std::size_t size_ = 0;
+    };
+
+    ///Тип, в котором хранятся координаты (может отличаться от типа вычислений в смешанной точности)
+    template <coordinate_source_like StorageT>
+    using scalar_t = std::remove_const_t<typename std::remove_cvref_t<StorageT>::value_type>;
+
+    ///Сегмент [begin, end) хранилища координат, разделяющий с ним память (у неявной сетки - те же таблицы)
+    template <coordinate_source_like StorageT>
+    [[nodiscard]] storage_subrange_t<StorageT> subrange(const StorageT& coordinates, std::size_t begin, std::size_t end) noexcept {
+        if constexpr (kokkos_view_2d_like<StorageT>)
+            return Kokkos::subview(coordinates, Kokkos::pair(begin, end), Kokkos::ALL);
+        else
+            return coordinates.subrange(begin, end);
+    }
+
+    ///Выделение хранилища на size точек без инициализации
+    template <coordinate_storage_like StorageT>
+    [[nodiscard]] StorageT allocate(const std::string& label, std::size_t size) {
+        if constexpr (kokkos_view_2d_like<StorageT>)
+            return StorageT(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), size);
+        else
+            return StorageT(label, size);
+    }
+}
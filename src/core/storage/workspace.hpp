@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/storage/pages.hpp"
+#include "core/storage/storage.hpp"
+
+namespace storage {
+
+    inline constexpr std::size_t workspace_alignment = 64; // Начало каждого выданного блока - на границе кэш-линии
+
+    ///Байт памяти под хранилище StorageT из size точек (у AoSoA - с хвостом последнего блока)
+    template <coordinate_storage_like StorageT>
+    [[nodiscard]] constexpr std::size_t storage_bytes(std::size_t size) noexcept {
+        if constexpr (kokkos_view_2d_like<StorageT>)
+            return required_bytes<StorageT>(size);
+        else
+            return (size + StorageT::block_size - 1) / StorageT::block_size * StorageT::block_size * 2 * sizeof(scalar_t<StorageT>);
+    }
+
+    /**
+     * Арена для временных хранилищ генераторов: неуправляемые хранилища Kokkos (и тривиально разрушаемые объекты, make)
+     * нарезаются подряд из заранее выделенной области (PageBuffer), reset() освобождает все разом.
+     * Сейчас арену использует только GenFrameKirsch с параметром workspace; аргументы ядер пула хранятся по значению
+     * в окружении задачи, поэтому make генераторами не используется.
+     * Запрос сверх области обслуживается отдельным блоком из кучи, а следующий reset() увеличивает область до наибольшего
+     * потребления с прошлого reset(): со второго прохода цикла с одинаковыми размерами выделений в куче нет.
+     * Выданное действительно до reset() или разрушения арены (копии представлений Kokkos память не удерживают).
+     * Не потокобезопасна: нарезка - из вызывающего потока, вне ядер пула
+     */
+    class Workspace {
+    public:
+        Workspace() = default;
+        Workspace(const Workspace&) = delete;
+        Workspace& operator=(const Workspace&) = delete;
+        Workspace(Workspace&&) noexcept = default;
+        Workspace& operator=(Workspace&&) noexcept = default;
+
+        /**
+         * Выделение области (все выданное ранее становится недействительным)
+         * @param bytes Размер области
+         * @param mode Страницы области (PageMode::ExplicitHuge требует зарезервированных огромных страниц)
+         * @return 0 или errno
+         */
+        [[nodiscard]] int reserve(std::size_t bytes, PageMode mode = PageMode::Default) noexcept {
+            release();
+            mode_ = mode;
+            return buffer_.allocate(bytes, mode);
+        }
+
+        /**
+         * Хранилище size точек без инициализации
+         * @tparam StorageT AoSView, SoAView или AoSoAView
+         */
+        template <coordinate_storage_like StorageT>
+        [[nodiscard]] StorageT take(std::size_t size) {
+            return StorageT(static_cast<scalar_t<StorageT>*>(takeBytes(storage_bytes<StorageT>(size))), size);
+        }
+
+        ///Объект аргументов в арене (деструктор не вызывается, поэтому только тривиально разрушаемые типы)
+        template <typename ArgsT, typename... Ts>
+        requires std::is_trivially_destructible_v<ArgsT>
+        [[nodiscard]] ArgsT* make(Ts&&... values) {
+            static_assert(alignof(ArgsT) <= workspace_alignment, "арена выравнивает по кэш-линии");
+            return ::new (takeBytes(sizeof(ArgsT))) ArgsT{std::forward<Ts>(values)...};
+        }
+
+        /**
+         * Освобождение всего выданного. Если с прошлого reset() области не хватило, она пересоздается под наибольшее потребление
+         * @return 0 или errno увеличения области (область остается прежней, запросы сверх нее снова идут в кучу)
+         */
+        [[nodiscard]] int reset() noexcept {
+            const std::size_t demand = demand_;
+            overflow_blocks_.clear();
+            offset_ = demand_ = 0;
+            if (demand <= buffer_.size())
+                return 0;
+            PageBuffer grown;
+            if (const int error = grown.allocate(demand, mode_); error != 0)
+                return error;
+            buffer_ = std::move(grown);
+            return 0;
+        }
+
+        ///Байт, выданных с прошлого reset() (включая блоки из кучи)
+        [[nodiscard]] std::size_t used() const noexcept { return demand_; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return buffer_.size(); }
+        ///Запросов с прошлого reset(), не поместившихся в область
+        [[nodiscard]] std::size_t countOverflows() const noexcept { return overflow_blocks_.size(); }
+        ///Лежит ли адрес в области арены
+        [[nodiscard]] bool owns(const void* address) const noexcept {
+            const auto* byte = static_cast<const std::byte*>(address);
+            return buffer_ && byte >= buffer_.data() && byte < buffer_.data() + buffer_.size();
+        }
+
+    private:
+        struct AlignedDelete {
+            void operator()(std::byte* data) const noexcept { ::operator delete[](data, std::align_val_t{workspace_alignment}); }
+        };
+
+        static constexpr std::size_t align_up(std::size_t offset) noexcept {
+            return (offset + workspace_alignment - 1) / workspace_alignment * workspace_alignment;
+        }
+
+        void* takeBytes(std::size_t bytes) {
+            demand_ = align_up(demand_) + bytes; // Столько заняла бы область, если бы все запросы в нее поместились
+            const std::size_t begin = align_up(offset_);
+            if (begin + bytes <= buffer_.size()) {
+                offset_ = begin + bytes;
+                return buffer_.data() + begin;
+            }
+            overflow_blocks_.emplace_back(static_cast<std::byte*>(::operator new[](std::max<std::size_t>(bytes, 1), std::align_val_t{workspace_alignment})));
+            return overflow_blocks_.back().get();
+        }
+
+        void release() noexcept {
+            overflow_blocks_.clear();
+            offset_ = demand_ = 0;
+            buffer_.reset();
+        }
+
+        PageBuffer buffer_;
+        PageMode mode_ = PageMode::Default;
+        std::size_t offset_ = 0; // Конец занятой части области
+        std::size_t demand_ = 0; // Потребление с учетом запросов, ушедших в кучу
+        std::vector<std::unique_ptr<std::byte[], AlignedDelete>> overflow_blocks_;
+    };
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "core/topology/topology.hpp"
+
+namespace topology {
+
+    /**
+     * Раскраска элементов: элементы одного цвета не имеют общих узлов, поэтому их вклады в глобальную матрицу
+     * можно складывать параллельно без атомарных операций. Элементы цвета c - elements_[offsets_[c], offsets_[c + 1]),
+     * внутри цвета в порядке возрастания номера
+     */
+    struct ElementColoring {
+        std::vector<std::size_t> offsets_;
+        std::vector<std::size_t> elements_;
+
+        [[nodiscard]] std::size_t count_colors() const noexcept { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+        [[nodiscard]] std::size_t count_elements(std::size_t color) const noexcept { return offsets_[color + 1] - offsets_[color]; }
+    };
+
+    ///Элементы, содержащие узел: elements_[offsets_[n], offsets_[n + 1]) для узла n
+    struct NodeElements {
+        std::vector<std::size_t> offsets_;
+        std::vector<std::size_t> elements_;
+    };
+
+    template <std::size_t NodesPerElement>
+    [[nodiscard]] NodeElements node_elements(const ConnectivityView<NodesPerElement>& elements, std::size_t count_nodes) {
+        NodeElements inverse;
+        inverse.offsets_.assign(count_nodes + 1, 0);
+        for (std::size_t e = 0; e < elements.extent(0); e++)
+            for (std::size_t a = 0; a < NodesPerElement; a++)
+                inverse.offsets_[elements(e, a) + 1]++;
+        for (std::size_t n = 0; n < count_nodes; n++)
+            inverse.offsets_[n + 1] += inverse.offsets_[n];
+
+        inverse.elements_.resize(inverse.offsets_.back());
+        std::vector<std::size_t> fill(inverse.offsets_.begin(), inverse.offsets_.end() - 1);
+        for (std::size_t e = 0; e < elements.extent(0); e++)
+            for (std::size_t a = 0; a < NodesPerElement; a++)
+                inverse.elements_[fill[elements(e, a)]++] = e;
+        return inverse;
+    }
+
+    /**
+     * Жадная раскраска: элемент получает наименьший цвет, не занятый элементами с общими узлами.
+     * На структурированной сетке четырехугольников в естественном порядке дает 4 цвета
+     */
+    template <std::size_t NodesPerElement>
+    [[nodiscard]] ElementColoring color_elements(const ConnectivityView<NodesPerElement>& elements, std::size_t count_nodes) {
+        constexpr std::size_t uncolored = std::numeric_limits<std::size_t>::max();
+        const std::size_t count_elements = elements.extent(0);
+        const NodeElements inverse = node_elements(elements, count_nodes);
+
+        std::vector<std::size_t> colors(count_elements, uncolored);
+        std::vector<std::size_t> forbidden; // forbidden[c] == e - цвет c занят соседом элемента e
+        std::size_t count_colors = 0;
+        for (std::size_t e = 0; e < count_elements; e++) {
+            for (std::size_t a = 0; a < NodesPerElement; a++) {
+                const std::size_t node = elements(e, a);
+                for (std::size_t i = inverse.offsets_[node]; i < inverse.offsets_[node + 1]; i++) {
+                    const std::size_t neighbour_color = colors[inverse.elements_[i]];
+                    if (neighbour_color != uncolored)
+                        forbidden[neighbour_color] = e;
+                }
+            }
+            std::size_t color = 0;
+            while (color < count_colors && forbidden[color] == e)
+                color++;
+            if (color == count_colors) {
+                count_colors++;
+                forbidden.push_back(uncolored);
+            }
+            colors[e] = color;
+        }
+
+        ElementColoring coloring;
+        coloring.offsets_.assign(count_colors + 1, 0);
+        for (std::size_t e = 0; e < count_elements; e++)
+            coloring.offsets_[colors[e] + 1]++;
+        for (std::size_t c = 0; c < count_colors; c++)
+            coloring.offsets_[c + 1] += coloring.offsets_[c];
+        coloring.elements_.resize(count_elements);
+        std::vector<std::size_t> fill(coloring.offsets_.begin(), coloring.offsets_.end() - 1);
+        for (std::size_t e = 0; e < count_elements; e++)
+            coloring.elements_[fill[colors[e]]++] = e;
+        return coloring;
+    }
+
+}
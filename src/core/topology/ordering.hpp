@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "core/custom_concepts.hpp"
+#include "core/storage/storage.hpp"
+#include "core/topology/topology.hpp"
+
+namespace topology {
+
+    ///Способ перенумерации узлов
+    enum class NodeOrdering {
+        Natural,             // Как в генераторе: луч за лучом
+        ReverseCuthillMcKee, // Минимизация ширины ленты и профиля матрицы жесткости
+        Hilbert              // Кривая Гильберта по координатам: соседние в памяти узлы близки в пространстве
+    };
+
+    ///Обход в ширину из start по непосещенным узлам. Возвращает уровни (номер уровня каждого достигнутого узла) через levels
+    inline std::size_t bfs_levels(const NodeGraph& graph, std::size_t start, std::vector<std::size_t>& levels, std::vector<std::size_t>& queue) {
+        constexpr std::size_t unvisited = std::numeric_limits<std::size_t>::max();
+        std::fill(levels.begin(), levels.end(), unvisited);
+        queue.clear();
+        queue.push_back(start);
+        levels[start] = 0;
+        for (std::size_t head = 0; head < queue.size(); head++) {
+            const std::size_t node = queue[head];
+            for (std::size_t n = graph.offsets_[node]; n < graph.offsets_[node + 1]; n++) {
+                const std::size_t neighbour = graph.neighbours_[n];
+                if (levels[neighbour] == unvisited) {
+                    levels[neighbour] = levels[node] + 1;
+                    queue.push_back(neighbour);
+                }
+            }
+        }
+        return levels[queue.back()];
+    }
+
+    /**
+     * Псевдопериферийный узел компоненты, содержащей start (алгоритм Джорджа - Лю):
+     * из последнего уровня обхода берется узел наименьшей степени, пока эксцентриситет растет
+     */
+    [[nodiscard]] inline std::size_t pseudo_peripheral_node(const NodeGraph& graph, std::size_t start) {
+        std::vector<std::size_t> levels(graph.count_nodes());
+        std::vector<std::size_t> queue;
+        queue.reserve(graph.count_nodes());
+
+        std::size_t node = start;
+        std::size_t eccentricity = bfs_levels(graph, node, levels, queue);
+        for (;;) {
+            std::size_t candidate = queue.back();
+            for (std::size_t q = queue.size(); q-- > 0 && levels[queue[q]] == eccentricity;)
+                if (graph.degree(queue[q]) < graph.degree(candidate))
+                    candidate = queue[q];
+            const std::size_t candidate_eccentricity = bfs_levels(graph, candidate, levels, queue);
+            if (candidate_eccentricity <= eccentricity)
+                return node;
+            node = candidate;
+            eccentricity = candidate_eccentricity;
+        }
+    }
+
+    /**
+     * Обратный алгоритм Катхилла - Макки. Каждая компонента связности обходится в ширину из псевдопериферийного узла,
+     * соседи добавляются в порядке возрастания степени; итоговый порядок обращается
+     * @return new_index: new_index[старый номер] = новый номер
+     */
+    [[nodiscard]] inline std::vector<std::size_t> reverse_cuthill_mckee(const NodeGraph& graph) {
+        const std::size_t count_nodes = graph.count_nodes();
+        std::vector<bool> visited(count_nodes, false);
+        std::vector<std::size_t> order;
+        order.reserve(count_nodes);
+        std::vector<std::size_t> neighbours;
+
+        for (std::size_t seed = 0; seed < count_nodes; seed++) {
+            if (visited[seed])
+                continue;
+            const std::size_t start = pseudo_peripheral_node(graph, seed);
+            visited[start] = true;
+            order.push_back(start);
+            for (std::size_t head = order.size() - 1; head < order.size(); head++) {
+                const std::size_t node = order[head];
+                neighbours.clear();
+                for (std::size_t n = graph.offsets_[node]; n < graph.offsets_[node + 1]; n++)
+                    if (!visited[graph.neighbours_[n]])
+                        neighbours.push_back(graph.neighbours_[n]);
+                std::sort(neighbours.begin(), neighbours.end(), [&graph](std::size_t lhs, std::size_t rhs) {
+                    return graph.degree(lhs) != graph.degree(rhs) ? graph.degree(lhs) < graph.degree(rhs) : lhs < rhs;
+                });
+                for (std::size_t neighbour : neighbours) {
+                    visited[neighbour] = true;
+                    order.push_back(neighbour);
+                }
+            }
+        }
+
+        std::vector<std::size_t> new_index(count_nodes);
+        for (std::size_t position = 0; position < count_nodes; position++)
+            new_index[order[position]] = count_nodes - 1 - position;
+        return new_index;
+    }
+
+    ///Номер клетки (x, y) решетки 2^order x 2^order на кривой Гильберта
+    [[nodiscard]] constexpr std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y, unsigned order) noexcept {
+        std::uint64_t index = 0;
+        for (std::uint32_t s = std::uint32_t(1) << (order - 1); s > 0; s >>= 1) {
+            const std::uint32_t rx = (x & s) ? 1 : 0;
+            const std::uint32_t ry = (y & s) ? 1 : 0;
+            index += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+            //Поворот четверти, чтобы кривая внутри нее начиналась и заканчивалась в нужных углах
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - (x & (s - 1));
+                    y = s - 1 - (y & (s - 1));
+                }
+                std::swap(x, y);
+            }
+        }
+        return index;
+    }
+
+    /**
+     * Нумерация узлов вдоль кривой Гильберта на решетке 2^16 x 2^16, натянутой на ограничивающий прямоугольник узлов
+     * @return new_index: new_index[старый номер] = новый номер
+     */
+    template <coordinate_storage_like ContainerT>
+    [[nodiscard]] std::vector<std::size_t> hilbert_ordering(const ContainerT& coordinates) {
+        constexpr unsigned order = 16;
+        const std::size_t count_nodes = coordinates.extent(0);
+        if (count_nodes == 0)
+            return {};
+
+        double min_x = coordinates(0, 0), max_x = min_x, min_y = coordinates(0, 1), max_y = min_y;
+        for (std::size_t i = 1; i < count_nodes; i++) {
+            min_x = std::min<double>(min_x, coordinates(i, 0));
+            max_x = std::max<double>(max_x, coordinates(i, 0));
+            min_y = std::min<double>(min_y, coordinates(i, 1));
+            max_y = std::max<double>(max_y, coordinates(i, 1));
+        }
+        const double cells = double((1u << order) - 1);
+        const double scale = cells / std::max({max_x - min_x, max_y - min_y, std::numeric_limits<double>::min()});
+
+        std::vector<std::pair<std::uint64_t, std::size_t>> keys(count_nodes);
+        for (std::size_t i = 0; i < count_nodes; i++) {
+            const auto x = static_cast<std::uint32_t>((coordinates(i, 0) - min_x) * scale);
+            const auto y = static_cast<std::uint32_t>((coordinates(i, 1) - min_y) * scale);
+            keys[i] = {hilbert_index(x, y, order), i};
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<std::size_t> new_index(count_nodes);
+        for (std::size_t position = 0; position < count_nodes; position++)
+            new_index[keys[position].second] = position;
+        return new_index;
+    }
+
+    ///Ширина ленты и профиль до и после перенумерации
+    struct OrderingReport {
+        BandMetrics before_;
+        BandMetrics after_;
+    };
+
+    /**
+     * Перенумерация узлов сетки
+     * @tparam ContainerT Хранилище координат
+     * @tparam NodesPerElement
+     */
+    template <coordinate_storage_like ContainerT, std::size_t NodesPerElement>
+    struct RenumberedMesh {
+        ContainerT coordinates_;
+        ConnectivityView<NodesPerElement> elements_;
+        std::vector<std::size_t> new_index_; // new_index_[старый номер] = новый номер
+        OrderingReport report_;
+    };
+
+    /**
+     * Перенумеровать узлы сетки выбранным способом: координаты переставляются в новое хранилище,
+     * номера узлов в связности заменяются на новые. Порядок элементов не меняется
+     * @param ordering
+     * @param coordinates Узлы сетки
+     * @param elements Связность
+     * @return RenumberedMesh с отчетом о ширине ленты и профиле до и после
+     */
+    template <coordinate_storage_like ContainerT, std::size_t NodesPerElement>
+    [[nodiscard]] RenumberedMesh<ContainerT, NodesPerElement> renumber(
+                                                    NodeOrdering ordering,
+                                                    const ContainerT& coordinates,
+                                                    const ConnectivityView<NodesPerElement>& elements
+                                                    ) {
+        const std::size_t count_nodes = coordinates.extent(0);
+        const NodeGraph graph = node_graph(elements, count_nodes);
+
+        RenumberedMesh<ContainerT, NodesPerElement> result;
+        switch (ordering) {
+            case NodeOrdering::ReverseCuthillMcKee: result.new_index_ = reverse_cuthill_mckee(graph); break;
+            case NodeOrdering::Hilbert:             result.new_index_ = hilbert_ordering(coordinates); break;
+            case NodeOrdering::Natural:             result.new_index_ = natural_ordering(count_nodes); break;
+        }
+        result.report_ = OrderingReport{band_metrics(graph, natural_ordering(count_nodes)), band_metrics(graph, result.new_index_)};
+
+        result.coordinates_ = storage::allocate<ContainerT>("v", count_nodes);
+        for (std::size_t i = 0; i < count_nodes; i++) {
+            result.coordinates_(result.new_index_[i], 0) = coordinates(i, 0);
+            result.coordinates_(result.new_index_[i], 1) = coordinates(i, 1);
+        }
+        result.elements_ = ConnectivityView<NodesPerElement>(Kokkos::view_alloc(Kokkos::WithoutInitializing, "elements"), elements.extent(0));
+        for (std::size_t e = 0; e < elements.extent(0); e++)
+            for (std::size_t a = 0; a < NodesPerElement; a++)
+                result.elements_(e, a) = result.new_index_[elements(e, a)];
+        return result;
+    }
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <Kokkos_Core.hpp>
+
+namespace topology {
+
+    /**
+     * Связность элементов: строка e - номера узлов элемента e в порядке обхода против часовой стрелки
+     * @tparam NodesPerElement 4 - четырехугольники, 3 - треугольники
+     */
+    template <std::size_t NodesPerElement>
+    using ConnectivityView = Kokkos::View<std::size_t*[NodesPerElement], Kokkos::LayoutRight, Kokkos::HostSpace>;
+
+    using QuadView = ConnectivityView<4>;
+    using TriView = ConnectivityView<3>;
+
+    /**
+     * Структурированная сетка лучи x точки на луче (как у GenFrameKirsch): узел (ray_idx, point_idx) имеет номер
+     * ray_idx * count_points_on_ray + point_idx. Ячейка (ray_idx, point_idx) лежит между лучами ray_idx и ray_idx + 1
+     */
+    struct RayLayout {
+        std::size_t count_rays_;
+        std::size_t count_points_on_ray_;
+
+        [[nodiscard]] std::size_t node(std::size_t ray_idx, std::size_t point_idx) const noexcept {
+            return ray_idx * count_points_on_ray_ + point_idx;
+        }
+        [[nodiscard]] std::size_t count_nodes() const noexcept { return count_rays_ * count_points_on_ray_; }
+        [[nodiscard]] std::size_t count_cells() const noexcept { return (count_rays_ - 1) * (count_points_on_ray_ - 1); }
+
+        /**
+         * Узлы ячейки против часовой стрелки: (k, j) -> (k, j + 1) -> (k + 1, j + 1) -> (k + 1, j).
+         * Точка j + 1 дальше от центра, луч k + 1 повернут против часовой стрелки относительно луча k
+         */
+        [[nodiscard]] std::array<std::size_t, 4> cell(std::size_t ray_idx, std::size_t point_idx) const noexcept {
+            return {node(ray_idx, point_idx), node(ray_idx, point_idx + 1), node(ray_idx + 1, point_idx + 1), node(ray_idx + 1, point_idx)};
+        }
+    };
+
+    /**
+     * Граф узлов в формате CSR: соседи узла i - neighbours_[offsets_[i], offsets_[i + 1]), отсортированы, без самого узла.
+     * Узлы соседние, если входят в один элемент (совпадает с портретом матрицы жесткости)
+     */
+    struct NodeGraph {
+        std::vector<std::size_t> offsets_;
+        std::vector<std::size_t> neighbours_;
+
+        [[nodiscard]] std::size_t count_nodes() const noexcept { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+        [[nodiscard]] std::size_t degree(std::size_t node) const noexcept { return offsets_[node + 1] - offsets_[node]; }
+    };
+
+    ///Граф узлов по связности элементов
+    template <std::size_t NodesPerElement>
+    [[nodiscard]] NodeGraph node_graph(const ConnectivityView<NodesPerElement>& elements, std::size_t count_nodes) {
+        //Первый проход - верхняя оценка степени, второй - заполнение с повторами, затем сортировка и удаление повторов по строкам
+        std::vector<std::size_t> upper_offsets(count_nodes + 1, 0);
+        for (std::size_t e = 0; e < elements.extent(0); e++)
+            for (std::size_t a = 0; a < NodesPerElement; a++)
+                upper_offsets[elements(e, a) + 1] += NodesPerElement - 1;
+        for (std::size_t i = 0; i < count_nodes; i++)
+            upper_offsets[i + 1] += upper_offsets[i];
+
+        std::vector<std::size_t> raw(upper_offsets.back());
+        std::vector<std::size_t> fill(upper_offsets.begin(), upper_offsets.end() - 1);
+        for (std::size_t e = 0; e < elements.extent(0); e++)
+            for (std::size_t a = 0; a < NodesPerElement; a++)
+                for (std::size_t b = 0; b < NodesPerElement; b++)
+                    if (a != b)
+                        raw[fill[elements(e, a)]++] = elements(e, b);
+
+        NodeGraph graph;
+        graph.offsets_.assign(count_nodes + 1, 0);
+        graph.neighbours_.reserve(raw.size());
+        for (std::size_t i = 0; i < count_nodes; i++) {
+            auto row_begin = raw.begin() + upper_offsets[i];
+            auto row_end = raw.begin() + upper_offsets[i + 1];
+            std::sort(row_begin, row_end);
+            row_end = std::unique(row_begin, row_end);
+            graph.neighbours_.insert(graph.neighbours_.end(), row_begin, row_end);
+            graph.offsets_[i + 1] = graph.neighbours_.size();
+        }
+        return graph;
+    }
+
+    ///Ширина ленты и профиль матрицы с портретом graph при нумерации new_index (new_index[старый номер] = новый номер)
+    struct BandMetrics {
+        std::size_t bandwidth_; // max |i - j| по ненулевым a_ij
+        std::size_t profile_;   // Сумма по строкам i расстояний от диагонали до первого ненулевого элемента строки
+    };
+
+    [[nodiscard]] inline BandMetrics band_metrics(const NodeGraph& graph, const std::vector<std::size_t>& new_index) noexcept {
+        BandMetrics metrics{0, 0};
+        for (std::size_t node = 0; node < graph.count_nodes(); node++) {
+            const std::size_t row = new_index[node];
+            std::size_t first_column = row;
+            for (std::size_t n = graph.offsets_[node]; n < graph.offsets_[node + 1]; n++) {
+                const std::size_t column = new_index[graph.neighbours_[n]];
+                metrics.bandwidth_ = std::max(metrics.bandwidth_, column > row ? column - row : row - column);
+                first_column = std::min(first_column, column);
+            }
+            metrics.profile_ += row - first_column;
+        }
+        return metrics;
+    }
+
+    ///Тождественная нумерация (new_index[i] = i)
+    [[nodiscard]] inline std::vector<std::size_t> natural_ordering(std::size_t count_nodes) {
+        std::vector<std::size_t> new_index(count_nodes);
+        for (std::size_t i = 0; i < count_nodes; i++)
+            new_index[i] = i;
+        return new_index;
+    }
+
+}
@@ -0,0 +1,409 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <Kokkos_Core.hpp>
+#include "core/io/file.hpp"
+
+#ifndef FEM_TRACE
+#define FEM_TRACE 0
+#endif
+
+namespace trace {
+
+    ///Запись событий включается при сборке (-DFEM_TRACE=1, опция CMake ENABLE_TRACE). Без нее вызовы записи пустые и вырезаются компилятором
+    inline constexpr bool enabled = FEM_TRACE != 0;
+    ///Событий в кольцевом буфере одного потока: при переполнении затираются самые старые
+    inline constexpr std::size_t ring_capacity = std::size_t{1} << 15;
+
+    enum class EventKind : std::uint8_t {
+        Job,          // Задача пула от постановки до завершения (поток, поставивший задачу): chunk_id_ - сегментов, end_ - размер области
+        Chunk,        // Сегмент chunk_id_ задачи job_id_, границы [begin_, end_)
+        Wake,         // Задержка пробуждения: от публикации задачи main до входа потока в нее
+        WaitWorkers,  // Ожидание main, пока остальные потоки выйдут из задачи
+        Park,         // Сон потока на futex в ожидании работы
+        Steal,        // Мгновенное: украдены сегменты [begin_, end_) у потока chunk_id_
+        Region,       // Именованная область: trace::Region или регион Kokkos Tools
+        KokkosKernel  // Ядро Kokkos (parallel_for/reduce/scan) через Kokkos Tools, job_id_ - номер ядра
+    };
+
+    ///Событие трассы. name_ - строка со статическим временем жизни или результат Recorder::intern
+    struct Event {
+        std::uint64_t begin_ns_;
+        std::uint64_t end_ns_;
+        std::uint64_t job_id_;
+        std::uint64_t chunk_id_;
+        std::uint64_t begin_;
+        std::uint64_t end_;
+        const char* name_;
+        std::uint32_t tid_;
+        EventKind kind_;
+    };
+
+    ///Монотонное время в наносекундах (0, если запись выключена)
+    [[nodiscard]] inline std::uint64_t now() noexcept {
+        if constexpr (enabled)
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                        std::chrono::steady_clock::now().time_since_epoch()).count());
+        else
+            return 0;
+    }
+
+    ///Номер задачи, уникальный в процессе (общий для всех пулов)
+    [[nodiscard]] inline std::uint64_t next_job_id() noexcept {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /**
+     * Кольцевой буфер событий одного потока. Пишет только владелец (без атомарных RMW),
+     * читать снимок можно, когда владелец не пишет (пул между задачами, поток завершен)
+     */
+    class RingBuffer {
+    public:
+        ///@param capacity Округляется вверх до степени двойки
+        explicit RingBuffer(std::size_t capacity = ring_capacity)
+                : events_(std::bit_ceil(std::max<std::size_t>(capacity, 1))) {}
+
+        void push(const Event& event) noexcept {
+            const std::uint64_t count = count_.load(std::memory_order_relaxed);
+            events_[count & (events_.size() - 1)] = event;
+            count_.store(count + 1, std::memory_order_release);
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return events_.size(); }
+        ///Всего записано событий (включая затертые)
+        [[nodiscard]] std::uint64_t recorded() const noexcept { return count_.load(std::memory_order_acquire); }
+
+        ///Дописать в out сохранившиеся события в порядке записи
+        void snapshot(std::vector<Event>& out) const {
+            const std::uint64_t count = count_.load(std::memory_order_acquire);
+            const std::uint64_t first = count > events_.size() ? count - events_.size() : 0;
+            for (std::uint64_t i = first; i < count; i++)
+                out.push_back(events_[i & (events_.size() - 1)]);
+        }
+
+        void clear() noexcept { count_.store(0, std::memory_order_release); }
+
+    private:
+        std::vector<Event> events_;
+        std::atomic<std::uint64_t> count_{0};
+    };
+
+    /**
+     * Реестр буферов потоков. Буфер выдается потоку при первой записи и возвращается в реестр при завершении потока:
+     * события завершенных потоков (пул разрушен) остаются в трассе, пока буфер не достанется новому потоку.
+     * Мьютекс берется только при выдаче буфера, интернировании имен и выгрузке - не на горячем пути
+     */
+    class Recorder {
+    public:
+        [[nodiscard]] static Recorder& instance() {
+            static Recorder recorder;
+            return recorder;
+        }
+
+        [[nodiscard]] RingBuffer* acquireBuffer() {
+            std::lock_guard lock(mutex_);
+            if (!free_buffers_.empty()) {
+                RingBuffer* buffer = free_buffers_.back();
+                free_buffers_.pop_back();
+                return buffer;
+            }
+            buffers_.push_back(std::make_unique<RingBuffer>());
+            return buffers_.back().get();
+        }
+
+        void releaseBuffer(RingBuffer* buffer) {
+            std::lock_guard lock(mutex_);
+            free_buffers_.push_back(buffer);
+        }
+
+        ///Строка, живущая до конца программы (имена регионов и ядер Kokkos приходят временными)
+        [[nodiscard]] const char* intern(std::string_view name) {
+            std::lock_guard lock(mutex_);
+            return names_.emplace(name).first->c_str();
+        }
+
+        void setThreadName(std::uint32_t tid, std::string name) {
+            std::lock_guard lock(mutex_);
+            for (auto& [known_tid, known_name] : thread_names_) {
+                if (known_tid == tid) {
+                    known_name = std::move(name);
+                    return;
+                }
+            }
+            thread_names_.emplace_back(tid, std::move(name));
+        }
+
+        [[nodiscard]] std::vector<std::pair<std::uint32_t, std::string>> threadNames() const {
+            std::lock_guard lock(mutex_);
+            return thread_names_;
+        }
+
+        ///События всех буферов, упорядоченные по времени начала
+        [[nodiscard]] std::vector<Event> collect() const {
+            std::vector<Event> events;
+            {
+                std::lock_guard lock(mutex_);
+                for (const auto& buffer : buffers_)
+                    buffer->snapshot(events);
+            }
+            std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.begin_ns_ < b.begin_ns_; });
+            return events;
+        }
+
+        ///Очистка всех буферов (пул не должен выполнять задачу)
+        void clear() {
+            std::lock_guard lock(mutex_);
+            for (const auto& buffer : buffers_)
+                buffer->clear();
+        }
+
+    private:
+        Recorder() = default;
+
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<RingBuffer>> buffers_;
+        std::vector<RingBuffer*> free_buffers_;
+        std::unordered_set<std::string> names_;
+        std::vector<std::pair<std::uint32_t, std::string>> thread_names_;
+    };
+
+    ///Буфер текущего потока: выдается при первой записи, возвращается в реестр деструктором thread_local
+    struct ThreadBuffer {
+        RingBuffer* buffer_ = Recorder::instance().acquireBuffer();
+        std::uint32_t tid_ = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+
+        ThreadBuffer() = default;
+        ThreadBuffer(const ThreadBuffer&) = delete;
+        ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+        ~ThreadBuffer() { Recorder::instance().releaseBuffer(buffer_); }
+    };
+
+    [[nodiscard]] inline ThreadBuffer& thread_buffer() {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    /**
+     * Запись события в буфер текущего потока
+     * @param kind
+     * @param name Статическая строка или Recorder::intern
+     * @param begin_ns, end_ns Время начала и конца (now()); у мгновенных событий совпадают
+     */
+    inline void record(EventKind kind, const char* name, std::uint64_t begin_ns, std::uint64_t end_ns,
+                       std::uint64_t job_id = 0, std::uint64_t chunk_id = 0, std::uint64_t begin = 0, std::uint64_t end = 0) noexcept {
+        if constexpr (enabled) {
+            ThreadBuffer& buffer = thread_buffer();
+            buffer.buffer_->push(Event{begin_ns, end_ns, job_id, chunk_id, begin, end, name, buffer.tid_, kind});
+        }
+    }
+
+    ///Имя текущего потока в трассе (метаданные thread_name)
+    inline void set_thread_name(std::string name) {
+        if constexpr (enabled)
+            Recorder::instance().setThreadName(thread_buffer().tid_, std::move(name));
+    }
+
+    ///Именованная область на время жизни объекта (фазы решателя, сборка и т.п.). Без FEM_TRACE пустая
+    class Region {
+    public:
+        explicit Region(const char* name) noexcept : name_(name), begin_ns_(now()) {}
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+        ~Region() { record(EventKind::Region, name_, begin_ns_, now()); }
+
+    private:
+        const char* name_;
+        std::uint64_t begin_ns_;
+    };
+
+    ///Открытые регионы и ядра Kokkos текущего потока: Kokkos Tools сообщает только начало и конец
+    struct KokkosOpenEvent {
+        const char* name_;
+        std::uint64_t begin_ns_;
+        std::uint64_t kernel_id_;
+    };
+
+    [[nodiscard]] inline std::vector<KokkosOpenEvent>& kokkos_open_events() {
+        thread_local std::vector<KokkosOpenEvent> open_events;
+        return open_events;
+    }
+
+    inline void kokkos_push_region(const char* name) {
+        kokkos_open_events().push_back({Recorder::instance().intern(name), now(), 0});
+    }
+
+    inline void kokkos_pop_region() {
+        auto& open_events = kokkos_open_events();
+        const auto it = std::find_if(open_events.rbegin(), open_events.rend(), [](const KokkosOpenEvent& e) { return e.kernel_id_ == 0; });
+        if (it == open_events.rend())
+            return;
+        record(EventKind::Region, it->name_, it->begin_ns_, now());
+        open_events.erase(std::next(it).base());
+    }
+
+    inline void kokkos_begin_kernel(const char* name, const std::uint32_t, std::uint64_t* kernel_id) {
+        *kernel_id = next_job_id();
+        kokkos_open_events().push_back({Recorder::instance().intern(name), now(), *kernel_id});
+    }
+
+    inline void kokkos_end_kernel(std::uint64_t kernel_id) {
+        auto& open_events = kokkos_open_events();
+        const auto it = std::find_if(open_events.rbegin(), open_events.rend(), [kernel_id](const KokkosOpenEvent& e) { return e.kernel_id_ == kernel_id; });
+        if (it == open_events.rend())
+            return;
+        record(EventKind::KokkosKernel, it->name_, it->begin_ns_, now(), kernel_id);
+        open_events.erase(std::next(it).base());
+    }
+
+    /**
+     * Подключение трассы к Kokkos Tools: регионы (Kokkos::Profiling::pushRegion) и ядра parallel_for/reduce/scan
+     * попадают в те же буферы, что и события пула, и ложатся на одну шкалу времени.
+     * Заменяет обработчики загруженной через KOKKOS_TOOLS_LIBS библиотеки. Без FEM_TRACE ничего не делает
+     */
+    inline void attach_kokkos_tools() {
+        if constexpr (enabled) {
+            namespace tools = Kokkos::Tools::Experimental;
+            tools::set_push_region_callback(&kokkos_push_region);
+            tools::set_pop_region_callback(&kokkos_pop_region);
+            tools::set_begin_parallel_for_callback(&kokkos_begin_kernel);
+            tools::set_end_parallel_for_callback(&kokkos_end_kernel);
+            tools::set_begin_parallel_reduce_callback(&kokkos_begin_kernel);
+            tools::set_end_parallel_reduce_callback(&kokkos_end_kernel);
+            tools::set_begin_parallel_scan_callback(&kokkos_begin_kernel);
+            tools::set_end_parallel_scan_callback(&kokkos_end_kernel);
+        }
+    }
+
+    [[nodiscard]] constexpr const char* category_of(EventKind kind) noexcept {
+        switch (kind) {
+            case EventKind::Region: return "region";
+            case EventKind::KokkosKernel: return "kokkos";
+            default: return "pool";
+        }
+    }
+
+    ///Строка в кавычках JSON
+    inline void append_json_string(std::string& out, std::string_view value) {
+        out += '"';
+        for (const char symbol : value) {
+            if (symbol == '"' || symbol == '\\') {
+                out += '\\';
+                out += symbol;
+            } else if (static_cast<unsigned char>(symbol) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(symbol));
+                out += escaped;
+            } else {
+                out += symbol;
+            }
+        }
+        out += '"';
+    }
+
+    /**
+     * Трасса в формате Chrome Trace Event (JSON): открывается в chrome://tracing и ui.perfetto.dev.
+     * Интервальные события - "X" (ts и dur в микросекундах от первого события), кража - мгновенное "i",
+     * имена потоков - метаданные "M"
+     */
+    [[nodiscard]] inline std::string chrome_trace_json(const std::vector<Event>& events,
+                                                       const std::vector<std::pair<std::uint32_t, std::string>>& thread_names) {
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&] {
+            if (!first)
+                out += ",\n";
+            first = false;
+        };
+        for (const auto& [tid, name] : thread_names) {
+            separator();
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(tid) + ",\"args\":{\"name\":";
+            append_json_string(out, name);
+            out += "}}";
+        }
+
+        const std::uint64_t origin_ns = events.empty() ? 0 : events.front().begin_ns_;
+        char buffer[256];
+        for (const Event& event : events) {
+            separator();
+            out += "{\"name\":";
+            append_json_string(out, event.name_ != nullptr ? event.name_ : "");
+            const double ts = static_cast<double>(event.begin_ns_ - origin_ns) * 1e-3;
+            const double dur = static_cast<double>(event.end_ns_ - event.begin_ns_) * 1e-3;
+            if (event.kind_ == EventKind::Steal)
+                std::snprintf(buffer, sizeof(buffer), ",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f",
+                              category_of(event.kind_), event.tid_, ts);
+            else
+                std::snprintf(buffer, sizeof(buffer), ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                              category_of(event.kind_), event.tid_, ts, dur);
+            out += buffer;
+
+            const auto job = static_cast<unsigned long long>(event.job_id_);
+            const auto chunk = static_cast<unsigned long long>(event.chunk_id_);
+            const auto begin = static_cast<unsigned long long>(event.begin_);
+            const auto end = static_cast<unsigned long long>(event.end_);
+            switch (event.kind_) {
+                case EventKind::Job:
+                    std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"job\":%llu,\"chunks\":%llu,\"size\":%llu}}", job, chunk, end);
+                    break;
+                case EventKind::Chunk:
+                    std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"job\":%llu,\"chunk\":%llu,\"begin\":%llu,\"end\":%llu}}", job, chunk, begin, end);
+                    break;
+                case EventKind::Steal:
+                    std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"job\":%llu,\"victim\":%llu,\"begin\":%llu,\"end\":%llu}}", job, chunk, begin, end);
+                    break;
+                case EventKind::Region:
+                    std::snprintf(buffer, sizeof(buffer), "}");
+                    break;
+                case EventKind::KokkosKernel:
+                    std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"kernel\":%llu}}", job);
+                    break;
+                default:
+                    std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"job\":%llu}}", job);
+                    break;
+            }
+            out += buffer;
+        }
+        out += "]}\n";
+        return out;
+    }
+
+    ///Трасса всех потоков процесса (Recorder::collect)
+    [[nodiscard]] inline std::string chrome_trace_json() {
+        const Recorder& recorder = Recorder::instance();
+        return chrome_trace_json(recorder.collect(), recorder.threadNames());
+    }
+
+    /**
+     * Выгрузка трассы в файл. Вызывать, когда пулы не выполняют задачи
+     * @return 0 или errno
+     */
+    [[nodiscard]] inline int write_chrome_trace(const std::string& path) {
+        const std::string json = chrome_trace_json();
+        io::FileDescriptor file = io::create_file(path);
+        if (!file)
+            return errno;
+        return io::pwrite_all(file.get(), json.data(), json.size(), 0);
+    }
+
+    ///Очистка буферов всех потоков (пулы не должны выполнять задачи)
+    inline void reset() {
+        Recorder::instance().clear();
+    }
+
+}
@@ -1,10 +1,44 @@
 #pragma once
 
 #include "core/custom_concepts.hpp"
+#include "core/fem/boundary.hpp"
+#include "core/fem/elasticity.hpp"
+#include "core/fem/estimator.hpp"
+#include "core/fem/kirsch.hpp"
 #include "core/geometry/geometry.hpp"
+#include "core/io/binary.hpp"
+#include "core/io/fields.hpp"
+#include "core/io/file.hpp"
+#include "core/io/vtu.hpp"
 #include "core/kernels/kernels.hpp"
 #include "core/math/math_helper.hpp"
+#include "core/solvers/cg.hpp"
+#include "core/solvers/pardiso.hpp"
+#include "core/sparse/csr_matrix.hpp"
+#include "core/storage/implicit.hpp"
+#include "core/storage/pages.hpp"
+#include "core/storage/storage.hpp"
+#include "core/storage/workspace.hpp"
+#include "core/topology/coloring.hpp"
+#include "core/topology/topology.hpp"
+#include "core/topology/ordering.hpp"
+#include "core/trace/trace.hpp"
 
+#include "solutions/custom_pthreads/affinity.hpp"
+#include "solutions/custom_pthreads/assembly/assembly.hpp"
+#include "solutions/custom_pthreads/executor.hpp"
 #include "solutions/custom_pthreads/grid/grid.hpp"
+#include "solutions/custom_pthreads/io/writers.hpp"
+#include "solutions/custom_pthreads/matrix_free/elasticity_operator.hpp"
+#include "solutions/custom_pthreads/mesh/adaptive.hpp"
+#include "solutions/custom_pthreads/mesh/cache.hpp"
+#include "solutions/custom_pthreads/mesh/implicit.hpp"
 #include "solutions/custom_pthreads/mesh/mesh.hpp"
-#include "solutions/custom_pthreads/pthreads_manage.hpp"
\ No newline at end of file
+#include "solutions/custom_pthreads/mesh/connectivity.hpp"
+#include "solutions/custom_pthreads/mesh/fixed.hpp"
+#include "solutions/custom_pthreads/mesh/quality.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+#include "solutions/custom_kokkos/grid/grid.hpp"
+#include "solutions/custom_kokkos/mesh/mesh.hpp"
+#include "solutions/custom_tbb/grid/grid.hpp"
+#include "solutions/custom_tbb/mesh/mesh.hpp"
@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/kernels/kernels.hpp"
+#include "core/storage/storage.hpp"
+
+namespace custom_kokkos::grid {
+
+    ///Точек на одну итерацию parallel_for: целое число отрезков пересчета степени, чтобы fast_pow вызывался один раз на итерацию
+    inline constexpr std::size_t points_per_iteration = kernels::simd_block_size * kernels::pow_reanchor_blocks;
+
+    /**
+     * Генерация сетки на луче через Kokkos::parallel_for. Результат побитово совпадает с grid::GenNonUniformOnRay
+     * @tparam ContainerT Хранилище точек луча
+     * @tparam ExecSpace Пространство исполнения хоста (Serial, OpenMP, Threads)
+     * @tparam ComputeT Тип, в котором считаются координаты
+     */
+    template <coordinate_storage_like ContainerT,
+              kokkos_host_execution_space ExecSpace = Kokkos::DefaultHostExecutionSpace,
+              scalar ComputeT = storage::scalar_t<ContainerT>>
+    class GenNonUniformOnRay {
+        using ScalarT = ComputeT;
+    public:
+        /**
+         * Функция для генерации сетки на луче на основе геометрической прогрессии
+         * (x, y) = (x_0, y_0) + (V_x, V_y) * (b-a) * t уравнение прямой, где t = (1 - r^i) / 1 - r^N
+         * Итерация RangePolicy заполняет points_per_iteration подряд идущих точек. Возврат после fence
+         * @param space Экземпляр пространства исполнения
+         * @param normalized_direction_ray Вектор направления луча
+         * @param start_point_grid Точка на луче, с которой начинается заполнение сетки (должна лежать на направляющем векторе)
+         * @param end_point_grid Точка на луче, на которой заканчивается заполнение сетки (должна лежать на направляющем векторе)
+         * @param multiplier_q Основание геометрической прогрессии для роста сетки
+         * @param ray_storage
+         */
+        void operator() (
+                    const ExecSpace &space,
+                    const geometry::Point2D<ScalarT> &normalized_direction_ray,
+                    const geometry::Point2D<ScalarT> &start_point_grid,
+                    const geometry::Point2D<ScalarT> &end_point_grid,
+                    ScalarT multiplier_q,
+                    ContainerT ray_storage
+                    ) const {
+            const std::size_t grid_size = ray_storage.extent(0);
+            const ScalarT denominator = ScalarT(1) - std::pow(multiplier_q, grid_size - 1);
+            const std::size_t count_iterations = (grid_size + points_per_iteration - 1) / points_per_iteration;
+            const geometry::Point2D<ScalarT> direction = normalized_direction_ray;
+            const geometry::Point2D<ScalarT> start_point = start_point_grid;
+            const geometry::Point2D<ScalarT> end_point = end_point_grid;
+
+            Kokkos::parallel_for(
+                        "custom_kokkos::GenNonUniformOnRay",
+                        Kokkos::RangePolicy<ExecSpace, Kokkos::IndexType<std::size_t>>(space, std::size_t{0}, count_iterations),
+                        KOKKOS_LAMBDA(const std::size_t iteration) {
+                            const std::size_t begin = iteration * points_per_iteration;
+                            const std::size_t end = std::min(begin + points_per_iteration, grid_size);
+                            kernels::fill_ray_segment_nonuniform(
+                                            direction,
+                                            start_point,
+                                            end_point,
+                                            multiplier_q,
+                                            denominator,
+                                            begin,
+                                            storage::subrange(ray_storage, begin, end)
+                                            );
+                        });
+            space.fence("custom_kokkos::GenNonUniformOnRay");
+        }
+
+        ///То же на экземпляре пространства исполнения по умолчанию
+        void operator() (
+                    const geometry::Point2D<ScalarT> &normalized_direction_ray,
+                    const geometry::Point2D<ScalarT> &start_point_grid,
+                    const geometry::Point2D<ScalarT> &end_point_grid,
+                    ScalarT multiplier_q,
+                    ContainerT ray_storage
+                    ) const {
+            (*this)(ExecSpace{}, normalized_direction_ray, start_point_grid, end_point_grid, multiplier_q, ray_storage);
+        }
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/storage/storage.hpp"
+#include "solutions/custom_kokkos/grid/grid.hpp"
+
+namespace custom_kokkos::mesh {
+
+    /**
+     * @tparam ContainerT Хранилище сетки (раскладка и тип хранения координат)
+     * @tparam ExecSpace Пространство исполнения хоста (Serial, OpenMP, Threads)
+     * @tparam ComputeT Тип, в котором считаются координаты
+     */
+    template <coordinate_storage_like ContainerT,
+              kokkos_host_execution_space ExecSpace = Kokkos::DefaultHostExecutionSpace,
+              scalar ComputeT = storage::scalar_t<ContainerT>>
+    struct GenFrameKirsch {
+        using ScalarT = ComputeT;
+        /**
+         * Генерация сетки через TeamPolicy: одна команда на луч, потоки команды делят точки луча (TeamThreadRange).
+         * Раскладка лучей в памяти и результат побитово совпадают с mesh::GenFrameKirsch
+         * @param space Экземпляр пространства исполнения
+         * @param radius_hole
+         * @param side_size Размер стороны пластины (пластина квадратная)
+         * @param multiplier_q Основание геометрической прогрессии (q != 1)
+         * @param count_points_on_hole Количество точек на отверстии (= количество лучей, >= 2)
+         * @param count_points_on_ray Количество точек на луче (>= 2)
+         * @return ContainerT
+         */
+        [[nodiscard]] ContainerT operator() (
+                        const ExecSpace &space,
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) const;
+
+        ///То же на экземпляре пространства исполнения по умолчанию
+        [[nodiscard]] ContainerT operator() (
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) const {
+            return (*this)(ExecSpace{}, radius_hole, side_size, multiplier_q, count_points_on_hole, count_points_on_ray);
+        }
+    };
+
+}
+
+#include "mesh_impl.tpp"
@@ -0,0 +1,69 @@
+#pragma once
+#include <algorithm>
+#include <numbers>
+
+namespace custom_kokkos::mesh {
+
+    template <coordinate_storage_like ContainerT, kokkos_host_execution_space ExecSpace, scalar ComputeT>
+    ContainerT GenFrameKirsch<ContainerT, ExecSpace, ComputeT>::operator() (
+                                const ExecSpace &space,
+                                ScalarT radius_hole,
+                                ScalarT side_size,
+                                ScalarT multiplier_q,
+                                std::size_t count_points_on_hole,
+                                std::size_t count_points_on_ray
+                                ) const {
+        using p_type = geometry::Point2D<ScalarT>;
+        using policy_type = Kokkos::TeamPolicy<ExecSpace>;
+        constexpr std::size_t points_per_iteration = grid::points_per_iteration;
+
+        auto mesh_storage = storage::allocate<ContainerT>("v", count_points_on_hole * count_points_on_ray);
+
+        //Точки на отверстии считаются так же, как в pthreads версии, чтобы лучи совпадали побитово
+        auto hole_grid_tmp = storage::allocate<storage::AoSView<ScalarT>>("v", count_points_on_hole);
+        kernels::fill_circle_arc_uniform(ScalarT(0.0), ScalarT(std::numbers::pi/2.0), radius_hole, hole_grid_tmp);
+
+        const p_type zero_point{ScalarT(0.0), ScalarT(0.0)}; // Все лучи выпускаются из точки (0,0)
+        const p_type first_point_right_edge{side_size, ScalarT(0.0)};
+        const p_type first_point_up_edge{ScalarT(0.0), side_size};
+        const p_type second_point_edge{side_size, side_size}; // Вторая точка у обоих границ общая
+        const std::size_t count_iterations_on_ray = (count_points_on_ray + points_per_iteration - 1) / points_per_iteration;
+
+        Kokkos::parallel_for(
+                    "custom_kokkos::GenFrameKirsch",
+                    policy_type(space, count_points_on_hole, Kokkos::AUTO),
+                    KOKKOS_LAMBDA(const typename policy_type::member_type &team) {
+                        const std::size_t ray_idx = team.league_rank();
+                        const p_type hole_point{hole_grid_tmp(ray_idx, 0), hole_grid_tmp(ray_idx, 1)};
+                        //Граница пластины выбирается по точке на отверстии: до 45 градусов - правая, после - верхняя
+                        const p_type first_point_edge = (hole_point.y <= hole_point.x) ? first_point_right_edge : first_point_up_edge;
+                        const auto frame = kernels::make_ray_frame(
+                                                        zero_point,
+                                                        hole_point,
+                                                        first_point_edge,
+                                                        second_point_edge,
+                                                        multiplier_q,
+                                                        count_points_on_ray
+                                                        );
+                        auto ray_storage = storage::subrange(mesh_storage, ray_idx * count_points_on_ray, (ray_idx + 1) * count_points_on_ray);
+
+                        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, count_iterations_on_ray), [&](const std::size_t iteration) {
+                            const std::size_t begin = iteration * points_per_iteration;
+                            const std::size_t end = std::min(begin + points_per_iteration, count_points_on_ray);
+                            kernels::fill_ray_segment_nonuniform(
+                                            frame.normalized_direction_,
+                                            frame.start_point_,
+                                            frame.end_point_,
+                                            multiplier_q,
+                                            frame.denominator_,
+                                            begin,
+                                            storage::subrange(ray_storage, begin, end)
+                                            );
+                        });
+                    });
+        space.fence("custom_kokkos::GenFrameKirsch");
+
+        return mesh_storage;
+    }
+
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace pthreads_manage {
+
+    ///Логический процессор, доступный процессу
+    struct CpuInfo {
+        int cpu_ = 0;     // Номер для sched_setaffinity
+        int core_ = 0;    // Физическое ядро внутри пакета (логические процессоры одного ядра - SMT-соседи)
+        int package_ = 0; // Сокет
+    };
+
+    ///Способ закрепления рабочих потоков пула за процессорами
+    enum class Affinity {
+        None,     // Не закреплять: потоки наследуют маску процесса, планировщик двигает их сам
+        Compact,  // Подряд: SMT-соседи одного ядра, затем следующее ядро того же пакета (общие кэши, меньше трафика между сокетами)
+        Scatter,  // По кругу между пакетами, внутри пакета сначала по одному потоку на ядро (больше суммарной пропускной способности памяти)
+        SmtAware  // Сначала по одному потоку на каждое физическое ядро, SMT-соседи - только когда ядра кончились
+    };
+
+    namespace detail {
+        ///Целое из файла sysfs/cgroup, fallback - если файла нет или он не читается
+        inline int read_int_file(const std::string& path, int fallback) noexcept {
+            std::FILE* file = std::fopen(path.c_str(), "r");
+            if (file == nullptr)
+                return fallback;
+            int value = fallback;
+            if (std::fscanf(file, "%d", &value) != 1)
+                value = fallback;
+            std::fclose(file);
+            return value;
+        }
+
+        ///Каталог cgroup v2 процесса (строка "0::/path" из /proc/self/cgroup), пустая строка - если cgroup v1 или файла нет
+        inline std::string cgroup_directory() {
+            std::FILE* file = std::fopen("/proc/self/cgroup", "r");
+            if (file == nullptr)
+                return {};
+            std::string directory;
+            char line[4096];
+            while (std::fgets(line, sizeof(line), file) != nullptr) {
+                if (std::strncmp(line, "0::", 3) != 0)
+                    continue;
+                directory = line + 3;
+                while (!directory.empty() && (directory.back() == '\n' || directory.back() == '/'))
+                    directory.pop_back();
+                directory.insert(0, "/sys/fs/cgroup");
+                break;
+            }
+            std::fclose(file);
+            return directory;
+        }
+    }
+
+    /**
+     * Процессоры из маски sched_getaffinity процесса (то, что оставили cpuset контейнера, taskset, numactl) с их ядрами и пакетами.
+     * Номера ядер и пакетов читаются из /sys/devices/system/cpu/cpuN/topology; без sysfs каждый процессор - отдельное ядро пакета 0
+     */
+    class CpuTopology {
+    public:
+        CpuTopology() = default;
+
+        ///Явный набор процессоров (для разбиения между пулами и тестов), порядок не важен
+        explicit CpuTopology(std::vector<CpuInfo> cpus) : cpus_(std::move(cpus)) {
+            std::sort(cpus_.begin(), cpus_.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                return std::tie(a.package_, a.core_, a.cpu_) < std::tie(b.package_, b.core_, b.cpu_);
+            });
+        }
+
+        ///Доступные процессу процессоры. Если sched_getaffinity не сработал - все онлайн-процессоры
+        [[nodiscard]] static CpuTopology discover() {
+            std::vector<CpuInfo> cpus;
+            for (const int cpu : available_cpus()) {
+                const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+                cpus.push_back(CpuInfo{cpu,
+                                       detail::read_int_file(topology + "core_id", cpu),
+                                       detail::read_int_file(topology + "physical_package_id", 0)});
+            }
+            return CpuTopology(std::move(cpus));
+        }
+
+        ///Номера процессоров из маски процесса по возрастанию
+        [[nodiscard]] static std::vector<int> available_cpus() {
+            std::vector<int> cpus;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                    if (CPU_ISSET(cpu, &set))
+                        cpus.push_back(cpu);
+            }
+            if (cpus.empty()) {
+                const long count_online = sysconf(_SC_NPROCESSORS_ONLN);
+                for (int cpu = 0; cpu < std::max(count_online, 1L); ++cpu)
+                    cpus.push_back(cpu);
+            }
+            return cpus;
+        }
+
+        ///Процессоры, упорядоченные по (пакет, ядро, номер): SMT-соседи стоят подряд
+        [[nodiscard]] const std::vector<CpuInfo>& cpus() const noexcept { return cpus_; }
+        [[nodiscard]] std::size_t size() const noexcept { return cpus_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return cpus_.empty(); }
+
+        [[nodiscard]] std::size_t countCores() const noexcept {
+            return count_distinct([](const CpuInfo& a, const CpuInfo& b) { return a.package_ == b.package_ && a.core_ == b.core_; });
+        }
+        [[nodiscard]] std::size_t countPackages() const noexcept {
+            return count_distinct([](const CpuInfo& a, const CpuInfo& b) { return a.package_ == b.package_; });
+        }
+
+        /**
+         * Порядок, в котором потоки занимают процессоры при данной политике (для None - порядок Compact)
+         * @return Номера процессоров, каждый доступный ровно один раз
+         */
+        [[nodiscard]] std::vector<int> order(Affinity affinity) const {
+            std::vector<int> result;
+            result.reserve(cpus_.size());
+            if (affinity == Affinity::None || affinity == Affinity::Compact) {
+                for (const CpuInfo& info : cpus_)
+                    result.push_back(info.cpu_);
+                return result;
+            }
+
+            //Ранг процессора внутри своего ядра (0 - первый SMT-сосед) и номер ядра внутри пакета
+            std::vector<std::size_t> smt_rank(cpus_.size()), core_rank(cpus_.size());
+            for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                const bool same_core = i > 0 && cpus_[i - 1].package_ == cpus_[i].package_ && cpus_[i - 1].core_ == cpus_[i].core_;
+                const bool same_package = i > 0 && cpus_[i - 1].package_ == cpus_[i].package_;
+                smt_rank[i] = same_core ? smt_rank[i - 1] + 1 : 0;
+                core_rank[i] = !same_package ? 0 : core_rank[i - 1] + (same_core ? 0 : 1);
+            }
+            std::vector<std::size_t> indices(cpus_.size());
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                indices[i] = i;
+            if (affinity == Affinity::SmtAware) {
+                std::stable_sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) { return smt_rank[a] < smt_rank[b]; });
+            } else {
+                std::stable_sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) {
+                    return std::tie(smt_rank[a], core_rank[a]) < std::tie(smt_rank[b], core_rank[b]);
+                });
+            }
+            for (const std::size_t i : indices)
+                result.push_back(cpus_[i].cpu_);
+            return result;
+        }
+
+        /**
+         * Разбиение на count_parts непересекающихся наборов для нескольких пулов в одном процессе.
+         * Делятся целые физические ядра (SMT-соседи не расходятся по разным пулам), соседние ядра - в один набор.
+         * Если ядер меньше, чем частей, наборы делят процессоры по кругу, а при нехватке и процессоров - повторяются
+         */
+        [[nodiscard]] std::vector<CpuTopology> partition(std::size_t count_parts) const {
+            std::vector<CpuTopology> parts(std::max<std::size_t>(count_parts, 1));
+            if (cpus_.empty())
+                return parts;
+            const std::size_t count_cores = countCores();
+            if (count_cores >= parts.size()) {
+                std::size_t core = 0;
+                for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                    if (i > 0 && (cpus_[i - 1].package_ != cpus_[i].package_ || cpus_[i - 1].core_ != cpus_[i].core_))
+                        ++core;
+                    parts[core * parts.size() / count_cores].cpus_.push_back(cpus_[i]);
+                }
+            } else {
+                for (std::size_t i = 0; i < cpus_.size(); ++i)
+                    parts[i % parts.size()].cpus_.push_back(cpus_[i]);
+                for (std::size_t part = cpus_.size(); part < parts.size(); ++part)
+                    parts[part].cpus_.push_back(cpus_[part % cpus_.size()]);
+            }
+            return parts;
+        }
+
+    private:
+        template <class SameF>
+        [[nodiscard]] std::size_t count_distinct(SameF same) const noexcept {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < cpus_.size(); ++i)
+                if (i == 0 || !same(cpus_[i - 1], cpus_[i]))
+                    ++count;
+            return count;
+        }
+
+        std::vector<CpuInfo> cpus_;
+    };
+
+    /**
+     * Ограничение cgroup v2 на процессорное время (cpu.max = "квота период") в целых процессорах с округлением вверх.
+     * 0 - ограничения нет ("max", cgroup v1 или файл не читается)
+     */
+    [[nodiscard]] inline std::size_t cgroup_cpu_limit() {
+        const std::string directory = detail::cgroup_directory();
+        if (directory.empty())
+            return 0;
+        std::FILE* file = std::fopen((directory + "/cpu.max").c_str(), "r");
+        if (file == nullptr)
+            return 0;
+        long quota = 0, period = 0;
+        const int count_read = std::fscanf(file, "%ld %ld", &quota, &period);
+        std::fclose(file);
+        if (count_read != 2 || quota <= 0 || period <= 0)
+            return 0;
+        return static_cast<std::size_t>((quota + period - 1) / period);
+    }
+
+    ///Число потоков по умолчанию: процессоры из маски процесса, но не больше квоты cgroup
+    [[nodiscard]] inline std::size_t count_usable_cpus() {
+        const std::size_t count_available = CpuTopology::available_cpus().size();
+        const std::size_t limit = cgroup_cpu_limit();
+        return limit == 0 ? count_available : std::max<std::size_t>(std::min(count_available, limit), 1);
+    }
+
+    ///Закрепление потока с атрибутами attr за одним процессором
+    inline void set_thread_cpu(pthread_attr_t& attr, int cpu) noexcept {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+
+}
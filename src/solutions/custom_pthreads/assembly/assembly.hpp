@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/fem/elasticity.hpp"
+#include "core/sparse/csr_matrix.hpp"
+#include "core/storage/storage.hpp"
+#include "core/topology/coloring.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace assembly {
+
+    ///Узлы, связанные с узлом node через общие элементы (вместе с ним самим), по возрастанию
+    template <std::size_t NodesPerElement>
+    void node_row_pattern(
+                    const topology::ConnectivityView<NodesPerElement>& elements,
+                    const topology::NodeElements& inverse,
+                    std::size_t node,
+                    std::vector<std::size_t>& row
+                    ) {
+        row.clear();
+        for (std::size_t i = inverse.offsets_[node]; i < inverse.offsets_[node + 1]; i++)
+            for (std::size_t a = 0; a < NodesPerElement; a++)
+                row.push_back(elements(inverse.elements_[i], a));
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+    }
+
+    template <std::size_t NodesPerElement>
+    struct KernelArgsPattern {
+        topology::ConnectivityView<NodesPerElement> elements_;
+        const topology::NodeElements* inverse_;
+        sparse::CsrMatrix* matrix_;
+        std::vector<std::size_t>* node_row_sizes_; // Первый проход: число соседних узлов (с самим узлом)
+    };
+
+    template <std::size_t NodesPerElement, coordinate_source_like ContainerT>
+    struct KernelArgsScatter {
+        ContainerT mesh_;
+        topology::ConnectivityView<NodesPerElement> elements_;
+        const std::size_t* color_elements_; // Элементы текущего цвета
+        fem::ElasticityMatrix D_;
+        double thickness_;
+        sparse::CsrMatrix* matrix_;
+    };
+
+    /**
+     * Вклад элементов [range.begin_, range.end_) одного цвета в значения матрицы. Элементы одного цвета не имеют общих узлов,
+     * поэтому строки, в которые пишут разные потоки, не пересекаются
+     */
+    template <std::size_t NodesPerElement, coordinate_source_like ContainerT>
+    void scatterDispatch(pthreads_manage::IndexRange range, const KernelArgsScatter<NodesPerElement, ContainerT>& args) noexcept {
+        sparse::CsrMatrix& matrix = *args.matrix_;
+        for (std::size_t i = range.begin_; i < range.end_; i++) {
+            const std::size_t e = args.color_elements_[i];
+            std::array<std::size_t, NodesPerElement> nodes{};
+            std::array<double, NodesPerElement> x{}, y{};
+            for (std::size_t a = 0; a < NodesPerElement; a++) {
+                nodes[a] = args.elements_(e, a);
+                x[a] = static_cast<double>(args.mesh_(nodes[a], 0));
+                y[a] = static_cast<double>(args.mesh_(nodes[a], 1));
+            }
+            const auto stiffness = fem::element_stiffness<NodesPerElement>(x, y, args.D_, args.thickness_);
+
+            for (std::size_t a = 0; a < NodesPerElement; a++) {
+                //Строки u_x и u_y узла имеют одинаковые столбцы, поэтому позиция ищется один раз в первой строке узла
+                const auto first_row = static_cast<MKL_INT>(fem::dofs_per_node * nodes[a]);
+                const std::size_t row_length = matrix.row_offsets_[first_row + 1] - matrix.row_offsets_[first_row];
+                for (std::size_t b = 0; b < NodesPerElement; b++) {
+                    //Столбцы узла b (u_x, u_y) стоят в строке подряд
+                    const std::size_t position = matrix.find(first_row, static_cast<MKL_INT>(fem::dofs_per_node * nodes[b]));
+                    for (std::size_t c = 0; c < fem::dofs_per_node; c++)
+                        for (std::size_t d = 0; d < fem::dofs_per_node; d++)
+                            matrix.values_[position + c * row_length + d] += stiffness[fem::dofs_per_node * a + c][fem::dofs_per_node * b + d];
+                }
+            }
+        }
+    }
+
+    /**
+     * Сборка глобальной матрицы жесткости плоской задачи теории упругости (плоское напряженное состояние).
+     * Портрет CSR и раскраска элементов строятся один раз в конструкторе, assemble заполняет значения и может
+     * вызываться повторно (другой материал, сдвинутые узлы при той же связности).
+     * Строки портрета считаются параллельно по узлам (два прохода: размеры строк, затем столбцы),
+     * значения - по цветам: элементы одного цвета делятся между потоками, вклады пишутся без атомарных операций
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     * @tparam NodesPerElement 4 - четырехугольники, 3 - треугольники
+     */
+    template <execution_policy Policy, std::size_t NodesPerElement>
+    class StiffnessAssembler {
+    public:
+        /**
+         * @param pthreads_pool
+         * @param elements Связность (узлы против часовой стрелки)
+         * @param count_nodes Количество узлов сетки
+         */
+        StiffnessAssembler(pthreads_manage::Pool &pthreads_pool, topology::ConnectivityView<NodesPerElement> elements, std::size_t count_nodes)
+                : elements_(elements),
+                  count_nodes_(count_nodes),
+                  coloring_(topology::color_elements(elements, count_nodes)) {
+            buildPattern(pthreads_pool);
+        }
+
+        [[nodiscard]] const topology::ElementColoring& coloring() const noexcept { return coloring_; }
+
+        ///Матрица с портретом сборки и нулевыми значениями, без handle
+        [[nodiscard]] sparse::CsrMatrix pattern() const {
+            sparse::CsrMatrix matrix;
+            matrix.count_rows_ = pattern_.count_rows_;
+            matrix.row_offsets_ = pattern_.row_offsets_;
+            matrix.col_indices_ = pattern_.col_indices_;
+            matrix.values_.assign(pattern_.col_indices_.size(), 0.0);
+            return matrix;
+        }
+
+        /**
+         * Заполнить значения matrix (портрет из pattern()) и пересоздать handle MKL
+         * @param pthreads_pool
+         * @param mesh Узлы сетки
+         * @param material
+         * @param matrix Матрица с портретом этого сборщика
+         * @return Статус создания handle: при ошибке handle_ пуст, и матрицу нельзя отдавать в SparseOperator
+         */
+        template <coordinate_source_like ContainerT>
+        [[nodiscard]] sparse_status_t assemble(
+                        pthreads_manage::Pool &pthreads_pool,
+                        const ContainerT& mesh,
+                        const fem::Material& material,
+                        sparse::CsrMatrix& matrix
+                        ) const {
+            matrix.handle_.reset();
+            sparse::CsrMatrix* matrix_ptr = &matrix;
+            const std::size_t count_values = matrix.values_.size();
+            pthreads_manage::Environment zero_env{
+                                    [](pthreads_manage::IndexRange range, std::size_t, sparse::CsrMatrix* m) noexcept {
+                                        std::fill(m->values_.begin() + range.begin_, m->values_.begin() + range.end_, 0.0);
+                                    },
+                                    matrix_ptr,
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{count_values, pthreads_pool.template rangeChunkSize<Policy>(count_values), 0}
+                                    };
+            pthreads_pool.template dispatchRange<Policy>(count_values, zero_env);
+
+            using args_type = KernelArgsScatter<NodesPerElement, ContainerT>;
+            for (std::size_t color = 0; color < coloring_.count_colors(); color++) {
+                const std::size_t count_elements = coloring_.count_elements(color);
+                pthreads_manage::Environment env{
+                                        [](pthreads_manage::IndexRange range, std::size_t, const args_type& args) noexcept {
+                                            scatterDispatch<NodesPerElement, ContainerT>(range, args);
+                                        },
+                                        args_type{
+                                                mesh,
+                                                elements_,
+                                                coloring_.elements_.data() + coloring_.offsets_[color],
+                                                fem::plane_stress(material),
+                                                material.thickness_,
+                                                matrix_ptr
+                                            },
+                                        [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                        pthreads_manage::PartitionerSettings{count_elements, pthreads_pool.template rangeChunkSize<Policy>(count_elements), 0}
+                                        };
+                pthreads_pool.template dispatchRange<Policy>(count_elements, env);
+            }
+            return matrix.make_handle();
+        }
+
+        /**
+         * Собранная матрица с handle MKL
+         * @param status Статус создания handle (как у assemble)
+         */
+        template <coordinate_source_like ContainerT>
+        [[nodiscard]] sparse::CsrMatrix operator() (pthreads_manage::Pool &pthreads_pool, const ContainerT& mesh, const fem::Material& material,
+                                                    sparse_status_t& status) const {
+            sparse::CsrMatrix matrix = pattern();
+            status = assemble(pthreads_pool, mesh, material, matrix);
+            return matrix;
+        }
+
+    private:
+        void buildPattern(pthreads_manage::Pool &pthreads_pool) {
+            const topology::NodeElements inverse = topology::node_elements(elements_, count_nodes_);
+            std::vector<std::size_t> node_row_sizes(count_nodes_);
+            KernelArgsPattern<NodesPerElement> args{elements_, &inverse, &pattern_, &node_row_sizes};
+            const pthreads_manage::PartitionerSettings settings{count_nodes_, pthreads_pool.template rangeChunkSize<Policy>(count_nodes_), 0};
+            auto identity = [](const pthreads_manage::PartitionerSettings& s) noexcept { return s; };
+
+            //Первый проход: размеры строк
+            pthreads_manage::Environment count_env{
+                                    [](pthreads_manage::IndexRange range, std::size_t, const KernelArgsPattern<NodesPerElement>& a) noexcept {
+                                        std::vector<std::size_t> row;
+                                        for (std::size_t node = range.begin_; node < range.end_; node++) {
+                                            node_row_pattern(a.elements_, *a.inverse_, node, row);
+                                            (*a.node_row_sizes_)[node] = row.size();
+                                        }
+                                    },
+                                    args, identity, settings
+                                    };
+            pthreads_pool.template dispatchRange<Policy>(count_nodes_, count_env);
+
+            //Строки степеней свободы узла n: dofs_per_node строк по dofs_per_node * size(n) столбцов
+            pattern_.count_rows_ = static_cast<MKL_INT>(fem::dofs_per_node * count_nodes_);
+            pattern_.row_offsets_.assign(pattern_.count_rows_ + 1, 0);
+            for (std::size_t node = 0; node < count_nodes_; node++)
+                for (std::size_t c = 0; c < fem::dofs_per_node; c++) {
+                    const std::size_t row = fem::dofs_per_node * node + c;
+                    pattern_.row_offsets_[row + 1] = pattern_.row_offsets_[row] + static_cast<MKL_INT>(fem::dofs_per_node * node_row_sizes[node]);
+                }
+            pattern_.col_indices_.resize(pattern_.row_offsets_.back());
+
+            //Второй проход: столбцы
+            pthreads_manage::Environment fill_env{
+                                    [](pthreads_manage::IndexRange range, std::size_t, const KernelArgsPattern<NodesPerElement>& a) noexcept {
+                                        std::vector<std::size_t> row;
+                                        for (std::size_t node = range.begin_; node < range.end_; node++) {
+                                            node_row_pattern(a.elements_, *a.inverse_, node, row);
+                                            for (std::size_t c = 0; c < fem::dofs_per_node; c++) {
+                                                MKL_INT position = a.matrix_->row_offsets_[fem::dofs_per_node * node + c];
+                                                for (std::size_t neighbour : row)
+                                                    for (std::size_t d = 0; d < fem::dofs_per_node; d++)
+                                                        a.matrix_->col_indices_[position++] = static_cast<MKL_INT>(fem::dofs_per_node * neighbour + d);
+                                            }
+                                        }
+                                    },
+                                    args, identity, settings
+                                    };
+            pthreads_pool.template dispatchRange<Policy>(count_nodes_, fill_env);
+        }
+
+        topology::ConnectivityView<NodesPerElement> elements_;
+        std::size_t count_nodes_;
+        topology::ElementColoring coloring_;
+        sparse::CsrMatrix pattern_; // Только row_offsets_ и col_indices_
+    };
+
+}
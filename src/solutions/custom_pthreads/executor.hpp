@@ -0,0 +1,227 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "core/trace/trace.hpp"
+#include "solutions/custom_pthreads/affinity.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace pthreads_manage {
+
+    namespace detail {
+        ///Задача со стертым типом. В отличие от std::function не требует копируемости: захват может владеть ресурсами
+        struct JobBase {
+            virtual ~JobBase() = default;
+            virtual void run(Pool& pthreads_pool) noexcept = 0;
+        };
+
+        template <class JobF>
+        struct JobHolder final : JobBase {
+            JobF job_;
+            explicit JobHolder(JobF&& job) : job_(std::move(job)) {}
+            void run(Pool& pthreads_pool) noexcept override { job_(pthreads_pool); }
+        };
+
+        ///Исполнитель, полосой которого является текущий поток (nullptr вне полос)
+        inline thread_local const void* current_lane_owner = nullptr;
+
+        ///Узел графа задач исполнителя. Поля, кроме done_, меняются только под мутексом Executor
+        struct JobState {
+            std::unique_ptr<JobBase> job_;
+            const void* owner_ = nullptr; // Исполнитель задачи
+            bool single_lane_ = false; // У исполнителя одна полоса
+            std::size_t remaining_dependencies_ = 0;
+            std::vector<std::shared_ptr<JobState>> dependents_;
+            std::atomic<std::uint32_t> done_{0}; // 1 - задача выполнена (futex для JobHandle::wait)
+        };
+    }
+
+    ///Задача, отправленная в Executor: ожидание завершения и зависимость для следующих задач. Пустой дескриптор всегда готов
+    class JobHandle {
+    public:
+        JobHandle() = default;
+
+        [[nodiscard]] bool ready() const noexcept {
+            return state_ == nullptr || state_->done_.load(std::memory_order_acquire) != 0;
+        }
+
+        /**
+         * Ожидание завершения задачи. Результаты ее ядер видны вызывающему после возврата.
+         * Из задачи того же исполнителя ждать можно, только если есть свободная полоса: задача занимает свою полосу
+         * на все время ожидания, и при одной полосе (или когда ждут все полосы) ожидаемая задача не начнется никогда.
+         * Ожидание невыполненной задачи из полосы исполнителя с одной полосой ловится assert
+         */
+        void wait() const noexcept {
+            if (state_ == nullptr)
+                return;
+            assert((ready() || !state_->single_lane_ || detail::current_lane_owner != state_->owner_)
+                   && "JobHandle::wait: ожидание задачи из единственной полосы ее исполнителя - взаимоблокировка");
+            while (state_->done_.load(std::memory_order_acquire) == 0)
+                futex_wait(state_->done_, 0);
+        }
+
+    private:
+        friend class Executor;
+        explicit JobHandle(std::shared_ptr<detail::JobState> state) noexcept : state_(std::move(state)) {}
+
+        std::shared_ptr<detail::JobState> state_;
+    };
+
+    ///Настройки исполнителя
+    struct ExecutorSettings {
+        std::size_t count_lanes_ = 1; // Задач, выполняемых одновременно: у каждой полосы свой пул на своей части CpuTopology::partition
+        std::size_t count_threads_per_lane_ = 0; // 0 - все процессоры полосы
+        Affinity affinity_ = Affinity::SmtAware;
+        WaitPolicy wait_policy_ = WaitPolicy::Park;
+        CpuTopology cpus_{}; // Пустой - CpuTopology::discover()
+    };
+
+    /**
+     * Неблокирующая отправка задач с зависимостями. Задача - вызываемый объект job(Pool&) noexcept, внутри которого
+     * обычные dispatchJob/dispatchRange на пуле полосы. Задача становится готовой, как только выполнены ее зависимости,
+     * и ее берет первая свободная полоса (раньше задач, ждущих с момента отправки): независимые этапы (генерация сектора k + 1 и запись сектора k) идут одновременно,
+     * без общего барьера. Вызывающий поток не входит ни в одну полосу и может работать, пока задачи выполняются
+     */
+    class Executor {
+    public:
+        explicit Executor(const ExecutorSettings& settings = {})
+                : count_lanes_(std::max<std::size_t>(settings.count_lanes_, 1)) {
+            const CpuTopology cpus = settings.cpus_.empty() ? CpuTopology::discover() : settings.cpus_;
+            const std::vector<CpuTopology> parts = cpus.partition(count_lanes_);
+            lanes_.reserve(count_lanes_);
+            for (std::size_t lane = 0; lane < count_lanes_; ++lane) {
+                PoolSettings pool_settings{settings.count_threads_per_lane_, settings.affinity_, settings.wait_policy_, parts[lane], true};
+                lanes_.emplace_back([this, lane, pool_settings] { laneLoop(lane, pool_settings); });
+            }
+        }
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        ///Дожидается всех отправленных задач, затем останавливает полосы
+        ~Executor() {
+            waitAll();
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            work_cv_.notify_all();
+            for (auto& lane : lanes_)
+                lane.join();
+        }
+
+        /**
+         * Отправка задачи без ожидания
+         * @param job Вызываемый объект job(Pool&) noexcept, может быть только перемещаемым. Перемещается в исполнитель
+         * и освобождается после выполнения
+         * @param dependencies Задачи, которые должны завершиться до начала job (пустые дескрипторы пропускаются)
+         * @return Дескриптор задачи
+         */
+        template <class JobF>
+        requires std::is_nothrow_invocable_v<JobF&, Pool&> && std::is_move_constructible_v<JobF>
+        JobHandle submit(JobF job, std::span<const JobHandle> dependencies) {
+            auto state = std::make_shared<detail::JobState>();
+            state->job_ = std::make_unique<detail::JobHolder<JobF>>(std::move(job));
+            state->owner_ = this;
+            state->single_lane_ = count_lanes_ == 1;
+            bool is_ready = false;
+            {
+                std::lock_guard lock(mutex_);
+                ++unfinished_;
+                for (const JobHandle& dependency : dependencies) {
+                    if (dependency.state_ == nullptr || dependency.state_->done_.load(std::memory_order_relaxed) != 0)
+                        continue;
+                    dependency.state_->dependents_.push_back(state);
+                    ++state->remaining_dependencies_;
+                }
+                is_ready = state->remaining_dependencies_ == 0;
+                if (is_ready)
+                    ready_.push_back(state);
+            }
+            if (is_ready)
+                work_cv_.notify_one();
+            return JobHandle(std::move(state));
+        }
+
+        template <class JobF>
+        requires std::is_nothrow_invocable_v<JobF&, Pool&> && std::is_move_constructible_v<JobF>
+        JobHandle submit(JobF job, std::initializer_list<JobHandle> dependencies = {}) {
+            return submit(std::move(job), std::span<const JobHandle>(dependencies.begin(), dependencies.size()));
+        }
+
+        ///Ожидание всех задач, отправленных до вызова (и порожденных ими)
+        void waitAll() {
+            std::unique_lock lock(mutex_);
+            idle_cv_.wait(lock, [this] { return unfinished_ == 0; });
+        }
+
+        [[nodiscard]] std::size_t countLanes() const noexcept { return count_lanes_; }
+
+    private:
+        void laneLoop(std::size_t lane, const PoolSettings& pool_settings) {
+            trace::set_thread_name("executor lane " + std::to_string(lane));
+            Pool pthreads_pool{pool_settings};
+            detail::current_lane_owner = this;
+            std::unique_lock lock(mutex_);
+            while (true) {
+                work_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+                if (ready_.empty())
+                    return; // stop_ и задач нет
+                std::shared_ptr<detail::JobState> state = std::move(ready_.front());
+                ready_.pop_front();
+                lock.unlock();
+
+                {
+                    trace::Region region{"executor job"};
+                    state->job_->run(pthreads_pool);
+                }
+                state->job_.reset(); // Освобождаем захваченное (представления Kokkos и т.п.) до завершения
+
+                //Разблокированные задачи - в начало очереди: их входные данные только что записаны и еще в кэше
+                lock.lock();
+                std::size_t count_ready = 0;
+                for (auto& dependent : state->dependents_) {
+                    if (--dependent->remaining_dependencies_ == 0) {
+                        ready_.push_front(std::move(dependent));
+                        ++count_ready;
+                    }
+                }
+                state->dependents_.clear();
+                state->done_.store(1, std::memory_order_release);
+                futex_wake(state->done_, INT_MAX);
+                const bool idle = --unfinished_ == 0;
+                if (count_ready > 1)
+                    work_cv_.notify_all();
+                else if (count_ready == 1)
+                    work_cv_.notify_one();
+                if (idle)
+                    idle_cv_.notify_all();
+            }
+        }
+
+        const std::size_t count_lanes_;
+        std::vector<std::thread> lanes_;
+
+        //Граф задач грубый (одна задача - целый dispatch), поэтому достаточно одного мутекса
+        std::mutex mutex_;
+        std::condition_variable work_cv_; // Появилась готовая задача или stop_
+        std::condition_variable idle_cv_; // unfinished_ стал 0
+        std::deque<std::shared_ptr<detail::JobState>> ready_;
+        std::size_t unfinished_ = 0;
+        bool stop_ = false;
+    };
+
+}
@@ -1,20 +1,31 @@
 #pragma once
+#include <array>
+#include <cassert>
+#include <cmath>
 #include <iostream>
 #include <Kokkos_Core.hpp>
 #include "core/custom_concepts.hpp"
 #include "core/geometry/geometry.hpp"
 #include "core/kernels/kernels.hpp"
+#include "core/storage/storage.hpp"
 #include "solutions/custom_pthreads/pthreads_manage.hpp"
 
 namespace grid {
 
-    template <kokkos_view_2d_like ContainerT, execution_policy Policy>
+    /**
+     * @tparam ContainerT Хранилище точек луча
+     * @tparam Policy
+     * @tparam ComputeT Тип, в котором считаются координаты. По умолчанию совпадает с типом хранилища;
+     * double при float хранилище - смешанная точность (считаем в double, храним float)
+     */
+    template <coordinate_storage_like ContainerT, execution_policy Policy, scalar ComputeT = storage::scalar_t<ContainerT>>
     class GenNonUniformOnRay {
-        using ScalarT = ContainerT::value_type;
+        using ScalarT = ComputeT;
     public:
         /**
          * Функция для генерации сетки на луче на основе геометрической прогрессии
          * (x, y) = (x_0, y_0) + (V_x, V_y) * (b-a) * t уравнение прямой, где t = (1 - r^i) / 1 - r^N
+         * При Sequential луч заполняется вызывающим потоком, пул не используется
          * @param pthreads_pool Менеджер потоков
          * @param normalized_direction_ray Вектор направления луча
          * @param start_point_grid Точка на луче, с которой начинается заполнение сетки (должна лежать на направляющем векторе)
@@ -33,6 +44,8 @@ namespace grid {
             std::size_t count_threads;
             if constexpr (is_parallel<Policy>)
                 count_threads = pthreads_pool.totalThreads();
+            else if constexpr (is_work_stealing<Policy>)
+                count_threads = pthreads_pool.totalThreads() * pthreads_manage::chunks_per_thread_stealing; // Мелкие сегменты для кражи
             else
                 count_threads = 1;
 
@@ -40,34 +53,29 @@ namespace grid {
             const ScalarT denominator = ScalarT(1) - std::pow(multiplier_q, grid_size - 1);
 
             PartitionerArgs partitioner_args{grid_size, count_threads};
-            auto partitioner_args_ptr = std::make_unique<PartitionerArgs>(partitioner_args);
-            auto settings = partitioner(partitioner_args_ptr.get()); // Запускаем здесь разделитель тоже, поскольку нужен chunk_size для работы ядра (для индекса от начала)
+            auto settings = partitioner(partitioner_args); // Запускаем здесь разделитель тоже, поскольку нужен chunk_size для работы ядра (для индекса от начала)
 
-            KernelArgs<ScalarT> kernel_args{
-                                normalized_direction_ray,
-                                start_point_grid,
-                                end_point_grid,
-                                multiplier_q,
-                                denominator,
-                                settings.chunk_size_
-                            };
-            auto kernel_args_ptr = std::make_unique<KernelArgs<ScalarT>>(kernel_args); // Обязательно выделять память не на стеке, через new или вектор,
-            // Поскольку если оставить аргументы на стеке, то при выходе из области видимости незакончившие потоки будут ссылаться на мусор
-
-
-            pthreads_manage::JobContext context{
-                                    ray_storage,
-                                    &threadDispatch,
-                                    kernel_args_ptr.get(),
-                                            &partitioner,
-                                    partitioner_args_ptr.get()
-                                    };
+            //Аргументы захватываются по значению в окружение задачи, ядро известно компилятору и встраивается в цикл сегмента
+            pthreads_manage::Environment env{
+                                    [](auto subrange, std::size_t chunk_id, const KernelArgs& args) noexcept {
+                                        threadDispatch(subrange, chunk_id, args);
+                                    },
+                                    KernelArgs{
+                                        normalized_direction_ray,
+                                        start_point_grid,
+                                        end_point_grid,
+                                        multiplier_q,
+                                        denominator,
+                                        settings.chunk_size_
+                                    },
+                                    [](const PartitionerArgs& args) noexcept { return partitioner(args); },
+                                    partitioner_args
+                                };
             //Запуск ядер
-            pthreads_pool.dispatchJob(context);
+            pthreads_pool.template dispatchJob<Policy>(ray_storage, env);
 
         }
     private:
-        template <typename ScalarT>
         struct KernelArgs {
             geometry::Point2D<ScalarT> normalized_direction_ray_;
             geometry::Point2D<ScalarT> start_point_full_grid_, end_point_full_grid_;
@@ -76,22 +84,16 @@ namespace grid {
             std::size_t chunk_size_;
         };
         ///Прослойка для распаковки параметров и запуска ядра
-        static void threadDispatch(ViewType subrange, std::size_t worker_id, void* args) noexcept {
-            auto* args_ptr = static_cast<KernelArgs<ScalarT>*>(args);
-
-            auto normalized_direction_ray = args_ptr->normalized_direction_ray_;
-            auto start_point_grid = args_ptr->start_point_full_grid_;
-            auto end_point_grid = args_ptr->end_point_full_grid_;
-            auto multiplier_q = args_ptr->multiplier_q_;
-            auto denominator = args_ptr->denominator_;
-            auto idx_from_start = args_ptr->chunk_size_ * worker_id;
+        template <coordinate_storage_like ChunkT>
+        static void threadDispatch(ChunkT subrange, std::size_t chunk_id, const KernelArgs& args) noexcept {
+            auto idx_from_start = args.chunk_size_ * chunk_id;
 
             kernels::fill_ray_segment_nonuniform(
-                            normalized_direction_ray,
-                            start_point_grid,
-                            end_point_grid,
-                            multiplier_q,
-                            denominator,
+                            args.normalized_direction_ray_,
+                            args.start_point_full_grid_,
+                            args.end_point_full_grid_,
+                            args.multiplier_q_,
+                            args.denominator_,
                             idx_from_start,
                             subrange
                             );
@@ -102,12 +104,79 @@ namespace grid {
             std::size_t count_threads_;
         };
         ///Политика разделения на сегменты
-        [[nodiscard]] static pthreads_manage::PartitionerSettings partitioner(void* args) noexcept {
-            auto* args_ptr = static_cast<PartitionerArgs*>(args);
-            std::size_t full_size = args_ptr->full_size_;
-            std::size_t chunk_size = (full_size + args_ptr->count_threads_ - 1) / args_ptr->count_threads_; // Размер целого подотрезка
+        [[nodiscard]] static pthreads_manage::PartitionerSettings partitioner(const PartitionerArgs& args) noexcept {
+            std::size_t full_size = args.full_size_;
+            std::size_t chunk_size = (full_size + args.count_threads_ - 1) / args.count_threads_; // Размер целого подотрезка
 
             return pthreads_manage::PartitionerSettings{full_size, chunk_size, 0};
         }
     };
+
+    /**
+     * GenNonUniformOnRay для фиксированного количества точек луча CountPoints (параметр шаблона): числители 1 - q^i
+     * считаются один раз в таблицу std::array (kernels::ray_parameter_numerators), степеней в ядре нет.
+     * При Sequential луч заполняется одним циклом известной длины (kernels::fill_ray_fixed)
+     * @tparam ContainerT Хранилище точек луча (extent(0) == CountPoints)
+     * @tparam Policy
+     * @tparam CountPoints Точек на луче (>= 2; таблица числителей - не больше kernels::max_fixed_table_bytes)
+     * @tparam ComputeT Тип вычислений, как у GenNonUniformOnRay
+     */
+    template <coordinate_storage_like ContainerT, execution_policy Policy, std::size_t CountPoints, scalar ComputeT = storage::scalar_t<ContainerT>>
+    requires (CountPoints >= 2)
+    class GenNonUniformOnRayFixed {
+        using ScalarT = ComputeT;
+    public:
+        ///Параметры как у GenNonUniformOnRay::operator()
+        void operator() (
+                    pthreads_manage::Pool &pthreads_pool,
+                    const geometry::Point2D<ScalarT> &normalized_direction_ray,
+                    const geometry::Point2D<ScalarT> &start_point_grid,
+                    const geometry::Point2D<ScalarT> &end_point_grid,
+                    ScalarT multiplier_q,
+                    ContainerT ray_storage
+                    ) const noexcept {
+            assert(ray_storage.extent(0) == CountPoints && "GenNonUniformOnRayFixed: ray_storage.extent(0) == CountPoints");
+            const auto numerators = kernels::ray_parameter_numerators<CountPoints>(multiplier_q);
+            //Знаменатель - как у GenFrameKirschFixed (kernels::make_ray_frame), а не std::pow GenNonUniformOnRay
+            const kernels::RayFrame<ScalarT> frame{normalized_direction_ray, start_point_grid, end_point_grid,
+                                                   kernels::ray_denominator(multiplier_q, CountPoints)};
+            if constexpr (is_sequential<Policy>) {
+                kernels::fill_ray_fixed(frame, numerators, ray_storage);
+            } else {
+                std::size_t count_chunks = pthreads_pool.totalThreads();
+                if constexpr (is_work_stealing<Policy>)
+                    count_chunks *= pthreads_manage::chunks_per_thread_stealing;
+                const std::size_t chunk_size = (CountPoints + count_chunks - 1) / count_chunks;
+                pthreads_manage::Environment env{
+                                        [](auto subrange, std::size_t chunk_id, const KernelArgs& args) noexcept {
+                                            threadDispatch(subrange, chunk_id, args);
+                                        },
+                                        KernelArgs{&frame, &numerators, chunk_size},
+                                        [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                        pthreads_manage::PartitionerSettings{CountPoints, chunk_size, 0}
+                                    };
+                pthreads_pool.template dispatchJob<Policy>(ray_storage, env);
+            }
+        }
+    private:
+        struct KernelArgs {
+            const kernels::RayFrame<ScalarT>* frame_;
+            const std::array<ScalarT, CountPoints>* numerators_;
+            std::size_t chunk_size_;
+        };
+        template <coordinate_storage_like ChunkT>
+        static void threadDispatch(ChunkT subrange, std::size_t chunk_id, const KernelArgs& args) noexcept {
+            using StorageScalarT = storage::scalar_t<ChunkT>;
+            const auto& frame = *args.frame_;
+            auto interval = frame.end_point_ - frame.start_point_;
+            const ScalarT scale = interval.GetL2Norm() / frame.denominator_;
+            const ScalarT step_x = frame.normalized_direction_.x * scale;
+            const ScalarT step_y = frame.normalized_direction_.y * scale;
+            const ScalarT* numerators = args.numerators_->data() + args.chunk_size_ * chunk_id;
+            for (std::size_t i = 0; i < subrange.extent(0); i++) {
+                subrange(i, 0) = static_cast<StorageScalarT>(frame.start_point_.x + step_x * numerators[i]);
+                subrange(i, 1) = static_cast<StorageScalarT>(frame.start_point_.y + step_y * numerators[i]);
+            }
+        }
+    };
 }
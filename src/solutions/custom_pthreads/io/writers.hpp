@@ -0,0 +1,300 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/io/binary.hpp"
+#include "core/io/fields.hpp"
+#include "core/io/file.hpp"
+#include "core/io/vtu.hpp"
+#include "core/kernels/kernels.hpp"
+#include "core/storage/storage.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace writers {
+
+    ///Точек в буфере упаковки координат (хранилища, которые нельзя записать как есть)
+    inline constexpr std::size_t pack_block_size = 1024;
+
+    template <coordinate_source_like ContainerT, std::size_t NodesPerElement, typename TargetT>
+    struct KernelArgsWrite {
+        ContainerT mesh_;
+        topology::ConnectivityView<NodesPerElement> elements_;
+        const io::FieldView* point_fields_;
+        const io::FieldView* cell_fields_;
+        const TargetT* layout_;
+        char* mapped_;              // Отображение файла (.vtu)
+        int fd_;                    // Дескриптор файла (двоичный формат)
+        std::atomic<int>* error_;   // Первая ошибка записи
+    };
+
+    inline void report_error(std::atomic<int>* error, int value) noexcept {
+        int expected = 0;
+        if (value != 0)
+            error->compare_exchange_strong(expected, value, std::memory_order_relaxed);
+    }
+
+    ///Хранилище, x и y которого лежат в памяти подряд и могут быть записаны одним блоком
+    template <class ContainerT>
+    inline constexpr bool contiguous_aos = [] {
+        if constexpr (kokkos_view_2d_like<ContainerT>)
+            return std::is_same_v<typename ContainerT::array_layout, Kokkos::LayoutRight>;
+        else
+            return false;
+    }();
+
+    /**
+     * Узлы [range) в .vtu: точки (x, y, 0) и поля в узлах копируются прямо в отображение файла.
+     * Точки собираются блоками simd_block_size, блок записывается одним memcpy (блоки appended данных не выровнены)
+     */
+    template <coordinate_source_like ContainerT, std::size_t N>
+    void vtuNodesDispatch(pthreads_manage::IndexRange range, std::size_t, const KernelArgsWrite<ContainerT, N, io::VtuLayout>& args) noexcept {
+        using ScalarT = storage::scalar_t<ContainerT>;
+        constexpr std::size_t B = kernels::simd_block_size;
+        const io::VtuLayout& layout = *args.layout_;
+        char* points = args.mapped_ + layout.points_.offset_;
+        ScalarT block[3 * B];
+        for (std::size_t block_start = range.begin_; block_start < range.end_; block_start += B) {
+            const std::size_t count = std::min(B, range.end_ - block_start);
+            for (std::size_t l = 0; l < count; l++) {
+                block[3 * l] = args.mesh_(block_start + l, 0);
+                block[3 * l + 1] = args.mesh_(block_start + l, 1);
+                block[3 * l + 2] = ScalarT(0);
+            }
+            std::memcpy(points + 3 * block_start * sizeof(ScalarT), block, 3 * count * sizeof(ScalarT));
+        }
+        for (std::size_t f = 0; f < layout.point_fields_.size(); f++) {
+            const std::size_t components = args.point_fields_[f].count_components_;
+            std::memcpy(args.mapped_ + layout.point_fields_[f].offset_ + range.begin_ * components * sizeof(double),
+                        args.point_fields_[f].data_ + range.begin_ * components,
+                        range.size() * components * sizeof(double));
+        }
+    }
+
+    ///Ячейки [range) в .vtu: связность, смещения, типы и поля в ячейках
+    template <coordinate_source_like ContainerT, std::size_t N>
+    void vtuCellsDispatch(pthreads_manage::IndexRange range, std::size_t, const KernelArgsWrite<ContainerT, N, io::VtuLayout>& args) noexcept {
+        constexpr std::size_t B = kernels::simd_block_size;
+        const io::VtuLayout& layout = *args.layout_;
+        static_assert(sizeof(std::size_t) == sizeof(std::int64_t), "связность записывается как Int64 без преобразования");
+        std::memcpy(args.mapped_ + layout.connectivity_.offset_ + range.begin_ * N * sizeof(std::int64_t),
+                    &args.elements_(range.begin_, 0),
+                    range.size() * N * sizeof(std::int64_t));
+
+        char* offsets = args.mapped_ + layout.offsets_.offset_;
+        std::int64_t block[B];
+        for (std::size_t block_start = range.begin_; block_start < range.end_; block_start += B) {
+            const std::size_t count = std::min(B, range.end_ - block_start);
+            for (std::size_t l = 0; l < B; l++)
+                block[l] = static_cast<std::int64_t>((block_start + l + 1) * N);
+            std::memcpy(offsets + block_start * sizeof(std::int64_t), block, count * sizeof(std::int64_t));
+        }
+        std::memset(args.mapped_ + layout.types_.offset_ + range.begin_, io::vtk_cell_type<N>, range.size());
+
+        for (std::size_t f = 0; f < layout.cell_fields_.size(); f++) {
+            const std::size_t components = args.cell_fields_[f].count_components_;
+            std::memcpy(args.mapped_ + layout.cell_fields_[f].offset_ + range.begin_ * components * sizeof(double),
+                        args.cell_fields_[f].data_ + range.begin_ * components,
+                        range.size() * components * sizeof(double));
+        }
+    }
+
+    /**
+     * Узлы [range) в двоичный файл через pwrite. Хранилище с x, y подряд (AoS Kokkos::View) пишется прямо из своей памяти,
+     * остальные упаковываются блоками по pack_block_size точек
+     */
+    template <coordinate_source_like ContainerT, std::size_t N>
+    void binaryNodesDispatch(pthreads_manage::IndexRange range, std::size_t, const KernelArgsWrite<ContainerT, N, io::BinaryLayout>& args) noexcept {
+        using ScalarT = storage::scalar_t<ContainerT>;
+        const io::BinaryLayout& layout = *args.layout_;
+        const std::size_t nodes_offset = layout.header_.nodes_offset_;
+        if constexpr (contiguous_aos<ContainerT>) {
+            report_error(args.error_, io::pwrite_all(args.fd_, &args.mesh_(range.begin_, 0), 2 * range.size() * sizeof(ScalarT),
+                                                     nodes_offset + 2 * range.begin_ * sizeof(ScalarT)));
+        } else {
+            ScalarT block[2 * pack_block_size];
+            for (std::size_t block_start = range.begin_; block_start < range.end_; block_start += pack_block_size) {
+                const std::size_t count = std::min(pack_block_size, range.end_ - block_start);
+                for (std::size_t l = 0; l < count; l++) {
+                    block[2 * l] = args.mesh_(block_start + l, 0);
+                    block[2 * l + 1] = args.mesh_(block_start + l, 1);
+                }
+                report_error(args.error_, io::pwrite_all(args.fd_, block, 2 * count * sizeof(ScalarT), nodes_offset + 2 * block_start * sizeof(ScalarT)));
+            }
+        }
+        for (std::size_t f = 0; f < layout.header_.count_point_fields_; f++) {
+            const std::size_t components = args.point_fields_[f].count_components_;
+            report_error(args.error_, io::pwrite_all(args.fd_, args.point_fields_[f].data_ + range.begin_ * components,
+                                                     range.size() * components * sizeof(double),
+                                                     layout.fields_[f].offset_ + range.begin_ * components * sizeof(double)));
+        }
+    }
+
+    ///Ячейки [range) в двоичный файл через pwrite прямо из памяти связности и полей
+    template <coordinate_source_like ContainerT, std::size_t N>
+    void binaryCellsDispatch(pthreads_manage::IndexRange range, std::size_t, const KernelArgsWrite<ContainerT, N, io::BinaryLayout>& args) noexcept {
+        const io::BinaryLayout& layout = *args.layout_;
+        report_error(args.error_, io::pwrite_all(args.fd_, &args.elements_(range.begin_, 0), range.size() * N * sizeof(std::uint64_t),
+                                                 layout.header_.cells_offset_ + range.begin_ * N * sizeof(std::uint64_t)));
+        const std::size_t first_cell_field = layout.header_.count_point_fields_;
+        for (std::size_t f = 0; f < layout.header_.count_cell_fields_; f++) {
+            const std::size_t components = args.cell_fields_[f].count_components_;
+            report_error(args.error_, io::pwrite_all(args.fd_, args.cell_fields_[f].data_ + range.begin_ * components,
+                                                     range.size() * components * sizeof(double),
+                                                     layout.fields_[first_cell_field + f].offset_ + range.begin_ * components * sizeof(double)));
+        }
+    }
+
+    ///Запуск ядра над узлами и над ячейками: диапазоны режутся на сектора подряд идущих лучей по политике
+    template <execution_policy Policy, typename ArgsT>
+    void dispatch_nodes_and_cells(pthreads_manage::Pool &pthreads_pool, std::size_t count_nodes, std::size_t count_cells,
+                                  auto nodes_kernel, auto cells_kernel, const ArgsT& args) noexcept {
+        if (count_nodes > 0) {
+            pthreads_manage::Environment env{
+                                    nodes_kernel,
+                                    args,
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{count_nodes, pthreads_pool.rangeChunkSize<Policy>(count_nodes), 0}
+                                    };
+            pthreads_pool.dispatchRange<Policy>(count_nodes, env);
+        }
+        if (count_cells > 0) {
+            pthreads_manage::Environment env{
+                                    cells_kernel,
+                                    args,
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{count_cells, pthreads_pool.rangeChunkSize<Policy>(count_cells), 0}
+                                    };
+            pthreads_pool.dispatchRange<Policy>(count_cells, env);
+        }
+    }
+
+    /**
+     * Запись сетки и полей в VTK XML (.vtu) с appended raw данными. Файл создается нужного размера (блоки выделяются сразу) и отображается в память,
+     * потоки пула копируют свои сектора узлов и ячеек прямо в отображение - промежуточных буферов на весь массив нет
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     */
+    template <execution_policy Policy>
+    struct VtuWriter {
+        /**
+         * @param pthreads_pool
+         * @param path
+         * @param mesh Узлы
+         * @param elements Связность (3 или 4 узла на ячейку)
+         * @param point_fields Поля в узлах (данные должны жить до возврата)
+         * @param cell_fields Поля в ячейках
+         * @return 0 или errno
+         */
+        template <coordinate_source_like ContainerT, std::size_t N>
+        [[nodiscard]] int operator() (
+                    pthreads_manage::Pool &pthreads_pool,
+                    const std::string& path,
+                    const ContainerT& mesh,
+                    const topology::ConnectivityView<N>& elements,
+                    const std::vector<io::FieldView>& point_fields = {},
+                    const std::vector<io::FieldView>& cell_fields = {}
+                    ) const {
+            const std::size_t count_nodes = mesh.extent(0);
+            const std::size_t count_cells = elements.extent(0);
+            const auto layout = io::vtu_layout<storage::scalar_t<ContainerT>, N>(count_nodes, count_cells, point_fields, cell_fields);
+
+            io::FileDescriptor fd = io::create_file(path);
+            if (!fd)
+                return errno;
+            //Блоки выделяются заранее: запись в дыру отображения при нехватке места - SIGBUS вместо кода ошибки
+            if (int error = io::allocate_file(fd.get(), layout.file_size_); error != 0)
+                return error;
+            io::MappedFile file;
+            if (int error = file.map(fd.get(), layout.file_size_, io::MapMode::Shared); error != 0)
+                return error;
+
+            char* mapped = file.data();
+            std::memcpy(mapped, layout.header_.data(), layout.header_.size());
+            std::memcpy(mapped + layout.file_size_ - layout.footer_.size(), layout.footer_.data(), layout.footer_.size());
+            auto write_block_header = [mapped](const io::VtuBlock& block) {
+                const std::uint64_t bytes = block.bytes_;
+                std::memcpy(mapped + block.offset_ - io::vtu_block_header_size, &bytes, sizeof(bytes));
+            };
+            for (const auto* block : {&layout.points_, &layout.connectivity_, &layout.offsets_, &layout.types_})
+                write_block_header(*block);
+            for (const auto& block : layout.point_fields_)
+                write_block_header(block);
+            for (const auto& block : layout.cell_fields_)
+                write_block_header(block);
+
+            std::atomic<int> error{0};
+            const KernelArgsWrite<ContainerT, N, io::VtuLayout> args{mesh, elements, point_fields.data(), cell_fields.data(), &layout, mapped, -1, &error};
+            dispatch_nodes_and_cells<Policy>(pthreads_pool, count_nodes, count_cells,
+                                             [](pthreads_manage::IndexRange range, std::size_t chunk_id, const auto& a) noexcept { vtuNodesDispatch(range, chunk_id, a); },
+                                             [](pthreads_manage::IndexRange range, std::size_t chunk_id, const auto& a) noexcept { vtuCellsDispatch(range, chunk_id, a); },
+                                             args);
+            return error.load();
+        }
+    };
+
+    /**
+     * Запись сетки и полей в двоичный формат io::BinaryHeader. Потоки пула пишут свои сектора через pwrite прямо из памяти
+     * хранилища, связности и полей; разделы выровнены по странице, поэтому файл можно отобразить и использовать без чтения
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     */
+    template <execution_policy Policy>
+    struct BinaryWriter {
+        /**
+         * @param pthreads_pool
+         * @param path
+         * @param mesh Узлы
+         * @param elements Связность (3 или 4 узла на ячейку)
+         * @param point_fields Поля в узлах (данные должны жить до возврата)
+         * @param cell_fields Поля в ячейках
+         * @param tag Метка в заголовке
+         * @param metadata Метаданные записавшего (например, параметры генерации для проверки при чтении)
+         * @return 0 или errno
+         */
+        template <coordinate_source_like ContainerT, std::size_t N>
+        [[nodiscard]] int operator() (
+                    pthreads_manage::Pool &pthreads_pool,
+                    const std::string& path,
+                    const ContainerT& mesh,
+                    const topology::ConnectivityView<N>& elements,
+                    const std::vector<io::FieldView>& point_fields = {},
+                    const std::vector<io::FieldView>& cell_fields = {},
+                    std::uint64_t tag = 0,
+                    std::string_view metadata = {}
+                    ) const {
+            const std::size_t count_nodes = mesh.extent(0);
+            const std::size_t count_cells = elements.extent(0);
+            const auto layout = io::binary_layout(sizeof(storage::scalar_t<ContainerT>), count_nodes, N, count_cells, point_fields, cell_fields,
+                                                  tag, metadata.size());
+
+            io::FileDescriptor fd = io::create_file(path);
+            if (!fd)
+                return errno;
+            if (int error = io::resize_file(fd.get(), layout.header_.file_size_); error != 0)
+                return error;
+            if (int error = io::pwrite_all(fd.get(), &layout.header_, sizeof(io::BinaryHeader), 0); error != 0)
+                return error;
+            if (int error = io::pwrite_all(fd.get(), layout.fields_.data(), layout.fields_.size() * sizeof(io::BinaryFieldRecord), sizeof(io::BinaryHeader)); error != 0)
+                return error;
+            if (int error = io::pwrite_all(fd.get(), metadata.data(), metadata.size(), layout.header_.metadata_offset_); error != 0)
+                return error;
+
+            std::atomic<int> error{0};
+            const KernelArgsWrite<ContainerT, N, io::BinaryLayout> args{mesh, elements, point_fields.data(), cell_fields.data(), &layout, nullptr, fd.get(), &error};
+            dispatch_nodes_and_cells<Policy>(pthreads_pool, count_nodes, count_cells,
+                                             [](pthreads_manage::IndexRange range, std::size_t chunk_id, const auto& a) noexcept { binaryNodesDispatch(range, chunk_id, a); },
+                                             [](pthreads_manage::IndexRange range, std::size_t chunk_id, const auto& a) noexcept { binaryCellsDispatch(range, chunk_id, a); },
+                                             args);
+            return error.load();
+        }
+    };
+
+}
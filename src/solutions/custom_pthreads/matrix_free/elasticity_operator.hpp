@@ -0,0 +1,206 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <mkl_types.h>
+#include "core/custom_concepts.hpp"
+#include "core/fem/elasticity.hpp"
+#include "core/kernels/kernels.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace matrix_free {
+
+    ///Элементов в блоке quad_apply_block: соседние ячейки одной полосы между лучами
+    inline constexpr std::size_t cells_per_block = kernels::simd_block_size;
+
+    template <coordinate_source_like ContainerT>
+    struct KernelArgsApply {
+        ContainerT mesh_;
+        topology::RayLayout layout_;
+        fem::ElasticityMatrix D_;
+        double thickness_;
+        const std::uint8_t* free_;  // 1 - свободная степень свободы, 0 - закрепленная
+        const double* x_;
+        double* y_;
+        std::size_t count_sectors_;
+        std::size_t parity_;        // Четность секторов текущего прохода
+    };
+
+    /**
+     * Вклад ячеек полосы ray_idx (между лучами ray_idx и ray_idx + 1) в y. Ячейки берутся блоками по cells_per_block вдоль луча:
+     * узлы блока - два непрерывных отрезка лучей, поэтому сбор и запись идут подряд по памяти без таблицы связности.
+     * Хвост блока дополняется копией последней ячейки полосы (считается, но не записывается)
+     */
+    template <coordinate_source_like ContainerT>
+    void apply_band(const KernelArgsApply<ContainerT>& args, std::size_t ray_idx) noexcept {
+        constexpr std::size_t B = cells_per_block;
+        constexpr std::size_t dofs = fem::dofs_per_node;
+        const std::size_t count_cells = args.layout_.count_points_on_ray_ - 1;
+        //Узлы ячейки j: (k, j), (k, j+1), (k+1, j+1), (k+1, j) - см. RayLayout::cell
+        const std::size_t inner_first = args.layout_.node(ray_idx, 0);
+        const std::size_t outer_first = args.layout_.node(ray_idx + 1, 0);
+        const std::uint8_t* free = args.free_;
+        const double* u = args.x_;
+
+        double x[4][B], y[4][B], ux[4][B], uy[4][B], fx[4][B], fy[4][B];
+        for (std::size_t block_start = 0; block_start < count_cells; block_start += B) {
+            const std::size_t count = std::min(B, count_cells - block_start);
+            for (std::size_t l = 0; l < B; l++) {
+                const std::size_t j = block_start + (l < count ? l : count - 1);
+                const std::size_t nodes[4] = {inner_first + j, inner_first + j + 1, outer_first + j + 1, outer_first + j};
+                for (std::size_t a = 0; a < 4; a++) {
+                    const std::size_t dof = dofs * nodes[a];
+                    x[a][l] = static_cast<double>(args.mesh_(nodes[a], 0));
+                    y[a][l] = static_cast<double>(args.mesh_(nodes[a], 1));
+                    ux[a][l] = free[dof] ? u[dof] : 0.0;
+                    uy[a][l] = free[dof + 1] ? u[dof + 1] : 0.0;
+                    fx[a][l] = 0.0;
+                    fy[a][l] = 0.0;
+                }
+            }
+            fem::quad_apply_block<B>(x, y, ux, uy, fx, fy, args.D_, args.thickness_);
+            //Соседние ячейки делят узлы: узел j + l луча получает вклад a = 0 ячейки l и a = 1 ячейки l - 1
+            double* inner = args.y_ + dofs * (inner_first + block_start);
+            double* outer = args.y_ + dofs * (outer_first + block_start);
+            for (std::size_t l = 0; l < count; l++) {
+                inner[dofs * l] += fx[0][l];
+                inner[dofs * l + 1] += fy[0][l];
+                outer[dofs * l] += fx[3][l];
+                outer[dofs * l + 1] += fy[3][l];
+                inner[dofs * (l + 1)] += fx[1][l];
+                inner[dofs * (l + 1) + 1] += fy[1][l];
+                outer[dofs * (l + 1)] += fx[2][l];
+                outer[dofs * (l + 1) + 1] += fy[2][l];
+            }
+        }
+    }
+
+    ///Сектор sector_id из полос [sector_id * B / S, (sector_id + 1) * B / S), B - полосы, S - сектора
+    [[nodiscard]] inline std::pair<std::size_t, std::size_t> sector_bands(std::size_t count_bands, std::size_t count_sectors, std::size_t sector_id) noexcept {
+        return {sector_id * count_bands / count_sectors, (sector_id + 1) * count_bands / count_sectors};
+    }
+
+    /**
+     * Оператор y = K * x плоской задачи теории упругости на структурированной сетке GenFrameKirsch без хранения матрицы:
+     * матрицы элементов не собираются, вклад ячейки считается по координатам ее узлов при каждом применении.
+     * Из памяти читаются только координаты и x, пишется y, поэтому трафик на порядок меньше, чем у CSR SpMV.
+     * Полосы между лучами делятся на сектора; соседние сектора делят луч, поэтому сначала параллельно считаются четные сектора,
+     * затем нечетные - без атомарных операций. Закрепленные степени свободы дают строки единичной матрицы
+     * (совпадает с fem::apply_dirichlet для собранной матрицы). Удовлетворяет linear_operator
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     * @tparam ContainerT Хранилище узлов
+     */
+    template <execution_policy Policy, coordinate_source_like ContainerT>
+    class ElasticityOperator {
+    public:
+        /**
+         * @param pthreads_pool Пул, на котором выполняется apply (должен жить дольше оператора)
+         * @param mesh Узлы сетки
+         * @param count_points_on_ray Количество точек на луче
+         * @param material
+         * @param fixed_dofs Закрепленные степени свободы (u_i = 0)
+         */
+        ElasticityOperator(
+                    pthreads_manage::Pool &pthreads_pool,
+                    ContainerT mesh,
+                    std::size_t count_points_on_ray,
+                    const fem::Material& material,
+                    const std::vector<MKL_INT>& fixed_dofs = {}
+                    )
+                : pthreads_pool_(&pthreads_pool),
+                  mesh_(mesh),
+                  layout_{mesh.extent(0) / count_points_on_ray, count_points_on_ray},
+                  D_(fem::plane_stress(material)),
+                  thickness_(material.thickness_),
+                  free_(fem::dofs_per_node * layout_.count_nodes(), 1) {
+            for (MKL_INT dof : fixed_dofs)
+                free_[dof] = 0;
+            const std::size_t count_bands = layout_.count_rays_ - 1;
+            std::size_t max_sectors = 1;
+            if constexpr (is_parallel<Policy>)
+                max_sectors = 2 * pthreads_pool.totalThreads();
+            else if constexpr (is_work_stealing<Policy>)
+                max_sectors = 2 * pthreads_pool.totalThreads() * pthreads_manage::chunks_per_thread_stealing;
+            count_sectors_ = std::max<std::size_t>(std::min(max_sectors, count_bands), 1);
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return free_.size(); }
+
+        void apply(const double* x, double* y) const noexcept {
+            const std::size_t n = size();
+            KernelArgsApply<ContainerT> args{mesh_, layout_, D_, thickness_, free_.data(), x, y, count_sectors_, 0};
+
+            pthreads_manage::Environment zero_env{
+                                    [](pthreads_manage::IndexRange range, std::size_t, double* out) noexcept {
+                                        std::fill(out + range.begin_, out + range.end_, 0.0);
+                                    },
+                                    y,
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{n, pthreads_pool_->template rangeChunkSize<Policy>(n), 0}
+                                    };
+            pthreads_pool_->template dispatchRange<Policy>(n, zero_env);
+
+            for (std::size_t parity = 0; parity < 2; parity++) {
+                args.parity_ = parity;
+                const std::size_t count_phase_sectors = (count_sectors_ + 1 - parity) / 2;
+                if (count_phase_sectors == 0)
+                    continue;
+                pthreads_manage::Environment env{
+                                        [](pthreads_manage::IndexRange range, std::size_t, const KernelArgsApply<ContainerT>& a) noexcept {
+                                            const std::size_t count_bands = a.layout_.count_rays_ - 1;
+                                            for (std::size_t i = range.begin_; i < range.end_; i++) {
+                                                const auto [first_band, end_band] = sector_bands(count_bands, a.count_sectors_, 2 * i + a.parity_);
+                                                for (std::size_t band = first_band; band < end_band; band++)
+                                                    apply_band(a, band);
+                                            }
+                                        },
+                                        args,
+                                        [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                        pthreads_manage::PartitionerSettings{count_phase_sectors, 1, 0}
+                                        };
+                pthreads_pool_->template dispatchRange<Policy>(count_phase_sectors, env);
+            }
+
+            //Строки закрепленных степеней свободы - единичные
+            for (std::size_t dof = 0; dof < n; dof++)
+                if (!free_[dof])
+                    y[dof] = x[dof];
+        }
+
+        ///Обратная диагональ K (для solvers::JacobiPreconditioner), матрицы элементов считаются один раз
+        [[nodiscard]] std::vector<double> inverse_diagonal() const {
+            std::vector<double> diagonal(size(), 0.0);
+            for (std::size_t k = 0; k + 1 < layout_.count_rays_; k++) {
+                for (std::size_t j = 0; j + 1 < layout_.count_points_on_ray_; j++) {
+                    const auto cell = layout_.cell(k, j);
+                    std::array<double, 4> x{}, y{};
+                    for (std::size_t a = 0; a < 4; a++) {
+                        x[a] = static_cast<double>(mesh_(cell[a], 0));
+                        y[a] = static_cast<double>(mesh_(cell[a], 1));
+                    }
+                    const auto stiffness = fem::element_stiffness<4>(x, y, D_, thickness_);
+                    for (std::size_t a = 0; a < 4; a++)
+                        for (std::size_t c = 0; c < fem::dofs_per_node; c++)
+                            diagonal[fem::dofs_per_node * cell[a] + c] += stiffness[fem::dofs_per_node * a + c][fem::dofs_per_node * a + c];
+                }
+            }
+            for (std::size_t dof = 0; dof < diagonal.size(); dof++)
+                diagonal[dof] = free_[dof] ? 1.0 / diagonal[dof] : 1.0;
+            return diagonal;
+        }
+
+    private:
+        pthreads_manage::Pool* pthreads_pool_;
+        ContainerT mesh_;
+        topology::RayLayout layout_;
+        fem::ElasticityMatrix D_;
+        double thickness_;
+        std::vector<std::uint8_t> free_;
+        std::size_t count_sectors_;
+    };
+
+}
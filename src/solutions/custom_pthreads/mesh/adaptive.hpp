@@ -0,0 +1,247 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <vector>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/fem/estimator.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/storage/storage.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/mesh/mesh.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace mesh {
+
+    ///Лучи неравномерной сетки Кирша: угол точки на отверстии (от оси x, по возрастанию от 0 до pi / 2) и основание прогрессии каждого луча
+    struct RayFan {
+        std::vector<double> angles_;
+        std::vector<double> multipliers_;
+
+        [[nodiscard]] std::size_t count_rays() const noexcept { return angles_.size(); }
+
+        ///Равномерный веер, как у GenFrameKirsch (count_rays >= 2)
+        [[nodiscard]] static RayFan uniform(std::size_t count_rays, double multiplier_q) {
+            //Один луч - деление угла на 0, ноль лучей - пустой веер
+            assert(count_rays >= 2 && "RayFan::uniform: count_rays >= 2");
+            RayFan fan{std::vector<double>(count_rays), std::vector<double>(count_rays, multiplier_q)};
+            for (std::size_t k = 0; k < count_rays; k++)
+                fan.angles_[k] = std::numbers::pi / 2.0 * static_cast<double>(k) / static_cast<double>(count_rays - 1);
+            fan.angles_.back() = std::numbers::pi / 2.0;
+            return fan;
+        }
+    };
+
+    ///Правила одного шага адаптации
+    struct RefineSettings {
+        double mark_fraction_ = 0.5; // Дробятся полосы с ошибкой >= mark_fraction_ * наибольшей ошибки
+        double tolerance_ = 0.0;     // ... и не меньше tolerance_: полосы, уже достигшие точности, не трогаются
+        double multiplier_step_ = 1.03; // Во сколько раз меняется q лучей полосы, если худшая ячейка у края луча
+        double min_multiplier_ = 1.001; // q = 1 недопустимо (знаменатель прогрессии)
+        double max_multiplier_ = 1.5;
+        double max_log_slope_ = 0.01; // Предел |ln q_{k+1} - ln q_k| / (угол между лучами); 0 - q меняется у всего веера сразу
+    };
+
+    ///Аргументы ядра генерации веера: луч либо копируется из предыдущей сетки, либо выпускается заново
+    template <coordinate_storage_like ContainerT>
+    struct KernelArgsEmitFan {
+        using ScalarT = storage::scalar_t<ContainerT>;
+        ScalarT radius_hole_;
+        ScalarT side_size_;
+        const double* angles_;
+        const double* multipliers_;
+        const std::size_t* sources_; // Номер луча в previous_ или new_ray - выпустить заново
+        std::size_t count_points_on_ray_;
+        ContainerT previous_;
+        ContainerT target_;
+    };
+
+    inline constexpr std::size_t new_ray = std::numeric_limits<std::size_t>::max();
+
+    ///Ядро генерации веера: сегмент - диапазон лучей
+    template <coordinate_storage_like ContainerT>
+    void emitFanDispatch(pthreads_manage::IndexRange range, std::size_t, const KernelArgsEmitFan<ContainerT>& args) noexcept {
+        using ScalarT = storage::scalar_t<ContainerT>;
+        using p_type = geometry::Point2D<ScalarT>;
+        const std::size_t count_points = args.count_points_on_ray_;
+        const p_type zero_point{ScalarT(0.0), ScalarT(0.0)};
+        const p_type first_point_right_edge{args.side_size_, ScalarT(0.0)};
+        const p_type first_point_up_edge{ScalarT(0.0), args.side_size_};
+        const p_type second_point_edge{args.side_size_, args.side_size_};
+        for (std::size_t ray_idx = range.begin_; ray_idx < range.end_; ++ray_idx) {
+            auto ray = storage::subrange(args.target_, ray_idx * count_points, (ray_idx + 1) * count_points);
+            const std::size_t source = args.sources_[ray_idx];
+            if (source != new_ray) {
+                for (std::size_t j = 0; j < count_points; j++) {
+                    ray(j, 0) = args.previous_(source * count_points + j, 0);
+                    ray(j, 1) = args.previous_(source * count_points + j, 1);
+                }
+                continue;
+            }
+            const p_type hole_point{args.radius_hole_ * static_cast<ScalarT>(std::cos(args.angles_[ray_idx])),
+                                    args.radius_hole_ * static_cast<ScalarT>(std::sin(args.angles_[ray_idx]))};
+            const p_type& first_point_edge = (hole_point.y <= hole_point.x) ? first_point_right_edge : first_point_up_edge;
+            emit_ray(zero_point, hole_point, first_point_edge, second_point_edge, static_cast<ScalarT>(args.multipliers_[ray_idx]), ray);
+        }
+    }
+
+    /**
+     * Сетка четверти пластины Кирша с адаптацией по оценке ошибки напряжений. Структура та же, что у GenFrameKirsch
+     * (count_rays лучей по count_points_on_ray точек, topology::RayLayout, связность GenConnectivityKirsch), но углы лучей
+     * и основание прогрессии у каждого луча свои. Шаг refine вставляет лучи в середины полос с большой ошибкой и сгущает
+     * (или разрежает) точки у отверстия на лучах этих полос. Неизмененные лучи копируются, заново выпускаются только новые
+     * и измененные
+     * @tparam ContainerT Хранилище сетки
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     */
+    template <coordinate_storage_like ContainerT, execution_policy Policy>
+    class AdaptiveKirsch {
+    public:
+        using ScalarT = storage::scalar_t<ContainerT>;
+
+        /**
+         * @param pthreads_pool
+         * @param radius_hole
+         * @param side_size
+         * @param fan Начальный веер лучей (>= 2)
+         * @param count_points_on_ray Точек на луче (>= 2), не меняется при адаптации
+         */
+        AdaptiveKirsch(pthreads_manage::Pool& pthreads_pool, double radius_hole, double side_size, RayFan fan, std::size_t count_points_on_ray)
+                : radius_hole_(radius_hole), side_size_(side_size), count_points_on_ray_(count_points_on_ray), fan_(std::move(fan)) {
+            assert(fan_.count_rays() >= 2 && "AdaptiveKirsch: fan.count_rays() >= 2");
+            assert(count_points_on_ray_ >= 2 && "AdaptiveKirsch: count_points_on_ray >= 2");
+            assert(fan_.multipliers_.size() == fan_.count_rays());
+            regenerate(pthreads_pool, ContainerT{}, std::vector<std::size_t>(fan_.count_rays(), new_ray));
+        }
+
+        [[nodiscard]] const ContainerT& mesh() const noexcept { return mesh_; }
+        [[nodiscard]] const RayFan& fan() const noexcept { return fan_; }
+        [[nodiscard]] topology::RayLayout layout() const noexcept { return topology::RayLayout{fan_.count_rays(), count_points_on_ray_}; }
+        ///Лучей, выпущенных заново последним шагом (остальные скопированы)
+        [[nodiscard]] std::size_t countEmitted() const noexcept { return count_emitted_; }
+
+        /**
+         * Шаг адаптации по ошибкам полос между лучами (fem::ray_interval_errors для текущей сетки).
+         * Отмеченная полоса делится лучом посередине (по углу), либо, если ее худшая ячейка вытянута вдоль луча и лежит
+         * в первой трети луча (у отверстия), q ее лучей растет в multiplier_step_ раз, в последней трети - уменьшается
+         * @return Количество отмеченных полос; 0 - сетка не изменилась
+         */
+        std::size_t refine(pthreads_manage::Pool& pthreads_pool, const std::vector<fem::RayIntervalError>& errors, const RefineSettings& settings) {
+            //Ошибки, посчитанные для сетки до прошлого шага, адресовали бы ячейки за пределами mesh_
+            assert(errors.size() == fan_.count_rays() - 1 && "AdaptiveKirsch::refine: errors.size() == count_rays - 1");
+            double max_error = 0.0;
+            for (const auto& interval : errors)
+                max_error = std::max(max_error, interval.error_);
+            const double threshold = std::max(settings.mark_fraction_ * max_error, settings.tolerance_);
+            const std::size_t cells_on_ray = count_points_on_ray_ - 1;
+
+            //Худшая ячейка отмеченной полосы делится новым лучом, если поперек луча она длиннее в sqrt(2) раз и больше
+            //(после деления отношение сторон лучше, чем до), иначе у края луча меняется q: билинейный элемент, вытянутый
+            //по лучу, от деления полосы только хуже. Направление изменения q луча: +1 - сгустить у отверстия, -1 - разредить
+            std::vector<int> direction(fan_.count_rays(), 0);
+            std::vector<bool> split(errors.size(), false);
+            std::size_t count_marked = 0;
+            for (std::size_t k = 0; k < errors.size(); k++) {
+                if (errors[k].error_ < threshold || errors[k].error_ == 0.0)
+                    continue;
+                ++count_marked;
+                const std::size_t j = errors[k].worst_point_;
+                assert(j < count_points_on_ray_ - 1 && "AdaptiveKirsch::refine: worst_point_ < count_points_on_ray - 1");
+                int change = 0;
+                if (3 * j < cells_on_ray)
+                    change = 1;
+                else if (3 * j >= 2 * cells_on_ray)
+                    change = -1;
+                if (change == 0 || cellLength(k, j, k + 1, j) > std::numbers::sqrt2 * cellLength(k, j, k, j + 1)) {
+                    split[k] = true;
+                    continue;
+                }
+                for (const std::size_t ray : {k, k + 1})
+                    direction[ray] = direction[ray] == 1 ? 1 : change;
+            }
+            if (count_marked == 0)
+                return 0;
+
+            //Сначала разрежение, затем сгущение (оно важнее). Изменение q луча распространяется на соседей так, чтобы
+            //|ln q_{k+1} - ln q_k| <= max_log_slope_ * (угол между лучами): резкая смена q от луча к лучу перекашивает
+            //ячейки у отверстия. Огибающая конусов этого наклона - проход вперед и назад
+            std::vector<double> multipliers(fan_.multipliers_);
+            auto spread = [&](double sign) {
+                auto pull = [&](std::size_t ray, std::size_t neighbour) {
+                    const double band = std::exp(-sign * settings.max_log_slope_ * std::abs(fan_.angles_[ray] - fan_.angles_[neighbour]));
+                    const double bound = multipliers[neighbour] * band;
+                    multipliers[ray] = sign > 0 ? std::max(multipliers[ray], bound) : std::min(multipliers[ray], bound);
+                };
+                for (std::size_t k = 1; k < multipliers.size(); k++)
+                    pull(k, k - 1);
+                for (std::size_t k = multipliers.size() - 1; k > 0; k--)
+                    pull(k - 1, k);
+            };
+            for (std::size_t k = 0; k < multipliers.size(); k++)
+                if (direction[k] < 0)
+                    multipliers[k] = std::max(multipliers[k] / settings.multiplier_step_, settings.min_multiplier_);
+            spread(-1.0);
+            for (std::size_t k = 0; k < multipliers.size(); k++)
+                if (direction[k] > 0)
+                    multipliers[k] = std::min(multipliers[k] * settings.multiplier_step_, settings.max_multiplier_);
+            spread(1.0);
+
+            if (std::none_of(split.begin(), split.end(), [](bool value) { return value; }) && multipliers == fan_.multipliers_)
+                return 0; // q уже на границе допустимого
+
+            RayFan refined;
+            std::vector<std::size_t> sources;
+            for (std::size_t k = 0; k < fan_.count_rays(); k++) {
+                refined.angles_.push_back(fan_.angles_[k]);
+                refined.multipliers_.push_back(multipliers[k]);
+                sources.push_back(multipliers[k] == fan_.multipliers_[k] ? k : new_ray);
+                if (k < split.size() && split[k]) {
+                    refined.angles_.push_back(0.5 * (fan_.angles_[k] + fan_.angles_[k + 1]));
+                    refined.multipliers_.push_back(std::sqrt(multipliers[k] * multipliers[k + 1]));
+                    sources.push_back(new_ray);
+                }
+            }
+            fan_ = std::move(refined);
+            regenerate(pthreads_pool, mesh_, sources);
+            return count_marked;
+        }
+
+    private:
+        ///Расстояние между точкой j1 луча k1 и точкой j2 луча k2
+        [[nodiscard]] double cellLength(std::size_t k1, std::size_t j1, std::size_t k2, std::size_t j2) const noexcept {
+            const std::size_t first = k1 * count_points_on_ray_ + j1, second = k2 * count_points_on_ray_ + j2;
+            return std::hypot(static_cast<double>(mesh_(first, 0)) - static_cast<double>(mesh_(second, 0)),
+                              static_cast<double>(mesh_(first, 1)) - static_cast<double>(mesh_(second, 1)));
+        }
+
+        void regenerate(pthreads_manage::Pool& pthreads_pool, const ContainerT& previous, const std::vector<std::size_t>& sources) {
+            const std::size_t count_rays = fan_.count_rays();
+            auto target = storage::allocate<ContainerT>("v", count_rays * count_points_on_ray_);
+            count_emitted_ = static_cast<std::size_t>(std::count(sources.begin(), sources.end(), new_ray));
+            pthreads_manage::Environment env{
+                                    [](pthreads_manage::IndexRange range, std::size_t chunk_id, const KernelArgsEmitFan<ContainerT>& args) noexcept {
+                                        emitFanDispatch(range, chunk_id, args);
+                                    },
+                                    KernelArgsEmitFan<ContainerT>{static_cast<ScalarT>(radius_hole_), static_cast<ScalarT>(side_size_),
+                                                                  fan_.angles_.data(), fan_.multipliers_.data(), sources.data(),
+                                                                  count_points_on_ray_, previous, target},
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{count_rays, pthreads_pool.rangeChunkSize<Policy>(count_rays), 0}
+                                    };
+            pthreads_pool.dispatchRange<Policy>(count_rays, env);
+            mesh_ = target;
+        }
+
+        double radius_hole_;
+        double side_size_;
+        std::size_t count_points_on_ray_;
+        RayFan fan_;
+        ContainerT mesh_{};
+        std::size_t count_emitted_ = 0;
+    };
+
+}
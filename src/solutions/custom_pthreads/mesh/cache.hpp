@@ -0,0 +1,209 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <unistd.h>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/io/binary.hpp"
+#include "core/storage/storage.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/io/writers.hpp"
+#include "solutions/custom_pthreads/mesh/mesh.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace mesh {
+
+    ///Версия численного результата GenFrameKirsch: увеличивается при любом изменении координат, которые выдает генератор
+    inline constexpr std::uint64_t kirsch_generator_version = 1;
+
+    ///Статистика кэша: попадания, промахи, промахи, результат которых не удалось сохранить, и файлы, которые не удалось отобразить
+    struct CacheStats {
+        std::size_t hits_ = 0;
+        std::size_t misses_ = 0;
+        std::size_t write_errors_ = 0;
+        std::size_t map_errors_ = 0; // Файл не открыт из-за нехватки ресурсов (ENOMEM при vm.max_map_count, EMFILE): сетка генерируется, файл не трогается
+    };
+
+    /**
+     * Сетка из кэша вместе с тем, что держит ее память: отображение файла при попадании или владеющий View при промахе.
+     * Только перемещение; mesh() (и его копии при попадании) действителен, пока жив объект
+     */
+    template <coordinate_storage_like ContainerT>
+    class CachedMesh {
+    public:
+        ///Сгенерированная сетка (промах)
+        explicit CachedMesh(ContainerT mesh) noexcept : mesh_(std::move(mesh)) {}
+
+        ///Отображенный файл (попадание): mesh() - неуправляемый View поверх его узлов
+        explicit CachedMesh(io::MappedBinaryMesh file) noexcept
+                : file_(std::move(file)),
+                  mesh_(static_cast<storage::scalar_t<ContainerT>*>(file_.writable_nodes()), file_.header().count_nodes_) {}
+
+        CachedMesh(CachedMesh&&) noexcept = default;
+        CachedMesh& operator=(CachedMesh&&) noexcept = default;
+
+        [[nodiscard]] const ContainerT& mesh() const noexcept { return mesh_; }
+
+        ///Сетка взята из файла кэша
+        [[nodiscard]] bool mapped() const noexcept { return static_cast<bool>(file_); }
+
+    private:
+        io::MappedBinaryMesh file_; // Перемещение не меняет адрес отображения, поэтому mesh_ остается действительным
+        ContainerT mesh_;
+    };
+
+    /**
+     * Параметры генерации, сохраняемые в метаданных файла кэша. Ключ - лишь 64-битный хэш, поэтому при попадании
+     * параметры сравниваются побайтно: коллизия хэшей дает промах, а не чужую сетку
+     */
+    struct KirschCacheRecord {
+        double radius_hole_ = 0.0;
+        double side_size_ = 0.0;
+        double multiplier_q_ = 0.0;
+        std::uint64_t count_points_on_hole_ = 0;
+        std::uint64_t count_points_on_ray_ = 0;
+        std::uint64_t scalar_size_ = 0;
+        std::uint64_t generator_version_ = kirsch_generator_version;
+
+        [[nodiscard]] std::string_view bytes() const noexcept { return {reinterpret_cast<const char*>(this), sizeof(*this)}; }
+    };
+
+    static_assert(sizeof(KirschCacheRecord) == 56, "запись хранится в файле побайтно, без дыр выравнивания");
+
+    /**
+     * Ключ сетки: FNV-1a от битовых представлений параметров, размера координаты, версии генератора и версии формата.
+     * Изменение любого из них дает другой ключ, поэтому старые файлы просто перестают находиться
+     */
+    template <scalar ScalarT>
+    [[nodiscard]] std::uint64_t kirsch_cache_key(
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) noexcept {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        auto mix = [&hash](std::uint64_t value) {
+            for (std::size_t byte = 0; byte < sizeof(value); byte++) {
+                hash ^= (value >> (8 * byte)) & 0xff;
+                hash *= 0x100000001b3ull;
+            }
+        };
+        mix(kirsch_generator_version);
+        mix(io::binary_version);
+        mix(sizeof(ScalarT));
+        for (double value : {double(radius_hole), double(side_size), double(multiplier_q)})
+            mix(std::bit_cast<std::uint64_t>(value));
+        mix(count_points_on_hole);
+        mix(count_points_on_ray);
+        return hash;
+    }
+
+    /**
+     * Дисковый кэш сеток GenFrameKirsch. При попадании файл кэша отображается в память (MAP_PRIVATE) и возвращается
+     * CachedMesh с неуправляемым View поверх отображения: время запуска - время подкачки страниц, а не генерации.
+     * При промахе сетка генерируется и сохраняется в io::BinaryHeader формате (тег - ключ параметров, метаданные -
+     * KirschCacheRecord) через временный файл, fsync и rename, после чего fsync каталога: параллельные процессы
+     * не видят недописанный файл, а после сбоя питания остается либо старый файл, либо новый целиком.
+     * Файл с неверной сигнатурой, версией, размером, ключом или параметрами считается промахом и перезаписывается.
+     * Отображение принадлежит возвращенному CachedMesh, сам кэш отображений не хранит: число отображений и время их жизни
+     * определяет вызывающий. Каждое попадание получает собственное отображение, поэтому запись в одну сетку
+     * не видна ни в других, ни в файле
+     * @tparam ContainerT Хранилище с x, y подряд (AoS Kokkos::View), например ViewType
+     * @tparam PolicyEmitRays Политика генерации и записи при промахе
+     */
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays>
+        requires writers::contiguous_aos<ContainerT>
+    class KirschMeshCache {
+        using ScalarT = storage::scalar_t<ContainerT>;
+    public:
+        ///@param directory Каталог кэша (создается при первой записи)
+        explicit KirschMeshCache(std::string directory) : directory_(std::move(directory)) {}
+
+        /**
+         * Сетка из кэша или, при промахе, из GenFrameKirsch (параметры как у GenFrameKirsch)
+         * @return CachedMesh - отображение файла при попадании, владеющий View при промахе
+         */
+        [[nodiscard]] CachedMesh<ContainerT> operator() (
+                        pthreads_manage::Pool &pthreads_pool,
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) {
+            const std::uint64_t key = kirsch_cache_key(radius_hole, side_size, multiplier_q, count_points_on_hole, count_points_on_ray);
+            const KirschCacheRecord record{double(radius_hole), double(side_size), double(multiplier_q),
+                                           count_points_on_hole, count_points_on_ray, sizeof(ScalarT)};
+
+            io::MappedBinaryMesh file;
+            const int open_error = file.open(path_of(key), io::MapMode::CopyOnWrite);
+            if (open_error == 0
+                    && file.header().tag_ == key
+                    && file.header().count_nodes_ == count_points_on_hole * count_points_on_ray
+                    && file.header().scalar_size_ == sizeof(ScalarT)
+                    && file.metadata() == record.bytes()) {
+                stats_.hits_++;
+                return CachedMesh<ContainerT>(std::move(file));
+            }
+            //Нехватка памяти, отображений или дескрипторов к файлу отношения не имеет: исправный файл не переписываем
+            const bool out_of_resources = open_error == ENOMEM || open_error == EMFILE || open_error == ENFILE;
+            if (out_of_resources)
+                stats_.map_errors_++;
+
+            stats_.misses_++;
+            ContainerT mesh = GenFrameKirsch<ContainerT, PolicyEmitRays>{}(
+                                    pthreads_pool, radius_hole, side_size, multiplier_q, count_points_on_hole, count_points_on_ray);
+            if (!out_of_resources && store(pthreads_pool, key, record, mesh) != 0)
+                stats_.write_errors_++;
+            return CachedMesh<ContainerT>(std::move(mesh));
+        }
+
+        [[nodiscard]] const CacheStats& stats() const noexcept { return stats_; }
+
+        ///Путь файла кэша для ключа
+        [[nodiscard]] std::string path_of(std::uint64_t key) const {
+            char name[32];
+            std::snprintf(name, sizeof(name), "kirsch_%016llx.bin", static_cast<unsigned long long>(key));
+            return directory_ + "/" + name;
+        }
+
+    private:
+        std::string directory_;
+        CacheStats stats_{};
+
+        ///Запись во временный файл того же каталога, сброс на диск и атомарная замена: 0 или errno
+        [[nodiscard]] int store(pthreads_manage::Pool &pthreads_pool, std::uint64_t key, const KirschCacheRecord& record,
+                                const ContainerT& mesh) const {
+            std::error_code error_code;
+            std::filesystem::create_directories(directory_, error_code);
+            if (error_code)
+                return error_code.value();
+            static std::atomic<std::uint64_t> counter{0};
+            const std::string path = path_of(key);
+            const std::string temporary = path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter++);
+
+            const topology::QuadView no_cells("v", 0);
+            int error = writers::BinaryWriter<PolicyEmitRays>{}(pthreads_pool, temporary, mesh, no_cells, {}, {}, key, record.bytes());
+            if (error == 0)
+                error = io::sync_path(temporary); // Иначе после сбоя rename может оказаться на диске раньше данных
+            if (error == 0 && std::rename(temporary.c_str(), path.c_str()) != 0)
+                error = errno;
+            if (error != 0) {
+                std::remove(temporary.c_str());
+                return error;
+            }
+            return io::sync_path(directory_);
+        }
+    };
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/storage/storage.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace mesh {
+
+    template <std::size_t NodesPerElement>
+    struct KernelArgsConnectivity {
+        topology::ConnectivityView<NodesPerElement> elements_;
+        topology::RayLayout layout_;
+        std::size_t count_rays_in_sector_;
+    };
+
+    struct ConnectivityPartitionerArgs {
+        std::size_t full_size_;
+        std::size_t sector_size_; // Точек в секторе: целое число лучей
+    };
+
+    /**
+     * Ядро сектора: элементы между каждым лучом сектора и следующим за ним.
+     * Ячейка (k, j) - четырехугольник k * (R - 1) + j или треугольники 2 * (k * (R - 1) + j) и 2 * (k * (R - 1) + j) + 1
+     * (ячейка режется диагональю (k, j) - (k + 1, j + 1))
+     */
+    template <std::size_t NodesPerElement, coordinate_source_like ChunkT>
+    void connectivityDispatch(ChunkT sector_storage, std::size_t sector_id, const KernelArgsConnectivity<NodesPerElement>& args) noexcept {
+        const topology::RayLayout layout = args.layout_;
+        const std::size_t first_ray_idx = sector_id * args.count_rays_in_sector_;
+        const std::size_t end_ray_idx = std::min(first_ray_idx + sector_storage.extent(0) / layout.count_points_on_ray_, layout.count_rays_ - 1);
+        const std::size_t count_cells_on_ray = layout.count_points_on_ray_ - 1;
+
+        for (std::size_t ray_idx = first_ray_idx; ray_idx < end_ray_idx; ray_idx++) {
+            for (std::size_t point_idx = 0; point_idx < count_cells_on_ray; point_idx++) {
+                const auto cell = layout.cell(ray_idx, point_idx);
+                const std::size_t cell_idx = ray_idx * count_cells_on_ray + point_idx;
+                if constexpr (NodesPerElement == 4) {
+                    for (std::size_t a = 0; a < 4; a++)
+                        args.elements_(cell_idx, a) = cell[a];
+                } else {
+                    args.elements_(2 * cell_idx, 0) = cell[0];
+                    args.elements_(2 * cell_idx, 1) = cell[1];
+                    args.elements_(2 * cell_idx, 2) = cell[2];
+                    args.elements_(2 * cell_idx + 1, 0) = cell[0];
+                    args.elements_(2 * cell_idx + 1, 1) = cell[2];
+                    args.elements_(2 * cell_idx + 1, 2) = cell[3];
+                }
+            }
+        }
+    }
+
+    /**
+     * Связность элементов сетки GenFrameKirsch (лучи подряд, по count_points_on_ray точек).
+     * Сетка режется на сектора из целых лучей, сектор - сегмент задачи пула; каждый сектор пишет элементы между своими лучами
+     * и следующими, поэтому сектора не пересекаются по записи
+     * @tparam PolicyElements Sequential - вызывающим потоком, Parallel - сектор на поток, WorkStealing - мелкие сектора с кражей
+     */
+    template <execution_policy PolicyElements>
+    struct GenConnectivityKirsch {
+        /**
+         * Четырехугольники, узлы против часовой стрелки
+         * @param pthreads_pool
+         * @param mesh Узлы сетки
+         * @param count_points_on_ray Количество точек на луче (>= 2)
+         * @return QuadView из (count_rays - 1) * (count_points_on_ray - 1) элементов
+         */
+        template <coordinate_source_like ContainerT>
+        [[nodiscard]] topology::QuadView quads(pthreads_manage::Pool &pthreads_pool, const ContainerT& mesh, std::size_t count_points_on_ray) const noexcept {
+            return generate<4>(pthreads_pool, mesh, count_points_on_ray, 1);
+        }
+
+        ///Треугольники (по два на ячейку), узлы против часовой стрелки
+        template <coordinate_source_like ContainerT>
+        [[nodiscard]] topology::TriView triangles(pthreads_manage::Pool &pthreads_pool, const ContainerT& mesh, std::size_t count_points_on_ray) const noexcept {
+            return generate<3>(pthreads_pool, mesh, count_points_on_ray, 2);
+        }
+
+    private:
+        template <std::size_t NodesPerElement, coordinate_source_like ContainerT>
+        [[nodiscard]] topology::ConnectivityView<NodesPerElement> generate(
+                                                            pthreads_manage::Pool &pthreads_pool,
+                                                            const ContainerT& mesh,
+                                                            std::size_t count_points_on_ray,
+                                                            std::size_t elements_per_cell
+                                                            ) const noexcept {
+            const topology::RayLayout layout{mesh.extent(0) / count_points_on_ray, count_points_on_ray};
+            topology::ConnectivityView<NodesPerElement> elements(
+                                                    Kokkos::view_alloc(Kokkos::WithoutInitializing, "elements"),
+                                                    layout.count_cells() * elements_per_cell
+                                                    );
+
+            std::size_t max_sectors;
+            if constexpr (is_parallel<PolicyElements>)
+                max_sectors = pthreads_pool.totalThreads();
+            else if constexpr (is_work_stealing<PolicyElements>)
+                max_sectors = pthreads_pool.totalThreads() * pthreads_manage::chunks_per_thread_stealing;
+            else
+                max_sectors = 1;
+            const std::size_t count_rays_in_sector = (layout.count_rays_ + max_sectors - 1) / max_sectors;
+
+            pthreads_manage::Environment env{
+                                    [](auto sector_storage, std::size_t sector_id, const KernelArgsConnectivity<NodesPerElement>& args) noexcept {
+                                        connectivityDispatch<NodesPerElement>(sector_storage, sector_id, args);
+                                    },
+                                    KernelArgsConnectivity<NodesPerElement>{elements, layout, count_rays_in_sector},
+                                    [](const ConnectivityPartitionerArgs& args) noexcept {
+                                        return pthreads_manage::PartitionerSettings{args.full_size_, args.sector_size_, 0};
+                                    },
+                                    ConnectivityPartitionerArgs{layout.count_nodes(), count_rays_in_sector * count_points_on_ray}
+                                    };
+            pthreads_pool.template dispatchJob<PolicyElements>(mesh, env);
+            return elements;
+        }
+    };
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <numbers>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/kernels/kernels.hpp"
+#include "core/storage/storage.hpp"
+#include "solutions/custom_pthreads/mesh/mesh.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace mesh {
+
+    ///Аргументы ядра сетки фиксированного размера: таблицы общие для всех лучей и живут на стеке вызывающего (dispatch синхронный)
+    template <typename ScalarT, std::size_t CountPointsOnHole, std::size_t CountPointsOnRay, coordinate_storage_like ContainerT>
+    struct KernelArgsFixedKirsch {
+        const std::array<ScalarT, 2 * CountPointsOnHole>* hole_points_; // x0 y0 x1 y1 ... (AoS)
+        const std::array<ScalarT, CountPointsOnRay>* numerators_;
+        ScalarT side_size_;
+        ScalarT multiplier_q_;
+        ContainerT mesh_storage_;
+    };
+
+    ///Ядро сетки фиксированного размера: сегмент - диапазон лучей, у каждого луча CountPointsOnRay итераций
+    template <typename ScalarT, std::size_t CountPointsOnHole, std::size_t CountPointsOnRay, coordinate_storage_like ContainerT>
+    void fixedKirschDispatch(pthreads_manage::IndexRange range, std::size_t, const KernelArgsFixedKirsch<ScalarT, CountPointsOnHole, CountPointsOnRay, ContainerT>& args) noexcept {
+        using p_type = geometry::Point2D<ScalarT>;
+        const p_type zero_point{ScalarT(0.0), ScalarT(0.0)};
+        const p_type first_point_right_edge{args.side_size_, ScalarT(0.0)};
+        const p_type first_point_up_edge{ScalarT(0.0), args.side_size_};
+        const p_type second_point_edge{args.side_size_, args.side_size_};
+        for (std::size_t ray_idx = range.begin_; ray_idx < range.end_; ++ray_idx) {
+            const p_type hole_point{(*args.hole_points_)[2 * ray_idx], (*args.hole_points_)[2 * ray_idx + 1]};
+            const p_type& first_point_edge = (hole_point.y <= hole_point.x) ? first_point_right_edge : first_point_up_edge;
+            const auto frame = kernels::make_ray_frame(zero_point, hole_point, first_point_edge, second_point_edge, args.multiplier_q_, CountPointsOnRay);
+            kernels::fill_ray_fixed(frame, *args.numerators_,
+                                    storage::subrange(args.mesh_storage_, ray_idx * CountPointsOnRay, (ray_idx + 1) * CountPointsOnRay));
+        }
+    }
+
+    /**
+     * GenFrameKirsch для фиксированной дискретизации: количества точек - параметры шаблона.
+     * Точки на отверстии и числители 1 - q^i считаются один раз на сетку в таблицы std::array известного размера
+     * (при constexpr q таблица числителей - kernels::ray_parameter_numerators - вычисляется компилятором),
+     * лучи заполняются циклами с известной длиной. Раскладка та же: луч k занимает [k * CountPointsOnRay, (k + 1) * CountPointsOnRay),
+     * точки совпадают с GenFrameKirsch с точностью до округления
+     * @tparam ContainerT Хранилище сетки
+     * @tparam Policy Sequential, Parallel или WorkStealing (распределение лучей по потокам)
+     * @tparam CountPointsOnHole Точек на отверстии (= лучей, >= 2)
+     * @tparam CountPointsOnRay Точек на луче (>= 2). Таблицы обеих дискретизаций вместе - не больше kernels::max_fixed_table_bytes
+     * @tparam ComputeT Тип вычислений, как у GenFrameKirsch
+     */
+    template <coordinate_storage_like ContainerT, execution_policy Policy, std::size_t CountPointsOnHole, std::size_t CountPointsOnRay,
+              scalar ComputeT = storage::scalar_t<ContainerT>>
+    requires (CountPointsOnHole >= 2 && CountPointsOnRay >= 2)
+    struct GenFrameKirschFixed {
+        using ScalarT = ComputeT;
+        static constexpr std::size_t count_points = CountPointsOnHole * CountPointsOnRay;
+        static_assert((2 * CountPointsOnHole + CountPointsOnRay) * sizeof(ScalarT) <= kernels::max_fixed_table_bytes,
+                      "таблицы точек на отверстии и числителей не помещаются в предел стека: используйте GenFrameKirsch");
+
+        [[nodiscard]] ContainerT operator() (pthreads_manage::Pool &pthreads_pool, ScalarT radius_hole, ScalarT side_size, ScalarT multiplier_q) const {
+            auto mesh_storage = storage::allocate<ContainerT>("v", count_points);
+            fill(pthreads_pool, mesh_storage, radius_hole, side_size, multiplier_q);
+            return mesh_storage;
+        }
+
+        ///Генерация в заранее выделенное хранилище из count_points точек (например, над std::array - без выделений памяти)
+        void fill(pthreads_manage::Pool &pthreads_pool, ContainerT mesh_storage, ScalarT radius_hole, ScalarT side_size, ScalarT multiplier_q) const noexcept {
+            assert(mesh_storage.extent(0) == count_points && "GenFrameKirschFixed: mesh_storage.extent(0) == count_points");
+            std::array<ScalarT, 2 * CountPointsOnHole> hole_points;
+            kernels::fill_circle_arc_uniform(ScalarT(0.0), ScalarT(std::numbers::pi / 2.0), radius_hole,
+                                             storage::AoSView<ScalarT>(hole_points.data(), CountPointsOnHole));
+            const auto numerators = kernels::ray_parameter_numerators<CountPointsOnRay>(multiplier_q);
+
+            using ArgsT = KernelArgsFixedKirsch<ScalarT, CountPointsOnHole, CountPointsOnRay, ContainerT>;
+            pthreads_manage::Environment env{
+                                    [](pthreads_manage::IndexRange range, std::size_t chunk_id, const ArgsT& args) noexcept {
+                                        fixedKirschDispatch(range, chunk_id, args);
+                                    },
+                                    ArgsT{&hole_points, &numerators, side_size, multiplier_q, mesh_storage},
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{CountPointsOnHole, pthreads_pool.rangeChunkSize<Policy>(CountPointsOnHole), 0}
+                                    };
+            pthreads_pool.dispatchRange<Policy>(CountPointsOnHole, env);
+        }
+    };
+
+}
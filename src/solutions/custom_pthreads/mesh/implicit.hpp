@@ -0,0 +1,98 @@
+#pragma once
+#include <numbers>
+#include <Kokkos_Core.hpp>
+#include "core/custom_concepts.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/kernels/kernels.hpp"
+#include "core/storage/implicit.hpp"
+#include "core/storage/storage.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace mesh {
+
+    /**
+     * Неявная сетка Кирша: те же параметры и та же геометрия, что у GenFrameKirsch, но вместо координат
+     * строятся таблицы storage::ImplicitKirschMesh (O(count_points_on_hole + count_points_on_ray), пул не нужен)
+     * @tparam ScalarT Тип хранения и вычисления координат
+     */
+    template <scalar ScalarT = double>
+    struct GenImplicitKirsch {
+        /**
+         * @param radius_hole
+         * @param side_size Размер стороны пластины (пластина квадратная)
+         * @param multiplier_q Основание геометрической прогрессии (q != 1)
+         * @param count_points_on_hole Количество точек на отверстии (= количество лучей, >= 2)
+         * @param count_points_on_ray Количество точек на луче (>= 2)
+         */
+        [[nodiscard]] storage::ImplicitKirschMesh<ScalarT> operator() (
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) const {
+            using p_type = geometry::Point2D<ScalarT>;
+            using mesh_type = storage::ImplicitKirschMesh<ScalarT>;
+            auto hole_points = storage::allocate<storage::AoSView<ScalarT>>("v", count_points_on_hole);
+            kernels::fill_circle_arc_uniform(ScalarT(0.0), ScalarT(std::numbers::pi/2.0), radius_hole, hole_points);
+
+            const p_type zero_point{ScalarT(0.0), ScalarT(0.0)};
+            const p_type first_point_right_edge{side_size, ScalarT(0.0)};
+            const p_type first_point_up_edge{ScalarT(0.0), side_size};
+            const p_type second_point_edge{side_size, side_size};
+
+            auto ray_starts = storage::allocate<typename mesh_type::rays_type>("ray_starts", count_points_on_hole);
+            auto ray_steps = storage::allocate<typename mesh_type::rays_type>("ray_steps", count_points_on_hole);
+            for (std::size_t ray_idx = 0; ray_idx < count_points_on_hole; ray_idx++) {
+                const p_type hole_point{hole_points(ray_idx, 0), hole_points(ray_idx, 1)};
+                const p_type first_point_edge = (hole_point.y <= hole_point.x) ? first_point_right_edge : first_point_up_edge;
+                const auto frame = kernels::make_ray_frame(zero_point, hole_point, first_point_edge, second_point_edge, multiplier_q, count_points_on_ray);
+                //Шаг - как в fill_ray_segment_nonuniform: направление * (длина / знаменатель)
+                const ScalarT scale = (frame.end_point_ - frame.start_point_).GetL2Norm() / frame.denominator_;
+                ray_starts(ray_idx, 0) = frame.start_point_.x;
+                ray_starts(ray_idx, 1) = frame.start_point_.y;
+                ray_steps(ray_idx, 0) = frame.normalized_direction_.x * scale;
+                ray_steps(ray_idx, 1) = frame.normalized_direction_.y * scale;
+            }
+
+            typename mesh_type::numerators_type numerators(Kokkos::view_alloc(Kokkos::WithoutInitializing, "numerators"), count_points_on_ray);
+            kernels::fill_ray_parameter_numerators(multiplier_q, count_points_on_ray, numerators.data());
+            return mesh_type(ray_starts, ray_steps, numerators);
+        }
+    };
+
+    ///Аргументы ядра материализации: источник (сегмент неявной сетки) и хранилище результата
+    template <scalar ScalarT, coordinate_storage_like ContainerT>
+    struct KernelArgsMaterialize {
+        storage::ImplicitKirschMesh<ScalarT> source_;
+        ContainerT target_;
+    };
+
+    /**
+     * Материализация узлов [begin, end) неявной сетки в новое хранилище: сегменты диапазона заполняют потоки пула.
+     * Результат совпадает с соответствующим сегментом GenFrameKirsch с точностью до сжатия в FMA
+     * @tparam ContainerT Хранилище результата
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     */
+    template <coordinate_storage_like ContainerT, execution_policy Policy, scalar ScalarT>
+    [[nodiscard]] ContainerT materialize(
+                        pthreads_manage::Pool &pthreads_pool,
+                        const storage::ImplicitKirschMesh<ScalarT>& implicit_mesh,
+                        std::size_t begin,
+                        std::size_t end
+                        ) {
+        const std::size_t count_nodes = end - begin;
+        auto result = storage::allocate<ContainerT>("v", count_nodes);
+        pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange range, std::size_t, const KernelArgsMaterialize<ScalarT, ContainerT>& args) noexcept {
+                                    args.source_.materialize(range.begin_, storage::subrange(args.target_, range.begin_, range.end_));
+                                },
+                                KernelArgsMaterialize<ScalarT, ContainerT>{implicit_mesh.subrange(begin, end), result},
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{count_nodes, pthreads_pool.rangeChunkSize<Policy>(count_nodes), 0}
+                                };
+        pthreads_pool.dispatchRange<Policy>(count_nodes, env);
+        return result;
+    }
+
+}
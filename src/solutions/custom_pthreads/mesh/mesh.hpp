@@ -2,16 +2,19 @@
 #include <Kokkos_Core.hpp>
 #include "core/custom_concepts.hpp"
 #include "core/geometry/geometry.hpp"
+#include "core/storage/pages.hpp"
+#include "core/storage/storage.hpp"
+#include "core/storage/workspace.hpp"
 #include "solutions/custom_pthreads/grid/grid.hpp"
 
 namespace mesh {
 
     /**
-     * Функция выпуска луча в 2D пространстве из точки zero_point, проходящий через точку на отверстии hole_storage[idx_point_on_hole]
-     * со значениями от hole_point до точки пересечения с границей пластины
+     * Функция выпуска луча в 2D пространстве из точки zero_point, проходящий через точку на отверстии hole_point
+     * со значениями от hole_point до точки пересечения с границей пластины.
+     * Луч заполняется последовательно вызвавшим потоком (функция вызывается изнутри ядер пула)
      * @tparam ContainerT
      * @tparam ScalarT
-     * @tparam PolicyFillRay Вызов функции GenNonUniformOnRay (Parallel/Sequential)
      * @param zero_point
      * @param hole_point
      * @param first_point_edge Граница задается двумя точками (first_point_edge, second_point_edge)
@@ -19,7 +22,7 @@ namespace mesh {
      * @param multiplier_q
      * @param ray_storage
      */
-    template <kokkos_view_2d_like ContainerT, execution_policy PolicyFillRay, typename ScalarT>
+    template <coordinate_storage_like ContainerT, typename ScalarT>
     void emit_ray(
                 const geometry::Point2D<ScalarT> &zero_point,
                 const geometry::Point2D<ScalarT> &hole_point,
@@ -29,28 +32,98 @@ namespace mesh {
                 ContainerT ray_storage
                 ) noexcept;
 
-    template <kokkos_view_2d_like ContainerT, execution_policy PolicyEmitRays>
+    ///Размещение страниц сетки в памяти
+    struct MeshPlacement {
+        bool first_touch_ = false; // Перед генерацией касание страниц тем же разделителем и Policy; поток совпадает только для главных лучей при Parallel
+        bool transparent_huge_pages_ = false; // madvise(MADV_HUGEPAGE) на выделенную память (действует на сетки от huge_page_size)
+    };
+
+    /**
+     * @tparam ContainerT Хранилище сетки (раскладка и тип хранения координат)
+     * @tparam PolicyEmitRays
+     * @tparam ComputeT Тип, в котором считаются координаты. По умолчанию совпадает с типом хранилища;
+     * double при float хранилище - смешанная точность (считаем в double, храним float).
+     * Для float вычислений q^(count_points_on_ray - 1) должно помещаться во float
+     */
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays, scalar ComputeT = storage::scalar_t<ContainerT>>
     struct GenFrameKirsch {
-        using ScalarT = ContainerT::value_type;
+        using ScalarT = ComputeT;
+        MeshPlacement placement_{};
         /**
-         * Генерация каркаса сетки
-         * Каркас сетки имеет вид | ___ | ___ | ___ | , где | - главные лучи, разделяющие сетку на сектора по потокам. _ - внутренние лучи, генерируемые внутри сектора потоком
+         * Генерация сетки за один параллельный проход
+         * Сетка имеет вид | ___ | ___ | ___ | , где | - главные лучи, разделяющие сетку на сектора по потокам. _ - внутренние лучи сектора.
+         * Сектор - сегмент задачи пула; его внутренние лучи ставятся вложенной задачей, которую разбирают освободившиеся потоки.
+         * Лучи лежат в памяти подряд: луч k занимает [k * count_points_on_ray, (k + 1) * count_points_on_ray)
          * @param pthreads_pool Менеджер потоков
          * @param radius_hole
          * @param side_size Размер стороны пластины (пластина квадратная)
-         * @param multiplier_q Основание геометрической прогрессии для роста интервала между точками для сторон пластины, прилежащих к отверстию
-         * @param count_points_on_hole Требуемое общее количество точек на отверстии (count_points_on_hole - 1) % threads == 0
-         * @param count_points_on_ray Количество точек на луче
-         * @return Kokkos::View<double*[2], Kokkos::LayoutRight, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Restrict | Kokkos::Aligned>>; (ViewType)
+         * @param multiplier_q Основание геометрической прогрессии для роста интервала между точками для сторон пластины, прилежащих к отверстию (q != 1)
+         * @param count_points_on_hole Требуемое общее количество точек на отверстии (= количество лучей, >= 2).
+         * Количество секторов - наибольший делитель (count_points_on_hole - 1), не превосходящий число потоков
+         * @param count_points_on_ray Количество точек на луче (>= 2)
+         * @return ContainerT - хранилище выбранной раскладки (ViewType, storage::SoAView, storage::AoSoAView)
          */
-        [[nodiscard]] ViewType operator() (
+        [[nodiscard]] ContainerT operator() (
                         pthreads_manage::Pool &pthreads_pool,
                         ScalarT radius_hole,
                         ScalarT side_size,
                         ScalarT multiplier_q,
-                        std::size_t count_points_on_hole, // (count_points_on_hole - 1) % threads == 0
+                        std::size_t count_points_on_hole,
                         std::size_t count_points_on_ray
                         ) const noexcept;
+
+        /**
+         * Генерация в арене: сетка и временные точки на отверстии берутся из workspace, куча не используется,
+         * если области арены хватает (после первого reset() цикла с теми же размерами). Сетка действительна до workspace.reset().
+         * placement_ не применяется (ни first_touch_, ни transparent_huge_pages_): размещение страниц определяет область арены
+         */
+        [[nodiscard]] ContainerT operator() (
+                        pthreads_manage::Pool &pthreads_pool,
+                        storage::Workspace &workspace,
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) const;
+
+        /**
+         * Генерация в заранее выделенное хранилище из count_points_on_hole * count_points_on_ray точек
+         * (например, storage::wrap над storage::PageBuffer с огромными страницами). transparent_huge_pages_ не применяется
+         */
+        void fill(
+                pthreads_manage::Pool &pthreads_pool,
+                ContainerT mesh_storage,
+                ScalarT radius_hole,
+                ScalarT side_size,
+                ScalarT multiplier_q,
+                std::size_t count_points_on_hole,
+                std::size_t count_points_on_ray
+                ) const noexcept;
+
+        ///То же, временные точки на отверстии - из workspace
+        void fill(
+                pthreads_manage::Pool &pthreads_pool,
+                storage::Workspace &workspace,
+                ContainerT mesh_storage,
+                ScalarT radius_hole,
+                ScalarT side_size,
+                ScalarT multiplier_q,
+                std::size_t count_points_on_hole,
+                std::size_t count_points_on_ray
+                ) const;
+
+    private:
+        void fillWithHole(
+                pthreads_manage::Pool &pthreads_pool,
+                ContainerT mesh_storage,
+                storage::AoSView<ScalarT> hole_storage,
+                ScalarT radius_hole,
+                ScalarT side_size,
+                ScalarT multiplier_q,
+                std::size_t count_points_on_ray,
+                bool first_touch
+                ) const noexcept;
     };
 
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <cassert>
+#include <numbers>
 
 namespace mesh {
     template <typename ScalarT>
@@ -6,8 +8,18 @@ namespace mesh {
         geometry::Point2D<ScalarT> zero_point_;
         geometry::Point2D<ScalarT> first_point_right_edge_, first_point_up_edge_, second_point_edge_;
         ScalarT multiplier_q_;
+        std::size_t count_rays_in_sector_; // Лучей в секторе без правого главного луча (он принадлежит следующему сектору)
         std::size_t count_sectors_;
-        ViewType hole_storage_;
+        std::size_t count_points_on_ray_;
+        storage::AoSView<ScalarT> hole_storage_; // Точки на отверстии в типе вычислений
+        pthreads_manage::Pool* pthreads_pool_; // nullptr - внутренние лучи заполняются последовательно
+    };
+
+    ///Аргументы вложенной задачи: внутренние лучи одного сектора
+    template <typename ScalarT>
+    struct KernelArgsSlaveRays {
+        const KernelArgsEmitRay<ScalarT>* common_;
+        std::size_t first_ray_idx_; // Глобальный номер первого внутреннего луча сектора
     };
 
     struct PartitionerArgs {
@@ -16,68 +28,209 @@ namespace mesh {
         std::size_t count_rays_between_masters_;
         std::size_t count_sectors_;
     };
-    ///Разделение по принципу 1 сектор = 1 поток
-    inline pthreads_manage::PartitionerSettings partitioner(void* args) {
-        auto* args_ptr = static_cast<PartitionerArgs*>(args);
-        std::size_t count_points_on_ray = args_ptr->count_points_on_ray_;
-        std::size_t count_rays_between_masters = args_ptr->count_rays_between_masters_;
+    ///Разделение по принципу 1 сектор = 1 сегмент
+    inline pthreads_manage::PartitionerSettings partitioner(const PartitionerArgs& args) noexcept {
+        std::size_t count_points_on_ray = args.count_points_on_ray_;
+        std::size_t count_rays_between_masters = args.count_rays_between_masters_;
         //Сетка имеет вид: |---|---|
         //Внутреннее незаполненное пространство для последующего заполнения сетки без учета краевых лучей сектора
         std::size_t size_inner_space = count_rays_between_masters * count_points_on_ray;
         std::size_t size_entire_sector = size_inner_space + 2 * count_points_on_ray; // | --- |
         return pthreads_manage::PartitionerSettings{
-                                            args_ptr->full_size_,
+                                            args.full_size_,
                                  size_entire_sector,
-                                            args_ptr->count_points_on_ray_, // Пересечение двух секторов = крайний луч
+                                            args.count_points_on_ray_, // Пересечение двух секторов = крайний луч
                                         };
 
     }
 
-    template <kokkos_view_2d_like ContainerT>
-    void* threadDispatch(ViewType ray_storage, std::size_t tid, void* args){
-        using ScalarT = ContainerT::value_type;
+    struct RayPartitionerArgs {
+        std::size_t full_size_;
+        std::size_t count_points_on_ray_;
+    };
+    ///Разделение по принципу 1 луч = 1 сегмент (для вложенной задачи внутренних лучей)
+    inline pthreads_manage::PartitionerSettings ray_partitioner(const RayPartitionerArgs& args) noexcept {
+        return pthreads_manage::PartitionerSettings{args.full_size_, args.count_points_on_ray_, 0};
+    }
+
+    ///Наибольшее количество секторов, не превосходящее max_sectors, на которое делятся все интервалы между лучами
+    [[nodiscard]] inline std::size_t count_sectors_for(std::size_t count_ray_intervals, std::size_t max_sectors) noexcept {
+        for (std::size_t count_sectors = std::min(max_sectors, count_ray_intervals); count_sectors > 1; --count_sectors) {
+            if (count_ray_intervals % count_sectors == 0)
+                return count_sectors;
+        }
+        return 1;
+    }
+
+    ///Выпуск луча с глобальным номером ray_idx. Граница пластины выбирается по точке на отверстии: до 45 градусов - правая, после - верхняя
+    template <typename ScalarT, coordinate_storage_like ChunkT>
+    void emit_ray_by_idx(const KernelArgsEmitRay<ScalarT>& args, std::size_t ray_idx, ChunkT ray_storage) noexcept {
         using p_type = geometry::Point2D<ScalarT>;
-        auto* args_ptr = static_cast<KernelArgsEmitRay<ScalarT>*>(args);
-        //Начальная точка границы, с которой ищем пересечение зависит от сектора из которого выпускаем луч (т.е. номера потока)
-        auto first_point_edge = (tid >= args_ptr->count_sectors_ /2) ? args_ptr->first_point_up_edge_ : args_ptr->first_point_right_edge_;
-        emit_ray<Sequential>( // Заполняем сетку последовательно, поскольку доступных потоков нет
-            args_ptr->zero_point,
-            p_type{args_ptr->hole_storage_(tid, 0), args_ptr->hole_grid_tmp(tid, 1)},
+        p_type hole_point{args.hole_storage_(ray_idx, 0), args.hole_storage_(ray_idx, 1)};
+        auto first_point_edge = (hole_point.y <= hole_point.x) ? args.first_point_right_edge_ : args.first_point_up_edge_;
+        emit_ray(
+            args.zero_point_,
+            hole_point,
             first_point_edge,
-            args_ptr->second_point_edge,
-            args_ptr->multiplier_q,
+            args.second_point_edge_,
+            args.multiplier_q_,
             ray_storage
             );
-        return nullptr;
     }
 
-    template <kokkos_view_2d_like ContainerT, execution_policy PolicyEmitRays>
-    ViewType GenFrameKirsch<ContainerT, PolicyEmitRays>::operator() (
+    ///Ядро вложенной задачи: сегмент = один внутренний луч
+    template <typename ScalarT, coordinate_storage_like ChunkT>
+    void slaveRaysDispatch(ChunkT ray_storage, std::size_t chunk_id, const KernelArgsSlaveRays<ScalarT>& args) noexcept {
+        emit_ray_by_idx(*args.common_, args.first_ray_idx_ + chunk_id, ray_storage);
+    }
+
+    /**
+     * Ядро сектора: левый главный луч (и правый у последнего сектора) заполняет сам поток,
+     * внутренние лучи ставятся вложенной задачей, чтобы их разобрали освободившиеся потоки
+     */
+    template <typename ScalarT, coordinate_storage_like ChunkT>
+    void sectorDispatch(ChunkT sector_storage, std::size_t sector_id, const KernelArgsEmitRay<ScalarT>& args) noexcept {
+        const auto* args_ptr = &args;
+        const std::size_t count_points_on_ray = args_ptr->count_points_on_ray_;
+        const std::size_t count_rays = args_ptr->count_rays_in_sector_;
+        const std::size_t first_ray_idx = sector_id * count_rays;
+        //Соседние сектора пересекаются по главному лучу, поэтому правый главный луч заполняет только последний сектор
+        auto ray = [&](std::size_t local_ray_idx) {
+            return storage::subrange(sector_storage, local_ray_idx * count_points_on_ray, (local_ray_idx + 1) * count_points_on_ray);
+        };
+
+        emit_ray_by_idx(*args_ptr, first_ray_idx, ray(0));
+        if (sector_id + 1 == args_ptr->count_sectors_)
+            emit_ray_by_idx(*args_ptr, first_ray_idx + count_rays, ray(count_rays));
+
+        if (count_rays < 2)
+            return;
+        auto slave_rays = storage::subrange(sector_storage, count_points_on_ray, count_rays * count_points_on_ray);
+        //Вложенная задача возвращается после заполнения всех лучей, поэтому окружение живет на стеке ядра
+        pthreads_manage::Environment env{
+                                [](auto ray_storage, std::size_t chunk_id, const KernelArgsSlaveRays<ScalarT>& slave_args) noexcept {
+                                    slaveRaysDispatch(ray_storage, chunk_id, slave_args);
+                                },
+                                KernelArgsSlaveRays<ScalarT>{args_ptr, first_ray_idx + 1},
+                                [](const RayPartitionerArgs& part_args) noexcept { return ray_partitioner(part_args); },
+                                RayPartitionerArgs{slave_rays.extent(0), count_points_on_ray}
+                                };
+        if (args_ptr->pthreads_pool_ == nullptr)
+            pthreads_manage::run_sequential(slave_rays, env);
+        else
+            args_ptr->pthreads_pool_->template dispatchNestedJob<Parallel>(slave_rays, env);
+    }
+
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays, scalar ComputeT>
+    ContainerT GenFrameKirsch<ContainerT, PolicyEmitRays, ComputeT>::operator() (
                                 pthreads_manage::Pool &pthreads_pool,
                                 ScalarT radius_hole,
                                 ScalarT side_size,
                                 ScalarT multiplier_q,
-                                std::size_t count_points_on_hole, // (count_points_on_hole - 1) % threads == 0
+                                std::size_t count_points_on_hole,
                                 std::size_t count_points_on_ray
                                 ) const noexcept {
-        std::size_t count_sectors;
-        if constexpr (is_parallel<PolicyEmitRays>)
-            count_sectors = pthreads_pool.totalThreads();
-        else
-            count_sectors = 1;
+        auto mesh_storage = storage::allocate<ContainerT>("v", count_points_on_hole * count_points_on_ray);
+        if (placement_.transparent_huge_pages_) {
+            const auto [data, bytes] = storage::memory_span(mesh_storage);
+            (void)storage::advise_huge_pages(data, bytes); // Без поддержки THP сетка остается на страницах 4K
+        }
+        fill(pthreads_pool, mesh_storage, radius_hole, side_size, multiplier_q, count_points_on_hole, count_points_on_ray);
+        return mesh_storage;
+    }
 
-        std::size_t count_master_rays_total = count_sectors + 1;
-        std::size_t count_slave_rays_total = count_points_on_hole - count_master_rays_total;
-        std::size_t count_slaves_between_masters = count_master_rays_total / count_sectors;
-        std::size_t mesh_size = (count_master_rays_total + count_slave_rays_total) * count_points_on_ray;
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays, scalar ComputeT>
+    ContainerT GenFrameKirsch<ContainerT, PolicyEmitRays, ComputeT>::operator() (
+                                pthreads_manage::Pool &pthreads_pool,
+                                storage::Workspace &workspace,
+                                ScalarT radius_hole,
+                                ScalarT side_size,
+                                ScalarT multiplier_q,
+                                std::size_t count_points_on_hole,
+                                std::size_t count_points_on_ray
+                                ) const {
+        auto mesh_storage = workspace.take<ContainerT>(count_points_on_hole * count_points_on_ray);
+        auto hole_storage = workspace.take<storage::AoSView<ScalarT>>(count_points_on_hole);
+        //Страницы арены уже размещены прошлыми проходами цикла: касаться их заново незачем
+        fillWithHole(pthreads_pool, mesh_storage, hole_storage, radius_hole, side_size, multiplier_q, count_points_on_ray, false);
+        return mesh_storage;
+    }
 
-        auto alloc = Kokkos::view_alloc(Kokkos::WithoutInitializing, "v");
-        auto mesh_storage = ViewType(alloc, mesh_size);
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays, scalar ComputeT>
+    void GenFrameKirsch<ContainerT, PolicyEmitRays, ComputeT>::fill(
+                                pthreads_manage::Pool &pthreads_pool,
+                                storage::Workspace &workspace,
+                                ContainerT mesh_storage,
+                                ScalarT radius_hole,
+                                ScalarT side_size,
+                                ScalarT multiplier_q,
+                                std::size_t count_points_on_hole,
+                                std::size_t count_points_on_ray
+                                ) const {
+        auto hole_storage = workspace.take<storage::AoSView<ScalarT>>(count_points_on_hole);
+        fillWithHole(pthreads_pool, mesh_storage, hole_storage, radius_hole, side_size, multiplier_q, count_points_on_ray, placement_.first_touch_);
+    }
 
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays, scalar ComputeT>
+    void GenFrameKirsch<ContainerT, PolicyEmitRays, ComputeT>::fill(
+                                pthreads_manage::Pool &pthreads_pool,
+                                ContainerT mesh_storage,
+                                ScalarT radius_hole,
+                                ScalarT side_size,
+                                ScalarT multiplier_q,
+                                std::size_t count_points_on_hole,
+                                std::size_t count_points_on_ray
+                                ) const noexcept {
         //Временная сетка для отверстия, для стартовой генерации. В итоговой сетке точки на окружности будут автоматически из за первой точки лучей
-        auto hole_grid_tmp = ViewType(alloc, count_master_rays_total);
+        auto hole_grid_tmp = storage::allocate<storage::AoSView<ScalarT>>("v", count_points_on_hole);
+        fillWithHole(pthreads_pool, mesh_storage, hole_grid_tmp, radius_hole, side_size, multiplier_q, count_points_on_ray, placement_.first_touch_);
+    }
+
+    template <coordinate_storage_like ContainerT, execution_policy PolicyEmitRays, scalar ComputeT>
+    void GenFrameKirsch<ContainerT, PolicyEmitRays, ComputeT>::fillWithHole(
+                                pthreads_manage::Pool &pthreads_pool,
+                                ContainerT mesh_storage,
+                                storage::AoSView<ScalarT> hole_storage,
+                                ScalarT radius_hole,
+                                ScalarT side_size,
+                                ScalarT multiplier_q,
+                                std::size_t count_points_on_ray,
+                                bool first_touch
+                                ) const noexcept {
+        const std::size_t count_points_on_hole = hole_storage.extent(0);
+        //Меньше двух лучей - нет интервалов между ними (count_rays_in_sector - 1 переполнится), меньше двух точек - шаг по лучу 1 / 0
+        assert(count_points_on_hole >= 2 && "GenFrameKirsch: count_points_on_hole >= 2");
+        assert(count_points_on_ray >= 2 && "GenFrameKirsch: count_points_on_ray >= 2");
+        assert(mesh_storage.extent(0) == count_points_on_hole * count_points_on_ray);
+        std::size_t max_sectors;
+        if constexpr (is_parallel<PolicyEmitRays>)
+            max_sectors = pthreads_pool.totalThreads();
+        else if constexpr (is_work_stealing<PolicyEmitRays>)
+            max_sectors = pthreads_pool.totalThreads() * pthreads_manage::chunks_per_thread_stealing;
+        else
+            max_sectors = 1;
+
+        std::size_t count_ray_intervals = count_points_on_hole - 1;
+        std::size_t count_sectors = count_sectors_for(count_ray_intervals, max_sectors);
+        std::size_t count_rays_in_sector = count_ray_intervals / count_sectors;
+        std::size_t count_slaves_between_masters = count_rays_in_sector - 1;
+        std::size_t mesh_size = count_points_on_hole * count_points_on_ray;
+        const PartitionerArgs partitioner_args{mesh_size, count_points_on_ray, count_slaves_between_masters, count_sectors};
 
-        kernels::fill_circle_arc_uniform(0.0, std::numbers::pi/2.0, radius_hole, hole_grid_tmp);
+        if (first_touch) {
+            //Разбиение как у генерации. При Parallel сегмент i касается и главный луч сектора i пишет поток i; внутренние лучи
+            //пишет вложенная задача любыми свободными потоками, а при WorkStealing сектора перехватываются - для них
+            //размещение лишь приблизительное
+            pthreads_manage::Environment touch_env{
+                                    [](auto sector_storage, std::size_t, int) noexcept { storage::touch_pages(sector_storage); },
+                                    0,
+                                    [](const PartitionerArgs& args) noexcept { return partitioner(args); },
+                                    partitioner_args
+                                    };
+            pthreads_pool.template dispatchJob<PolicyEmitRays>(mesh_storage, touch_env);
+        }
+
+        kernels::fill_circle_arc_uniform(ScalarT(0.0), ScalarT(std::numbers::pi/2.0), radius_hole, hole_storage);
 
         using p_type = geometry::Point2D<ScalarT>;
         p_type zero_point{ScalarT(0.0), ScalarT(0.0)}; // Все лучи выпускаются из точки (0,0)
@@ -85,49 +238,36 @@ namespace mesh {
         p_type first_point_up_edge{ScalarT(0.0), side_size};
         p_type second_point_edge{side_size, side_size}; // Вторая точка у обоих границ общая
 
-
-        PartitionerArgs part_args{mesh_size, count_points_on_ray, count_slaves_between_masters, count_sectors};
-        auto part_args_ptr = std::make_unique<PartitionerArgs>(part_args);
         KernelArgsEmitRay<ScalarT> kernel_args{
                                         zero_point,
                                         first_point_right_edge,
                                         first_point_up_edge,
                                         second_point_edge,
                                         multiplier_q,
+                                        count_rays_in_sector,
                                         count_sectors,
-                                        hole_grid_tmp
+                                        count_points_on_ray,
+                                        hole_storage,
+                                        &pthreads_pool
                                     };
-        auto kernel_args_ptr = std::make_unique<KernelArgsEmitRay<ScalarT>>(kernel_args);
-        pthreads_manage::JobContext context{
-                                mesh_storage,
-                                &threadDispatch,
-                                kernel_args_ptr.get(),
-                                        &partitioner,
-                                part_args_ptr.get()
-                                };
 
-        //Запускаем генерацию лучей параллельно
-        pthreads_pool.dispatchJob(context);
+        if constexpr (is_sequential<PolicyEmitRays>)
+            kernel_args.pthreads_pool_ = nullptr; // Один сектор на всю сетку, пул не участвует
 
-        //Отдельно заполняем последний луч (вертикальный) тк он остался необработанный
-        auto last_ray = Kokkos::subview(
-                                mesh_storage,
-                                Kokkos::pair(mesh_size - count_points_on_ray, mesh_size - 1),
-                                Kokkos::ALL
-                            );
-        emit_ray(
-            zero_point,
-            p_type{hole_grid_tmp(count_master_rays_total - 1, 0), hole_grid_tmp(count_master_rays_total - 1, 1)},
-            first_point_up_edge,
-            second_point_edge,
-            multiplier_q,
-            last_ray
-            );
+        pthreads_manage::Environment env{
+                                [](auto sector_storage, std::size_t sector_id, const KernelArgsEmitRay<ScalarT>& args) noexcept {
+                                    sectorDispatch(sector_storage, sector_id, args);
+                                },
+                                kernel_args,
+                                [](const PartitionerArgs& args) noexcept { return partitioner(args); },
+                                partitioner_args
+                                };
 
-        return mesh_storage;
+        //Все лучи (главные и внутренние) за один проход пула
+        pthreads_pool.template dispatchJob<PolicyEmitRays>(mesh_storage, env);
     }
 
-    template <kokkos_view_2d_like ContainerT, execution_policy PolicyFillRay, typename ScalarT>
+    template <coordinate_storage_like ContainerT, typename ScalarT>
     void emit_ray(
                 const geometry::Point2D<ScalarT> &zero_point,
                 const geometry::Point2D<ScalarT> &hole_point,
@@ -136,25 +276,23 @@ namespace mesh {
                 ScalarT multiplier_q,
                 ContainerT ray_storage
                 ) noexcept {
-        using p_type = geometry::Point2D<ScalarT>;
-        p_type interception_point = geometry::interception_lines(
-                                                zero_point,
-                                                hole_point,
-                                                first_point_edge,
-                                                second_point_edge
-                                                        );
-        // Так как первая точка нулевая, то точка на окружности = вектор направления луча
-        p_type direction = hole_point;
-        direction.Normalize();
-
-        grid::GenNonUniformOnRay<ScalarT, PolicyFillRay> gen_ray;
-        gen_ray(
-            direction,
-            hole_point,
-            interception_point,
-            multiplier_q,
-            ray_storage
-            );
+        const auto frame = kernels::make_ray_frame(
+                                        zero_point,
+                                        hole_point,
+                                        first_point_edge,
+                                        second_point_edge,
+                                        multiplier_q,
+                                        ray_storage.extent(0)
+                                        );
+        kernels::fill_ray_segment_nonuniform(
+                        frame.normalized_direction_,
+                        frame.start_point_,
+                        frame.end_point_,
+                        multiplier_q,
+                        frame.denominator_,
+                        0,
+                        ray_storage
+                        );
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "core/custom_concepts.hpp"
+#include "core/topology/topology.hpp"
+#include "solutions/custom_pthreads/pthreads_manage.hpp"
+
+namespace mesh {
+
+    ///Ограничивающий прямоугольник узлов
+    struct BoundingBox {
+        double min_x_ = std::numeric_limits<double>::infinity();
+        double min_y_ = std::numeric_limits<double>::infinity();
+        double max_x_ = -std::numeric_limits<double>::infinity();
+        double max_y_ = -std::numeric_limits<double>::infinity();
+
+        void add(double x, double y) noexcept {
+            min_x_ = std::min(min_x_, x);
+            min_y_ = std::min(min_y_, y);
+            max_x_ = std::max(max_x_, x);
+            max_y_ = std::max(max_y_, y);
+        }
+
+        [[nodiscard]] static BoundingBox combine(const BoundingBox& first, const BoundingBox& second) noexcept {
+            return {std::min(first.min_x_, second.min_x_), std::min(first.min_y_, second.min_y_),
+                    std::max(first.max_x_, second.max_x_), std::max(first.max_y_, second.max_y_)};
+        }
+    };
+
+    ///Показатели четырехугольных ячеек сетки лучей
+    struct CellQuality {
+        static constexpr std::size_t no_cell = std::numeric_limits<std::size_t>::max();
+
+        std::size_t count_cells_ = 0;
+        double min_area_ = std::numeric_limits<double>::infinity(); // Площадь со знаком (обход узлов против часовой стрелки)
+        double max_area_ = -std::numeric_limits<double>::infinity();
+        double max_aspect_ratio_ = 0.0; // Отношение длин самого длинного и самого короткого ребра ячейки
+        double min_scaled_jacobian_ = std::numeric_limits<double>::infinity(); // Якобиан в углу / произведение длин ребер угла, из [-1, 1]
+        std::size_t count_inverted_ = 0; // Ячеек с неположительным якобианом хотя бы в одном углу (вывернутые или вырожденные)
+        std::size_t first_inverted_ = no_cell; // Наименьший номер такой ячейки
+
+        [[nodiscard]] static CellQuality combine(const CellQuality& first, const CellQuality& second) noexcept {
+            return {first.count_cells_ + second.count_cells_,
+                    std::min(first.min_area_, second.min_area_), std::max(first.max_area_, second.max_area_),
+                    std::max(first.max_aspect_ratio_, second.max_aspect_ratio_),
+                    std::min(first.min_scaled_jacobian_, second.min_scaled_jacobian_),
+                    first.count_inverted_ + second.count_inverted_, std::min(first.first_inverted_, second.first_inverted_)};
+        }
+    };
+
+    struct MeshQuality {
+        BoundingBox bounds_;
+        CellQuality cells_;
+
+        ///Все ячейки ориентированы правильно: сетку можно отдавать в сборку
+        [[nodiscard]] bool valid() const noexcept { return cells_.count_inverted_ == 0; }
+    };
+
+    /**
+     * Добавление ячейки cell_idx с узлами x, y (против часовой стрелки) к частичному результату.
+     * Якобиан билинейного отображения в углу a пропорционален векторному произведению ребер a -> a + 1 и a -> a - 1
+     */
+    inline void add_quad_quality(const std::array<double, 4>& x, const std::array<double, 4>& y, std::size_t cell_idx, CellQuality& quality) noexcept {
+        std::array<double, 4> edge_x{}, edge_y{}, length{};
+        for (std::size_t a = 0; a < 4; a++) {
+            edge_x[a] = x[(a + 1) % 4] - x[a];
+            edge_y[a] = y[(a + 1) % 4] - y[a];
+            length[a] = std::sqrt(edge_x[a] * edge_x[a] + edge_y[a] * edge_y[a]);
+        }
+        double min_jacobian = std::numeric_limits<double>::infinity();
+        for (std::size_t a = 0; a < 4; a++) {
+            const std::size_t prev = (a + 3) % 4; // Ребро prev идет в угол a, поэтому берется с обратным знаком
+            const double jacobian = edge_x[prev] * edge_y[a] - edge_y[prev] * edge_x[a];
+            const double lengths = length[a] * length[prev];
+            min_jacobian = std::min(min_jacobian, lengths > 0.0 ? jacobian / lengths : 0.0);
+        }
+        const double area = 0.5 * ((x[2] - x[0]) * (y[3] - y[1]) - (y[2] - y[0]) * (x[3] - x[1]));
+        const auto [shortest, longest] = std::minmax_element(length.begin(), length.end());
+
+        quality.count_cells_ += 1;
+        quality.min_area_ = std::min(quality.min_area_, area);
+        quality.max_area_ = std::max(quality.max_area_, area);
+        quality.max_aspect_ratio_ = std::max(quality.max_aspect_ratio_,
+                                             *shortest > 0.0 ? *longest / *shortest : std::numeric_limits<double>::infinity());
+        quality.min_scaled_jacobian_ = std::min(quality.min_scaled_jacobian_, min_jacobian);
+        if (min_jacobian <= 0.0) {
+            quality.count_inverted_ += 1;
+            quality.first_inverted_ = std::min(quality.first_inverted_, cell_idx);
+        }
+    }
+
+    template <coordinate_source_like ContainerT>
+    struct KernelArgsQuality {
+        ContainerT mesh_;
+        topology::RayLayout layout_;
+    };
+
+    /**
+     * Ограничивающий прямоугольник узлов: редукция пула по узлам (сегмент на поток для Parallel)
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     */
+    template <execution_policy Policy, coordinate_source_like ContainerT>
+    [[nodiscard]] BoundingBox bounding_box(pthreads_manage::Pool &pthreads_pool, const ContainerT& mesh) {
+        const std::size_t count_nodes = mesh.extent(0);
+        const pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange range, std::size_t, const ContainerT& nodes, BoundingBox& partial) noexcept {
+                                    BoundingBox bounds = partial; // Локальная копия: запись в partial могла бы пересекаться с узлами
+                                    for (std::size_t i = range.begin_; i < range.end_; i++)
+                                        bounds.add(static_cast<double>(nodes(i, 0)), static_cast<double>(nodes(i, 1)));
+                                    partial = bounds;
+                                },
+                                mesh,
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{count_nodes, pthreads_pool.rangeChunkSize<Policy>(count_nodes), 0}
+                                };
+        return pthreads_pool.reduceRange<Policy>(count_nodes, env, BoundingBox{}, &BoundingBox::combine);
+    }
+
+    /**
+     * Показатели ячеек сетки GenFrameKirsch (или любой сетки с раскладкой layout): редукция пула по ячейкам,
+     * ячейка (k, j) имеет номер k * (count_points_on_ray - 1) + j
+     * @tparam Policy Sequential, Parallel или WorkStealing
+     */
+    template <execution_policy Policy, coordinate_source_like ContainerT>
+    [[nodiscard]] CellQuality cell_quality(pthreads_manage::Pool &pthreads_pool, const ContainerT& mesh, const topology::RayLayout& layout) {
+        const std::size_t count_cells = layout.count_cells();
+        const pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange range, std::size_t, const KernelArgsQuality<ContainerT>& args, CellQuality& partial) noexcept {
+                                    const std::size_t cells_on_ray = args.layout_.count_points_on_ray_ - 1;
+                                    CellQuality quality = partial;
+                                    for (std::size_t cell_idx = range.begin_; cell_idx < range.end_; cell_idx++) {
+                                        const auto nodes = args.layout_.cell(cell_idx / cells_on_ray, cell_idx % cells_on_ray);
+                                        std::array<double, 4> x{}, y{};
+                                        for (std::size_t a = 0; a < 4; a++) {
+                                            x[a] = static_cast<double>(args.mesh_(nodes[a], 0));
+                                            y[a] = static_cast<double>(args.mesh_(nodes[a], 1));
+                                        }
+                                        add_quad_quality(x, y, cell_idx, quality);
+                                    }
+                                    partial = quality;
+                                },
+                                KernelArgsQuality<ContainerT>{mesh, layout},
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{count_cells, pthreads_pool.rangeChunkSize<Policy>(count_cells), 0}
+                                };
+        return pthreads_pool.reduceRange<Policy>(count_cells, env, CellQuality{}, &CellQuality::combine);
+    }
+
+    ///Проверка сетки перед расчетом: ограничивающий прямоугольник и показатели ячеек
+    template <execution_policy Policy, coordinate_source_like ContainerT>
+    [[nodiscard]] MeshQuality mesh_quality(pthreads_manage::Pool &pthreads_pool, const ContainerT& mesh, const topology::RayLayout& layout) {
+        return {bounding_box<Policy>(pthreads_pool, mesh), cell_quality<Policy>(pthreads_pool, mesh, layout)};
+    }
+
+}
@@ -1,17 +1,86 @@
 #pragma once
 #include <pthread.h>
+#include <sched.h>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 #include <cstdlib>
 #include <unistd.h>
 #include "core/custom_concepts.hpp"
+#include "core/storage/storage.hpp"
+#include "core/trace/trace.hpp"
+#include "solutions/custom_pthreads/affinity.hpp"
 
 namespace pthreads_manage {
 
+    ///Процессоры, на которых процессу можно работать: маска sched_getaffinity (cpuset контейнера) с учетом квоты cgroup
     static std::size_t get_count_cpu() {
-        const std::size_t count_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+        const std::size_t count_cpu = count_usable_cpus();
         return count_cpu;
     }
 
+    ///Сколько итераций поток крутится в ожидании, прежде чем уснуть на futex (режим SpinThenPark)
+    inline constexpr std::size_t spin_iterations_before_park = 4096;
+
+    ///Во сколько раз сегментов больше, чем потоков, в режиме WorkStealing (мелкие сегменты = выравнивание нагрузки)
+    inline constexpr std::size_t chunks_per_thread_stealing = 8;
+
+    ///Способ распределения сегментов по потокам
+    enum class Schedule {
+        Static,      // Сегмент i выполняет поток i
+        WorkStealing // Сегменты раскладываются по очередям потоков, освободившиеся потоки крадут из чужих очередей
+    };
+
+    ///Поведение потоков в ожидании задачи (и main в ожидании завершения)
+    enum class WaitPolicy {
+        Park,        // Сразу засыпаем на futex: не тратим ядро, но каждое пробуждение - системный вызов
+        SpinThenPark // Сначала крутимся на атомарной эпохе, засыпаем только если задача долго не приходит. Для частых маленьких задач
+    };
+
+    ///Настройки пула
+    struct PoolSettings {
+        std::size_t count_threads_ = 0; // Вместе с вызывающим; 0 - get_count_cpu() для найденной топологии или размер cpus_
+        Affinity affinity_ = Affinity::SmtAware;
+        WaitPolicy wait_policy_ = WaitPolicy::Park;
+        CpuTopology cpus_{}; // Процессоры пула (например, часть CpuTopology::partition); пустой - CpuTopology::discover()
+        bool pin_caller_ = false; // Закрепить и вызывающий поток (tid 0) - чтобы пулы из разных потоков не делили процессоры. Прежняя маска восстанавливается в ~Pool
+    };
+
+    inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    ///Ожидание в цикле: сначала pause, затем уступаем ядро (на случай, если потоков больше, чем свободных ядер)
+    inline void backoff(std::size_t &iterations) noexcept {
+        if (iterations++ < spin_iterations_before_park)
+            cpu_relax();
+        else
+            sched_yield();
+    }
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) && std::atomic<std::uint32_t>::is_always_lock_free,
+                  "futex требует атомарное 32-битное слово без блокировок");
+
+    ///Уснуть, если *word == expected (проверка и засыпание атомарны в ядре)
+    inline void futex_wait(std::atomic<std::uint32_t> &word, std::uint32_t expected) noexcept {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    inline void futex_wake(std::atomic<std::uint32_t> &word, int count) noexcept {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
     struct PartitionerSettings {
         std::size_t full_size_;
         std::size_t chunk_size_;
@@ -21,58 +90,398 @@ namespace pthreads_manage {
     struct JobContext {
         ViewType parent_view; //Откуда нарезать сегменты
 
-        void (*run_kernel)(ViewType chunk, std::size_t worker_id, void* kernel_args); //Прокладка, запускающая ядро
+        void (*run_kernel)(ViewType chunk, std::size_t chunk_id, void* kernel_args); //Прокладка, запускающая ядро
         void* kernel_args;
 
         PartitionerSettings (*partitioner)(void* partitioner_args); //Разделитель, возвращающий параметры для нарезки сегментов
         void* partitioner_args;
 
+        Schedule schedule = Schedule::Static;
+    };
+
+    /**
+     * Окружение задачи для типизированного dispatchJob: ядро и разделитель - вызываемые объекты, аргументы хранятся по значению.
+     * Ядро вызывается как run_kernel(subrange, chunk_id, kernel_args), разделитель - как partitioner(partitioner_args)
+     */
+    template <typename KernelT, typename KernelArgsT, typename PartitionerT, typename PartitionerArgsT>
+    struct Environment {
+        [[no_unique_address]] KernelT run_kernel;
+        KernelArgsT kernel_args;
+        [[no_unique_address]] PartitionerT partitioner;
+        PartitionerArgsT partitioner_args;
+    };
+
+    ///Сегмент индексов [begin_, end_) для задач над массивами, не являющимися хранилищем координат (элементы, строки матрицы)
+    struct IndexRange {
+        std::size_t begin_;
+        std::size_t end_;
+
+        [[nodiscard]] std::size_t size() const noexcept { return end_ - begin_; }
+    };
+
+    ///Окружение задачи над диапазоном индексов: ядро принимает IndexRange вместо сегмента хранилища
+    template <class E>
+    concept range_environment = environment<E> && requires (const E e, IndexRange range, std::size_t chunk_id){
+        { e.partitioner(e.partitioner_args).chunk_size_ } -> std::convertible_to<std::size_t>;
+        { e.partitioner(e.partitioner_args).overlap_size_ } -> std::convertible_to<std::size_t>;
+        e.run_kernel(range, chunk_id, e.kernel_args);
+    };
+
+    ///Окружение редукции над диапазоном индексов: ядро дополнительно принимает частичный результат своего сегмента
+    template <class E, typename ValueT>
+    concept reduce_environment = environment<E> && requires (const E e, IndexRange range, std::size_t chunk_id, ValueT& partial){
+        { e.partitioner(e.partitioner_args).chunk_size_ } -> std::convertible_to<std::size_t>;
+        { e.partitioner(e.partitioner_args).overlap_size_ } -> std::convertible_to<std::size_t>;
+        e.run_kernel(range, chunk_id, e.kernel_args, partial);
+    };
+
+    ///Частичный результат сегмента на своей кэш-линии: потоки, накапливающие соседние сегменты, не делят строку кэша
+    template <typename ValueT>
+    struct alignas(std::max<std::size_t>(64, alignof(ValueT))) PaddedPartial {
+        ValueT value_;
+    };
+
+    template <execution_policy Policy>
+    inline constexpr Schedule schedule_of = is_work_stealing<Policy> ? Schedule::WorkStealing : Schedule::Static;
+
+    ///Количество сегментов, на которые разрезает область разделитель (соседние сегменты пересекаются на overlap_size_)
+    [[nodiscard]] inline std::size_t count_chunks(const PartitionerSettings& settings, std::size_t full_size) noexcept {
+        if (full_size == 0 || settings.chunk_size_ == 0)
+            return 0;
+        if (full_size <= settings.chunk_size_)
+            return 1;
+        const std::size_t step = settings.chunk_size_ - settings.overlap_size_;
+        return 1 + (full_size - settings.chunk_size_ + step - 1) / step;
+    }
+
+    ///Границы сегмента chunk_id в исходной области
+    [[nodiscard]] inline std::pair<std::size_t, std::size_t> chunk_bounds(const PartitionerSettings& settings, std::size_t full_size, std::size_t chunk_id) noexcept {
+        std::size_t begin_subrange = chunk_id * settings.chunk_size_ - settings.overlap_size_ * chunk_id;
+        std::size_t end_subrange = std::min(begin_subrange + settings.chunk_size_, full_size);
+        return {begin_subrange, end_subrange};
+    }
+
+    /**
+     * Задача во внутреннем представлении пула: тип ядра стерт до одного указателя на функцию, запускающую сегмент [begin, end).
+     * Внутри run_chunk ядро известно компилятору и встраивается в цикл по точкам сегмента
+     */
+    struct Task {
+        void (*run_chunk)(const void* payload, std::size_t begin, std::size_t end, std::size_t chunk_id) noexcept;
+        const void* payload;
+        std::size_t full_size;
+        PartitionerSettings settings;
+        std::size_t count_chunks;
+        Schedule schedule;
+        std::uint64_t job_id = 0; // Номер задачи в трассе (trace::next_job_id), 0 без FEM_TRACE
+    };
+
+    inline void run_task_chunk(const Task& task, std::size_t chunk_id) noexcept {
+        auto [begin_subrange, end_subrange] = chunk_bounds(task.settings, task.full_size, chunk_id);
+        const std::uint64_t begin_ns = trace::now();
+        task.run_chunk(task.payload, begin_subrange, end_subrange, chunk_id);
+        trace::record(trace::EventKind::Chunk, "chunk", begin_ns, trace::now(), task.job_id, chunk_id, begin_subrange, end_subrange);
+    }
+
+    ///Запуск сегмента задачи в формате JobContext
+    inline void run_legacy_chunk(const void* payload, std::size_t begin, std::size_t end, std::size_t chunk_id) noexcept {
+        const auto* job = static_cast<const JobContext*>(payload);
+        auto subrange = Kokkos::subview(job->parent_view, Kokkos::pair(begin, end), Kokkos::ALL);
+        job->run_kernel(subrange, chunk_id, job->kernel_args);
+    }
+
+    template <coordinate_source_like ViewT, environment_for<ViewT> EnvT>
+    struct TypedPayload {
+        ViewT parent_view_;
+        EnvT env_;
+    };
+
+    ///Запуск сегмента типизированной задачи
+    template <coordinate_source_like ViewT, environment_for<ViewT> EnvT>
+    void run_typed_chunk(const void* payload, std::size_t begin, std::size_t end, std::size_t chunk_id) noexcept {
+        const auto* payload_ptr = static_cast<const TypedPayload<ViewT, EnvT>*>(payload);
+        auto subrange = storage::subrange(payload_ptr->parent_view_, begin, end);
+        payload_ptr->env_.run_kernel(subrange, chunk_id, payload_ptr->env_.kernel_args);
+    }
+
+    template <coordinate_source_like ViewT, environment_for<ViewT> EnvT>
+    [[nodiscard]] Task make_typed_task(const TypedPayload<ViewT, EnvT>& payload, Schedule schedule) noexcept {
+        const PartitionerSettings settings = payload.env_.partitioner(payload.env_.partitioner_args);
+        const std::size_t full_size = payload.parent_view_.extent(0);
+        return Task{&run_typed_chunk<ViewT, EnvT>, &payload, full_size, settings, count_chunks(settings, full_size), schedule};
+    }
+
+    ///Последовательное выполнение всех сегментов вызывающим потоком, пул не участвует
+    template <coordinate_source_like ViewT, environment_for<ViewT> EnvT>
+    void run_sequential(ViewT parent_view, const EnvT& env) noexcept {
+        const PartitionerSettings settings = env.partitioner(env.partitioner_args);
+        const std::size_t full_size = parent_view.extent(0);
+        const std::size_t count = count_chunks(settings, full_size);
+        for (std::size_t chunk_id = 0; chunk_id < count; ++chunk_id) {
+            auto [begin_subrange, end_subrange] = chunk_bounds(settings, full_size, chunk_id);
+            auto subrange = storage::subrange(parent_view, begin_subrange, end_subrange);
+            env.run_kernel(subrange, chunk_id, env.kernel_args);
+        }
+    }
+
+    template <range_environment EnvT>
+    struct RangePayload {
+        std::size_t full_size_;
+        EnvT env_;
+    };
+
+    ///Запуск сегмента задачи над диапазоном индексов
+    template <range_environment EnvT>
+    void run_range_chunk(const void* payload, std::size_t begin, std::size_t end, std::size_t chunk_id) noexcept {
+        const auto* payload_ptr = static_cast<const RangePayload<EnvT>*>(payload);
+        payload_ptr->env_.run_kernel(IndexRange{begin, end}, chunk_id, payload_ptr->env_.kernel_args);
+    }
+
+    template <range_environment EnvT>
+    [[nodiscard]] Task make_range_task(const RangePayload<EnvT>& payload, Schedule schedule) noexcept {
+        const PartitionerSettings settings = payload.env_.partitioner(payload.env_.partitioner_args);
+        return Task{&run_range_chunk<EnvT>, &payload, payload.full_size_, settings, count_chunks(settings, payload.full_size_), schedule};
+    }
+
+    ///Последовательное выполнение всех сегментов диапазона [0, full_size) вызывающим потоком
+    template <range_environment EnvT>
+    void run_sequential_range(std::size_t full_size, const EnvT& env) noexcept {
+        const PartitionerSettings settings = env.partitioner(env.partitioner_args);
+        const std::size_t count = count_chunks(settings, full_size);
+        for (std::size_t chunk_id = 0; chunk_id < count; ++chunk_id) {
+            auto [begin_subrange, end_subrange] = chunk_bounds(settings, full_size, chunk_id);
+            env.run_kernel(IndexRange{begin_subrange, end_subrange}, chunk_id, env.kernel_args);
+        }
+    }
+
+    /**
+     * Очередь сегментов одного потока для режима WorkStealing.
+     * Сегменты задачи известны заранее, поэтому очередь хранится как непрерывный интервал номеров [head, tail),
+     * упакованный в одно атомарное слово: владелец забирает сегменты с головы, вор отрезает половину с хвоста.
+     */
+    struct alignas(64) ChunkDeque {
+        std::atomic<std::uint64_t> range_{0};
+
+        [[nodiscard]] static constexpr std::uint64_t pack(std::uint64_t head, std::uint64_t tail) noexcept {
+            return (tail << 32) | head;
+        }
+
+        void reset(std::size_t head, std::size_t tail) noexcept {
+            range_.store(pack(head, tail), std::memory_order_relaxed);
+        }
+
+        ///Забрать сегмент с головы (вызывается только владельцем)
+        [[nodiscard]] bool popFront(std::size_t &chunk_id) noexcept {
+            std::uint64_t range = range_.load(std::memory_order_acquire);
+            for (;;) {
+                const std::uint64_t head = range & 0xFFFFFFFFu;
+                const std::uint64_t tail = range >> 32;
+                if (head >= tail)
+                    return false;
+                if (range_.compare_exchange_weak(range, pack(head + 1, tail), std::memory_order_acq_rel)) {
+                    chunk_id = head;
+                    return true;
+                }
+            }
+        }
+
+        ///Отрезать половину оставшихся сегментов с хвоста, возвращает украденный интервал [begin, end)
+        [[nodiscard]] bool stealHalf(std::size_t &begin, std::size_t &end) noexcept {
+            std::uint64_t range = range_.load(std::memory_order_acquire);
+            for (;;) {
+                const std::uint64_t head = range & 0xFFFFFFFFu;
+                const std::uint64_t tail = range >> 32;
+                if (head >= tail)
+                    return false;
+                const std::uint64_t new_tail = tail - (tail - head + 1) / 2;
+                if (range_.compare_exchange_weak(range, pack(head, new_tail), std::memory_order_acq_rel)) {
+                    begin = new_tail;
+                    end = tail;
+                    return true;
+                }
+            }
+        }
+    };
+
+    /**
+     * Вложенная задача, поставленная ядром изнутри пула. Потоки, у которых нет своей работы, разбирают ее сегменты
+     * через общий счетчик next_chunk_. Пока helpers_ != 0, владелец не переиспользует слот.
+     */
+    struct alignas(64) NestedJob {
+        Task task_{};
+
+        alignas(64) std::atomic<std::size_t> next_chunk_{0};
+        alignas(64) std::atomic<std::size_t> done_chunks_{0};
+        std::atomic<std::uint32_t> helpers_{0};
+        std::atomic<bool> active_{false};
     };
 
     class Pool {
     public:
         [[nodiscard]] std::size_t totalThreads() const {return total_count_threads_;}
+        /**
+         * Размер сегмента для dispatchRange по диапазону из full_size индексов:
+         * Sequential - весь диапазон, Parallel - сегмент на поток, WorkStealing - chunks_per_thread_stealing сегментов на поток
+         */
+        template <execution_policy Policy>
+        [[nodiscard]] std::size_t rangeChunkSize(std::size_t full_size) const noexcept {
+            std::size_t count_chunks = 1;
+            if constexpr (is_parallel<Policy>)
+                count_chunks = total_count_threads_;
+            else if constexpr (is_work_stealing<Policy>)
+                count_chunks = total_count_threads_ * chunks_per_thread_stealing;
+            return std::max<std::size_t>((full_size + count_chunks - 1) / count_chunks, 1);
+        }
         ///Постановка задачи с main thread
         void dispatchJob(const JobContext& job) noexcept {
-            pthread_mutex_lock(&mutex_); // для защиты job, job_active, active_workers + mutex необходим для условия
+            const PartitionerSettings settings = job.partitioner(job.partitioner_args);
+            const std::size_t full_size = job.parent_view.extent(0);
+            dispatchTask(Task{&run_legacy_chunk, &job, full_size, settings, count_chunks(settings, full_size), job.schedule});
+        }
+
+        /**
+         * Типизированная постановка задачи с main thread. Ядро и разделитель известны на этапе компиляции,
+         * окружение копируется в кадр вызова (без кучи). Sequential выполняется вызывающим потоком без пула,
+         * Parallel - Schedule::Static, WorkStealing - Schedule::WorkStealing
+         * @tparam Policy
+         * @param parent_view Откуда нарезать сегменты
+         * @param env Environment{ядро, аргументы ядра, разделитель, аргументы разделителя}
+         */
+        template <execution_policy Policy, coordinate_source_like ViewT, environment_for<ViewT> EnvT>
+        void dispatchJob(ViewT parent_view, EnvT env) noexcept {
+            if constexpr (is_sequential<Policy>) {
+                run_sequential(parent_view, env);
+            } else {
+                const TypedPayload<ViewT, EnvT> payload{parent_view, std::move(env)};
+                dispatchTask(make_typed_task(payload, schedule_of<Policy>));
+            }
+        }
 
-            current_job_ = job;
-            job_active_ = true;
-            active_workers_ = 1;
-            job_id_++;
-            settings_ = job.partitioner(job.partitioner_args);
+        /**
+         * Постановка вложенной задачи изнутри ядра, выполняющегося в пуле (например, внутренние лучи сектора).
+         * Вызвавший поток сам разбирает сегменты, свободные потоки пула помогают. Возврат - когда выполнены все сегменты,
+         * поэтому аргументы можно держать на стеке ядра. Вне пула равносильно dispatchJob.
+         * Вложенная задача внутри вложенной задачи того же потока выполняется последовательно этим потоком.
+         */
+        void dispatchNestedJob(const JobContext& job) noexcept {
+            const PartitionerSettings settings = job.partitioner(job.partitioner_args);
+            const std::size_t full_size = job.parent_view.extent(0);
+            dispatchNestedTask(Task{&run_legacy_chunk, &job, full_size, settings, count_chunks(settings, full_size), job.schedule});
+        }
 
-            //main thread тоже запускается. чтобы не ждал вхолостую
-            std::size_t begin_subrange = 0;
-            std::size_t end_subrange = std::min(begin_subrange + settings_.chunk_size_, job.parent_view.extent(0));
-            auto subrange = Kokkos::subview(
-                                                    job.parent_view,
-                                                        Kokkos::pair(begin_subrange, end_subrange),
-                                                        Kokkos::ALL
-                                                    );
-            pthread_cond_broadcast(&job_start_);
-            pthread_mutex_unlock(&mutex_); // Открываем мутекс, чтобы остальные не ждали пока main выполнит ядро
-            job.run_kernel(subrange, 0, job.kernel_args);
-
-            pthread_mutex_lock(&mutex_); // Закрываем для проверки условия
-            if (--active_workers_ == 0) {
-                job_active_ = false;
-                pthread_cond_signal(&job_done_);
-            }
-            while(job_active_)
-                pthread_cond_wait(&job_done_, &mutex_);
-                //для условия мутекс нужен, поскольку условие ожидания может изменится в момент проверки = вечный сон ожидающего потока
-            pthread_mutex_unlock(&mutex_);
-        }
-
-        explicit Pool() noexcept : contexts_(get_count_cpu()), total_count_threads_(get_count_cpu()), threads_(get_count_cpu()) {
-            for (std::size_t tid = 1; tid < total_count_threads_ - 1; ++tid) {
+        ///Типизированная вложенная задача (правила те же, что у dispatchJob<Policy>; расписание вложенных задач всегда общий счетчик)
+        template <execution_policy Policy, coordinate_source_like ViewT, environment_for<ViewT> EnvT>
+        void dispatchNestedJob(ViewT parent_view, EnvT env) noexcept {
+            if constexpr (is_sequential<Policy>) {
+                run_sequential(parent_view, env);
+            } else {
+                const TypedPayload<ViewT, EnvT> payload{parent_view, std::move(env)};
+                dispatchNestedTask(make_typed_task(payload, schedule_of<Policy>));
+            }
+        }
+
+        /**
+         * Задача над диапазоном индексов [0, full_size) с main thread (правила те же, что у dispatchJob<Policy>).
+         * Для циклов по элементам, строкам матрицы и векторам, у которых нет хранилища координат
+         * @tparam Policy
+         * @param full_size Размер диапазона
+         * @param env Environment, ядро вызывается как run_kernel(IndexRange, chunk_id, kernel_args)
+         */
+        template <execution_policy Policy, range_environment EnvT>
+        void dispatchRange(std::size_t full_size, EnvT env) noexcept {
+            if constexpr (is_sequential<Policy>) {
+                run_sequential_range(full_size, env);
+            } else {
+                const RangePayload<EnvT> payload{full_size, std::move(env)};
+                dispatchTask(make_range_task(payload, schedule_of<Policy>));
+            }
+        }
+
+        /**
+         * Редукция по диапазону [0, full_size) с main thread (правила те же, что у dispatchRange<Policy>).
+         * Сегмент накапливает свой частичный результат, начиная с identity, затем вызывающий поток сворачивает их
+         * в порядке номеров сегментов: при одном и том же разделителе результат не зависит от расписания и числа потоков,
+         * если partitioner от них не зависит. overlap_size_ разделителя не используется: сегменты редукции всегда
+         * идут встык (иначе общие индексы соседних сегментов попали бы в результат дважды)
+         * @tparam Policy
+         * @param full_size Размер диапазона
+         * @param env Environment, ядро вызывается как run_kernel(IndexRange, chunk_id, kernel_args, ValueT& partial)
+         * @param identity Нейтральный элемент combine (результат для пустого диапазона)
+         * @param combine Ассоциативная свертка ValueT combine(const ValueT&, const ValueT&)
+         */
+        template <execution_policy Policy, typename ValueT, reduce_environment<ValueT> EnvT, typename CombineT>
+        [[nodiscard]] ValueT reduceRange(std::size_t full_size, const EnvT& env, const ValueT& identity, CombineT combine) {
+            PartitionerSettings settings = env.partitioner(env.partitioner_args);
+            settings.overlap_size_ = 0;
+            std::vector<PaddedPartial<ValueT>> partials(count_chunks(settings, full_size), PaddedPartial<ValueT>{identity});
+
+            struct ReduceArgs {
+                const EnvT* env_;
+                PaddedPartial<ValueT>* partials_;
+            };
+            dispatchRange<Policy>(full_size, Environment{
+                                    [](IndexRange range, std::size_t chunk_id, const ReduceArgs& args) noexcept {
+                                        args.env_->run_kernel(range, chunk_id, args.env_->kernel_args, args.partials_[chunk_id].value_);
+                                    },
+                                    ReduceArgs{&env, partials.data()},
+                                    [](const PartitionerSettings& partitioner_settings) noexcept { return partitioner_settings; },
+                                    settings
+                                    });
+
+            ValueT result = identity;
+            for (const auto& partial : partials)
+                result = combine(result, partial.value_);
+            return result;
+        }
+
+        explicit Pool(WaitPolicy wait_policy = WaitPolicy::Park)
+                : Pool(PoolSettings{0, Affinity::SmtAware, wait_policy}) {}
+
+        /**
+         * Пул из заданного числа потоков (вместе с вызывающим), закрепленных SmtAware на процессорах процесса
+         * @param count_threads Количество потоков (0 трактуется как 1)
+         * @param wait_policy
+         */
+        explicit Pool(std::size_t count_threads, WaitPolicy wait_policy = WaitPolicy::Park)
+                : Pool(PoolSettings{std::max<std::size_t>(count_threads, 1), Affinity::SmtAware, wait_policy}) {}
+
+        /**
+         * Пул на процессорах settings.cpus_: поток tid закрепляется за процессором order(affinity_)[tid % size()].
+         * Вызывающий поток (tid 0) занимает первый процессор порядка, но закрепляется только при pin_caller_.
+         * Не noexcept: CpuTopology::discover() и векторы пула выделяют память
+         */
+        explicit Pool(const PoolSettings& settings)
+                : Pool(settings, settings.cpus_.empty() ? CpuTopology::discover() : settings.cpus_) {}
+
+        ///Процессор, за которым закреплен поток tid, или -1 (Affinity::None, вызывающий поток без pin_caller_)
+        [[nodiscard]] int threadCpu(std::size_t tid) const noexcept { return thread_cpus_[tid]; }
+
+    private:
+        Pool(const PoolSettings& settings, const CpuTopology& cpus)
+                : contexts_(count_threads_for(settings, cpus)), total_count_threads_(contexts_.size()),
+                  threads_(total_count_threads_), deques_(total_count_threads_), nested_(total_count_threads_),
+                  thread_cpus_(total_count_threads_, -1),
+                  spin_iterations_(settings.wait_policy_ == WaitPolicy::SpinThenPark ? spin_iterations_before_park : 0) {
+            const std::vector<int> order = cpus.order(settings.affinity_);
+            if (settings.affinity_ != Affinity::None && !order.empty()) {
+                for (std::size_t tid = 0; tid < total_count_threads_; ++tid)
+                    thread_cpus_[tid] = order[tid % order.size()];
+                if (settings.pin_caller_) {
+                    caller_ = pthread_self();
+                    restore_caller_ = pthread_getaffinity_np(caller_, sizeof(caller_mask_), &caller_mask_) == 0;
+                    cpu_set_t set;
+                    CPU_ZERO(&set);
+                    CPU_SET(thread_cpus_[0], &set);
+                    pthread_setaffinity_np(caller_, sizeof(set), &set);
+                } else {
+                    thread_cpus_[0] = -1;
+                }
+            }
+            contexts_[0] = WorkerContext{this, 0};
+            for (std::size_t tid = 1; tid < total_count_threads_; ++tid) { // tid = 0 - main thread
                 pthread_attr_t attr;
                 pthread_attr_init(&attr);
-                cpu_set_t set;
-                CPU_ZERO(&set);
-                CPU_SET(tid, &set);
-                pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+                if (thread_cpus_[tid] >= 0)
+                    set_thread_cpu(attr, thread_cpus_[tid]);
                 contexts_[tid] = WorkerContext{this, tid};
 
                 //Создаем поток и забрасываем его в пул this
@@ -80,93 +489,298 @@ namespace pthreads_manage {
                 pthread_attr_destroy(&attr);
             }
         }
+
+        static std::size_t count_threads_for(const PoolSettings& settings, const CpuTopology& cpus) noexcept {
+            if (settings.count_threads_ != 0)
+                return settings.count_threads_;
+            return settings.cpus_.empty() ? get_count_cpu() : std::max<std::size_t>(cpus.size(), 1);
+        }
+
+    public:
         ~Pool() noexcept {
-            pthread_mutex_lock(&mutex_);
-            stop_ = true;
-            job_active_ = false;
-            pthread_cond_broadcast(&job_start_);
-            pthread_mutex_unlock(&mutex_);
+            stop_.store(true, std::memory_order_relaxed);
+            job_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake(job_epoch_, INT_MAX);
 
-            for (auto& t : threads_) {
-                pthread_join(t, nullptr);
+            for (std::size_t tid = 1; tid < total_count_threads_; ++tid) {
+                pthread_join(threads_[tid], nullptr);
             }
-
-            pthread_mutex_destroy(&mutex_);
-            pthread_cond_destroy(&job_start_);
-            pthread_cond_destroy(&job_done_);
+            if (restore_caller_)
+                pthread_setaffinity_np(caller_, sizeof(caller_mask_), &caller_mask_);
         }
 
     private:
+        void dispatchTask(const Task& task) noexcept {
+            const std::uint64_t dispatch_ns = trace::now();
+            //Пока active_workers_ != 0 рабочие потоки не трогают current_task_, поэтому публикуем задачу без мутекса
+            current_task_ = task;
+            if constexpr (trace::enabled) {
+                current_task_.job_id = trace::next_job_id();
+                published_ns_ = dispatch_ns;
+            }
+            const std::uint64_t job_id = current_task_.job_id;
+            if (task.schedule == Schedule::WorkStealing)
+                seedDeques();
+            pending_chunks_.store(task.count_chunks, std::memory_order_relaxed);
+            active_workers_.store(static_cast<std::uint32_t>(total_count_threads_), std::memory_order_relaxed); // Задача завершена, когда из нее вышли все потоки, включая main
+
+            job_epoch_.fetch_add(1, std::memory_order_seq_cst); // Новая эпоха = новая задача, публикует все записи выше
+            if (parked_workers_.load(std::memory_order_seq_cst) != 0)
+                futex_wake(job_epoch_, INT_MAX);
+
+            //main thread тоже запускается. чтобы не ждал вхолостую
+            const WorkerContext* outer_context = current_worker_;
+            current_worker_ = &contexts_[0];
+            runShare(0);
+            current_worker_ = outer_context;
+
+            if (active_workers_.fetch_sub(1, std::memory_order_seq_cst) != 1) {
+                const std::uint64_t wait_ns = trace::now();
+                waitWorkers();
+                trace::record(trace::EventKind::WaitWorkers, "wait workers", wait_ns, trace::now(), job_id);
+            }
+            trace::record(trace::EventKind::Job, "job", dispatch_ns, trace::now(), job_id, task.count_chunks, 0, task.full_size);
+        }
+
+        void dispatchNestedTask(Task task) noexcept {
+            const WorkerContext* context = current_worker_;
+            if (context == nullptr || context->pool_ != this) {
+                dispatchTask(task);
+                return;
+            }
+            const std::uint64_t dispatch_ns = trace::now();
+            if constexpr (trace::enabled)
+                task.job_id = trace::next_job_id();
+            const std::size_t count = task.count_chunks;
+            NestedJob& nested = nested_[context->tid_];
+            if (count <= 1 || nested.active_.load(std::memory_order_relaxed)) {
+                for (std::size_t chunk_id = 0; chunk_id < count; ++chunk_id)
+                    run_task_chunk(task, chunk_id);
+                trace::record(trace::EventKind::Job, "nested job", dispatch_ns, trace::now(), task.job_id, count, 0, task.full_size);
+                return;
+            }
+
+            nested.task_ = task;
+            nested.next_chunk_.store(0, std::memory_order_relaxed);
+            nested.done_chunks_.store(0, std::memory_order_relaxed);
+            nested.active_.store(true, std::memory_order_seq_cst);
+            notifyHelpers();
+
+            std::size_t chunk_id;
+            while ((chunk_id = nested.next_chunk_.fetch_add(1, std::memory_order_relaxed)) < count) {
+                run_task_chunk(task, chunk_id);
+                nested.done_chunks_.fetch_add(1, std::memory_order_release);
+            }
+            //Сегменты разобраны, но часть еще выполняется помощниками: пока ждем, помогаем чужим вложенным задачам
+            std::size_t wait_iterations = 0;
+            while (nested.done_chunks_.load(std::memory_order_acquire) < count) {
+                if (!helpNested(context->tid_))
+                    backoff(wait_iterations);
+            }
+            nested.active_.store(false, std::memory_order_seq_cst);
+            while (nested.helpers_.load(std::memory_order_seq_cst) != 0)
+                backoff(wait_iterations);
+            trace::record(trace::EventKind::Job, "nested job", dispatch_ns, trace::now(), task.job_id, count, 0, task.full_size);
+        }
+
         ///Прокладка между бесконечным циклом ожидания задачи и созданием потока, чтобы сделать цикл членом класса
         static void* workerEntry(void* arg) noexcept { // static поскольку pthread_create требует указатель на функцию (без static тип: void* (PthreadPool::*)(void*))
             auto* context_ptr = static_cast<WorkerContext*>(arg);
+            current_worker_ = context_ptr;
+            if constexpr (trace::enabled)
+                trace::set_thread_name("pool worker " + std::to_string(context_ptr->tid_));
             context_ptr->pool_->workerLoop(context_ptr->tid_);
             return nullptr;
         }
         ///Бесконечный цикл ожидания задачи
         void workerLoop(std::size_t worker_id) noexcept {
-            std::size_t local_job_id = 0;
+            std::uint32_t local_epoch = 0; //Чтобы потоки не выходили и заходили несколько раз в одну и ту же задачу
             for (;;) {
-                //Невозможно проверить условие без мутекса
-                pthread_mutex_lock(&mutex_);
-                // Нет задачи и еще не закончили => ждем
-                //Чтобы потоки не выходили и заходили несколько раз в одну и ту же задачу
-                while (local_job_id == job_id_ && !stop_)
-                    pthread_cond_wait(&job_start_, &mutex_);
+                local_epoch = waitJob(local_epoch);
                 // Закончили
-                if (stop_) {
-                    pthread_mutex_unlock(&mutex_);
+                if (stop_.load(std::memory_order_relaxed))
                     break;
+                //Если дошли до этой точки, значит появилась задача (main сменил эпоху)
+                trace::record(trace::EventKind::Wake, "wake", published_ns_, trace::now(), current_task_.job_id);
+                runShare(worker_id);
+
+                //Окончание работы. Последний вышедший будит main, если тот уже уснул
+                if (active_workers_.fetch_sub(1, std::memory_order_seq_cst) == 1 && main_parked_.load(std::memory_order_seq_cst) != 0)
+                    futex_wake(active_workers_, 1);
+            }
+        }
+
+        ///Ожидание смены эпохи: крутимся spin_iterations_ итераций, затем засыпаем на futex
+        [[nodiscard]] std::uint32_t waitJob(std::uint32_t seen_epoch) noexcept {
+            std::uint32_t epoch;
+            for (std::size_t i = 0; i < spin_iterations_; ++i) {
+                epoch = job_epoch_.load(std::memory_order_acquire);
+                if (epoch != seen_epoch)
+                    return epoch;
+                cpu_relax();
+            }
+            const std::uint64_t park_ns = trace::now();
+            parked_workers_.fetch_add(1, std::memory_order_seq_cst); // Сначала объявляем о сне, потом перепроверяем эпоху: иначе main может не разбудить
+            while ((epoch = job_epoch_.load(std::memory_order_seq_cst)) == seen_epoch)
+                futex_wait(job_epoch_, seen_epoch);
+            parked_workers_.fetch_sub(1, std::memory_order_relaxed);
+            trace::record(trace::EventKind::Park, "park", park_ns, trace::now());
+            return epoch;
+        }
+
+        ///Ожидание main, пока остальные потоки не выйдут из задачи
+        void waitWorkers() noexcept {
+            for (std::size_t i = 0; i < spin_iterations_; ++i) {
+                if (active_workers_.load(std::memory_order_acquire) == 0)
+                    return;
+                cpu_relax();
+            }
+            main_parked_.store(1, std::memory_order_seq_cst);
+            std::uint32_t active;
+            while ((active = active_workers_.load(std::memory_order_seq_cst)) != 0)
+                futex_wait(active_workers_, active);
+            main_parked_.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * Выполнение доли потока worker_id в текущей задаче.
+         * Поток не выходит из задачи, пока не выполнены все ее сегменты: свободное время тратится на вложенные задачи других потоков
+         */
+        void runShare(std::size_t worker_id) noexcept {
+            std::size_t next_static_chunk = worker_id;
+            std::size_t idle_iterations = 0;
+            for (;;) {
+                const std::uint32_t seen_epoch = help_epoch_.load(std::memory_order_seq_cst);
+                std::size_t chunk_id;
+                if (takeChunk(worker_id, next_static_chunk, chunk_id)) {
+                    run_task_chunk(current_task_, chunk_id);
+                    if (pending_chunks_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        notifyHelpers(); // Последний сегмент: будим уснувших, чтобы вышли из задачи
+                    idle_iterations = 0;
+                    continue;
                 }
-                //Если дошли до этой точки, значит появилась задача (разбудил главный поток)
-                auto job = current_job_;
-                ++active_workers_;
-                local_job_id = job_id_; //Чтобы потоки не выходили и заходили несколько раз в одну и ту же задачу
-
-                std::size_t begin_subrange = worker_id * settings_.chunk_size_ - settings_.overlap_size_ * worker_id;
-                std::size_t end_subrange = std::min(begin_subrange + settings_.chunk_size_, job.parent_view.extent(0));
-                auto subrange = Kokkos::subview(
-                                                        job.parent_view,
-                                                            Kokkos::pair(begin_subrange, end_subrange),
-                                                            Kokkos::ALL
-                                                        );
-                pthread_mutex_unlock(&mutex_);
-
-                job.run_kernel(subrange, worker_id, job.kernel_args);
-
-                //Окончание работы
-                pthread_mutex_lock(&mutex_);
-                if (--active_workers_ == 0) {
-                    job_active_ = false;
-                    pthread_cond_signal(&job_done_); //Последний вышедший сигнализирует в main
+                if (helpNested(worker_id)) {
+                    idle_iterations = 0;
+                    continue;
                 }
-                pthread_mutex_unlock(&mutex_);
+                if (pending_chunks_.load(std::memory_order_acquire) == 0)
+                    break;
+                if (idle_iterations++ < spin_iterations_) {
+                    cpu_relax();
+                    continue;
+                }
+                const std::uint64_t park_ns = trace::now();
+                parked_helpers_.fetch_add(1, std::memory_order_seq_cst);
+                if (help_epoch_.load(std::memory_order_seq_cst) == seen_epoch)
+                    futex_wait(help_epoch_, seen_epoch);
+                parked_helpers_.fetch_sub(1, std::memory_order_relaxed);
+                trace::record(trace::EventKind::Park, "park", park_ns, trace::now(), current_task_.job_id);
+                idle_iterations = 0;
+            }
+        }
+
+        ///Следующий сегмент верхней задачи: Static - каждый total_count_threads_-й начиная с worker_id, WorkStealing - из очередей
+        [[nodiscard]] bool takeChunk(std::size_t worker_id, std::size_t &next_static_chunk, std::size_t &chunk_id) noexcept {
+            if (current_task_.schedule == Schedule::WorkStealing)
+                return deques_[worker_id].popFront(chunk_id) || steal(worker_id, chunk_id);
+            if (next_static_chunk >= current_task_.count_chunks)
+                return false;
+            chunk_id = next_static_chunk;
+            next_static_chunk += total_count_threads_;
+            return true;
+        }
+
+        ///Помощь во вложенных задачах других потоков. true - если удалось выполнить хотя бы один сегмент
+        [[nodiscard]] bool helpNested(std::size_t helper_id) noexcept {
+            bool helped = false;
+            for (std::size_t shift = 0; shift < total_count_threads_; ++shift) {
+                NestedJob& nested = nested_[(helper_id + shift) % total_count_threads_];
+                if (!nested.active_.load(std::memory_order_relaxed))
+                    continue;
+                //Сначала регистрируемся, потом перепроверяем active_: владелец не освободит слот, пока мы внутри
+                nested.helpers_.fetch_add(1, std::memory_order_seq_cst);
+                if (nested.active_.load(std::memory_order_seq_cst)) {
+                    std::size_t chunk_id;
+                    while ((chunk_id = nested.next_chunk_.fetch_add(1, std::memory_order_relaxed)) < nested.task_.count_chunks) {
+                        run_task_chunk(nested.task_, chunk_id);
+                        nested.done_chunks_.fetch_add(1, std::memory_order_release);
+                        helped = true;
+                    }
+                }
+                nested.helpers_.fetch_sub(1, std::memory_order_seq_cst);
+            }
+            return helped;
+        }
+
+        ///Появилась работа для простаивающих потоков (вложенная задача, украденные сегменты) или задача закончилась
+        void notifyHelpers() noexcept {
+            help_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            if (parked_helpers_.load(std::memory_order_seq_cst) != 0)
+                futex_wake(help_epoch_, INT_MAX);
+        }
+
+        ///Начальная раскладка сегментов: потоку достается непрерывный блок, чтобы соседние сегменты были в одном кэше
+        void seedDeques() noexcept {
+            for (std::size_t tid = 0; tid < total_count_threads_; ++tid) {
+                std::size_t head = tid * current_task_.count_chunks / total_count_threads_;
+                std::size_t tail = (tid + 1) * current_task_.count_chunks / total_count_threads_;
+                deques_[tid].reset(head, tail);
             }
         }
 
+        /**
+         * Кража работы: обходим чужие очереди, начиная с соседа, и отрезаем половину первой непустой.
+         * Первый украденный сегмент выполняем сразу, остальные кладем в свою (пустую) очередь, чтобы их могли украсть дальше.
+         */
+        [[nodiscard]] bool steal(std::size_t thief_id, std::size_t &chunk_id) noexcept {
+            for (std::size_t shift = 1; shift < total_count_threads_; ++shift) {
+                std::size_t victim_id = (thief_id + shift) % total_count_threads_;
+                std::size_t begin, end;
+                if (deques_[victim_id].stealHalf(begin, end)) {
+                    const std::uint64_t steal_ns = trace::now();
+                    trace::record(trace::EventKind::Steal, "steal", steal_ns, steal_ns, current_task_.job_id, victim_id, begin, end);
+                    deques_[thief_id].reset(begin + 1, end);
+                    if (end - begin > 1)
+                        notifyHelpers();
+                    chunk_id = begin;
+                    return true;
+                }
+            }
+            return false;
+        }
+
         struct WorkerContext {
             Pool* pool_;
             std::size_t tid_;
         };
         std::vector<WorkerContext> contexts_; // Для передачи tid
+        inline static thread_local const WorkerContext* current_worker_ = nullptr; // Контекст потока, выполняющего ядро (для вложенных задач)
 
         ///Достпуные потоки в системе
         const std::size_t total_count_threads_;
         std::vector<pthread_t> threads_;
+        std::vector<ChunkDeque> deques_; // Очереди сегментов для режима WorkStealing, по одной на поток
+        std::vector<NestedJob> nested_; // Вложенная задача каждого потока
+        std::vector<int> thread_cpus_; // Процессор каждого потока, -1 - не закреплен
+        pthread_t caller_{}; // Поток, закрепленный при pin_caller_
+        cpu_set_t caller_mask_{}; // Его маска до закрепления
+        bool restore_caller_ = false;
 
-        JobContext current_job_{};
-        std::size_t job_id_{}; // чтобы отличать текущую задачу от предыдущей
-
-        pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
-        pthread_cond_t job_start_ = PTHREAD_COND_INITIALIZER;
-        pthread_cond_t job_done_ = PTHREAD_COND_INITIALIZER;
+        Task current_task_{};
+        std::uint64_t published_ns_ = 0; // Время публикации текущей задачи (для событий Wake), пишется до смены эпохи
 
-        volatile bool job_active_{false};
-        volatile bool stop_{false};
+        const std::size_t spin_iterations_; // 0 для WaitPolicy::Park
 
-        PartitionerSettings settings_{};
-        std::size_t active_workers_{0};
+        // Каждое поле синхронизации на своей кэш-линии, чтобы крутящиеся потоки не мешали друг другу
+        alignas(64) std::atomic<std::uint32_t> job_epoch_{0}; // чтобы отличать текущую задачу от предыдущей (futex)
+        alignas(64) std::atomic<std::uint32_t> active_workers_{0}; // Потоки, еще не вышедшие из текущей задачи (futex для main)
+        alignas(64) std::atomic<std::size_t> pending_chunks_{0}; // Невыполненные сегменты текущей задачи
+        alignas(64) std::atomic<std::uint32_t> help_epoch_{0}; // Смена = появилась работа для простаивающих внутри задачи (futex)
+        std::atomic<std::uint32_t> parked_helpers_{0};
+        alignas(64) std::atomic<std::uint32_t> parked_workers_{0};
+        std::atomic<std::uint32_t> main_parked_{0};
+        std::atomic<bool> stop_{false};
 
     };
 
-}
\ No newline at end of file
+}
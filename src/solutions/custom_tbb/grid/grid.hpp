@@ -0,0 +1,74 @@
+#pragma once
+#include <cmath>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+#include "core/custom_concepts.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/kernels/kernels.hpp"
+#include "core/storage/storage.hpp"
+
+namespace custom_tbb::grid {
+
+    ///Минимальный сегмент луча для одной задачи TBB (blocked_range не делит его дальше)
+    inline constexpr std::size_t grain_points = 1024;
+
+    /**
+     * Генерация сетки на луче через tbb::parallel_for. Результат побитово совпадает с grid::GenNonUniformOnRay
+     * @tparam ContainerT Хранилище точек луча
+     * @tparam ComputeT Тип, в котором считаются координаты
+     */
+    template <coordinate_storage_like ContainerT, scalar ComputeT = storage::scalar_t<ContainerT>>
+    class GenNonUniformOnRay {
+        using ScalarT = ComputeT;
+    public:
+        /**
+         * Функция для генерации сетки на луче на основе геометрической прогрессии
+         * (x, y) = (x_0, y_0) + (V_x, V_y) * (b-a) * t уравнение прямой, где t = (1 - r^i) / 1 - r^N
+         * Выполняется в текущей арене вызывающего потока (ограничения task_arena соблюдаются)
+         * @param normalized_direction_ray Вектор направления луча
+         * @param start_point_grid Точка на луче, с которой начинается заполнение сетки (должна лежать на направляющем векторе)
+         * @param end_point_grid Точка на луче, на которой заканчивается заполнение сетки (должна лежать на направляющем векторе)
+         * @param multiplier_q Основание геометрической прогрессии для роста сетки
+         * @param ray_storage
+         */
+        void operator() (
+                    const geometry::Point2D<ScalarT> &normalized_direction_ray,
+                    const geometry::Point2D<ScalarT> &start_point_grid,
+                    const geometry::Point2D<ScalarT> &end_point_grid,
+                    ScalarT multiplier_q,
+                    ContainerT ray_storage
+                    ) const {
+            const std::size_t grid_size = ray_storage.extent(0);
+            const ScalarT denominator = ScalarT(1) - std::pow(multiplier_q, grid_size - 1);
+
+            tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, grid_size, grain_points),
+                    [&](const tbb::blocked_range<std::size_t> &subrange) {
+                        kernels::fill_ray_segment_nonuniform(
+                                        normalized_direction_ray,
+                                        start_point_grid,
+                                        end_point_grid,
+                                        multiplier_q,
+                                        denominator,
+                                        subrange.begin(),
+                                        storage::subrange(ray_storage, subrange.begin(), subrange.end())
+                                        );
+                    });
+        }
+
+        ///То же внутри арены arena: задачи выполняют только потоки арены
+        void operator() (
+                    tbb::task_arena &arena,
+                    const geometry::Point2D<ScalarT> &normalized_direction_ray,
+                    const geometry::Point2D<ScalarT> &start_point_grid,
+                    const geometry::Point2D<ScalarT> &end_point_grid,
+                    ScalarT multiplier_q,
+                    ContainerT ray_storage
+                    ) const {
+            arena.execute([&] {
+                (*this)(normalized_direction_ray, start_point_grid, end_point_grid, multiplier_q, ray_storage);
+            });
+        }
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <oneapi/tbb/task_arena.h>
+#include "core/custom_concepts.hpp"
+#include "core/geometry/geometry.hpp"
+#include "core/storage/storage.hpp"
+#include "solutions/custom_tbb/grid/grid.hpp"
+
+namespace custom_tbb::mesh {
+
+    /**
+     * @tparam ContainerT Хранилище сетки (раскладка и тип хранения координат)
+     * @tparam ComputeT Тип, в котором считаются координаты
+     */
+    template <coordinate_storage_like ContainerT, scalar ComputeT = storage::scalar_t<ContainerT>>
+    struct GenFrameKirsch {
+        using ScalarT = ComputeT;
+        /**
+         * Генерация сетки: сетка делится на сектора по max_concurrency текущей арены, каждый сектор - задача task_group.
+         * Задача сектора заполняет левый главный луч, внутренние лучи сектора раздаются через parallel_for,
+         * так что освободившиеся потоки арены забирают их у занятых секторов.
+         * Раскладка лучей в памяти и результат побитово совпадают с mesh::GenFrameKirsch
+         * @param radius_hole
+         * @param side_size Размер стороны пластины (пластина квадратная)
+         * @param multiplier_q Основание геометрической прогрессии (q != 1)
+         * @param count_points_on_hole Количество точек на отверстии (= количество лучей, >= 2)
+         * @param count_points_on_ray Количество точек на луче (>= 2)
+         * @return ContainerT
+         */
+        [[nodiscard]] ContainerT operator() (
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) const;
+
+        ///То же внутри арены arena: число секторов и потоков ограничено ее concurrency
+        [[nodiscard]] ContainerT operator() (
+                        tbb::task_arena &arena,
+                        ScalarT radius_hole,
+                        ScalarT side_size,
+                        ScalarT multiplier_q,
+                        std::size_t count_points_on_hole,
+                        std::size_t count_points_on_ray
+                        ) const {
+            return arena.execute([&] {
+                return (*this)(radius_hole, side_size, multiplier_q, count_points_on_hole, count_points_on_ray);
+            });
+        }
+    };
+
+}
+
+#include "mesh_impl.tpp"
@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <numbers>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_group.h>
+
+namespace custom_tbb::mesh {
+
+    template <typename ScalarT>
+    struct RaysArgs {
+        geometry::Point2D<ScalarT> zero_point_;
+        geometry::Point2D<ScalarT> first_point_right_edge_, first_point_up_edge_, second_point_edge_;
+        ScalarT multiplier_q_;
+        std::size_t count_points_on_ray_;
+        storage::AoSView<ScalarT> hole_storage_;
+    };
+
+    ///Выпуск луча с глобальным номером ray_idx. Граница пластины выбирается по точке на отверстии: до 45 градусов - правая, после - верхняя
+    template <typename ScalarT, coordinate_storage_like ContainerT>
+    void emit_ray_by_idx(const RaysArgs<ScalarT> &args, std::size_t ray_idx, const ContainerT &mesh_storage) noexcept {
+        using p_type = geometry::Point2D<ScalarT>;
+        const std::size_t count_points_on_ray = args.count_points_on_ray_;
+        p_type hole_point{args.hole_storage_(ray_idx, 0), args.hole_storage_(ray_idx, 1)};
+        auto first_point_edge = (hole_point.y <= hole_point.x) ? args.first_point_right_edge_ : args.first_point_up_edge_;
+        const auto frame = kernels::make_ray_frame(
+                                        args.zero_point_,
+                                        hole_point,
+                                        first_point_edge,
+                                        args.second_point_edge_,
+                                        args.multiplier_q_,
+                                        count_points_on_ray
+                                        );
+        kernels::fill_ray_segment_nonuniform(
+                        frame.normalized_direction_,
+                        frame.start_point_,
+                        frame.end_point_,
+                        args.multiplier_q_,
+                        frame.denominator_,
+                        0,
+                        storage::subrange(mesh_storage, ray_idx * count_points_on_ray, (ray_idx + 1) * count_points_on_ray)
+                        );
+    }
+
+    template <coordinate_storage_like ContainerT, scalar ComputeT>
+    ContainerT GenFrameKirsch<ContainerT, ComputeT>::operator() (
+                                ScalarT radius_hole,
+                                ScalarT side_size,
+                                ScalarT multiplier_q,
+                                std::size_t count_points_on_hole,
+                                std::size_t count_points_on_ray
+                                ) const {
+        using p_type = geometry::Point2D<ScalarT>;
+        auto mesh_storage = storage::allocate<ContainerT>("v", count_points_on_hole * count_points_on_ray);
+
+        //Точки на отверстии считаются так же, как в pthreads версии, чтобы лучи совпадали побитово
+        auto hole_grid_tmp = storage::allocate<storage::AoSView<ScalarT>>("v", count_points_on_hole);
+        kernels::fill_circle_arc_uniform(ScalarT(0.0), ScalarT(std::numbers::pi/2.0), radius_hole, hole_grid_tmp);
+
+        const RaysArgs<ScalarT> args{
+                                p_type{ScalarT(0.0), ScalarT(0.0)}, // Все лучи выпускаются из точки (0,0)
+                                p_type{side_size, ScalarT(0.0)},
+                                p_type{ScalarT(0.0), side_size},
+                                p_type{side_size, side_size}, // Вторая точка у обоих границ общая
+                                multiplier_q,
+                                count_points_on_ray,
+                                hole_grid_tmp
+                            };
+
+        //Сектор = подряд идущие лучи [first, last), сектора различаются по размеру не больше чем на луч
+        const std::size_t count_sectors = std::min<std::size_t>(tbb::this_task_arena::max_concurrency(), count_points_on_hole);
+        tbb::task_group sectors;
+        for (std::size_t sector_id = 0; sector_id < count_sectors; sector_id++) {
+            const std::size_t first_ray_idx = sector_id * count_points_on_hole / count_sectors;
+            const std::size_t last_ray_idx = (sector_id + 1) * count_points_on_hole / count_sectors;
+            sectors.run([&args, &mesh_storage, first_ray_idx, last_ray_idx] {
+                emit_ray_by_idx(args, first_ray_idx, mesh_storage);
+                tbb::parallel_for(
+                        tbb::blocked_range<std::size_t>(first_ray_idx + 1, last_ray_idx),
+                        [&](const tbb::blocked_range<std::size_t> &rays) {
+                            for (std::size_t ray_idx = rays.begin(); ray_idx < rays.end(); ray_idx++)
+                                emit_ray_by_idx(args, ray_idx, mesh_storage);
+                        });
+            });
+        }
+        sectors.wait();
+
+        return mesh_storage;
+    }
+
+}
@@ -0,0 +1,168 @@
+#include "test_fixtures.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 10.0;
+    const fem::FarFieldStress tension{1.0e6, 0.0};
+
+    ///Решение задачи Кирша на сетке и ошибки ячеек относительно аналитического решения
+    template <coordinate_source_like ContainerT>
+    std::vector<double> solve_cell_errors(pthreads_manage::Pool& pthreads_pool, const ContainerT& mesh, const topology::RayLayout& layout) {
+        auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, layout.count_points_on_ray_);
+        assembly::StiffnessAssembler<Parallel, 4> assembler{pthreads_pool, quads, mesh.extent(0)};
+        auto matrix = assembler.pattern();
+        EXPECT_EQ(assembler.assemble(pthreads_pool, mesh, steel, matrix), SPARSE_STATUS_SUCCESS);
+        const auto fixed_dofs = fem::kirsch_symmetry_dofs(layout);
+        fem::apply_dirichlet(matrix, fixed_dofs);
+        std::vector<double> rhs(2 * mesh.extent(0), 0.0), x(rhs.size(), 0.0);
+        fem::add_far_field_load(mesh, layout, tension, steel.thickness_, rhs.data());
+        for (MKL_INT dof : fixed_dofs)
+            rhs[dof] = 0.0;
+        const auto report = solvers::conjugate_gradient(solvers::SparseOperator{matrix}, solvers::JacobiPreconditioner{matrix},
+                                                        rhs.data(), x.data(), solvers::CgSettings{1e-10, 100000});
+        EXPECT_TRUE(report.converged_);
+        const auto stresses = fem::cell_stresses(mesh, layout, x.data(), steel);
+        return fem::analytic_cell_errors(mesh, layout, stresses, tension, radius_hole);
+    }
+
+    double max_of(const std::vector<double>& values) {
+        return *std::max_element(values.begin(), values.end());
+    }
+}
+
+TEST(KirschStressTest, MatchesClassicValues) {
+    const double S = tension.sigma_xx_;
+    //Концентрация 3 на оси, перпендикулярной нагрузке, и -S на оси нагрузки
+    EXPECT_NEAR(fem::kirsch_stress(tension, radius_hole, 0.0, radius_hole).sigma_xx_, 3.0 * S, 1e-9 * S);
+    EXPECT_NEAR(fem::kirsch_stress(tension, radius_hole, radius_hole, 0.0).sigma_yy_, -S, 1e-9 * S);
+    //Край отверстия свободен: sigma_rr = sigma_rt = 0
+    for (const double t : {0.1, 0.5, 1.0, 1.4}) {
+        const double c = std::cos(t), s = std::sin(t);
+        const auto sigma = fem::kirsch_stress(tension, radius_hole, radius_hole * c, radius_hole * s);
+        EXPECT_NEAR(sigma.sigma_xx_ * c * c + sigma.sigma_yy_ * s * s + 2.0 * sigma.sigma_xy_ * s * c, 0.0, 1e-9 * S) << "t " << t;
+        EXPECT_NEAR((sigma.sigma_yy_ - sigma.sigma_xx_) * s * c + sigma.sigma_xy_ * (c * c - s * s), 0.0, 1e-9 * S) << "t " << t;
+    }
+    //Вдали от отверстия - поле на бесконечности
+    const auto far = fem::kirsch_stress(fem::FarFieldStress{S, 0.5 * S}, radius_hole, 300.0, 400.0);
+    EXPECT_NEAR(far.sigma_xx_, S, 1e-5 * S);
+    EXPECT_NEAR(far.sigma_yy_, 0.5 * S, 1e-5 * S);
+    EXPECT_NEAR(far.sigma_xy_, 0.0, 1e-5 * S);
+}
+
+TEST(EstimatorTest, RecoveryErrorVanishesForUniformStress) {
+    const topology::RayLayout layout{5, 4};
+    std::vector<fem::Stress> stresses(layout.count_cells(), fem::Stress{1.0, -2.0, 0.5});
+    for (const double error : fem::recovery_cell_errors(layout, stresses, 1.0))
+        EXPECT_NEAR(error, 0.0, 1e-15);
+
+    stresses[0].sigma_xx_ = 3.0; // Скачок в одной ячейке виден у нее и у соседей
+    const auto errors = fem::recovery_cell_errors(layout, stresses, 1.0);
+    const auto intervals = fem::ray_interval_errors(layout, errors);
+    ASSERT_EQ(intervals.size(), 4u);
+    EXPECT_EQ(std::max_element(errors.begin(), errors.end()) - errors.begin(), 0);
+    EXPECT_EQ(intervals[0].worst_point_, 0u);
+    EXPECT_GT(intervals[1].error_, 0.0);
+    EXPECT_EQ(intervals[3].error_, 0.0);
+}
+
+TEST(AdaptiveKirschTest, UniformFanMatchesFrameKirsch) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t H = 9, R = 12;
+    mesh::AdaptiveKirsch<ViewType, Parallel> adaptive(pthreads_pool, radius_hole, side_size, mesh::RayFan::uniform(H, 1.1), R);
+    const auto expected = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, 1.1, H, R);
+    ASSERT_EQ(adaptive.mesh().extent(0), expected.extent(0));
+    EXPECT_EQ(adaptive.countEmitted(), H);
+    for (std::size_t i = 0; i < expected.extent(0); i++) {
+        EXPECT_NEAR(adaptive.mesh()(i, 0), expected(i, 0), 1e-12) << "node " << i;
+        EXPECT_NEAR(adaptive.mesh()(i, 1), expected(i, 1), 1e-12) << "node " << i;
+    }
+}
+
+TEST(AdaptiveKirschTest, RefineEmitsOnlyChangedRays) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t H = 5, R = 10;
+    mesh::AdaptiveKirsch<ViewType, Parallel> adaptive(pthreads_pool, radius_hole, side_size, mesh::RayFan::uniform(H, 1.1), R);
+    const ViewType before = adaptive.mesh();
+    const auto fan_before = adaptive.fan();
+
+    //Худшая ячейка в средней трети: полоса 2 делится, q не меняется
+    std::vector<fem::RayIntervalError> errors(H - 1, fem::RayIntervalError{0.01, 0});
+    errors[2] = fem::RayIntervalError{1.0, R / 2};
+    EXPECT_EQ(adaptive.refine(pthreads_pool, errors, mesh::RefineSettings{}), 1u);
+    ASSERT_EQ(adaptive.fan().count_rays(), H + 1);
+    EXPECT_EQ(adaptive.countEmitted(), 1u);
+    EXPECT_DOUBLE_EQ(adaptive.fan().angles_[3], 0.5 * (fan_before.angles_[2] + fan_before.angles_[3]));
+    EXPECT_EQ(adaptive.fan().multipliers_, std::vector<double>(H + 1, 1.1));
+    //Старые лучи скопированы побитово
+    for (const auto& [old_ray, new_ray] : {std::pair{0, 0}, {2, 2}, {3, 4}, {4, 5}})
+        EXPECT_EQ(std::memcmp(&adaptive.mesh()(new_ray * R, 0), &before(old_ray * R, 0), R * 2 * sizeof(double)), 0) << "ray " << old_ray;
+
+    //Новый луч совпадает с лучом равномерного веера под тем же углом
+    const auto reference = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, 1.1, 9, R);
+    for (std::size_t j = 0; j < R; j++) {
+        EXPECT_NEAR(adaptive.mesh()(3 * R + j, 0), reference(5 * R + j, 0), 1e-12);
+        EXPECT_NEAR(adaptive.mesh()(3 * R + j, 1), reference(5 * R + j, 1), 1e-12);
+    }
+
+    //Ошибки ниже допуска - сетка не меняется
+    mesh::RefineSettings settings;
+    settings.tolerance_ = 2.0;
+    std::vector<fem::RayIntervalError> small(adaptive.layout().count_rays_ - 1, fem::RayIntervalError{1.0, 0});
+    EXPECT_EQ(adaptive.refine(pthreads_pool, small, settings), 0u);
+    EXPECT_EQ(adaptive.fan().count_rays(), H + 1);
+}
+
+TEST(AdaptiveKirschTest, RefineGradesMultipliersSmoothly) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t H = 9, R = 10;
+    mesh::AdaptiveKirsch<ViewType, Parallel> adaptive(pthreads_pool, radius_hole, side_size, mesh::RayFan::uniform(H, 1.1), R);
+    mesh::RefineSettings settings;
+    settings.max_log_slope_ = 0.1;
+    //Худшая ячейка у отверстия в последней полосе: q ее лучей растет, соседи подтягиваются в пределах max_log_slope_
+    for (int step = 0; step < 3; step++) {
+        std::vector<fem::RayIntervalError> errors(adaptive.layout().count_rays_ - 1, fem::RayIntervalError{0.01, 0});
+        errors.back() = fem::RayIntervalError{1.0, 0};
+        adaptive.refine(pthreads_pool, errors, settings);
+    }
+    const auto& fan = adaptive.fan();
+    EXPECT_GT(fan.multipliers_.back(), 1.1);
+    EXPECT_LE(fan.multipliers_.back(), settings.max_multiplier_);
+    for (std::size_t k = 0; k + 1 < fan.count_rays(); k++) {
+        EXPECT_LT(fan.angles_[k], fan.angles_[k + 1]);
+        const double slope = std::abs(std::log(fan.multipliers_[k + 1] / fan.multipliers_[k])) / (fan.angles_[k + 1] - fan.angles_[k]);
+        EXPECT_LE(slope, settings.max_log_slope_ * (1.0 + 1e-9)) << "rays " << k << ", " << k + 1;
+    }
+    //Лучи у оси x далеко: их q и узлы не тронуты
+    EXPECT_DOUBLE_EQ(fan.multipliers_.front(), 1.1);
+    EXPECT_LT(adaptive.countEmitted(), fan.count_rays());
+}
+
+///Адаптация достигает точности 2% по напряжениям с меньшим числом степеней свободы, чем равномерная сетка
+TEST(AdaptiveKirschTest, ReachesToleranceWithFewerDofs) {
+    pthreads_manage::Pool pthreads_pool{};
+    constexpr double target = 0.02;
+    const std::size_t R = 25;
+    mesh::AdaptiveKirsch<ViewType, Parallel> adaptive(pthreads_pool, radius_hole, side_size, mesh::RayFan::uniform(5, 1.1), R);
+    mesh::RefineSettings settings;
+    settings.tolerance_ = target;
+    double error = 1.0;
+    for (int step = 0; step < 6; step++) {
+        const auto errors = solve_cell_errors(pthreads_pool, adaptive.mesh(), adaptive.layout());
+        error = max_of(errors);
+        if (error < target)
+            break;
+        ASSERT_GT(adaptive.refine(pthreads_pool, fem::ray_interval_errors(adaptive.layout(), errors), settings), 0u);
+    }
+    EXPECT_LT(error, target);
+    const std::size_t adaptive_dofs = 2 * adaptive.mesh().extent(0);
+
+    const std::size_t n = 25; // Больше степеней свободы, чем у адаптивной сетки
+    const auto uniform = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, 1.15, n, n);
+    ASSERT_LT(adaptive_dofs, 2 * n * n);
+    EXPECT_GT(max_of(solve_cell_errors(pthreads_pool, uniform, topology::RayLayout{n, n})), target);
+}
@@ -0,0 +1,194 @@
+#include "test_fixtures.hpp"
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+    ///Два пакета по два ядра, у каждого ядра два SMT-соседа (нумерация как в Linux: соседи - cpu и cpu + 4)
+    pthreads_manage::CpuTopology two_sockets_smt() {
+        std::vector<pthreads_manage::CpuInfo> cpus;
+        for (int cpu = 0; cpu < 8; ++cpu)
+            cpus.push_back(pthreads_manage::CpuInfo{cpu, (cpu % 4) % 2, (cpu % 4) / 2});
+        return pthreads_manage::CpuTopology(std::move(cpus));
+    }
+
+    std::set<int> cpu_numbers(const pthreads_manage::CpuTopology& topology) {
+        std::set<int> result;
+        for (const auto& info : topology.cpus())
+            result.insert(info.cpu_);
+        return result;
+    }
+
+    ///Для каждого сегмента: процессор, на котором он выполнялся, и число процессоров в маске выполнившего потока
+    struct PlacementArgs {
+        std::vector<int>* cpus_;
+        std::vector<int>* mask_sizes_;
+    };
+
+    void run_placement_job(pthreads_manage::Pool& pool, std::vector<int>& cpus, std::vector<int>& mask_sizes) {
+        const std::size_t count_chunks = pool.totalThreads();
+        cpus.assign(count_chunks, -1);
+        mask_sizes.assign(count_chunks, 0);
+        pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange, std::size_t chunk_id, const PlacementArgs& args) noexcept {
+                                    cpu_set_t set;
+                                    CPU_ZERO(&set);
+                                    pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+                                    (*args.cpus_)[chunk_id] = sched_getcpu();
+                                    (*args.mask_sizes_)[chunk_id] = CPU_COUNT(&set);
+                                },
+                                PlacementArgs{&cpus, &mask_sizes},
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{count_chunks, 1, 0}
+                                };
+        pool.dispatchRange<Parallel>(count_chunks, env);
+    }
+}
+
+TEST(CpuTopologyTest, CountsCoresAndPackages) {
+    const auto topology = two_sockets_smt();
+    EXPECT_EQ(topology.size(), 8u);
+    EXPECT_EQ(topology.countCores(), 4u);
+    EXPECT_EQ(topology.countPackages(), 2u);
+}
+
+TEST(CpuTopologyTest, PolicyOrders) {
+    const auto topology = two_sockets_smt();
+    using pthreads_manage::Affinity;
+    EXPECT_EQ(topology.order(Affinity::Compact), (std::vector<int>{0, 4, 1, 5, 2, 6, 3, 7}));
+    EXPECT_EQ(topology.order(Affinity::SmtAware), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(topology.order(Affinity::Scatter), (std::vector<int>{0, 2, 1, 3, 4, 6, 5, 7}));
+}
+
+TEST(CpuTopologyTest, PartitionKeepsSmtSiblingsTogether) {
+    const auto topology = two_sockets_smt();
+    const auto halves = topology.partition(2);
+    ASSERT_EQ(halves.size(), 2u);
+    EXPECT_EQ(cpu_numbers(halves[0]), (std::set<int>{0, 1, 4, 5}));
+    EXPECT_EQ(cpu_numbers(halves[1]), (std::set<int>{2, 3, 6, 7}));
+
+    const auto thirds = topology.partition(3);
+    std::set<int> covered;
+    for (const auto& part : thirds) {
+        EXPECT_FALSE(part.empty());
+        EXPECT_EQ(part.size() % 2, 0u); // Только целые ядра
+        for (const int cpu : cpu_numbers(part))
+            EXPECT_TRUE(covered.insert(cpu).second) << "cpu " << cpu << " in two parts";
+    }
+    EXPECT_EQ(covered.size(), 8u);
+}
+
+TEST(CpuTopologyTest, PartitionWithFewCpus) {
+    const pthreads_manage::CpuTopology topology({{0, 0, 0}, {1, 0, 0}});
+    const auto parts = topology.partition(2);
+    EXPECT_EQ(cpu_numbers(parts[0]), (std::set<int>{0}));
+    EXPECT_EQ(cpu_numbers(parts[1]), (std::set<int>{1}));
+
+    const auto repeated = pthreads_manage::CpuTopology({{3, 0, 0}}).partition(3);
+    ASSERT_EQ(repeated.size(), 3u);
+    for (const auto& part : repeated)
+        EXPECT_EQ(cpu_numbers(part), (std::set<int>{3}));
+}
+
+TEST(CpuTopologyTest, DiscoverMatchesProcessMask) {
+    const auto topology = pthreads_manage::CpuTopology::discover();
+    ASSERT_FALSE(topology.empty());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+    EXPECT_EQ(topology.size(), static_cast<std::size_t>(CPU_COUNT(&set)));
+    for (const auto& info : topology.cpus())
+        EXPECT_TRUE(CPU_ISSET(info.cpu_, &set)) << "cpu " << info.cpu_;
+    EXPECT_GE(pthreads_manage::get_count_cpu(), 1u);
+    EXPECT_LE(pthreads_manage::get_count_cpu(), topology.size());
+}
+
+TEST(PoolAffinityTest, WorkersArePinnedInsideTopology) {
+    const auto topology = pthreads_manage::CpuTopology::discover();
+    const std::set<int> allowed = cpu_numbers(topology);
+    for (const auto affinity : {pthreads_manage::Affinity::Compact, pthreads_manage::Affinity::Scatter, pthreads_manage::Affinity::SmtAware}) {
+        pthreads_manage::Pool pool{pthreads_manage::PoolSettings{3, affinity}};
+        ASSERT_EQ(pool.totalThreads(), 3u);
+        EXPECT_EQ(pool.threadCpu(0), -1);
+        const std::vector<int> order = topology.order(affinity);
+        for (std::size_t tid = 1; tid < pool.totalThreads(); ++tid)
+            EXPECT_EQ(pool.threadCpu(tid), order[tid % order.size()]);
+
+        std::vector<int> cpus, mask_sizes;
+        run_placement_job(pool, cpus, mask_sizes);
+        for (std::size_t chunk = 0; chunk < cpus.size(); ++chunk)
+            EXPECT_TRUE(allowed.contains(cpus[chunk])) << "cpu " << cpus[chunk];
+        //Рабочие потоки закреплены за одним процессором, main сохраняет маску процесса
+        EXPECT_GE(std::count(mask_sizes.begin(), mask_sizes.end(), 1), static_cast<std::ptrdiff_t>(topology.size() == 1 ? 3 : 2));
+    }
+}
+
+TEST(PoolAffinityTest, NoneLeavesProcessMask) {
+    pthreads_manage::Pool pool{pthreads_manage::PoolSettings{2, pthreads_manage::Affinity::None}};
+    EXPECT_EQ(pool.threadCpu(0), -1);
+    EXPECT_EQ(pool.threadCpu(1), -1);
+    std::vector<int> cpus, mask_sizes;
+    run_placement_job(pool, cpus, mask_sizes);
+    for (const int mask_size : mask_sizes)
+        EXPECT_EQ(static_cast<std::size_t>(mask_size), pthreads_manage::CpuTopology::discover().size());
+}
+
+TEST(PoolAffinityTest, DefaultThreadCountFollowsCpus) {
+    const auto topology = pthreads_manage::CpuTopology::discover();
+    pthreads_manage::Pool pool{pthreads_manage::PoolSettings{0, pthreads_manage::Affinity::Compact, pthreads_manage::WaitPolicy::Park, topology.partition(1)[0]}};
+    EXPECT_EQ(pool.totalThreads(), topology.size());
+}
+
+TEST(PoolAffinityTest, PartitionedPoolsRunConcurrently) {
+    const auto parts = pthreads_manage::CpuTopology::discover().partition(2);
+    std::atomic<std::size_t> failures{0};
+    std::vector<std::thread> owners;
+    for (const auto& part : parts) {
+        owners.emplace_back([&part, &failures] {
+            pthreads_manage::PoolSettings settings{2, pthreads_manage::Affinity::Compact, pthreads_manage::WaitPolicy::Park, part, true};
+            pthreads_manage::Pool pool{settings};
+            const std::set<int> allowed = cpu_numbers(part);
+            for (std::size_t tid = 0; tid < pool.totalThreads(); ++tid)
+                if (!allowed.contains(pool.threadCpu(tid)))
+                    failures.fetch_add(1);
+            for (int repeat = 0; repeat < 20; ++repeat) {
+                std::vector<int> cpus, mask_sizes;
+                run_placement_job(pool, cpus, mask_sizes);
+                for (std::size_t chunk = 0; chunk < cpus.size(); ++chunk)
+                    if (!allowed.contains(cpus[chunk]) || mask_sizes[chunk] != 1)
+                        failures.fetch_add(1);
+            }
+        });
+    }
+    for (auto& owner : owners)
+        owner.join();
+    EXPECT_EQ(failures.load(), 0u);
+}
+
+TEST(PoolAffinityTest, PinnedCallerMaskIsRestored) {
+    //В отдельном потоке: при ошибке маска тестового процесса не меняется
+    std::thread owner([] {
+        cpu_set_t before, pinned, after;
+        ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(before), &before), 0);
+        {
+            pthreads_manage::PoolSettings settings{2};
+            settings.pin_caller_ = true;
+            pthreads_manage::Pool pool{settings};
+            ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(pinned), &pinned), 0);
+            EXPECT_EQ(CPU_COUNT(&pinned), 1);
+            EXPECT_TRUE(CPU_ISSET(pool.threadCpu(0), &pinned));
+        }
+        ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(after), &after), 0);
+        EXPECT_TRUE(CPU_EQUAL(&before, &after));
+    });
+    owner.join();
+}
+
+TEST(PoolAffinityTest, CountConstructorUsesSmtAware) {
+    const std::vector<int> order = pthreads_manage::CpuTopology::discover().order(pthreads_manage::Affinity::SmtAware);
+    pthreads_manage::Pool pool(3);
+    for (std::size_t tid = 1; tid < pool.totalThreads(); ++tid)
+        EXPECT_EQ(pool.threadCpu(tid), order[tid % order.size()]);
+}
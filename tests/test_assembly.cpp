@@ -0,0 +1,133 @@
+#include "test_fixtures.hpp"
+#include <cmath>
+
+namespace {
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Перемещения жесткого тела: два сдвига и поворот вокруг начала координат
+    template <std::size_t NodesPerElement>
+    std::array<std::array<double, 2 * NodesPerElement>, 3> rigid_modes(const std::array<double, NodesPerElement>& x, const std::array<double, NodesPerElement>& y) {
+        std::array<std::array<double, 2 * NodesPerElement>, 3> modes{};
+        for (std::size_t a = 0; a < NodesPerElement; a++) {
+            modes[0][2 * a] = 1.0;
+            modes[1][2 * a + 1] = 1.0;
+            modes[2][2 * a] = -y[a];
+            modes[2][2 * a + 1] = x[a];
+        }
+        return modes;
+    }
+
+    template <std::size_t NodesPerElement>
+    void expect_symmetric_with_rigid_kernel(const std::array<double, NodesPerElement>& x, const std::array<double, NodesPerElement>& y) {
+        const auto stiffness = fem::element_stiffness<NodesPerElement>(x, y, fem::plane_stress(steel), steel.thickness_);
+        double scale = 0.0;
+        for (std::size_t i = 0; i < 2 * NodesPerElement; i++) {
+            EXPECT_GT(stiffness[i][i], 0.0);
+            scale = std::max(scale, stiffness[i][i]);
+        }
+        for (std::size_t i = 0; i < 2 * NodesPerElement; i++)
+            for (std::size_t j = 0; j < 2 * NodesPerElement; j++)
+                EXPECT_NEAR(stiffness[i][j], stiffness[j][i], 1e-12 * scale);
+
+        for (const auto& mode : rigid_modes<NodesPerElement>(x, y))
+            for (std::size_t i = 0; i < 2 * NodesPerElement; i++) {
+                double force = 0.0;
+                for (std::size_t j = 0; j < 2 * NodesPerElement; j++)
+                    force += stiffness[i][j] * mode[j];
+                EXPECT_NEAR(force, 0.0, 1e-9 * scale);
+            }
+    }
+}
+
+TEST(ElasticityTest, QuadStiffnessIsSymmetricWithRigidKernel) {
+    expect_symmetric_with_rigid_kernel<4>({0.5, 1.3, 1.1, 0.3}, {0.1, 0.2, 1.4, 0.9});
+}
+
+TEST(ElasticityTest, TriangleStiffnessIsSymmetricWithRigidKernel) {
+    expect_symmetric_with_rigid_kernel<3>({0.5, 1.3, 0.7}, {0.1, 0.2, 1.4});
+}
+
+TEST(ElasticityTest, UnitSquareMatchesClosedForm) {
+    //Диагональ матрицы квадрата со стороной 1: E t / (1 - nu^2) * (1/3 + (1 - nu)/6) (Зенкевич)
+    const fem::Material material{1.0, 0.25, 1.0};
+    const auto stiffness = fem::element_stiffness<4>({0.0, 1.0, 1.0, 0.0}, {0.0, 0.0, 1.0, 1.0}, fem::plane_stress(material), 1.0);
+    const double expected = 1.0 / (1.0 - 0.25 * 0.25) * (1.0 / 3.0 + 0.75 / 6.0);
+    for (std::size_t i = 0; i < 8; i++)
+        EXPECT_NEAR(stiffness[i][i], expected, 1e-14);
+}
+
+TYPED_TEST(KirschMeshFixture, ColoringSeparatesSharedNodes) {
+    const std::size_t R = this->count_points_on_ray;
+    auto mesh = this->template generate<Parallel>();
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(this->pthreads_pool, mesh, R);
+    auto coloring = topology::color_elements(quads, mesh.extent(0));
+
+    EXPECT_LE(coloring.count_colors(), 4u);
+    EXPECT_EQ(coloring.elements_.size(), quads.extent(0));
+    for (std::size_t color = 0; color < coloring.count_colors(); color++) {
+        std::vector<bool> used(mesh.extent(0), false);
+        for (std::size_t i = coloring.offsets_[color]; i < coloring.offsets_[color + 1]; i++)
+            for (std::size_t a = 0; a < 4; a++) {
+                const std::size_t node = quads(coloring.elements_[i], a);
+                EXPECT_FALSE(used[node]) << "color " << color << ", node " << node;
+                used[node] = true;
+            }
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, AssembledStiffnessIsSymmetricAndPolicyIndependent) {
+    const std::size_t R = this->count_points_on_ray;
+    auto mesh = this->template generate<Parallel>();
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(this->pthreads_pool, mesh, R);
+
+    sparse_status_t status = SPARSE_STATUS_NOT_INITIALIZED;
+    auto matrix = assembly::StiffnessAssembler<Parallel, 4>{this->pthreads_pool, quads, mesh.extent(0)}(this->pthreads_pool, mesh, steel, status);
+    ASSERT_EQ(status, SPARSE_STATUS_SUCCESS);
+    auto reference = assembly::StiffnessAssembler<Sequential, 4>{this->pthreads_pool, quads, mesh.extent(0)}(this->pthreads_pool, mesh, steel, status);
+    ASSERT_EQ(status, SPARSE_STATUS_SUCCESS);
+    auto stealing = assembly::StiffnessAssembler<WorkStealing, 4>{this->pthreads_pool, quads, mesh.extent(0)}(this->pthreads_pool, mesh, steel, status);
+    ASSERT_EQ(status, SPARSE_STATUS_SUCCESS);
+
+    ASSERT_TRUE(static_cast<bool>(matrix.handle_));
+    ASSERT_EQ(matrix.count_rows_, static_cast<MKL_INT>(2 * mesh.extent(0)));
+    EXPECT_EQ(matrix.row_offsets_, reference.row_offsets_);
+    EXPECT_EQ(matrix.col_indices_, reference.col_indices_);
+    EXPECT_EQ(matrix.values_, reference.values_);
+    EXPECT_EQ(matrix.values_, stealing.values_);
+
+    for (MKL_INT row = 0; row < matrix.count_rows_; row++) {
+        for (MKL_INT p = matrix.row_offsets_[row]; p < matrix.row_offsets_[row + 1]; p++) {
+            const std::size_t transposed = matrix.find(matrix.col_indices_[p], row);
+            ASSERT_LT(transposed, matrix.count_nonzeros());
+            EXPECT_NEAR(matrix.values_[p], matrix.values_[transposed], 1e-6 * std::abs(matrix.values_[p]) + 1e-3);
+        }
+    }
+
+    //Сдвиг вдоль x не вызывает сил: K * (1, 0, 1, 0, ...) = 0
+    std::vector<double> shift(matrix.count_rows_), force(matrix.count_rows_);
+    for (std::size_t node = 0; node < mesh.extent(0); node++)
+        shift[2 * node] = 1.0;
+    ASSERT_EQ(mkl_sparse_d_mv(SPARSE_OPERATION_NON_TRANSPOSE, 1.0, matrix.handle_.get(), sparse::general_descr(), shift.data(), 0.0, force.data()),
+              SPARSE_STATUS_SUCCESS);
+    for (MKL_INT row = 0; row < matrix.count_rows_; row++)
+        EXPECT_NEAR(force[row], 0.0, 1e-6 * steel.young_modulus_) << "row " << row;
+}
+
+TEST(AssemblyTest, ReassemblyReusesPattern) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t H = 17, R = 23;
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, H, R);
+    auto triangles = mesh::GenConnectivityKirsch<Parallel>{}.triangles(pthreads_pool, mesh, R);
+    assembly::StiffnessAssembler<Parallel, 3> assembler{pthreads_pool, triangles, mesh.extent(0)};
+    auto matrix = assembler.pattern();
+    ASSERT_EQ(assembler.assemble(pthreads_pool, mesh, steel, matrix), SPARSE_STATUS_SUCCESS);
+
+    //Повторная сборка с другим материалом на том же портрете масштабирует значения
+    const fem::Material soft{steel.young_modulus_ / 2.0, steel.poisson_ratio_, steel.thickness_};
+    auto values = matrix.values_;
+    ASSERT_EQ(assembler.assemble(pthreads_pool, mesh, soft, matrix), SPARSE_STATUS_SUCCESS);
+    for (std::size_t p = 0; p < values.size(); p++)
+        EXPECT_NEAR(matrix.values_[p], values[p] / 2.0, 1e-9 * std::abs(values[p]));
+    for (MKL_INT row = 0; row < matrix.count_rows_; row++)
+        EXPECT_GT(matrix.values_[matrix.find(row, row)], 0.0);
+}
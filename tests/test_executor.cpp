@@ -0,0 +1,189 @@
+#include "test_fixtures.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    ///Ожидание флага с ограничением по времени (на машине с одним ядром полосы чередуются, поэтому уступаем процессор)
+    bool wait_flag(const std::atomic<bool>& flag, std::chrono::seconds timeout = std::chrono::seconds(10)) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!flag.load(std::memory_order_acquire)) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            sched_yield();
+        }
+        return true;
+    }
+
+    ///Порядок выполнения задач
+    struct Journal {
+        std::mutex mutex_;
+        std::vector<int> order_;
+
+        void push(int value) {
+            std::lock_guard lock(mutex_);
+            order_.push_back(value);
+        }
+        std::size_t position(int value) {
+            std::lock_guard lock(mutex_);
+            return static_cast<std::size_t>(std::find(order_.begin(), order_.end(), value) - order_.begin());
+        }
+    };
+}
+
+TEST(ExecutorTest, SubmitDoesNotBlock) {
+    pthreads_manage::Executor executor;
+    std::atomic<bool> released{false};
+    std::atomic<bool> finished{false};
+    auto handle = executor.submit([&](pthreads_manage::Pool&) noexcept {
+        wait_flag(released);
+        finished.store(true, std::memory_order_release);
+    });
+    EXPECT_FALSE(handle.ready());
+    released.store(true, std::memory_order_release);
+    handle.wait();
+    EXPECT_TRUE(handle.ready());
+    EXPECT_TRUE(finished.load(std::memory_order_acquire));
+}
+
+TEST(ExecutorTest, DependenciesRunFirst) {
+    pthreads_manage::Executor executor{pthreads_manage::ExecutorSettings{3}};
+    Journal journal;
+    //Ромб: 1 -> (2, 3) -> 4, и 5 без зависимостей
+    auto first = executor.submit([&](pthreads_manage::Pool&) noexcept { journal.push(1); });
+    auto left = executor.submit([&](pthreads_manage::Pool&) noexcept { journal.push(2); }, {first});
+    auto right = executor.submit([&](pthreads_manage::Pool&) noexcept { journal.push(3); }, {first});
+    auto last = executor.submit([&](pthreads_manage::Pool&) noexcept { journal.push(4); }, {left, right, pthreads_manage::JobHandle{}});
+    executor.submit([&](pthreads_manage::Pool&) noexcept { journal.push(5); });
+    last.wait();
+    EXPECT_LT(journal.position(1), journal.position(2));
+    EXPECT_LT(journal.position(1), journal.position(3));
+    EXPECT_LT(journal.position(2), journal.position(4));
+    EXPECT_LT(journal.position(3), journal.position(4));
+
+    executor.waitAll();
+    EXPECT_EQ(journal.order_.size(), 5u);
+
+    //Зависимость от уже выполненной задачи не задерживает новую
+    executor.submit([&](pthreads_manage::Pool&) noexcept { journal.push(6); }, {last}).wait();
+    EXPECT_EQ(journal.order_.size(), 6u);
+}
+
+TEST(ExecutorTest, IndependentJobsOverlap) {
+    pthreads_manage::Executor executor{pthreads_manage::ExecutorSettings{2}};
+    ASSERT_EQ(executor.countLanes(), 2u);
+    std::atomic<bool> first_started{false}, second_started{false};
+    std::atomic<int> met{0};
+    //Каждая задача ждет начала другой: завершатся, только если выполняются одновременно
+    auto first = executor.submit([&](pthreads_manage::Pool&) noexcept {
+        first_started.store(true, std::memory_order_release);
+        met.fetch_add(wait_flag(second_started) ? 1 : 0);
+    });
+    auto second = executor.submit([&](pthreads_manage::Pool&) noexcept {
+        second_started.store(true, std::memory_order_release);
+        met.fetch_add(wait_flag(first_started) ? 1 : 0);
+    });
+    first.wait();
+    second.wait();
+    EXPECT_EQ(met.load(), 2);
+}
+
+TEST(ExecutorTest, JobsDispatchOnLanePool) {
+    pthreads_manage::Executor executor{pthreads_manage::ExecutorSettings{1, 3}};
+    const std::size_t N = 1000;
+    std::vector<std::size_t> hits(N, 0);
+    executor.submit([&hits, N](pthreads_manage::Pool& pthreads_pool) noexcept {
+        EXPECT_EQ(pthreads_pool.totalThreads(), 3u);
+        pthreads_manage::Environment env{
+                                [](pthreads_manage::IndexRange range, std::size_t, std::size_t* hits_data) noexcept {
+                                    for (std::size_t i = range.begin_; i < range.end_; ++i)
+                                        hits_data[i]++;
+                                },
+                                hits.data(),
+                                [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                pthreads_manage::PartitionerSettings{N, pthreads_pool.rangeChunkSize<WorkStealing>(N), 0}
+                                };
+        pthreads_pool.dispatchRange<WorkStealing>(N, env);
+    }).wait();
+    for (std::size_t i = 0; i < N; ++i)
+        EXPECT_EQ(hits[i], 1u) << "index " << i;
+}
+
+TEST(ExecutorTest, DestructorDrainsSubmittedJobs) {
+    std::atomic<int> count{0};
+    {
+        pthreads_manage::Executor executor{pthreads_manage::ExecutorSettings{2}};
+        pthreads_manage::JobHandle previous;
+        for (int i = 0; i < 50; ++i)
+            previous = executor.submit([&count](pthreads_manage::Pool&) noexcept { count.fetch_add(1); }, {previous});
+    }
+    EXPECT_EQ(count.load(), 50);
+}
+
+TEST(ExecutorTest, AcceptsMoveOnlyJobs) {
+    pthreads_manage::Executor executor;
+    auto value = std::make_unique<int>(7);
+    int result = 0;
+    executor.submit([value = std::move(value), &result](pthreads_manage::Pool&) noexcept { result = *value; }).wait();
+    EXPECT_EQ(result, 7);
+}
+
+TEST(ExecutorTest, LaneMayWaitForFinishedJob) {
+    pthreads_manage::Executor executor;
+    auto first = executor.submit([](pthreads_manage::Pool&) noexcept {});
+    std::atomic<bool> finished{false};
+    //Зависимость гарантирует, что first уже выполнена: ожидание из единственной полосы не блокирует
+    executor.submit([&finished, first](pthreads_manage::Pool&) noexcept {
+        first.wait();
+        finished.store(true, std::memory_order_release);
+    }, {first}).wait();
+    EXPECT_TRUE(finished.load(std::memory_order_acquire));
+}
+
+///Конвейер: сектор k пишется в файл, пока материализуется сектор k + 1
+TEST(ExecutorTest, PipelinedSectorsMatchMaterializedMesh) {
+    const std::size_t H = 33, R = 65, count_sectors = 8;
+    const auto implicit_mesh = mesh::GenImplicitKirsch<double>{}(0.5, 10.0, 1.05, H, R);
+    const std::size_t count_nodes = implicit_mesh.extent(0);
+    const std::string path = ::testing::TempDir() + "fem_pipeline.bin";
+    auto file = io::create_file(path);
+    ASSERT_TRUE(file);
+
+    std::vector<ViewType> sectors(count_sectors);
+    std::atomic<int> error{0};
+    {
+        pthreads_manage::Executor executor{pthreads_manage::ExecutorSettings{2}};
+        for (std::size_t k = 0; k < count_sectors; ++k) {
+            const std::size_t begin = k * count_nodes / count_sectors;
+            const std::size_t end = (k + 1) * count_nodes / count_sectors;
+            auto generated = executor.submit([&, k, begin, end](pthreads_manage::Pool& pthreads_pool) noexcept {
+                sectors[k] = mesh::materialize<ViewType, Parallel>(pthreads_pool, implicit_mesh, begin, end);
+            });
+            //Запись сектора ждет только его генерации: pwrite по своему смещению, порядок записей не важен
+            executor.submit([&, k, begin, end](pthreads_manage::Pool&) noexcept {
+                const ViewType sector = sectors[k];
+                if (const int status = io::pwrite_all(file.get(), sector.data(), (end - begin) * 2 * sizeof(double), begin * 2 * sizeof(double)); status != 0)
+                    error.store(status);
+                sectors[k] = ViewType{};
+            }, {generated});
+        }
+    }
+    EXPECT_EQ(error.load(), 0);
+    file.reset();
+
+    std::ifstream input(path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(bytes.size(), count_nodes * 2 * sizeof(double));
+    pthreads_manage::Pool pthreads_pool{2};
+    const auto expected = mesh::materialize<ViewType, Parallel>(pthreads_pool, implicit_mesh, 0, count_nodes);
+    EXPECT_EQ(std::memcmp(bytes.data(), expected.data(), bytes.size()), 0);
+    std::filesystem::remove(path);
+}
@@ -72,6 +72,29 @@ public:
 
 
 
+template<typename S>
+class KirschMeshFixture : public ::testing::Test{
+public:
+    static constexpr std::size_t count_points_on_hole = S::N_;
+    static constexpr std::size_t count_points_on_ray = S::M_;
+    static constexpr double radius_hole = 0.5;
+    static constexpr double side_size = 4.0;
+    static constexpr double multiplier_q = 1.1;
+    pthreads_manage::Pool pthreads_pool{};
+
+    template <execution_policy Policy>
+    ViewType generate() {
+        mesh::GenFrameKirsch<ViewType, Policy> gen_mesh;
+        return gen_mesh(this->pthreads_pool, radius_hole, side_size, multiplier_q, count_points_on_hole, count_points_on_ray);
+    }
+
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+};
+
+
 using AllSizesSingleGrid = ::testing::Types<
                                     S_Single<10>,
                                     S_Single<3>,
@@ -109,5 +132,16 @@ using AllSizesSingleMesh = ::testing::Types<
                                     S_Single<500>
                                 >;
 
+using AllSizesKirschMesh = ::testing::Types<
+                            S_Two<2, 2>,
+                            S_Two<3, 5>,
+                            S_Two<5, 10>,
+                            S_Two<9, 17>,
+                            S_Two<13, 7>,
+                            S_Two<65, 40>,
+                            S_Two<101, 33>
+                        >;
+
 TYPED_TEST_SUITE(SingleGridFixture, AllSizesSingleGrid);
 TYPED_TEST_SUITE(TwoGridFixture, AllSizesTwoGrid);
+TYPED_TEST_SUITE(KirschMeshFixture, AllSizesKirschMesh);
@@ -33,4 +33,24 @@ TYPED_TEST(TwoGridFixture, NonUniformEdgeCorrectly) {
     }
 
 
-}
\ No newline at end of file
+}
+
+TYPED_TEST(TwoGridFixture, NonUniformFixedMatchesRuntime) {
+    constexpr std::size_t M = TestFixture::M;
+    const geometry::Point2D<double> direction{0.6, 0.8};
+    const geometry::Point2D<double> start_grid_point{3.0, 4.0};
+    const geometry::Point2D<double> end_grid_point{6.0, 8.0};
+    const double multiplier_q = 1.05;
+    grid::GenNonUniformOnRay<ViewType, Parallel>{}(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, this->grid_second);
+
+    ViewType fixed("v", M);
+    grid::GenNonUniformOnRayFixed<ViewType, Sequential, M>{}(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, fixed);
+    ViewType fixed_parallel("v", M);
+    grid::GenNonUniformOnRayFixed<ViewType, WorkStealing, M>{}(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, fixed_parallel);
+    for (std::size_t i = 0; i < M; i++) {
+        EXPECT_NEAR(fixed(i, 0), this->grid_second(i, 0), 1e-12) << "point " << i;
+        EXPECT_NEAR(fixed(i, 1), this->grid_second(i, 1), 1e-12) << "point " << i;
+        EXPECT_EQ(fixed_parallel(i, 0), fixed(i, 0)) << "point " << i;
+        EXPECT_EQ(fixed_parallel(i, 1), fixed(i, 1)) << "point " << i;
+    }
+}
@@ -0,0 +1,130 @@
+#include "test_fixtures.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace {
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Неявная сетка против хранимой GenFrameKirsch с теми же параметрами. Формула та же, но сжатие в FMA
+    ///у векторизованного ядра генерации и у доступа по индексу может различаться, поэтому сравнение с точностью до ulp
+    template <typename S>
+    class ImplicitMeshTest : public KirschMeshFixture<S> {
+    public:
+        static constexpr std::size_t H = S::N_;
+        static constexpr std::size_t R = S::M_;
+        ViewType reference = this->template generate<Parallel>();
+        storage::ImplicitKirschMesh<double> implicit_mesh = mesh::GenImplicitKirsch<double>{}(
+                                                                this->radius_hole, this->side_size, this->multiplier_q, H, R);
+
+        static void expect_same(const ViewType& actual, const ViewType& expected, std::size_t offset = 0) {
+            for (std::size_t i = 0; i < actual.extent(0); i++) {
+                EXPECT_DOUBLE_EQ(actual(i, 0), expected(offset + i, 0)) << "node " << offset + i;
+                EXPECT_DOUBLE_EQ(actual(i, 1), expected(offset + i, 1)) << "node " << offset + i;
+            }
+        }
+
+        template <execution_policy Policy>
+        void expect_materialize_matches(std::size_t begin, std::size_t end) {
+            auto materialized = mesh::materialize<ViewType, Policy>(this->pthreads_pool, implicit_mesh, begin, end);
+            ASSERT_EQ(materialized.extent(0), end - begin);
+            expect_same(materialized, reference, begin);
+        }
+    };
+
+    using ImplicitMeshSizes = ::testing::Types<
+                                    S_Two<2, 2>,
+                                    S_Two<3, 5>,
+                                    S_Two<9, 17>,
+                                    S_Two<13, 7>,
+                                    S_Two<65, 40>,
+                                    S_Two<101, 257>
+                                >;
+}
+
+TYPED_TEST_SUITE(ImplicitMeshTest, ImplicitMeshSizes);
+
+TYPED_TEST(ImplicitMeshTest, AccessMatchesStoredMesh) {
+    auto& implicit_mesh = this->implicit_mesh;
+    ASSERT_EQ(implicit_mesh.extent(0), this->reference.extent(0));
+    EXPECT_EQ(implicit_mesh.count_rays(), this->H);
+    EXPECT_EQ(implicit_mesh.count_points_on_ray(), this->R);
+    for (std::size_t i = 0; i < implicit_mesh.extent(0); i++) {
+        EXPECT_DOUBLE_EQ(implicit_mesh(i, 0), this->reference(i, 0)) << "node " << i;
+        EXPECT_DOUBLE_EQ(implicit_mesh(i, 1), this->reference(i, 1)) << "node " << i;
+    }
+}
+
+TYPED_TEST(ImplicitMeshTest, SubrangeSharesTables) {
+    const std::size_t n = this->implicit_mesh.extent(0);
+    const std::size_t begin = n / 3, end = n - n / 5;
+    auto sub = storage::subrange(this->implicit_mesh, begin, end);
+    ASSERT_EQ(sub.extent(0), end - begin);
+    EXPECT_EQ(sub.memory_bytes(), this->implicit_mesh.memory_bytes());
+    for (std::size_t i = 0; i < sub.extent(0); i++)
+        EXPECT_EQ(sub(i, 1), this->implicit_mesh(begin + i, 1)) << "node " << begin + i;
+}
+
+TYPED_TEST(ImplicitMeshTest, MaterializeMatchesStoredMesh) {
+    const std::size_t n = this->implicit_mesh.extent(0);
+    this->template expect_materialize_matches<Sequential>(0, n);
+    this->template expect_materialize_matches<Parallel>(0, n);
+    this->template expect_materialize_matches<WorkStealing>(0, n);
+    this->template expect_materialize_matches<Parallel>(n / 2 - 1, n - 1);
+}
+
+TYPED_TEST(ImplicitMeshTest, MemoryIsLinearInRaysAndPoints) {
+    EXPECT_EQ(this->implicit_mesh.memory_bytes(), (4 * this->H + this->R) * sizeof(double));
+}
+
+TYPED_TEST(ImplicitMeshTest, ConnectivityMatchesStoredMesh) {
+    mesh::GenConnectivityKirsch<Parallel> gen_connectivity;
+    topology::QuadView expected = gen_connectivity.quads(this->pthreads_pool, this->reference, this->R);
+    topology::QuadView actual = gen_connectivity.quads(this->pthreads_pool, this->implicit_mesh, this->R);
+    ASSERT_EQ(actual.extent(0), expected.extent(0));
+    EXPECT_EQ(std::memcmp(actual.data(), expected.data(), expected.extent(0) * 4 * sizeof(expected(0, 0))), 0);
+}
+
+TYPED_TEST(ImplicitMeshTest, MatrixFreeOperatorMatchesStoredMesh) {
+    auto fixed_dofs = fem::kirsch_symmetry_dofs(topology::RayLayout{this->H, this->R});
+    matrix_free::ElasticityOperator<Parallel, ViewType> stored{this->pthreads_pool, this->reference, this->R, steel, fixed_dofs};
+    matrix_free::ElasticityOperator<Parallel, storage::ImplicitKirschMesh<double>> implicit{
+                                    this->pthreads_pool, this->implicit_mesh, this->R, steel, fixed_dofs};
+    ASSERT_EQ(implicit.size(), stored.size());
+    std::vector<double> x(stored.size());
+    for (std::size_t i = 0; i < x.size(); i++)
+        x[i] = std::sin(0.37 * static_cast<double>(i));
+    std::vector<double> expected(x.size()), actual(x.size());
+    stored.apply(x.data(), expected.data());
+    implicit.apply(x.data(), actual.data());
+    double scale = 0.0;
+    for (double value : expected)
+        scale = std::max(scale, std::abs(value));
+    for (std::size_t i = 0; i < x.size(); i++)
+        EXPECT_NEAR(actual[i], expected[i], 1e-12 * scale) << "dof " << i;
+}
+
+TYPED_TEST(ImplicitMeshTest, VtuWriterMatchesMaterializedMesh) {
+    const std::string directory = ::testing::TempDir();
+    const std::string stored_path = directory + "fem_implicit_stored.vtu";
+    const std::string implicit_path = directory + "fem_implicit_implicit.vtu";
+    auto materialized = storage::allocate<ViewType>("v", this->implicit_mesh.extent(0));
+    for (std::size_t i = 0; i < materialized.extent(0); i++) {
+        materialized(i, 0) = this->implicit_mesh(i, 0);
+        materialized(i, 1) = this->implicit_mesh(i, 1);
+    }
+    topology::QuadView quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(this->pthreads_pool, this->reference, this->R);
+    ASSERT_EQ(writers::VtuWriter<Parallel>{}(this->pthreads_pool, stored_path, materialized, quads), 0);
+    ASSERT_EQ(writers::VtuWriter<Parallel>{}(this->pthreads_pool, implicit_path, this->implicit_mesh, quads), 0);
+    auto read_file = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    EXPECT_EQ(read_file(implicit_path), read_file(stored_path));
+    std::filesystem::remove(stored_path);
+    std::filesystem::remove(implicit_path);
+}
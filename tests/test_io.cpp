@@ -0,0 +1,220 @@
+#include "test_fixtures.hpp"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+    constexpr std::size_t H = 13;
+    constexpr std::size_t R = 21;
+
+    std::string temp_path(const std::string& name) {
+        return ::testing::TempDir() + "fem_test_" + name;
+    }
+
+    std::string read_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    ///Данные блока appended первого DataArray, начиная с array_marker
+    std::string appended_block(const std::string& vtu, const std::string& array_marker) {
+        const std::size_t array = vtu.find(array_marker);
+        const std::size_t offset_attr = vtu.find("offset=\"", array) + 8;
+        const std::size_t offset = std::stoull(vtu.substr(offset_attr, vtu.find('"', offset_attr) - offset_attr));
+        const std::size_t data_start = vtu.find("_", vtu.find("<AppendedData")) + 1;
+        std::uint64_t bytes = 0;
+        std::memcpy(&bytes, vtu.data() + data_start + offset, sizeof(bytes));
+        return vtu.substr(data_start + offset + sizeof(bytes), bytes);
+    }
+
+    template <typename T>
+    T value_at(const std::string& bytes, std::size_t idx) {
+        T value;
+        std::memcpy(&value, bytes.data() + idx * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    template <typename PolicyT>
+    class WritersTest : public ::testing::Test {
+    public:
+        pthreads_manage::Pool pthreads_pool{};
+        ViewType mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, H, R);
+        topology::QuadView quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, R);
+        std::vector<double> displacement = std::vector<double>(2 * H * R);
+        std::vector<double> cell_area = std::vector<double>((H - 1) * (R - 1));
+
+        void SetUp() override {
+            for (std::size_t i = 0; i < displacement.size(); i++)
+                displacement[i] = 1e-3 * double(i);
+            for (std::size_t i = 0; i < cell_area.size(); i++)
+                cell_area[i] = double(i) + 0.5;
+        }
+    };
+
+    using WriterPolicies = ::testing::Types<Sequential, Parallel, WorkStealing>;
+}
+
+TYPED_TEST_SUITE(WritersTest, WriterPolicies);
+
+TYPED_TEST(WritersTest, VtuContainsMeshConnectivityAndFields) {
+    const std::string path = temp_path("mesh.vtu");
+    ASSERT_EQ((writers::VtuWriter<TypeParam>{}(this->pthreads_pool, path, this->mesh, this->quads,
+                                               {{"displacement", this->displacement.data(), 2}}, {{"area", this->cell_area.data(), 1}})), 0);
+    const std::string vtu = read_file(path);
+    ASSERT_EQ(vtu.rfind("<?xml", 0), 0u);
+    EXPECT_NE(vtu.find("NumberOfPoints=\"" + std::to_string(H * R) + "\" NumberOfCells=\"" + std::to_string((H - 1) * (R - 1)) + "\""), std::string::npos);
+    const std::string footer = "\n  </AppendedData>\n</VTKFile>\n";
+    EXPECT_EQ(vtu.substr(vtu.size() - footer.size()), footer);
+
+    const auto points = appended_block(vtu, "<Points>");
+    ASSERT_EQ(points.size(), 3 * H * R * sizeof(double));
+    for (std::size_t i = 0; i < H * R; i++) {
+        EXPECT_EQ(value_at<double>(points, 3 * i), this->mesh(i, 0));
+        EXPECT_EQ(value_at<double>(points, 3 * i + 1), this->mesh(i, 1));
+        EXPECT_EQ(value_at<double>(points, 3 * i + 2), 0.0);
+    }
+    const auto connectivity = appended_block(vtu, "Name=\"connectivity\"");
+    const auto offsets = appended_block(vtu, "Name=\"offsets\"");
+    const auto types = appended_block(vtu, "Name=\"types\"");
+    ASSERT_EQ(types.size(), this->quads.extent(0));
+    for (std::size_t e = 0; e < this->quads.extent(0); e++) {
+        for (std::size_t a = 0; a < 4; a++)
+            EXPECT_EQ(value_at<std::int64_t>(connectivity, 4 * e + a), static_cast<std::int64_t>(this->quads(e, a)));
+        EXPECT_EQ(value_at<std::int64_t>(offsets, e), static_cast<std::int64_t>(4 * (e + 1)));
+        EXPECT_EQ(static_cast<std::uint8_t>(types[e]), 9);
+    }
+    const auto displacement = appended_block(vtu, "Name=\"displacement\"");
+    ASSERT_EQ(displacement.size(), this->displacement.size() * sizeof(double));
+    EXPECT_EQ(std::memcmp(displacement.data(), this->displacement.data(), displacement.size()), 0);
+    const auto area = appended_block(vtu, "Name=\"area\"");
+    ASSERT_EQ(area.size(), this->cell_area.size() * sizeof(double));
+    EXPECT_EQ(std::memcmp(area.data(), this->cell_area.data(), area.size()), 0);
+}
+
+TYPED_TEST(WritersTest, BinaryRoundTripThroughMapping) {
+    const std::string path = temp_path("mesh.bin");
+    ASSERT_EQ((writers::BinaryWriter<TypeParam>{}(this->pthreads_pool, path, this->mesh, this->quads,
+                                                  {{"displacement", this->displacement.data(), 2}}, {{"area", this->cell_area.data(), 1}}, 42)), 0);
+    io::MappedBinaryMesh file;
+    ASSERT_EQ(file.open(path), 0);
+    const auto& header = file.header();
+    EXPECT_EQ(header.count_nodes_, H * R);
+    EXPECT_EQ(header.count_cells_, this->quads.extent(0));
+    EXPECT_EQ(header.nodes_per_cell_, 4u);
+    EXPECT_EQ(header.scalar_size_, sizeof(double));
+    EXPECT_EQ(header.tag_, 42u);
+    EXPECT_EQ(header.nodes_offset_ % io::binary_alignment, 0u);
+
+    EXPECT_EQ(std::memcmp(file.nodes(), this->mesh.data(), 2 * H * R * sizeof(double)), 0);
+    EXPECT_EQ(std::memcmp(file.cells(), this->quads.data(), this->quads.extent(0) * 4 * sizeof(std::uint64_t)), 0);
+    const auto* displacement = file.field("displacement");
+    ASSERT_NE(displacement, nullptr);
+    EXPECT_EQ(displacement->count_components_, 2u);
+    EXPECT_EQ(std::memcmp(file.field_data(*displacement), this->displacement.data(), this->displacement.size() * sizeof(double)), 0);
+    const auto* area = file.field("area");
+    ASSERT_NE(area, nullptr);
+    EXPECT_EQ(std::memcmp(file.field_data(*area), this->cell_area.data(), this->cell_area.size() * sizeof(double)), 0);
+    EXPECT_EQ(file.field("missing"), nullptr);
+}
+
+TEST(BinaryFormatTest, PackedStorageMatchesAoS) {
+    pthreads_manage::Pool pthreads_pool{};
+    auto soa = mesh::GenFrameKirsch<storage::SoAView<float>, Parallel>{}(pthreads_pool, 0.5f, 4.0f, 1.1f, H, R);
+    auto triangles = mesh::GenConnectivityKirsch<Parallel>{}.triangles(pthreads_pool, soa, R);
+    const std::string path = temp_path("soa.bin");
+    ASSERT_EQ(writers::BinaryWriter<Parallel>{}(pthreads_pool, path, soa, triangles), 0);
+
+    io::MappedBinaryMesh file;
+    ASSERT_EQ(file.open(path), 0);
+    ASSERT_EQ(file.header().scalar_size_, sizeof(float));
+    EXPECT_EQ(file.header().nodes_per_cell_, 3u);
+    const auto* nodes = static_cast<const float*>(file.nodes());
+    for (std::size_t i = 0; i < H * R; i++) {
+        EXPECT_EQ(nodes[2 * i], soa(i, 0));
+        EXPECT_EQ(nodes[2 * i + 1], soa(i, 1));
+    }
+}
+
+TEST(BinaryFormatTest, RejectsForeignAndTruncatedFiles) {
+    pthreads_manage::Pool pthreads_pool{};
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, H, R);
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, R);
+    const std::string path = temp_path("broken.bin");
+    io::MappedBinaryMesh file;
+
+    EXPECT_NE(file.open(temp_path("does_not_exist.bin")), 0);
+
+    ASSERT_EQ(writers::BinaryWriter<Parallel>{}(pthreads_pool, path, mesh, quads), 0);
+    std::string bytes = read_file(path);
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+    }
+    EXPECT_EQ(file.open(path), EINVAL);
+
+    bytes[8] = static_cast<char>(io::binary_version + 1);
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    EXPECT_EQ(file.open(path), EINVAL);
+    EXPECT_FALSE(file);
+}
+
+///Размеры разделов, переполняющие 64 бита, не должны оборачиваться в малое число и проходить проверку длины файла
+TEST(BinaryFormatTest, RejectsOverflowingSectionSizes) {
+    pthreads_manage::Pool pthreads_pool{};
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, H, R);
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, R);
+    const std::string path = temp_path("overflow.bin");
+    ASSERT_EQ(writers::BinaryWriter<Parallel>{}(pthreads_pool, path, mesh, quads), 0);
+    const std::string original = read_file(path);
+
+    auto open_patched = [&](std::size_t field_offset, std::uint64_t value) {
+        std::string bytes = original;
+        std::memcpy(bytes.data() + field_offset, &value, sizeof(value));
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        io::MappedBinaryMesh file;
+        return file.open(path);
+    };
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, count_nodes_), std::uint64_t{1} << 60), EINVAL);           // * 2 * 8 = 2^64
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, nodes_per_cell_), std::uint64_t{1} << 61), EINVAL);        // * 8 = 2^64
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, nodes_offset_), ~std::uint64_t{0} - 8), EINVAL);           // offset + bytes
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, count_point_fields_), std::uint64_t{1} << 58), EINVAL);    // * 64 = 2^64
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, count_cell_fields_), ~std::uint64_t{0}), EINVAL);          // сумма полей
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, tag_), 42), 0); // Метка на проверку не влияет
+}
+
+///Разделы, не выровненные по binary_alignment, дали бы невыровненные указатели на double и uint64_t
+TEST(BinaryFormatTest, RejectsMisalignedSections) {
+    pthreads_manage::Pool pthreads_pool{};
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, H, R);
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, R);
+    const std::vector<double> values(H * R, 1.0);
+    const std::string path = temp_path("misaligned.bin");
+    ASSERT_EQ(writers::BinaryWriter<Parallel>{}(pthreads_pool, path, mesh, quads, {io::FieldView{"u", values.data()}}), 0);
+    const std::string original = read_file(path);
+
+    auto open_patched = [&](std::size_t field_offset, std::uint64_t delta) {
+        std::string bytes = original;
+        std::uint64_t value;
+        std::memcpy(&value, bytes.data() + field_offset, sizeof(value));
+        value -= delta; // Раньше на delta байт: раздел по-прежнему помещается в файл
+        std::memcpy(bytes.data() + field_offset, &value, sizeof(value));
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        io::MappedBinaryMesh file;
+        return file.open(path);
+    };
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, nodes_offset_), 0), 0);
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, nodes_offset_), 1), EINVAL);
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, cells_offset_), 8), EINVAL);
+    EXPECT_EQ(open_patched(offsetof(io::BinaryHeader, metadata_offset_), 8), EINVAL);
+    EXPECT_EQ(open_patched(sizeof(io::BinaryHeader) + offsetof(io::BinaryFieldRecord, offset_), 8), EINVAL);
+}
+
+TEST(VtuFormatTest, FieldNamesAreEscaped) {
+    const std::vector<double> values(4, 0.0);
+    const auto layout = io::vtu_layout<double, 4>(4, 1, {io::FieldView{"a<b & \"c\"", values.data()}}, {});
+    EXPECT_NE(layout.header_.find("Name=\"a&lt;b &amp; &quot;c&quot;\""), std::string::npos);
+    EXPECT_EQ(layout.header_.find("a<b"), std::string::npos);
+}
@@ -66,4 +66,55 @@ TYPED_TEST(SingleGridFixture, StepNonUniformCorrectly) {
             << "Got     : " << i_step_size << "\n";
         step_size = i_step_size;
     }
-}
\ No newline at end of file
+}
+
+TYPED_TEST(SingleGridFixture, CircleMatchesScalar) {
+    double radius = 0.7;
+    auto reference = ViewType("v", this->N);
+    kernels::fill_circle_arc_uniform(0.3, 2.1, radius, this->grid);
+    kernels::fill_circle_arc_uniform_scalar(0.3, 2.1, radius, reference);
+    for (std::size_t i = 0; i < this->N; i++) {
+        EXPECT_NEAR(this->grid(i, 0), reference(i, 0), 1e-15) << "point " << i;
+        EXPECT_NEAR(this->grid(i, 1), reference(i, 1), 1e-15) << "point " << i;
+    }
+}
+
+TYPED_TEST(SingleGridFixture, NonUniformMatchesScalar) {
+    using p_type = geometry::Point2D<double>;
+    p_type direction{0.6, 0.8};
+    double multiplier = 1.03;
+    std::size_t offset = 13; // Сегмент не с начала луча и не с границы блока
+    std::size_t N = this->grid.extent(0);
+    double denominator = 1 - math_helper::fast_pow(multiplier, N + offset - 1);
+    auto reference = ViewType("v", N);
+    p_type start{direction.x * 0.5, direction.y * 0.5};
+    p_type end{direction.x * 20.0, direction.y * 20.0};
+    kernels::fill_ray_segment_nonuniform(direction, start, end, multiplier, denominator, offset, this->grid);
+    kernels::fill_ray_segment_nonuniform_scalar(direction, start, end, multiplier, denominator, offset, reference);
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_NEAR(this->grid(i, 0), reference(i, 0), 1e-12) << "point " << i;
+        EXPECT_NEAR(this->grid(i, 1), reference(i, 1), 1e-12) << "point " << i;
+    }
+}
+
+TYPED_TEST(SingleGridFixture, NonUniformIndependentOfSplit) {
+    using p_type = geometry::Point2D<double>;
+    p_type direction{0.8, 0.6};
+    double multiplier = 1.2;
+    std::size_t N = this->grid.extent(0);
+    double denominator = 1 - math_helper::fast_pow(multiplier, N - 1);
+    p_type start{direction.x * 1.0, direction.y * 1.0};
+    p_type end{direction.x * 5.0, direction.y * 5.0};
+    kernels::fill_ray_segment_nonuniform(direction, start, end, multiplier, denominator, 0, this->grid);
+
+    auto split = ViewType("v", N);
+    std::size_t chunk_size = 3; // Сегменты не совпадают с блоками ядра
+    for (std::size_t begin = 0; begin < N; begin += chunk_size) {
+        auto segment = Kokkos::subview(split, Kokkos::pair(begin, std::min(begin + chunk_size, N)), Kokkos::ALL);
+        kernels::fill_ray_segment_nonuniform(direction, start, end, multiplier, denominator, begin, segment);
+    }
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_EQ(this->grid(i, 0), split(i, 0)) << "point " << i;
+        EXPECT_EQ(this->grid(i, 1), split(i, 1)) << "point " << i;
+    }
+}
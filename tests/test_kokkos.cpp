@@ -0,0 +1,40 @@
+#include "test_fixtures.hpp"
+
+TYPED_TEST(TwoGridFixture, KokkosRayMatchesPthreads) {
+    geometry::Point2D<double> direction{0.6, 0.8};
+    geometry::Point2D<double> start_grid_point{direction.x * 0.5, direction.y * 0.5};
+    geometry::Point2D<double> end_grid_point{direction.x * 10.0, direction.y * 10.0};
+    double multiplier_q = 1.05;
+
+    grid::GenNonUniformOnRay<ViewType, Parallel>{}(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, this->grid_first);
+    auto kokkos_storage = ViewType("v", this->grid_first.extent(0));
+    custom_kokkos::grid::GenNonUniformOnRay<ViewType>{}(direction, start_grid_point, end_grid_point, multiplier_q, kokkos_storage);
+
+    for (std::size_t i = 0; i < kokkos_storage.extent(0); i++) {
+        EXPECT_EQ(kokkos_storage(i, 0), this->grid_first(i, 0)) << "point " << i;
+        EXPECT_EQ(kokkos_storage(i, 1), this->grid_first(i, 1)) << "point " << i;
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, KokkosMatchesPthreads) {
+    auto reference = this->template generate<Parallel>();
+    auto mesh = custom_kokkos::mesh::GenFrameKirsch<ViewType>{}(
+                        this->radius_hole, this->side_size, this->multiplier_q,
+                        this->count_points_on_hole, this->count_points_on_ray);
+    ASSERT_EQ(mesh.extent(0), reference.extent(0));
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_EQ(mesh(i, 0), reference(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, KokkosSoAMatchesPthreads) {
+    auto reference = this->template generate<WorkStealing>();
+    auto mesh = custom_kokkos::mesh::GenFrameKirsch<storage::SoAView<double>>{}(
+                        Kokkos::DefaultHostExecutionSpace{}, this->radius_hole, this->side_size, this->multiplier_q,
+                        this->count_points_on_hole, this->count_points_on_ray);
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_EQ(mesh(i, 0), reference(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
@@ -0,0 +1,105 @@
+#include "test_fixtures.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Матрица-фри оператор против собранной матрицы с закреплениями на той же сетке
+    template <typename S>
+    class MatrixFreeTest : public KirschMeshFixture<S> {
+    public:
+        static constexpr std::size_t H = S::N_;
+        static constexpr std::size_t R = S::M_;
+        ViewType mesh = this->template generate<Parallel>();
+        topology::RayLayout layout{H, R};
+        std::vector<MKL_INT> fixed_dofs = fem::kirsch_symmetry_dofs(layout);
+
+        sparse::CsrMatrix system() {
+            topology::QuadView quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(this->pthreads_pool, mesh, R);
+            assembly::StiffnessAssembler<Parallel, 4> assembler{this->pthreads_pool, quads, mesh.extent(0)};
+            auto matrix = assembler.pattern();
+            EXPECT_EQ(assembler.assemble(this->pthreads_pool, mesh, steel, matrix), SPARSE_STATUS_SUCCESS);
+            fem::apply_dirichlet(matrix, fixed_dofs);
+            return matrix;
+        }
+
+        static std::vector<double> random_vector(std::size_t n) {
+            std::mt19937_64 generator(42);
+            std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+            std::vector<double> x(n);
+            for (double& value : x)
+                value = distribution(generator);
+            return x;
+        }
+
+        template <execution_policy Policy>
+        void expect_matches_matrix() {
+            auto matrix = system();
+            matrix_free::ElasticityOperator<Policy, ViewType> op{this->pthreads_pool, mesh, R, steel, fixed_dofs};
+            ASSERT_EQ(op.size(), static_cast<std::size_t>(matrix.count_rows_));
+
+            auto x = random_vector(op.size());
+            std::vector<double> expected(op.size()), actual(op.size(), 1.0);
+            solvers::SparseOperator{matrix}.apply(x.data(), expected.data());
+            op.apply(x.data(), actual.data());
+
+            double scale = 0.0;
+            for (double value : expected)
+                scale = std::max(scale, std::abs(value));
+            for (std::size_t i = 0; i < op.size(); i++)
+                EXPECT_NEAR(actual[i], expected[i], 1e-12 * scale) << "dof " << i;
+
+            auto inverse_diagonal = op.inverse_diagonal();
+            for (MKL_INT row = 0; row < matrix.count_rows_; row++)
+                EXPECT_NEAR(inverse_diagonal[row] * matrix.values_[matrix.find(row, row)], 1.0, 1e-12) << "row " << row;
+        }
+    };
+
+    using MatrixFreeSizes = ::testing::Types<
+                                    S_Two<2, 2>,
+                                    S_Two<3, 9>,
+                                    S_Two<9, 12>,
+                                    S_Two<31, 28>,
+                                    S_Two<40, 17>
+                                >;
+}
+
+TYPED_TEST_SUITE(MatrixFreeTest, MatrixFreeSizes);
+
+TYPED_TEST(MatrixFreeTest, SequentialMatchesAssembledMatrix) {
+    this->template expect_matches_matrix<Sequential>();
+}
+
+TYPED_TEST(MatrixFreeTest, ParallelMatchesAssembledMatrix) {
+    this->template expect_matches_matrix<Parallel>();
+}
+
+TYPED_TEST(MatrixFreeTest, WorkStealingMatchesAssembledMatrix) {
+    this->template expect_matches_matrix<WorkStealing>();
+}
+
+TYPED_TEST(MatrixFreeTest, CgMatchesPardiso) {
+    constexpr std::size_t H = TestFixture::H, R = TestFixture::R;
+    auto matrix = this->system();
+    std::vector<double> rhs(2 * H * R, 0.0);
+    fem::add_far_field_load(this->mesh, this->layout, fem::FarFieldStress{1.0e6, 0.5e6}, steel.thickness_, rhs.data());
+    for (MKL_INT dof : this->fixed_dofs)
+        rhs[dof] = 0.0;
+
+    std::vector<double> direct(rhs.size()), iterative(rhs.size(), 0.0);
+    solvers::PardisoSolver solver;
+    ASSERT_EQ(solver.analyze(matrix), 0);
+    ASSERT_EQ(solver.factorize(matrix), 0);
+    ASSERT_EQ(solver.solve(rhs.data(), direct.data()), 0);
+
+    matrix_free::ElasticityOperator<Parallel, ViewType> op{this->pthreads_pool, this->mesh, R, steel, this->fixed_dofs};
+    auto report = solvers::conjugate_gradient(op, solvers::JacobiPreconditioner{op.inverse_diagonal()}, rhs.data(), iterative.data(),
+                                              solvers::CgSettings{1e-12, 10000});
+    ASSERT_TRUE(report.converged_) << "iterations " << report.iterations_ << ", residual " << report.relative_residual_;
+    double scale = 0.0;
+    for (double value : direct)
+        scale = std::max(scale, std::abs(value));
+    for (std::size_t i = 0; i < direct.size(); i++)
+        EXPECT_NEAR(iterative[i], direct[i], 1e-8 * scale) << "dof " << i;
+}
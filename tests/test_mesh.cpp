@@ -1,4 +1,5 @@
 #include "test_fixtures.hpp"
+#include <array>
 
 // TEST(DISABLED_PartitionalTest, FixSizeCorrectWithOneSlave) {
 //     std::size_t N = 21;
@@ -34,4 +35,158 @@
 //             << "prepare_sector gave wrong result:\n"
 //             << "Expected: " << 174  << "\n"
 //             << "Got     : " << sum << "\n";
-// }
\ No newline at end of file
+// }
+TYPED_TEST(KirschMeshFixture, RaysStartOnHoleEndOnEdge) {
+    auto mesh = this->template generate<Sequential>();
+    const std::size_t H = this->count_points_on_hole;
+    const std::size_t P = this->count_points_on_ray;
+    const double eps = 1e-12;
+    ASSERT_EQ(mesh.extent(0), H * P);
+
+    for (std::size_t ray = 0; ray < H; ray++) {
+        double first_x = mesh(ray * P, 0), first_y = mesh(ray * P, 1);
+        double last_x = mesh(ray * P + P - 1, 0), last_y = mesh(ray * P + P - 1, 1);
+        EXPECT_NEAR(std::hypot(first_x, first_y), this->radius_hole, eps) << "ray " << ray;
+        EXPECT_TRUE(
+            std::abs(last_x - this->side_size) < eps || std::abs(last_y - this->side_size) < eps
+            )   << "ray " << ray << " ends inside the plate: " << last_x << " " << last_y;
+
+        double angle = std::numbers::pi / 2 * static_cast<double>(ray) / static_cast<double>(H - 1);
+        EXPECT_NEAR(std::atan2(last_y, last_x), angle, 1e-9) << "ray " << ray;
+
+        for (std::size_t i = 1; i < P; i++) {
+            EXPECT_LT(std::hypot(mesh(ray * P + i - 1, 0), mesh(ray * P + i - 1, 1)),
+                      std::hypot(mesh(ray * P + i, 0), mesh(ray * P + i, 1)) + eps)
+                      << "ray " << ray << " point " << i;
+        }
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, ParallelMatchesSequential) {
+    auto mesh_sequential = this->template generate<Sequential>();
+    auto mesh_parallel = this->template generate<Parallel>();
+    auto mesh_stealing = this->template generate<WorkStealing>();
+    ASSERT_EQ(mesh_sequential.extent(0), mesh_parallel.extent(0));
+    ASSERT_EQ(mesh_sequential.extent(0), mesh_stealing.extent(0));
+
+    for (std::size_t i = 0; i < mesh_sequential.extent(0); i++) {
+        EXPECT_EQ(mesh_sequential(i, 0), mesh_parallel(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh_sequential(i, 1), mesh_parallel(i, 1)) << "point " << i;
+        EXPECT_EQ(mesh_sequential(i, 0), mesh_stealing(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh_sequential(i, 1), mesh_stealing(i, 1)) << "point " << i;
+    }
+}
+
+///Сетка с размерами - параметрами шаблона совпадает с обычной при любой политике и в хранилище над std::array
+TYPED_TEST(KirschMeshFixture, FixedMatchesRuntime) {
+    constexpr std::size_t H = TestFixture::count_points_on_hole;
+    constexpr std::size_t P = TestFixture::count_points_on_ray;
+    const auto reference = this->template generate<Sequential>();
+    auto check = [&](const auto& mesh, const char* name) {
+        ASSERT_EQ(mesh.extent(0), H * P);
+        for (std::size_t i = 0; i < H * P; i++) {
+            EXPECT_NEAR(mesh(i, 0), reference(i, 0), 1e-12) << name << " point " << i;
+            EXPECT_NEAR(mesh(i, 1), reference(i, 1), 1e-12) << name << " point " << i;
+        }
+    };
+    const double a = this->radius_hole, L = this->side_size, q = this->multiplier_q;
+    check(mesh::GenFrameKirschFixed<ViewType, Sequential, H, P>{}(this->pthreads_pool, a, L, q), "sequential");
+    check(mesh::GenFrameKirschFixed<ViewType, Parallel, H, P>{}(this->pthreads_pool, a, L, q), "parallel");
+    check(mesh::GenFrameKirschFixed<storage::SoAView<double>, WorkStealing, H, P>{}(this->pthreads_pool, a, L, q), "stealing soa");
+
+    std::array<double, 2 * H * P> fixed_storage{};
+    mesh::GenFrameKirschFixed<ViewType, Parallel, H, P>{}.fill(this->pthreads_pool, ViewType(fixed_storage.data(), H * P), a, L, q);
+    check(ViewType(fixed_storage.data(), H * P), "std::array");
+}
+
+///Параллельная проверка качества совпадает с последовательной; сетка Кирша заполняет квадрат без вывернутых ячеек
+TYPED_TEST(KirschMeshFixture, QualityIsValidAndPolicyIndependent) {
+    const topology::RayLayout layout{TestFixture::count_points_on_hole, TestFixture::count_points_on_ray};
+    const auto mesh = this->template generate<Parallel>();
+    const auto quality = mesh::mesh_quality<Sequential>(this->pthreads_pool, mesh, layout);
+    EXPECT_TRUE(quality.valid());
+    EXPECT_EQ(quality.cells_.count_cells_, layout.count_cells());
+    EXPECT_EQ(quality.cells_.first_inverted_, mesh::CellQuality::no_cell);
+    EXPECT_GT(quality.cells_.min_area_, 0.0);
+    EXPECT_GT(quality.cells_.min_scaled_jacobian_, 0.0);
+    EXPECT_GE(quality.cells_.max_aspect_ratio_, 1.0);
+    EXPECT_NEAR(quality.bounds_.min_x_, 0.0, 1e-12);
+    EXPECT_NEAR(quality.bounds_.min_y_, 0.0, 1e-12);
+    EXPECT_NEAR(quality.bounds_.max_x_, this->side_size, 1e-12);
+    EXPECT_NEAR(quality.bounds_.max_y_, this->side_size, 1e-12);
+
+    for (const auto& other : {mesh::mesh_quality<Parallel>(this->pthreads_pool, mesh, layout),
+                              mesh::mesh_quality<WorkStealing>(this->pthreads_pool, mesh, layout)}) {
+        EXPECT_EQ(other.cells_.count_cells_, quality.cells_.count_cells_);
+        EXPECT_EQ(other.cells_.min_area_, quality.cells_.min_area_);
+        EXPECT_EQ(other.cells_.max_area_, quality.cells_.max_area_);
+        EXPECT_EQ(other.cells_.max_aspect_ratio_, quality.cells_.max_aspect_ratio_);
+        EXPECT_EQ(other.cells_.min_scaled_jacobian_, quality.cells_.min_scaled_jacobian_);
+        EXPECT_EQ(other.bounds_.max_x_, quality.bounds_.max_x_);
+        EXPECT_EQ(other.bounds_.min_x_, quality.bounds_.min_x_);
+    }
+}
+
+TEST(MeshQualityTest, UnitSquareAndInvertedCells) {
+    mesh::CellQuality square;
+    mesh::add_quad_quality({0.0, 2.0, 2.0, 0.0}, {0.0, 0.0, 1.0, 1.0}, 0, square);
+    EXPECT_DOUBLE_EQ(square.min_area_, 2.0);
+    EXPECT_DOUBLE_EQ(square.max_aspect_ratio_, 2.0);
+    EXPECT_DOUBLE_EQ(square.min_scaled_jacobian_, 1.0);
+    EXPECT_EQ(square.count_inverted_, 0u);
+
+    //Два узла на луче 4 переставлены местами: ячейки с ребром между ними выворачиваются
+    pthreads_manage::Pool pthreads_pool{};
+    const topology::RayLayout layout{9, 12};
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, layout.count_rays_, layout.count_points_on_ray_);
+    for (std::size_t d = 0; d < 2; d++)
+        std::swap(mesh(layout.node(4, 6), d), mesh(layout.node(4, 7), d));
+    const auto quality = mesh::mesh_quality<WorkStealing>(pthreads_pool, mesh, layout);
+    EXPECT_FALSE(quality.valid());
+    EXPECT_LE(quality.cells_.min_scaled_jacobian_, 0.0);
+    EXPECT_GT(quality.cells_.count_inverted_, 0u);
+    EXPECT_EQ(quality.cells_.first_inverted_, 3 * (layout.count_points_on_ray_ - 1) + 6); // Ячейка (3, 6) с переставленным ребром - "бабочка"
+}
+
+TEST(FixedKirschTest, NumeratorsAreConstexpr) {
+    constexpr auto numerators = kernels::ray_parameter_numerators<33>(1.1);
+    static_assert(numerators[0] == 0.0);
+    static_assert(numerators[1] < 0.0 && numerators[32] < numerators[31]);
+    std::array<double, 33> runtime{};
+    kernels::fill_ray_parameter_numerators(1.1, 33, runtime.data());
+    EXPECT_EQ(numerators, runtime);
+}
+
+TEST(CountSectorsTest, LargestDivisor) {
+    EXPECT_EQ(mesh::count_sectors_for(64, 8), 8u);
+    EXPECT_EQ(mesh::count_sectors_for(12, 8), 6u);
+    EXPECT_EQ(mesh::count_sectors_for(13, 8), 1u);
+    EXPECT_EQ(mesh::count_sectors_for(3, 8), 3u);
+    EXPECT_EQ(mesh::count_sectors_for(1, 8), 1u);
+}
+
+TYPED_TEST(KirschMeshFixture, MixedPrecisionIsRoundedDouble) {
+    using FloatView = storage::AoSView<float>;
+    auto reference = this->template generate<Parallel>();
+    auto mixed = mesh::GenFrameKirsch<FloatView, Parallel, double>{}(
+                        this->pthreads_pool, this->radius_hole, this->side_size, this->multiplier_q,
+                        this->count_points_on_hole, this->count_points_on_ray);
+    ASSERT_EQ(mixed.extent(0), reference.extent(0));
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_EQ(mixed(i, 0), static_cast<float>(reference(i, 0))) << "point " << i;
+        EXPECT_EQ(mixed(i, 1), static_cast<float>(reference(i, 1))) << "point " << i;
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, FloatCloseToDouble) {
+    using FloatView = storage::AoSView<float>;
+    auto reference = this->template generate<Parallel>();
+    auto single = mesh::GenFrameKirsch<FloatView, Parallel>{}(
+                        this->pthreads_pool, float(this->radius_hole), float(this->side_size), float(this->multiplier_q),
+                        this->count_points_on_hole, this->count_points_on_ray);
+    const double eps = 16 * std::numeric_limits<float>::epsilon() * this->side_size;
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_NEAR(single(i, 0), reference(i, 0), eps) << "point " << i;
+        EXPECT_NEAR(single(i, 1), reference(i, 1), eps) << "point " << i;
+    }
+}
@@ -0,0 +1,155 @@
+#include "test_fixtures.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+namespace {
+    constexpr double radius_hole = 0.5;
+    constexpr double side_size = 4.0;
+    constexpr double multiplier_q = 1.1;
+    constexpr std::size_t H = 17;
+    constexpr std::size_t R = 33;
+
+    class MeshCacheTest : public ::testing::Test {
+    public:
+        pthreads_manage::Pool pthreads_pool{};
+        std::string directory;
+        ViewType reference;
+
+        void SetUp() override {
+            directory = ::testing::TempDir() + "fem_mesh_cache_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+            std::filesystem::remove_all(directory);
+            reference = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+        }
+
+        void TearDown() override {
+            std::filesystem::remove_all(directory);
+        }
+
+        static void expect_same(const ViewType& actual, const ViewType& expected) {
+            ASSERT_EQ(actual.extent(0), expected.extent(0));
+            EXPECT_EQ(std::memcmp(actual.data(), expected.data(), 2 * expected.extent(0) * sizeof(double)), 0);
+        }
+    };
+}
+
+TEST_F(MeshCacheTest, MissGeneratesAndStoresThenRestartHits) {
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        const auto cached = cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+        EXPECT_FALSE(cached.mapped());
+        expect_same(cached.mesh(), reference);
+        EXPECT_EQ(cache.stats().misses_, 1u);
+        EXPECT_EQ(cache.stats().hits_, 0u);
+        EXPECT_EQ(cache.stats().write_errors_, 0u);
+    }
+    //Новый экземпляр - как новый процесс: сетка берется из файла
+    mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+    const auto cached = cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+    ASSERT_TRUE(cached.mapped());
+    expect_same(cached.mesh(), reference);
+    EXPECT_EQ(cache.stats().hits_, 1u);
+    EXPECT_EQ(cache.stats().misses_, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(cached.mesh().data()) % io::binary_alignment, 0u);
+
+    //Каждое попадание - свое отображение: запись в одну сетку не видна в другой
+    const auto again = cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+    EXPECT_NE(again.mesh().data(), cached.mesh().data());
+    EXPECT_EQ(cache.stats().hits_, 2u);
+    cached.mesh()(0, 0) = -1.0;
+    expect_same(again.mesh(), reference);
+}
+
+TEST_F(MeshCacheTest, HandleOwnsMappingAfterCacheIsGone) {
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        (void)cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+    }
+    std::optional<mesh::CachedMesh<ViewType>> kept;
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        auto cached = cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+        ASSERT_TRUE(cached.mapped());
+        kept.emplace(std::move(cached)); // Перемещение не меняет адрес отображения
+    }
+    ASSERT_TRUE(kept->mapped());
+    expect_same(kept->mesh(), reference);
+}
+
+TEST_F(MeshCacheTest, KeyDependsOnEveryParameter) {
+    const auto key = mesh::kirsch_cache_key(radius_hole, side_size, multiplier_q, H, R);
+    EXPECT_NE(key, mesh::kirsch_cache_key(std::nextafter(radius_hole, 1.0), side_size, multiplier_q, H, R));
+    EXPECT_NE(key, mesh::kirsch_cache_key(radius_hole, side_size + 1.0, multiplier_q, H, R));
+    EXPECT_NE(key, mesh::kirsch_cache_key(radius_hole, side_size, 1.01, H, R));
+    EXPECT_NE(key, mesh::kirsch_cache_key(radius_hole, side_size, multiplier_q, R, H));
+    EXPECT_NE(key, mesh::kirsch_cache_key(float(radius_hole), float(side_size), float(multiplier_q), H, R));
+
+    mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+    (void)cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+    const auto other = cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R + 1);
+    EXPECT_EQ(other.mesh().extent(0), H * (R + 1));
+    EXPECT_EQ(cache.stats().misses_, 2u);
+}
+
+TEST_F(MeshCacheTest, KeyCollisionWithOtherParametersIsMiss) {
+    const auto key = mesh::kirsch_cache_key(radius_hole, side_size, multiplier_q, H, R);
+    const double other_q = 1.2;
+    const auto other_key = mesh::kirsch_cache_key(radius_hole, side_size, other_q, H, R);
+    mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+    (void)cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+
+    //Файл других параметров под ключом other_key с подмененной меткой - как при коллизии хэшей
+    std::filesystem::copy_file(cache.path_of(key), cache.path_of(other_key));
+    {
+        std::fstream file(cache.path_of(other_key), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offsetof(io::BinaryHeader, tag_));
+        file.write(reinterpret_cast<const char*>(&other_key), sizeof(other_key));
+    }
+    const auto other = cache(pthreads_pool, radius_hole, side_size, other_q, H, R);
+    EXPECT_EQ(cache.stats().misses_, 2u);
+    expect_same(other.mesh(), mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, radius_hole, side_size, other_q, H, R));
+}
+
+TEST_F(MeshCacheTest, CorruptedFileIsRegenerated) {
+    const auto key = mesh::kirsch_cache_key(radius_hole, side_size, multiplier_q, H, R);
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        (void)cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+        std::filesystem::resize_file(cache.path_of(key), 100);
+    }
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        expect_same(cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R).mesh(), reference);
+        EXPECT_EQ(cache.stats().misses_, 1u);
+    }
+    mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+    expect_same(cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R).mesh(), reference);
+    EXPECT_EQ(cache.stats().hits_, 1u);
+}
+
+TEST_F(MeshCacheTest, WritesToMappedMeshDoNotReachFile) {
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        (void)cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+    }
+    {
+        mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+        const auto cached = cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R);
+        ASSERT_EQ(cache.stats().hits_, 1u);
+        cached.mesh()(0, 0) = -1.0;
+        EXPECT_EQ(cached.mesh()(0, 0), -1.0);
+    }
+    mesh::KirschMeshCache<ViewType, Parallel> cache(directory);
+    expect_same(cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R).mesh(), reference);
+}
+
+TEST_F(MeshCacheTest, UnwritableDirectoryStillReturnsMesh) {
+    mesh::KirschMeshCache<ViewType, Parallel> cache("/dev/null/fem_mesh_cache");
+    expect_same(cache(pthreads_pool, radius_hole, side_size, multiplier_q, H, R).mesh(), reference);
+    EXPECT_EQ(cache.stats().misses_, 1u);
+    EXPECT_EQ(cache.stats().write_errors_, 1u);
+    EXPECT_EQ(cache.stats().map_errors_, 0u);
+}
@@ -0,0 +1,352 @@
+#include "test_fixtures.hpp"
+
+namespace {
+    struct CountingArgs {
+        std::vector<std::atomic<std::size_t>>* chunk_hits_;
+    };
+
+    void countingKernel(ViewType chunk, std::size_t chunk_id, void* args) {
+        auto* args_ptr = static_cast<CountingArgs*>(args);
+        (*args_ptr->chunk_hits_)[chunk_id].fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < chunk.extent(0); i++) {
+            chunk(i, 0) += 1.0;
+            chunk(i, 1) = static_cast<double>(chunk_id);
+        }
+    }
+
+    struct OverlapArgs {
+        std::vector<std::vector<std::size_t>>* chunk_rows_; // Строки, пройденные каждым сегментом (пишет только свой сегмент)
+        std::size_t step_;                                  // chunk_size - overlap: начало сегмента chunk_id - chunk_id * step_
+    };
+
+    void overlapKernel(ViewType chunk, std::size_t chunk_id, void* args) {
+        auto* args_ptr = static_cast<OverlapArgs*>(args);
+        auto& rows = (*args_ptr->chunk_rows_)[chunk_id];
+        for (std::size_t i = 0; i < chunk.extent(0); i++)
+            rows.push_back(chunk_id * args_ptr->step_ + i);
+    }
+
+    pthreads_manage::PartitionerSettings testPartitioner(void* args) {
+        return *static_cast<pthreads_manage::PartitionerSettings*>(args);
+    }
+}
+
+TEST(CountChunksTest, WithoutAndWithOverlap) {
+    EXPECT_EQ(pthreads_manage::count_chunks({10, 3, 0}, 10), 4u);
+    EXPECT_EQ(pthreads_manage::count_chunks({10, 10, 0}, 10), 1u);
+    EXPECT_EQ(pthreads_manage::count_chunks({10, 4, 1}, 10), 3u); // [0,4) [3,7) [6,10)
+    EXPECT_EQ(pthreads_manage::count_chunks({11, 4, 1}, 11), 4u);
+    EXPECT_EQ(pthreads_manage::count_chunks({0, 4, 1}, 0), 0u);
+}
+
+class PoolScheduleTest : public ::testing::TestWithParam<std::tuple<pthreads_manage::Schedule, pthreads_manage::WaitPolicy>> {
+public:
+    pthreads_manage::Schedule schedule = std::get<0>(GetParam());
+    pthreads_manage::Pool pthreads_pool{std::get<1>(GetParam())};
+};
+
+TEST_P(PoolScheduleTest, EveryChunkRunsOnce) {
+    const std::size_t count_chunks = schedule == pthreads_manage::Schedule::WorkStealing
+                                        ? pthreads_pool.totalThreads() * pthreads_manage::chunks_per_thread_stealing
+                                        : pthreads_pool.totalThreads();
+    const std::size_t chunk_size = 7;
+    const std::size_t N = count_chunks * chunk_size - 3; // Последний сегмент неполный
+
+    auto view = ViewType("v", N);
+    std::vector<std::atomic<std::size_t>> chunk_hits(count_chunks);
+    CountingArgs kernel_args{&chunk_hits};
+    pthreads_manage::PartitionerSettings settings{N, chunk_size, 0};
+
+    for (std::size_t repeat = 0; repeat < 50; repeat++) {
+        pthreads_manage::JobContext context{view, &countingKernel, &kernel_args, &testPartitioner, &settings, schedule};
+        pthreads_pool.dispatchJob(context);
+    }
+
+    for (std::size_t c = 0; c < count_chunks; c++)
+        EXPECT_EQ(chunk_hits[c].load(), 50u) << "chunk " << c;
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_EQ(view(i, 0), 50.0) << "row " << i;
+        EXPECT_EQ(view(i, 1), static_cast<double>(i / chunk_size)) << "row " << i;
+    }
+}
+
+TEST_P(PoolScheduleTest, OverlappedChunksShareBorder) {
+    const std::size_t count_chunks = pthreads_pool.totalThreads();
+    const std::size_t chunk_size = 5, overlap = 1;
+    const std::size_t N = count_chunks * (chunk_size - overlap) + overlap;
+
+    //Пограничные строки проходят два потока одновременно, поэтому сегменты не пишут в них, а записывают свои строки отдельно
+    auto view = ViewType("v", N);
+    std::vector<std::vector<std::size_t>> chunk_rows(count_chunks);
+    OverlapArgs kernel_args{&chunk_rows, chunk_size - overlap};
+    pthreads_manage::PartitionerSettings settings{N, chunk_size, overlap};
+    pthreads_manage::JobContext context{view, &overlapKernel, &kernel_args, &testPartitioner, &settings, schedule};
+    pthreads_pool.dispatchJob(context);
+
+    std::vector<std::size_t> row_hits(N, 0);
+    for (const auto& rows : chunk_rows)
+        for (const std::size_t row : rows)
+            row_hits[row] += 1;
+    for (std::size_t i = 0; i < N; i++) {
+        bool is_border = i != 0 && i != N - 1 && i % (chunk_size - overlap) == 0;
+        EXPECT_EQ(row_hits[i], is_border ? 2u : 1u) << "row " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Schedules,
+    PoolScheduleTest,
+    ::testing::Combine(
+        ::testing::Values(pthreads_manage::Schedule::Static, pthreads_manage::Schedule::WorkStealing),
+        ::testing::Values(pthreads_manage::WaitPolicy::Park, pthreads_manage::WaitPolicy::SpinThenPark)
+    )
+);
+
+TYPED_TEST(TwoGridFixture, WorkStealingMatchesStatic) {
+    grid::GenNonUniformOnRay<ViewType, Parallel> gen_static;
+    grid::GenNonUniformOnRay<ViewType, WorkStealing> gen_stealing;
+
+    geometry::Point2D<double> direction{0.6, 0.8};
+    geometry::Point2D<double> start_grid_point{direction.x * 0.5, direction.y * 0.5};
+    geometry::Point2D<double> end_grid_point{direction.x * 10.0, direction.y * 10.0};
+    double multiplier_q = 1.05;
+
+    gen_static(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, this->grid_first);
+    std::size_t line_size = this->grid_first.extent(0);
+    auto stealing_storage = ViewType("v", line_size);
+    gen_stealing(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, stealing_storage);
+
+    for (std::size_t i = 0; i < line_size; i++) {
+        EXPECT_NEAR(this->grid_first(i, 0), stealing_storage(i, 0), 1e-12);
+        EXPECT_NEAR(this->grid_first(i, 1), stealing_storage(i, 1), 1e-12);
+    }
+}
+
+namespace {
+    struct NestedArgs {
+        pthreads_manage::Pool* pthreads_pool_;
+        std::size_t inner_chunk_size_;
+    };
+
+    void innerKernel(ViewType chunk, std::size_t, void*) {
+        for (std::size_t i = 0; i < chunk.extent(0); i++)
+            chunk(i, 0) += 1.0;
+    }
+
+    void outerKernel(ViewType chunk, std::size_t, void* args) {
+        auto* args_ptr = static_cast<NestedArgs*>(args);
+        pthreads_manage::PartitionerSettings inner_settings{chunk.extent(0), args_ptr->inner_chunk_size_, 0};
+        pthreads_manage::JobContext inner{chunk, &innerKernel, nullptr, &testPartitioner, &inner_settings};
+        args_ptr->pthreads_pool_->dispatchNestedJob(inner);
+        chunk(0, 1) = 1.0; // Вложенная задача завершена до возврата
+    }
+}
+
+TEST_P(PoolScheduleTest, NestedJobsCoverParentChunk) {
+    const std::size_t count_chunks = pthreads_pool.totalThreads() * 2;
+    const std::size_t chunk_size = 64;
+    const std::size_t N = count_chunks * chunk_size;
+    auto view = ViewType("v", N);
+
+    NestedArgs kernel_args{&pthreads_pool, 5};
+    pthreads_manage::PartitionerSettings settings{N, chunk_size, 0};
+    for (std::size_t repeat = 0; repeat < 20; repeat++) {
+        pthreads_manage::JobContext context{view, &outerKernel, &kernel_args, &testPartitioner, &settings, schedule};
+        pthreads_pool.dispatchJob(context);
+    }
+
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_EQ(view(i, 0), 20.0) << "row " << i;
+        EXPECT_EQ(view(i, 1), i % chunk_size == 0 ? 1.0 : 0.0) << "row " << i;
+    }
+}
+
+TEST(PoolNestedTest, OutsidePoolRunsAsJob) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t N = 100;
+    auto view = ViewType("v", N);
+    pthreads_manage::PartitionerSettings settings{N, 7, 0};
+    pthreads_manage::JobContext context{view, &innerKernel, nullptr, &testPartitioner, &settings};
+    pthreads_pool.dispatchNestedJob(context);
+    for (std::size_t i = 0; i < N; i++)
+        EXPECT_EQ(view(i, 0), 1.0) << "row " << i;
+}
+
+TEST_P(PoolScheduleTest, TypedDispatchAcceptsLambdaKernel) {
+    const std::size_t count_chunks = pthreads_pool.totalThreads() * 3;
+    const std::size_t chunk_size = 11;
+    const std::size_t N = count_chunks * chunk_size - 4;
+    auto view = ViewType("v", N);
+
+    struct Offset { double value_; };
+    pthreads_manage::Environment env{
+                            [](auto chunk, std::size_t chunk_id, const Offset& offset) noexcept {
+                                for (std::size_t i = 0; i < chunk.extent(0); i++) {
+                                    chunk(i, 0) += offset.value_;
+                                    chunk(i, 1) = static_cast<double>(chunk_id);
+                                }
+                            },
+                            Offset{0.5},
+                            [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                            pthreads_manage::PartitionerSettings{N, chunk_size, 0}
+                        };
+    for (std::size_t repeat = 0; repeat < 10; repeat++) {
+        if (schedule == pthreads_manage::Schedule::WorkStealing)
+            pthreads_pool.dispatchJob<WorkStealing>(view, env);
+        else
+            pthreads_pool.dispatchJob<Parallel>(view, env);
+    }
+
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_EQ(view(i, 0), 5.0) << "row " << i;
+        EXPECT_EQ(view(i, 1), static_cast<double>(i / chunk_size)) << "row " << i;
+    }
+}
+
+TEST(PoolTypedTest, SequentialRunsOnCallingThread) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t N = 50;
+    auto view = ViewType("v", N);
+    const auto caller = pthread_self();
+    std::atomic<std::size_t> foreign_chunks{0};
+
+    pthreads_manage::Environment env{
+                            [caller](auto chunk, std::size_t, std::atomic<std::size_t>* foreign) noexcept {
+                                if (!pthread_equal(pthread_self(), caller))
+                                    foreign->fetch_add(1, std::memory_order_relaxed);
+                                for (std::size_t i = 0; i < chunk.extent(0); i++)
+                                    chunk(i, 0) = 1.0;
+                            },
+                            &foreign_chunks,
+                            [](std::size_t full_size) noexcept { return pthreads_manage::PartitionerSettings{full_size, 8, 0}; },
+                            N
+                        };
+    pthreads_pool.dispatchJob<Sequential>(view, env);
+
+    EXPECT_EQ(foreign_chunks.load(), 0u);
+    for (std::size_t i = 0; i < N; i++)
+        EXPECT_EQ(view(i, 0), 1.0) << "row " << i;
+}
+
+TEST(PoolTypedTest, UnmanagedViewIsAccepted) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t N = 40;
+    std::vector<double> buffer(2 * N, 0.0);
+    Kokkos::View<double*[2], Kokkos::LayoutRight, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> view(buffer.data(), N);
+
+    pthreads_manage::Environment env{
+                            [](auto chunk, std::size_t chunk_id, std::size_t) noexcept {
+                                for (std::size_t i = 0; i < chunk.extent(0); i++)
+                                    chunk(i, 1) = static_cast<double>(chunk_id + 1);
+                            },
+                            std::size_t{0},
+                            [](std::size_t full_size) noexcept { return pthreads_manage::PartitionerSettings{full_size, 10, 0}; },
+                            N
+                        };
+    pthreads_pool.dispatchJob<Parallel>(view, env);
+
+    for (std::size_t i = 0; i < N; i++)
+        EXPECT_EQ(buffer[2 * i + 1], static_cast<double>(i / 10 + 1)) << "row " << i;
+}
+
+TEST(PoolTypedTest, ExplicitThreadCountCoversAllChunks) {
+    for (std::size_t count_threads : {std::size_t{0}, std::size_t{1}, std::size_t{3}, 2 * pthreads_manage::get_count_cpu()}) {
+        pthreads_manage::Pool pthreads_pool{count_threads};
+        EXPECT_EQ(pthreads_pool.totalThreads(), std::max<std::size_t>(count_threads, 1));
+
+        const std::size_t N = 64;
+        auto view = ViewType("v", N);
+        pthreads_manage::Environment env{
+                                [](auto chunk, std::size_t, std::size_t) noexcept {
+                                    for (std::size_t i = 0; i < chunk.extent(0); i++)
+                                        chunk(i, 0) += 1.0;
+                                },
+                                std::size_t{0},
+                                [](std::size_t full_size) noexcept { return pthreads_manage::PartitionerSettings{full_size, 4, 0}; },
+                                N
+                            };
+        pthreads_pool.dispatchJob<Parallel>(view, env);
+
+        for (std::size_t i = 0; i < N; i++)
+            EXPECT_EQ(view(i, 0), 1.0) << "threads " << count_threads << ", row " << i;
+    }
+}
+
+namespace {
+    ///Хеш последовательности индексов: свертка некоммутативна, поэтому проверяет порядок частичных результатов
+    struct SequenceHash {
+        std::uint64_t hash_ = 0;
+        std::uint64_t power_ = 1; // base^длина
+    };
+    constexpr std::uint64_t hash_base = 1000003;
+
+    SequenceHash combine_hashes(const SequenceHash& first, const SequenceHash& second) noexcept {
+        return {first.hash_ * second.power_ + second.hash_, first.power_ * second.power_};
+    }
+}
+
+TEST_P(PoolScheduleTest, ReduceRangeCombinesChunksInOrder) {
+    static_assert(alignof(pthreads_manage::PaddedPartial<double>) == 64 && sizeof(pthreads_manage::PaddedPartial<double>) == 64);
+    const std::size_t N = 1003;
+    SequenceHash expected;
+    for (std::size_t i = 0; i < N; i++)
+        expected = combine_hashes(expected, SequenceHash{i + 1, hash_base});
+
+    const pthreads_manage::Environment env{
+                            [](pthreads_manage::IndexRange range, std::size_t, int, SequenceHash& partial) noexcept {
+                                for (std::size_t i = range.begin_; i < range.end_; i++)
+                                    partial = SequenceHash{partial.hash_ * hash_base + i + 1, partial.power_ * hash_base};
+                            },
+                            0,
+                            [](std::size_t full_size) noexcept { return pthreads_manage::PartitionerSettings{full_size, 17, 0}; },
+                            N
+                        };
+    const SequenceHash result = schedule == pthreads_manage::Schedule::WorkStealing
+                                    ? pthreads_pool.reduceRange<WorkStealing>(N, env, SequenceHash{}, combine_hashes)
+                                    : pthreads_pool.reduceRange<Parallel>(N, env, SequenceHash{}, combine_hashes);
+    EXPECT_EQ(result.hash_, expected.hash_);
+    EXPECT_EQ(result.power_, expected.power_);
+    EXPECT_EQ(pthreads_pool.reduceRange<Sequential>(N, env, SequenceHash{}, combine_hashes).hash_, expected.hash_);
+    //Пустой диапазон - нейтральный элемент
+    EXPECT_EQ(pthreads_pool.reduceRange<Parallel>(0, env, SequenceHash{7, 1}, combine_hashes).hash_, 7u);
+}
+
+TEST_P(PoolScheduleTest, ReduceRangeIgnoresOverlap) {
+    const std::size_t N = 1003;
+    const pthreads_manage::Environment env{
+                            [](pthreads_manage::IndexRange range, std::size_t, int, std::size_t& partial) noexcept {
+                                partial += range.end_ - range.begin_;
+                            },
+                            0,
+                            [](std::size_t full_size) noexcept { return pthreads_manage::PartitionerSettings{full_size, 17, 5}; },
+                            N
+                        };
+    auto sum = [](std::size_t first, std::size_t second) { return first + second; };
+    const std::size_t count = schedule == pthreads_manage::Schedule::WorkStealing
+                                    ? pthreads_pool.reduceRange<WorkStealing>(N, env, std::size_t{0}, sum)
+                                    : pthreads_pool.reduceRange<Parallel>(N, env, std::size_t{0}, sum);
+    EXPECT_EQ(count, N); // Каждый индекс - ровно один раз
+}
+
+TEST_P(PoolScheduleTest, RangeDispatchCoversAllIndices) {
+    const std::size_t N = 1003;
+    std::vector<std::size_t> hits(N, 0);
+
+    pthreads_manage::Environment env{
+                            [](pthreads_manage::IndexRange range, std::size_t, std::size_t* hits_ptr) noexcept {
+                                for (std::size_t i = range.begin_; i < range.end_; i++)
+                                    hits_ptr[i] += 1;
+                            },
+                            hits.data(),
+                            [](std::size_t full_size) noexcept { return pthreads_manage::PartitionerSettings{full_size, 17, 0}; },
+                            N
+                        };
+    if (schedule == pthreads_manage::Schedule::WorkStealing)
+        pthreads_pool.dispatchRange<WorkStealing>(N, env);
+    else
+        pthreads_pool.dispatchRange<Parallel>(N, env);
+    pthreads_pool.dispatchRange<Sequential>(N, env);
+
+    for (std::size_t i = 0; i < N; i++)
+        EXPECT_EQ(hits[i], 2u) << "index " << i;
+}
@@ -0,0 +1,157 @@
+#include "test_fixtures.hpp"
+#include <cmath>
+
+namespace {
+    const fem::Material steel{2.1e11, 0.3, 1.0};
+
+    ///Система задачи Кирша на четверти пластины: симметрия на осях, far field на внешней границе
+    class KirschSystemTest : public ::testing::Test {
+    public:
+        static constexpr std::size_t H = 9;
+        static constexpr std::size_t R = 12;
+        pthreads_manage::Pool pthreads_pool{};
+        ViewType mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, H, R);
+        topology::QuadView quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, R);
+        assembly::StiffnessAssembler<Parallel, 4> assembler{pthreads_pool, quads, mesh.extent(0)};
+        topology::RayLayout layout{H, R};
+        std::vector<MKL_INT> fixed_dofs = fem::kirsch_symmetry_dofs(layout);
+
+        sparse::CsrMatrix system(const fem::Material& material) {
+            auto matrix = assembler.pattern();
+            EXPECT_EQ(assembler.assemble(pthreads_pool, mesh, material, matrix), SPARSE_STATUS_SUCCESS);
+            fem::apply_dirichlet(matrix, fixed_dofs);
+            return matrix;
+        }
+
+        ///Правые части для случаев нагружения по столбцам
+        std::vector<double> loads(const std::vector<fem::FarFieldStress>& cases) {
+            const std::size_t n = 2 * mesh.extent(0);
+            std::vector<double> rhs(n * cases.size(), 0.0);
+            for (std::size_t c = 0; c < cases.size(); c++) {
+                fem::add_far_field_load(mesh, layout, cases[c], steel.thickness_, rhs.data() + c * n);
+                for (MKL_INT dof : fixed_dofs)
+                    rhs[c * n + dof] = 0.0;
+            }
+            return rhs;
+        }
+
+        static double relative_residual(const sparse::CsrMatrix& matrix, const double* x, const double* b) {
+            std::vector<double> Ax(matrix.count_rows_);
+            solvers::SparseOperator{matrix}.apply(x, Ax.data());
+            double residual = 0.0, norm_b = 0.0;
+            for (MKL_INT i = 0; i < matrix.count_rows_; i++) {
+                residual += (Ax[i] - b[i]) * (Ax[i] - b[i]);
+                norm_b += b[i] * b[i];
+            }
+            return std::sqrt(residual / norm_b);
+        }
+    };
+}
+
+TEST_F(KirschSystemTest, PardisoSolvesUniaxialTension) {
+    auto matrix = system(steel);
+    auto rhs = loads({{1.0e6, 0.0}});
+    std::vector<double> x(rhs.size());
+
+    solvers::PardisoSolver solver;
+    ASSERT_EQ(solver.analyze(matrix), 0);
+    ASSERT_EQ(solver.factorize(matrix), 0);
+    ASSERT_EQ(solver.solve(rhs.data(), x.data()), 0);
+
+    EXPECT_LT(relative_residual(matrix, x.data(), rhs.data()), 1e-10);
+    //Растяжение вдоль x: правая граница уходит вправо, верхняя опускается (эффект Пуассона)
+    EXPECT_GT(x[2 * layout.node(0, R - 1)], 0.0);
+    EXPECT_LT(x[2 * layout.node(H - 1, R - 1) + 1], 0.0);
+    for (MKL_INT dof : fixed_dofs)
+        EXPECT_EQ(x[dof], 0.0);
+
+    EXPECT_EQ(solver.timings().count_factorizations_, 1u);
+    EXPECT_EQ(solver.timings().count_solves_, 1u);
+    EXPECT_GE(solver.timings().reorder_seconds_, 0.0);
+}
+
+TEST_F(KirschSystemTest, MultipleRightHandSidesMatchSingleSolves) {
+    auto matrix = system(steel);
+    const std::vector<fem::FarFieldStress> cases{{1.0e6, 0.0}, {0.0, 1.0e6}, {1.0e6, 1.0e6}};
+    auto rhs = loads(cases);
+    const std::size_t n = 2 * mesh.extent(0);
+
+    solvers::PardisoSolver solver;
+    ASSERT_EQ(solver.analyze(matrix), 0);
+    ASSERT_EQ(solver.factorize(matrix), 0);
+    std::vector<double> all(rhs.size());
+    ASSERT_EQ(solver.solve(rhs.data(), all.data(), static_cast<MKL_INT>(cases.size())), 0);
+
+    for (std::size_t c = 0; c < cases.size(); c++) {
+        std::vector<double> single(n);
+        ASSERT_EQ(solver.solve(rhs.data() + c * n, single.data()), 0);
+        for (std::size_t i = 0; i < n; i++)
+            EXPECT_NEAR(all[c * n + i], single[i], 1e-12 * (1.0 + std::abs(single[i]))) << "case " << c << ", dof " << i;
+    }
+    //Двухосное растяжение - сумма одноосных (линейность)
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_NEAR(all[2 * n + i], all[i] + all[n + i], 1e-9 * (std::abs(all[i]) + std::abs(all[n + i])) + 1e-20);
+    EXPECT_EQ(solver.timings().count_solves_, cases.size() + 3);
+}
+
+TEST_F(KirschSystemTest, PardisoRejectsOutOfOrderAndFailedPhases) {
+    auto matrix = system(steel);
+    auto rhs = loads({{1.0e6, 0.0}});
+    std::vector<double> x(rhs.size());
+
+    solvers::PardisoSolver solver;
+    EXPECT_EQ(solver.factorize(matrix), solvers::PardisoSolver::not_ready);
+    EXPECT_EQ(solver.solve(rhs.data(), x.data()), solvers::PardisoSolver::not_ready);
+    ASSERT_EQ(solver.analyze(matrix), 0);
+    EXPECT_EQ(solver.solve(rhs.data(), x.data()), solvers::PardisoSolver::not_ready);
+
+    //Отрицательно определенная матрица: факторизация mtype = 2 невозможна, неудача не считается и solve недоступен
+    auto negative = system(fem::Material{-steel.young_modulus_, steel.poisson_ratio_, steel.thickness_});
+    EXPECT_NE(solver.factorize(negative), 0);
+    EXPECT_EQ(solver.timings().count_factorizations_, 0u);
+    EXPECT_EQ(solver.solve(rhs.data(), x.data()), solvers::PardisoSolver::not_ready);
+
+    ASSERT_EQ(solver.factorize(matrix), 0);
+    EXPECT_EQ(solver.timings().count_factorizations_, 1u);
+    EXPECT_EQ(solver.solve(rhs.data(), x.data()), 0);
+}
+
+TEST_F(KirschSystemTest, RefactorizationReusesAnalysis) {
+    auto matrix = system(steel);
+    auto rhs = loads({{1.0e6, 0.0}});
+    std::vector<double> x(rhs.size()), x_soft(rhs.size());
+
+    solvers::PardisoSolver solver;
+    ASSERT_EQ(solver.analyze(matrix), 0);
+    ASSERT_EQ(solver.factorize(matrix), 0);
+    ASSERT_EQ(solver.solve(rhs.data(), x.data()), 0);
+
+    //Тот же портрет, модуль Юнга вдвое меньше: только численная факторизация, перемещения вдвое больше
+    auto soft = system(fem::Material{steel.young_modulus_ / 2.0, steel.poisson_ratio_, steel.thickness_});
+    ASSERT_EQ(solver.factorize(soft), 0);
+    ASSERT_EQ(solver.solve(rhs.data(), x_soft.data()), 0);
+    for (std::size_t i = 0; i < x.size(); i++)
+        EXPECT_NEAR(x_soft[i], 2.0 * x[i], 1e-9 * std::abs(x[i]) + 1e-20);
+    EXPECT_EQ(solver.timings().count_factorizations_, 2u);
+}
+
+TEST_F(KirschSystemTest, PreconditionedCgMatchesPardiso) {
+    auto matrix = system(steel);
+    ASSERT_EQ(matrix.make_handle(1000), SPARSE_STATUS_SUCCESS);
+    auto rhs = loads({{1.0e6, 0.5e6}});
+    std::vector<double> direct(rhs.size()), iterative(rhs.size(), 0.0);
+
+    solvers::PardisoSolver solver;
+    ASSERT_EQ(solver.analyze(matrix), 0);
+    ASSERT_EQ(solver.factorize(matrix), 0);
+    ASSERT_EQ(solver.solve(rhs.data(), direct.data()), 0);
+
+    auto report = solvers::conjugate_gradient(solvers::SparseOperator{matrix}, solvers::JacobiPreconditioner{matrix}, rhs.data(), iterative.data(),
+                                              solvers::CgSettings{1e-12, 10000});
+    ASSERT_TRUE(report.converged_) << "iterations " << report.iterations_ << ", residual " << report.relative_residual_;
+    double scale = 0.0;
+    for (double value : direct)
+        scale = std::max(scale, std::abs(value));
+    for (std::size_t i = 0; i < direct.size(); i++)
+        EXPECT_NEAR(iterative[i], direct[i], 1e-8 * scale) << "dof " << i;
+}
@@ -0,0 +1,205 @@
+#include "test_fixtures.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+TEST(AoSoAViewTest, BlocksHoldXThenY) {
+    storage::AoSoAView<double, 4> coordinates("v", 10);
+    EXPECT_EQ(coordinates.extent(0), 10u);
+    EXPECT_EQ(coordinates.blocks().extent(0), 3u); // Последний блок неполный
+    for (std::size_t i = 0; i < 10; i++) {
+        coordinates(i, 0) = static_cast<double>(i);
+        coordinates(i, 1) = -static_cast<double>(i);
+    }
+    const double* raw = coordinates.data();
+    EXPECT_EQ(raw[0], 0.0);
+    EXPECT_EQ(raw[3], 3.0);
+    EXPECT_EQ(raw[4], -0.0);
+    EXPECT_EQ(raw[7], -3.0);
+    EXPECT_EQ(raw[8], 4.0); // Второй блок
+}
+
+TEST(AoSoAViewTest, SubrangeSharesMemory) {
+    storage::AoSoAView<double, 4> coordinates("v", 12);
+    auto segment = storage::subrange(coordinates, 5, 11);
+    EXPECT_EQ(segment.extent(0), 6u);
+    for (std::size_t i = 0; i < segment.extent(0); i++)
+        segment(i, 1) = 1.0 + i;
+    auto inner = storage::subrange(segment, 2, 4);
+    EXPECT_EQ(inner(0, 1), 3.0);
+    EXPECT_EQ(coordinates(5, 1), 1.0);
+    EXPECT_EQ(coordinates(10, 1), 6.0);
+}
+
+template <typename StorageT>
+class LayoutFixture : public ::testing::Test {
+public:
+    pthreads_manage::Pool pthreads_pool{};
+};
+
+using AllLayouts = ::testing::Types<
+                        storage::SoAView<double>,
+                        storage::AoSoAView<double, 4>,
+                        storage::AoSoAView<double, 8>
+                    >;
+TYPED_TEST_SUITE(LayoutFixture, AllLayouts);
+
+TYPED_TEST(LayoutFixture, RayMatchesAoS) {
+    geometry::Point2D<double> direction{0.6, 0.8};
+    geometry::Point2D<double> start{0.3, 0.4};
+    geometry::Point2D<double> end{6.0, 8.0};
+    const std::size_t N = 203;
+
+    auto reference = storage::allocate<ViewType>("v", N);
+    auto ray = storage::allocate<TypeParam>("v", N);
+    grid::GenNonUniformOnRay<ViewType, Parallel>{}(this->pthreads_pool, direction, start, end, 1.02, reference);
+    grid::GenNonUniformOnRay<TypeParam, WorkStealing>{}(this->pthreads_pool, direction, start, end, 1.02, ray);
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_EQ(ray(i, 0), reference(i, 0)) << "point " << i;
+        EXPECT_EQ(ray(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
+
+TYPED_TEST(LayoutFixture, KirschMeshMatchesAoS) {
+    const std::size_t count_points_on_hole = 41, count_points_on_ray = 23;
+    auto reference = mesh::GenFrameKirsch<ViewType, Sequential>{}(this->pthreads_pool, 0.5, 4.0, 1.1, count_points_on_hole, count_points_on_ray);
+    auto mesh = mesh::GenFrameKirsch<TypeParam, Parallel>{}(this->pthreads_pool, 0.5, 4.0, 1.1, count_points_on_hole, count_points_on_ray);
+    ASSERT_EQ(mesh.extent(0), reference.extent(0));
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_EQ(mesh(i, 0), reference(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
+
+TYPED_TEST(LayoutFixture, FirstTouchAndHugePagesKeepMesh) {
+    const std::size_t count_points_on_hole = 257, count_points_on_ray = 1100; // Больше huge_page_size
+    auto reference = mesh::GenFrameKirsch<TypeParam, Parallel>{}(this->pthreads_pool, 0.5, 4.0, 1.01, count_points_on_hole, count_points_on_ray);
+    mesh::GenFrameKirsch<TypeParam, Parallel> gen_mesh{mesh::MeshPlacement{true, true}};
+    auto mesh = gen_mesh(this->pthreads_pool, 0.5, 4.0, 1.01, count_points_on_hole, count_points_on_ray);
+    ASSERT_EQ(mesh.extent(0), reference.extent(0));
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        ASSERT_EQ(mesh(i, 0), reference(i, 0)) << "point " << i;
+        ASSERT_EQ(mesh(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
+
+TYPED_TEST(LayoutFixture, TouchPagesReachesEveryPage) {
+    using ScalarT = storage::scalar_t<TypeParam>;
+    const std::size_t N = 3 * storage::small_page_size / sizeof(ScalarT) + 5;
+    auto coordinates = storage::allocate<TypeParam>("v", N);
+    for (std::size_t i = 0; i < N; i++) {
+        coordinates(i, 0) = ScalarT(1);
+        coordinates(i, 1) = ScalarT(1);
+    }
+    storage::touch_pages(storage::subrange(coordinates, 3, N));
+    //Между соседними касаниями в каждой компоненте не больше страницы
+    for (std::size_t component = 0; component < 2; component++) {
+        std::size_t last_touch = 3;
+        for (std::size_t i = 3; i < N; i++) {
+            if (coordinates(i, component) == ScalarT(0)) {
+                EXPECT_LE((i - last_touch) * sizeof(ScalarT), storage::small_page_size) << "point " << i;
+                last_touch = i;
+            }
+        }
+        EXPECT_EQ(coordinates(3, component), ScalarT(0));
+        EXPECT_EQ(coordinates(N - 1, component), ScalarT(0));
+        EXPECT_EQ(coordinates(2, component), ScalarT(1));
+    }
+}
+
+TEST(PageBufferTest, TransparentHugeIsAligned) {
+    storage::PageBuffer buffer;
+    const std::size_t bytes = 3 * storage::huge_page_size + 123;
+    ASSERT_EQ(buffer.allocate(bytes, storage::PageMode::TransparentHuge), 0);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(buffer.size(), bytes);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data()) % storage::huge_page_size, 0u);
+    buffer.data()[bytes - 1] = std::byte{7};
+
+    storage::PageBuffer moved = std::move(buffer);
+    EXPECT_FALSE(buffer);
+    EXPECT_EQ(moved.data()[bytes - 1], std::byte{7});
+    moved.reset();
+    EXPECT_FALSE(moved);
+}
+
+TEST(PageBufferTest, FillWrappedBufferMatchesAllocated) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t count_points_on_hole = 65, count_points_on_ray = 40;
+    auto reference = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, count_points_on_hole, count_points_on_ray);
+
+    for (auto mode : {storage::PageMode::Default, storage::PageMode::TransparentHuge, storage::PageMode::ExplicitHuge}) {
+        storage::PageBuffer buffer;
+        const int error = buffer.allocate(storage::required_bytes<ViewType>(reference.extent(0)), mode);
+        if (mode == storage::PageMode::ExplicitHuge && error != 0)
+            continue; // Пул vm.nr_hugepages пуст
+        ASSERT_EQ(error, 0);
+        auto mesh = storage::wrap<ViewType>(buffer, reference.extent(0));
+        mesh::GenFrameKirsch<ViewType, WorkStealing>{mesh::MeshPlacement{true, false}}.fill(
+                        pthreads_pool, mesh, 0.5, 4.0, 1.1, count_points_on_hole, count_points_on_ray);
+        EXPECT_EQ(std::memcmp(mesh.data(), reference.data(), storage::required_bytes<ViewType>(reference.extent(0))), 0);
+    }
+}
+
+TEST(WorkspaceTest, GrowsOnResetAndStopsOverflowing) {
+    struct Args {
+        double value_;
+        std::size_t count_;
+    };
+    storage::Workspace workspace;
+    auto take_all = [&workspace] {
+        auto aos = workspace.take<ViewType>(100);
+        auto* args = workspace.make<Args>(1.5, std::size_t{3});
+        auto aosoa = workspace.take<storage::AoSoAView<float, 8>>(13);
+        for (const void* data : {static_cast<const void*>(aos.data()), static_cast<const void*>(args), static_cast<const void*>(aosoa.data())})
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % storage::workspace_alignment, 0u);
+        aos(99, 1) = 1.0;
+        aosoa(12, 1) = 2.0f; // Хвост последнего блока тоже выделен
+        EXPECT_EQ(args->count_, 3u);
+        return std::array<const void*, 3>{aos.data(), args, aosoa.data()};
+    };
+
+    take_all();
+    EXPECT_EQ(workspace.countOverflows(), 3u);
+    EXPECT_EQ(workspace.capacity(), 0u);
+    const std::size_t used = workspace.used();
+    EXPECT_GE(used, 100 * 2 * sizeof(double) + sizeof(Args) + 16 * 2 * sizeof(float));
+    ASSERT_EQ(workspace.reset(), 0);
+    EXPECT_GE(workspace.capacity(), used);
+    EXPECT_EQ(workspace.used(), 0u);
+
+    for (int repeat = 0; repeat < 3; repeat++) {
+        for (const void* data : take_all())
+            EXPECT_TRUE(workspace.owns(data));
+        EXPECT_EQ(workspace.countOverflows(), 0u);
+        EXPECT_EQ(workspace.used(), used);
+        ASSERT_EQ(workspace.reset(), 0);
+    }
+}
+
+template <typename ContainerT>
+class WorkspaceSweepTest : public ::testing::Test {};
+using WorkspaceSweepTypes = ::testing::Types<ViewType, storage::SoAView<double>, storage::AoSoAView<double, 8>>;
+TYPED_TEST_SUITE(WorkspaceSweepTest, WorkspaceSweepTypes);
+
+///Цикл по q в одной арене: сетки совпадают с обычной генерацией, со второго прохода все - из области арены
+TYPED_TEST(WorkspaceSweepTest, SweepMatchesAllocatedMesh) {
+    pthreads_manage::Pool pthreads_pool{};
+    const std::size_t H = 33, R = 20;
+    mesh::GenFrameKirsch<TypeParam, WorkStealing> gen_mesh;
+    storage::Workspace workspace;
+    for (const double q : {1.05, 1.1, 1.15, 1.2}) {
+        ASSERT_EQ(workspace.reset(), 0);
+        const auto mesh = gen_mesh(pthreads_pool, workspace, 0.5, 4.0, q, H, R);
+        const auto reference = gen_mesh(pthreads_pool, 0.5, 4.0, q, H, R);
+        ASSERT_EQ(mesh.extent(0), reference.extent(0));
+        for (std::size_t i = 0; i < mesh.extent(0); i++) {
+            EXPECT_EQ(mesh(i, 0), reference(i, 0)) << "q " << q << " node " << i;
+            EXPECT_EQ(mesh(i, 1), reference(i, 1)) << "q " << q << " node " << i;
+        }
+        if (q != 1.05) {
+            EXPECT_EQ(workspace.countOverflows(), 0u);
+            EXPECT_TRUE(workspace.owns(mesh.data()));
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "test_fixtures.hpp"
+#include <algorithm>
+#include <oneapi/tbb/task_scheduler_observer.h>
+
+TYPED_TEST(TwoGridFixture, TbbRayMatchesPthreads) {
+    geometry::Point2D<double> direction{0.6, 0.8};
+    geometry::Point2D<double> start_grid_point{direction.x * 0.5, direction.y * 0.5};
+    geometry::Point2D<double> end_grid_point{direction.x * 10.0, direction.y * 10.0};
+    double multiplier_q = 1.05;
+
+    grid::GenNonUniformOnRay<ViewType, Parallel>{}(this->pthreads_pool, direction, start_grid_point, end_grid_point, multiplier_q, this->grid_first);
+    auto tbb_storage = ViewType("v", this->grid_first.extent(0));
+    custom_tbb::grid::GenNonUniformOnRay<ViewType>{}(direction, start_grid_point, end_grid_point, multiplier_q, tbb_storage);
+
+    for (std::size_t i = 0; i < tbb_storage.extent(0); i++) {
+        EXPECT_EQ(tbb_storage(i, 0), this->grid_first(i, 0)) << "point " << i;
+        EXPECT_EQ(tbb_storage(i, 1), this->grid_first(i, 1)) << "point " << i;
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, TbbMatchesPthreads) {
+    auto reference = this->template generate<Parallel>();
+    auto mesh = custom_tbb::mesh::GenFrameKirsch<ViewType>{}(
+                        this->radius_hole, this->side_size, this->multiplier_q,
+                        this->count_points_on_hole, this->count_points_on_ray);
+    ASSERT_EQ(mesh.extent(0), reference.extent(0));
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_EQ(mesh(i, 0), reference(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
+
+namespace {
+    ///Наибольшее число потоков, одновременно находившихся в арене
+    class ArenaOccupancy : public tbb::task_scheduler_observer {
+    public:
+        explicit ArenaOccupancy(tbb::task_arena &arena) : tbb::task_scheduler_observer(arena) { observe(true); }
+        ~ArenaOccupancy() override { observe(false); }
+
+        void on_scheduler_entry(bool) override {
+            const std::size_t current = active_.fetch_add(1) + 1;
+            std::size_t seen = max_active_.load();
+            while (current > seen && !max_active_.compare_exchange_weak(seen, current)) {}
+        }
+        void on_scheduler_exit(bool) override { active_.fetch_sub(1); }
+
+        std::atomic<std::size_t> active_{0}, max_active_{0};
+    };
+}
+
+TEST(TbbArenaTest, MeshStaysWithinArenaConcurrency) {
+    tbb::task_arena arena(2);
+    ArenaOccupancy occupancy(arena);
+    pthreads_manage::Pool pthreads_pool{};
+    auto reference = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.1, 257, 129);
+
+    auto mesh = custom_tbb::mesh::GenFrameKirsch<storage::SoAView<double>>{}(arena, 0.5, 4.0, 1.1, 257, 129);
+    EXPECT_LE(occupancy.max_active_.load(), 2u);
+    for (std::size_t i = 0; i < reference.extent(0); i++) {
+        EXPECT_EQ(mesh(i, 0), reference(i, 0)) << "point " << i;
+        EXPECT_EQ(mesh(i, 1), reference(i, 1)) << "point " << i;
+    }
+}
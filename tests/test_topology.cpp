@@ -0,0 +1,121 @@
+#include "test_fixtures.hpp"
+#include <numeric>
+
+namespace {
+    template <std::size_t NodesPerElement>
+    double signed_area(const ViewType& mesh, const topology::ConnectivityView<NodesPerElement>& elements, std::size_t e) {
+        double area = 0.0;
+        for (std::size_t a = 0; a < NodesPerElement; a++) {
+            const std::size_t p = elements(e, a);
+            const std::size_t q = elements(e, (a + 1) % NodesPerElement);
+            area += mesh(p, 0) * mesh(q, 1) - mesh(q, 0) * mesh(p, 1);
+        }
+        return 0.5 * area;
+    }
+
+    bool is_permutation(std::vector<std::size_t> new_index) {
+        std::sort(new_index.begin(), new_index.end());
+        for (std::size_t i = 0; i < new_index.size(); i++)
+            if (new_index[i] != i)
+                return false;
+        return true;
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, QuadsAreCounterClockwiseAndIndependentOfPolicy) {
+    const std::size_t H = this->count_points_on_hole;
+    const std::size_t R = this->count_points_on_ray;
+    auto mesh = this->template generate<Parallel>();
+
+    auto quads = mesh::GenConnectivityKirsch<Sequential>{}.quads(this->pthreads_pool, mesh, R);
+    auto quads_parallel = mesh::GenConnectivityKirsch<Parallel>{}.quads(this->pthreads_pool, mesh, R);
+    auto quads_stealing = mesh::GenConnectivityKirsch<WorkStealing>{}.quads(this->pthreads_pool, mesh, R);
+
+    ASSERT_EQ(quads.extent(0), (H - 1) * (R - 1));
+    ASSERT_EQ(quads_parallel.extent(0), quads.extent(0));
+    ASSERT_EQ(quads_stealing.extent(0), quads.extent(0));
+    for (std::size_t e = 0; e < quads.extent(0); e++) {
+        EXPECT_GT(signed_area(mesh, quads, e), 0.0) << "quad " << e;
+        for (std::size_t a = 0; a < 4; a++) {
+            EXPECT_EQ(quads_parallel(e, a), quads(e, a)) << "quad " << e;
+            EXPECT_EQ(quads_stealing(e, a), quads(e, a)) << "quad " << e;
+        }
+    }
+}
+
+TYPED_TEST(KirschMeshFixture, TrianglesSplitQuads) {
+    const std::size_t R = this->count_points_on_ray;
+    auto mesh = this->template generate<Parallel>();
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(this->pthreads_pool, mesh, R);
+    auto triangles = mesh::GenConnectivityKirsch<Parallel>{}.triangles(this->pthreads_pool, mesh, R);
+
+    ASSERT_EQ(triangles.extent(0), 2 * quads.extent(0));
+    for (std::size_t e = 0; e < quads.extent(0); e++) {
+        const double quad_area = signed_area(mesh, quads, e);
+        EXPECT_GT(signed_area(mesh, triangles, 2 * e), 0.0) << "triangle " << 2 * e;
+        EXPECT_GT(signed_area(mesh, triangles, 2 * e + 1), 0.0) << "triangle " << 2 * e + 1;
+        EXPECT_NEAR(signed_area(mesh, triangles, 2 * e) + signed_area(mesh, triangles, 2 * e + 1), quad_area, 1e-12 * (1.0 + quad_area));
+    }
+}
+
+TEST(TopologyTest, NodeGraphOfQuadGrid) {
+    const topology::RayLayout layout{4, 5};
+    topology::QuadView quads("quads", layout.count_cells());
+    for (std::size_t k = 0; k + 1 < layout.count_rays_; k++)
+        for (std::size_t j = 0; j + 1 < layout.count_points_on_ray_; j++) {
+            const auto cell = layout.cell(k, j);
+            for (std::size_t a = 0; a < 4; a++)
+                quads(k * (layout.count_points_on_ray_ - 1) + j, a) = cell[a];
+        }
+
+    auto graph = topology::node_graph(quads, layout.count_nodes());
+    ASSERT_EQ(graph.count_nodes(), layout.count_nodes());
+    EXPECT_EQ(graph.degree(layout.node(0, 0)), 3u);   // Угол
+    EXPECT_EQ(graph.degree(layout.node(0, 2)), 5u);   // Край
+    EXPECT_EQ(graph.degree(layout.node(1, 2)), 8u);   // Внутренний узел
+    auto metrics = topology::band_metrics(graph, topology::natural_ordering(layout.count_nodes()));
+    EXPECT_EQ(metrics.bandwidth_, layout.count_points_on_ray_ + 1);
+}
+
+TEST(TopologyTest, ReverseCuthillMcKeeNarrowsBand) {
+    //Мало лучей и длинные лучи: естественная нумерация дает ленту R + 1, обход поперек лучей - около H + 1
+    const std::size_t H = 6, R = 200;
+    pthreads_manage::Pool pthreads_pool{};
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.01, H, R);
+    auto quads = mesh::GenConnectivityKirsch<Parallel>{}.quads(pthreads_pool, mesh, R);
+
+    auto renumbered = topology::renumber(topology::NodeOrdering::ReverseCuthillMcKee, mesh, quads);
+    ASSERT_TRUE(is_permutation(renumbered.new_index_));
+    EXPECT_EQ(renumbered.report_.before_.bandwidth_, R + 1);
+    EXPECT_LE(renumbered.report_.after_.bandwidth_, 2 * H);
+    EXPECT_LT(renumbered.report_.after_.profile_, renumbered.report_.before_.profile_);
+
+    for (std::size_t i = 0; i < mesh.extent(0); i++) {
+        EXPECT_EQ(renumbered.coordinates_(renumbered.new_index_[i], 0), mesh(i, 0));
+        EXPECT_EQ(renumbered.coordinates_(renumbered.new_index_[i], 1), mesh(i, 1));
+    }
+    for (std::size_t e = 0; e < quads.extent(0); e++)
+        for (std::size_t a = 0; a < 4; a++)
+            EXPECT_EQ(renumbered.elements_(e, a), renumbered.new_index_[quads(e, a)]);
+}
+
+TEST(TopologyTest, HilbertOrderingIsPermutation) {
+    const std::size_t H = 33, R = 40;
+    pthreads_manage::Pool pthreads_pool{};
+    auto mesh = mesh::GenFrameKirsch<ViewType, Parallel>{}(pthreads_pool, 0.5, 4.0, 1.05, H, R);
+    auto triangles = mesh::GenConnectivityKirsch<Parallel>{}.triangles(pthreads_pool, mesh, R);
+
+    auto renumbered = topology::renumber(topology::NodeOrdering::Hilbert, mesh, triangles);
+    ASSERT_TRUE(is_permutation(renumbered.new_index_));
+    for (std::size_t e = 0; e < triangles.extent(0); e++)
+        EXPECT_GT(signed_area(renumbered.coordinates_, renumbered.elements_, e), 0.0) << "triangle " << e;
+}
+
+TEST(TopologyTest, HilbertIndexVisitsAllCells) {
+    constexpr unsigned order = 3;
+    std::vector<bool> seen(64, false);
+    for (std::uint32_t x = 0; x < 8; x++)
+        for (std::uint32_t y = 0; y < 8; y++)
+            seen[topology::hilbert_index(x, y, order)] = true;
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](bool s) { return s; }));
+}
@@ -0,0 +1,175 @@
+#include "test_fixtures.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+    trace::Event make_event(trace::EventKind kind, const char* name, std::uint64_t begin_ns, std::uint64_t end_ns,
+                            std::uint64_t job_id = 0, std::uint64_t chunk_id = 0, std::uint64_t begin = 0, std::uint64_t end = 0) {
+        return trace::Event{begin_ns, end_ns, job_id, chunk_id, begin, end, name, 7, kind};
+    }
+
+    ///События пула пишутся только в сборке с FEM_TRACE (ENABLE_TRACE)
+    class PoolTraceTest : public ::testing::Test {
+    public:
+        void SetUp() override {
+            if constexpr (!trace::enabled)
+                GTEST_SKIP() << "built without FEM_TRACE";
+            trace::reset();
+        }
+
+        static std::vector<trace::Event> events_of(trace::EventKind kind) {
+            std::vector<trace::Event> result;
+            for (const auto& event : trace::Recorder::instance().collect())
+                if (event.kind_ == kind)
+                    result.push_back(event);
+            return result;
+        }
+
+        template <execution_policy Policy>
+        static void expect_chunks_cover_range(std::size_t count_threads, std::size_t full_size) {
+            trace::reset();
+            pthreads_manage::Pool pthreads_pool{count_threads};
+            pthreads_manage::Environment env{
+                                    [](pthreads_manage::IndexRange, std::size_t, int) noexcept {},
+                                    0,
+                                    [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                                    pthreads_manage::PartitionerSettings{full_size, pthreads_pool.rangeChunkSize<Policy>(full_size), 0}
+                                    };
+            pthreads_pool.dispatchRange<Policy>(full_size, env);
+
+            const auto jobs = events_of(trace::EventKind::Job);
+            ASSERT_EQ(jobs.size(), 1u);
+            const std::uint64_t job_id = jobs[0].job_id_;
+            EXPECT_NE(job_id, 0u);
+            EXPECT_EQ(jobs[0].end_, full_size);
+
+            auto chunks = events_of(trace::EventKind::Chunk);
+            ASSERT_EQ(chunks.size(), jobs[0].chunk_id_);
+            std::sort(chunks.begin(), chunks.end(), [](const auto& a, const auto& b) { return a.begin_ < b.begin_; });
+            std::uint64_t covered = 0;
+            for (const auto& chunk : chunks) {
+                EXPECT_EQ(chunk.job_id_, job_id);
+                EXPECT_EQ(chunk.begin_, covered);
+                EXPECT_LE(chunk.begin_ns_, chunk.end_ns_);
+                EXPECT_GE(chunk.begin_ns_, jobs[0].begin_ns_);
+                EXPECT_LE(chunk.end_ns_, jobs[0].end_ns_);
+                covered = chunk.end_;
+            }
+            EXPECT_EQ(covered, full_size);
+
+            const auto wakes = events_of(trace::EventKind::Wake);
+            EXPECT_EQ(wakes.size(), count_threads - 1);
+            for (const auto& wake : wakes)
+                EXPECT_EQ(wake.job_id_, job_id);
+        }
+    };
+}
+
+TEST(RingBuffer, KeepsLatestEvents) {
+    trace::RingBuffer buffer(5);
+    ASSERT_EQ(buffer.capacity(), 8u);
+    for (std::uint64_t i = 0; i < 11; i++)
+        buffer.push(make_event(trace::EventKind::Chunk, "chunk", i, i + 1, 1, i));
+    EXPECT_EQ(buffer.recorded(), 11u);
+
+    std::vector<trace::Event> events;
+    buffer.snapshot(events);
+    ASSERT_EQ(events.size(), 8u);
+    for (std::size_t i = 0; i < events.size(); i++)
+        EXPECT_EQ(events[i].chunk_id_, 3 + i);
+
+    buffer.clear();
+    events.clear();
+    buffer.snapshot(events);
+    EXPECT_TRUE(events.empty());
+}
+
+TEST(ChromeTrace, FormatsCompleteInstantAndMetadataEvents) {
+    const std::vector<trace::Event> events{
+            make_event(trace::EventKind::Job, "job", 1000, 6000, 3, 2, 0, 100),
+            make_event(trace::EventKind::Chunk, "chunk", 1500, 2500, 3, 1, 50, 100),
+            make_event(trace::EventKind::Steal, "steal", 2000, 2000, 3, 1, 4, 8),
+            make_event(trace::EventKind::Region, "say \"hi\"\n", 3000, 3250),
+    };
+    const std::string json = trace::chrome_trace_json(events, {{7, "pool worker 1"}});
+
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(json.substr(json.size() - 3), "]}\n");
+    EXPECT_NE(json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":7,\"args\":{\"name\":\"pool worker 1\"}}"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"job\",\"cat\":\"pool\",\"ph\":\"X\",\"pid\":1,\"tid\":7,\"ts\":0.000,\"dur\":5.000,"
+                        "\"args\":{\"job\":3,\"chunks\":2,\"size\":100}}"), std::string::npos);
+    EXPECT_NE(json.find("\"ts\":0.500,\"dur\":1.000,\"args\":{\"job\":3,\"chunk\":1,\"begin\":50,\"end\":100}}"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"steal\",\"cat\":\"pool\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":7,\"ts\":1.000,"
+                        "\"args\":{\"job\":3,\"victim\":1,\"begin\":4,\"end\":8}}"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"say \\\"hi\\\"\\u000a\",\"cat\":\"region\""), std::string::npos);
+}
+
+TEST(ChromeTrace, WritesFile) {
+    const std::string path = ::testing::TempDir() + "fem_trace.json";
+    ASSERT_EQ(trace::write_chrome_trace(path), 0);
+    std::ifstream file(path);
+    const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    std::filesystem::remove(path);
+    EXPECT_NE(trace::write_chrome_trace(::testing::TempDir() + "missing_directory/fem_trace.json"), 0);
+}
+
+TEST_F(PoolTraceTest, ParallelChunksCoverRange) {
+    expect_chunks_cover_range<Parallel>(4, 1000);
+}
+
+TEST_F(PoolTraceTest, WorkStealingChunksCoverRange) {
+    expect_chunks_cover_range<WorkStealing>(3, 777);
+}
+
+TEST_F(PoolTraceTest, MainWaitIsRecorded) {
+    pthreads_manage::Pool pthreads_pool{2};
+    pthreads_manage::Environment env{
+                            [](pthreads_manage::IndexRange range, std::size_t, int) noexcept {
+                                if (range.begin_ != 0)
+                                    usleep(2000);
+                            },
+                            0,
+                            [](const pthreads_manage::PartitionerSettings& settings) noexcept { return settings; },
+                            pthreads_manage::PartitionerSettings{2, 1, 0}
+                            };
+    pthreads_pool.dispatchRange<Parallel>(2, env);
+    const auto jobs = events_of(trace::EventKind::Job);
+    ASSERT_EQ(jobs.size(), 1u);
+    //Main выполнил свой сегмент и ждет второй: сначала спит внутри задачи (Park), затем ждет выхода потоков (WaitWorkers)
+    std::uint64_t waited_ns = 0;
+    for (const auto kind : {trace::EventKind::Park, trace::EventKind::WaitWorkers}) {
+        for (const auto& event : events_of(kind)) {
+            if (event.tid_ != jobs[0].tid_ || event.job_id_ != jobs[0].job_id_)
+                continue;
+            EXPECT_GE(event.begin_ns_, jobs[0].begin_ns_);
+            EXPECT_LE(event.end_ns_, jobs[0].end_ns_);
+            waited_ns += event.end_ns_ - event.begin_ns_;
+        }
+    }
+    EXPECT_GT(waited_ns, 1000000u);
+}
+
+TEST_F(PoolTraceTest, RegionsAndKokkosKernelsShareTimeline) {
+    trace::attach_kokkos_tools();
+    {
+        trace::Region region{"solve"};
+        Kokkos::Profiling::pushRegion("kokkos phase");
+        Kokkos::parallel_for("fill", Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, 16), KOKKOS_LAMBDA(int) {});
+        Kokkos::Profiling::popRegion();
+    }
+    const auto regions = events_of(trace::EventKind::Region);
+    const auto kernels = events_of(trace::EventKind::KokkosKernel);
+    ASSERT_EQ(regions.size(), 2u);
+    ASSERT_EQ(kernels.size(), 1u);
+    EXPECT_STREQ(regions[0].name_, "solve");
+    EXPECT_STREQ(regions[1].name_, "kokkos phase");
+    EXPECT_STREQ(kernels[0].name_, "fill");
+    EXPECT_GE(kernels[0].begin_ns_, regions[1].begin_ns_);
+    EXPECT_LE(kernels[0].end_ns_, regions[1].end_ns_);
+    EXPECT_LE(regions[1].end_ns_, regions[0].end_ns_);
+}